@@ -4,6 +4,7 @@
 #include "utils/Log.h"
 #include "utils/Assert.h"
 #include "utils/allocators/SmartPtr.h"
+#include "utils/filesystem/FileIO.h"
 
 #include "core/Application.h"
 #include "core/Logger.h"
@@ -5,6 +5,7 @@
 #include "render/vulkan/VulkanDriver.h"
 #include "core/Application.h"
 #include "core/Logger.h"
+#include "core/MemoryBudget.h"
 
 namespace coust {
 
@@ -18,6 +19,10 @@ Application::Application() noexcept
 
     m_render_layer.on_attach();
 
+#if defined(COUST_CHECK_FRAME_ALLOCATION)
+    check_frame_allocation(memory::AllocationCheckScope::Mode::count);
+#endif
+
     m_running = true;
 }
 
@@ -34,7 +39,18 @@ void Application::run() noexcept {
         cur_time = TimeStep::clock_t::now();
         TimeStep ts{last_time, cur_time};
         m_window.poll_events();
-        m_render_layer.on_update(ts);
+        {
+            std::optional<memory::AllocationCheckScope> frame_check{};
+            if (m_frame_check_mode.has_value()) {
+                if (m_frame_check_warm_up_count > 0)
+                    m_frame_check_warm_up_count--;
+                else
+                    frame_check.emplace("frame", *m_frame_check_mode);
+            }
+            m_render_layer.on_update(ts);
+        }
+        // between frames, so that no cache entry is in use while evicted
+        get_memory_budget().update();
         last_time = cur_time;
     }
 }
@@ -43,6 +59,13 @@ Window& Application::get_window() noexcept {
     return m_window;
 }
 
+void Application::check_frame_allocation(
+    memory::AllocationCheckScope::Mode mode,
+    uint32_t warm_up_frame_count) noexcept {
+    m_frame_check_mode = mode;
+    m_frame_check_warm_up_count = warm_up_frame_count;
+}
+
 Application& Application::get_instance() noexcept {
     return *s_instance;
 }
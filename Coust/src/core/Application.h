@@ -13,11 +13,13 @@ WARNING_POP
 #include "utils/TypeName.h"
 #include "utils/Log.h"
 #include "utils/allocators/SmartPtr.h"
+#include "utils/allocators/AllocationCheck.h"
 #include "core/layers/RenderLayer.h"
 #include "core/Window.h"
 #include "core/Memory.h"
 
 #include <memory>
+#include <optional>
 
 namespace coust {
 
@@ -44,6 +46,13 @@ public:
 
     Window& get_window() noexcept;
 
+    // watch the heap allocations of every frame once the first
+    // `warm_up_frame_count` frames have loaded the scene, see
+    // `memory::AllocationCheckScope`. It's turned on from the start with the
+    // `COUST_CHECK_FRAME_ALLOCATION` option
+    void check_frame_allocation(memory::AllocationCheckScope::Mode mode,
+        uint32_t warm_up_frame_count = 3) noexcept;
+
 public:
     static Application& get_instance() noexcept;
 
@@ -54,6 +63,10 @@ private:
     Window m_window;
     bool m_running = false;
 
+private:
+    std::optional<memory::AllocationCheckScope::Mode> m_frame_check_mode{};
+    uint32_t m_frame_check_warm_up_count = 0;
+
 private:
     static Application* s_instance;
 };
@@ -11,7 +11,12 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv) {
     if (should_exit)
         return test_result;
 #endif
+    std::filesystem::path const alloc_profile_path =
+        coust::file::get_absolute_path_from(
+            ".coustcache", "default_alloc_profile");
+    coust::reserve_default_alloc_from_profile(alloc_profile_path);
     auto app = coust::create_application();
     app->run();
+    coust::save_default_alloc_profile(alloc_profile_path);
     return 0;
 }
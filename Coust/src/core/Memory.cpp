@@ -2,6 +2,7 @@
 
 #include "utils/Compiler.h"
 #include "core/Memory.h"
+#include "utils/filesystem/FileIO.h"
 
 namespace coust {
 namespace memory {
@@ -9,6 +10,9 @@ namespace memory {
 WARNING_PUSH
 CLANG_DISABLE_WARNING("-Wexit-time-destructors")
 MemoryPool& get_global_memory_pool() noexcept {
+    // no allocator draws 50 KB areas any more, but the largest size sets how
+    // large the raw areas split into the smaller ones are. without it, every
+    // five 1 KB areas would cost a heap allocation of their own
     static MemoryPool s_global_memory_pool{
         {small_growth_factor, medium_growth_factor, large_growth_factor},
         global_memory_pool_alignment
@@ -17,68 +21,713 @@ MemoryPool& get_global_memory_pool() noexcept {
 }
 WARNING_POP
 
+namespace {
+
+// a single area must be able to hold the allocation along with the
+// bookkeeping of the raw allocator
+size_t constexpr medium_alloc_max_size =
+    medium_growth_factor - TLSFAllocator::BOOKKEEPING_SIZE;
+size_t constexpr large_alloc_max_size =
+    large_growth_factor - TLSFAllocator::BOOKKEEPING_SIZE;
+
+}  // namespace
+
 AggregateAllocator::AggregateAllocator(MemoryPool& pool) noexcept
-    : m_8byte_alloc(pool, byte_8),
-      m_16byte_alloc(pool, byte_16),
-      m_32byte_alloc(pool, byte_32),
-      m_64byte_alloc(pool, byte_64),
-      m_128byte_alloc(pool, byte_128),
+    : AggregateAllocator(pool, std::make_index_sequence<SMALL_CLASS_COUNT>{},
+          std::make_index_sequence<MEDIUM_CLASS_COUNT>{}) {
+}
+
+template <size_t... Small_Idx, size_t... Medium_Idx>
+AggregateAllocator::AggregateAllocator(MemoryPool& pool,
+    std::index_sequence<Small_Idx...>,
+    std::index_sequence<Medium_Idx...>) noexcept
+    : m_pool(pool),
+      m_small_allocs{HomoAlloc_S{pool, size_class::get_size(Small_Idx)}...},
+      m_medium_allocs{HomoAlloc_M{
+          pool, size_class::get_size(SMALL_CLASS_COUNT + Medium_Idx)}...},
       m_upto_5kbyte_alloc(pool),
-      m_upto_50kbyte_alloc(pool) {
+      m_upto_50kbyte_alloc(
+          large_alloc_reserved_size, PageType::transparent_huge) {
 }
 
 void* AggregateAllocator::allocate(size_t size, size_t alignment) noexcept {
     COUST_ASSERT(size != 0, "Allocation memory with size 0 is problematic");
-    if (size <= byte_8) {
-        return m_8byte_alloc.allocate(size, alignment);
-    } else if (size <= byte_16) {
-        return m_16byte_alloc.allocate(size, alignment);
-    } else if (size <= byte_32) {
-        return m_32byte_alloc.allocate(size, alignment);
-    } else if (size <= byte_64) {
-        return m_64byte_alloc.allocate(size, alignment);
-    } else if (size <= byte_128) {
-        return m_128byte_alloc.allocate(size, alignment);
-    } else if (size <= kbyte_5) {
-        return m_upto_5kbyte_alloc.allocate(size, alignment);
-    } else if (size <= kbyte_50) {
-        return m_upto_50kbyte_alloc.allocate(size, alignment);
+    detail::AllocationReport report{AllocationSource::aggregate, size};
+    size_t const slot = get_stats_slot(size);
+    m_stats[slot].record_allocation(size);
+    void* ret_ptr = nullptr;
+    if (slot < SMALL_CLASS_COUNT) {
+        ret_ptr = m_small_allocs[slot].allocate(size, alignment);
+    } else if (slot < size_class::count) {
+        ret_ptr = m_medium_allocs[slot - SMALL_CLASS_COUNT].allocate(
+            size, alignment);
+    } else if (slot == MEDIUM_STATS_SLOT) {
+        // an over-aligned block near the limit doesn't fit in a medium area
+        // along with its gap, the large allocations' range takes it instead
+        if (TLSFAllocator::get_padded_size(size, alignment) <=
+            medium_alloc_max_size)
+            ret_ptr = m_upto_5kbyte_alloc.allocate(size, alignment);
+        else
+            ret_ptr = m_upto_50kbyte_alloc.allocate(size, alignment);
+    } else if (slot == LARGE_STATS_SLOT) {
+        ret_ptr = m_upto_50kbyte_alloc.allocate(size, alignment);
     } else {
-        COUST_INFO("Giant Allocation: size {}, alignment {}", size, alignment);
-        return m_gaigantic_alloc.allocate(size, alignment);
+        ret_ptr = m_gaigantic_alloc.allocate(size, alignment);
     }
+    if (m_trace_recorder) {
+        m_trace_recorder->record(AllocationEvent::Kind::allocate, ret_ptr,
+            size, alignment, slot);
+    }
+    return ret_ptr;
 }
 
 void AggregateAllocator::deallocate(void* p, size_t size) noexcept {
     if (p == nullptr)
         return;
-    if (size <= byte_8) {
-        return m_8byte_alloc.deallocate(p, size);
-    } else if (size <= byte_16) {
-        return m_16byte_alloc.deallocate(p, size);
-    } else if (size <= byte_32) {
-        return m_32byte_alloc.deallocate(p, size);
-    } else if (size <= byte_64) {
-        return m_64byte_alloc.deallocate(p, size);
-    } else if (size <= byte_128) {
-        return m_128byte_alloc.deallocate(p, size);
-    } else if (size <= kbyte_5) {
-        return m_upto_5kbyte_alloc.deallocate(p, size);
-    } else if (size <= kbyte_50) {
-        return m_upto_50kbyte_alloc.deallocate(p, size);
+    size_t const slot = get_stats_slot(size);
+    m_stats[slot].record_deallocation(size);
+    if (m_trace_recorder) {
+        m_trace_recorder->record(
+            AllocationEvent::Kind::deallocate, p, size, 0, slot);
+    }
+    if (slot < SMALL_CLASS_COUNT) {
+        m_small_allocs[slot].deallocate(p, size);
+    } else if (slot < size_class::count) {
+        m_medium_allocs[slot - SMALL_CLASS_COUNT].deallocate(p, size);
+    } else if (slot == MEDIUM_STATS_SLOT) {
+        // the range of the large allocations tells its blocks apart cheaply
+        if (m_upto_50kbyte_alloc.contained(p))
+            m_upto_50kbyte_alloc.deallocate(p, size);
+        else
+            m_upto_5kbyte_alloc.deallocate(p, size);
+    } else if (slot == LARGE_STATS_SLOT) {
+        m_upto_50kbyte_alloc.deallocate(p, size);
+    } else {
+        m_gaigantic_alloc.deallocate(p, size);
+    }
+}
+
+bool AggregateAllocator::try_expand(
+    void* p, size_t old_size, size_t new_size) noexcept {
+    size_t const slot = get_stats_slot(old_size);
+    if (slot != get_stats_slot(new_size))
+        return false;
+    bool expanded = false;
+    if (slot < size_class::count) {
+        // the block is as large as its size class anyway
+        expanded = true;
+    } else if (slot == MEDIUM_STATS_SLOT) {
+        expanded = m_upto_50kbyte_alloc.contained(p) ?
+                       m_upto_50kbyte_alloc.try_expand(p, old_size, new_size) :
+                       m_upto_5kbyte_alloc.try_expand(p, old_size, new_size);
+    } else if (slot == LARGE_STATS_SLOT) {
+        expanded = m_upto_50kbyte_alloc.try_expand(p, old_size, new_size);
+    } else {
+        expanded = m_gaigantic_alloc.try_expand(p, old_size, new_size);
+    }
+    if (!expanded)
+        return false;
+    m_stats[slot].record_deallocation(old_size);
+    m_stats[slot].record_allocation(new_size);
+    // replayed as a reallocation, the original alignment isn't known here
+    if (m_trace_recorder) {
+        m_trace_recorder->record(
+            AllocationEvent::Kind::deallocate, p, old_size, 0, slot);
+        m_trace_recorder->record(AllocationEvent::Kind::allocate, p, new_size,
+            DEFAULT_ALIGNMENT, slot);
+    }
+    return true;
+}
+
+AllocationStats AggregateAllocator::get_stats(size_t slot) const noexcept {
+    AllocationStats ret = m_stats[slot];
+    if (slot < SMALL_CLASS_COUNT) {
+        ret.reserved_size = m_small_allocs[slot].get_reserved_size();
+    } else if (slot < size_class::count) {
+        ret.reserved_size =
+            m_medium_allocs[slot - SMALL_CLASS_COUNT].get_reserved_size();
+    } else if (slot == MEDIUM_STATS_SLOT) {
+        ret.reserved_size = m_upto_5kbyte_alloc.get_reserved_size();
+    } else if (slot == LARGE_STATS_SLOT) {
+        ret.reserved_size = m_upto_50kbyte_alloc.get_reserved_size();
+    } else {
+        // giant allocations go to the system directly
+        ret.reserved_size = ret.live_size;
+    }
+    return ret;
+}
+
+void AggregateAllocator::dump_stats_json(std::string& out) const noexcept {
+    dump_stats_json(out, [this](size_t slot) { return get_stats(slot); });
+}
+
+template <typename Stats_Func>
+void AggregateAllocator::dump_stats_json(
+    std::string& out, Stats_Func const& get_slot_stats) noexcept {
+    out += "{\"size_classes\":[";
+    for (size_t i = 0; i < size_class::count; ++i) {
+        std::format_to(std::back_inserter(out), "{}{{\"size\":{},\"stats\":",
+            i == 0 ? "" : ",", size_class::get_size(i));
+        get_slot_stats(i).dump_json(out);
+        out += "}";
+    }
+    out += "],\"medium\":";
+    get_slot_stats(MEDIUM_STATS_SLOT).dump_json(out);
+    out += ",\"large\":";
+    get_slot_stats(LARGE_STATS_SLOT).dump_json(out);
+    out += ",\"giant\":";
+    get_slot_stats(GIANT_STATS_SLOT).dump_json(out);
+    out += "}";
+}
+
+void AggregateAllocator::start_trace(
+    std::filesystem::path const& path) noexcept {
+    m_trace_recorder = std::make_unique<AllocationTraceRecorder>(path);
+}
+
+size_t AggregateAllocator::stop_trace() noexcept {
+    if (!m_trace_recorder)
+        return 0;
+    size_t const ret = m_trace_recorder->get_event_count();
+    m_trace_recorder.reset();
+    return ret;
+}
+
+AggregateAllocator::Profile AggregateAllocator::get_profile() const noexcept {
+    // the peak reserved size counts the areas of `reserve()` too, used or not.
+    // capping it with the areas the peak usage takes keeps a reserve from
+    // carrying over to the next profile
+    auto const cap = [](size_t peak_reserved_size, size_t used_size,
+                         size_t area_size) {
+        size_t const area_count = (used_size + area_size - 1) / area_size;
+        return std::min(peak_reserved_size, area_count * area_size);
+    };
+    Profile ret{};
+    for (size_t i = 0; i < size_class::count; ++i) {
+        size_t const growth_factor =
+            i < SMALL_CLASS_COUNT ? small_growth_factor : medium_growth_factor;
+        size_t const area_size =
+            m_pool.get_area_size(m_pool.find_pool(growth_factor));
+        // the blocks are packed from the start of an area, and only the tail
+        // shorter than a block is left out
+        size_t const block_count = area_size / size_class::get_size(i);
+        size_t const used_size =
+            (m_stats[i].peak_live_count + block_count - 1) / block_count *
+            area_size;
+        size_t const peak_reserved_size =
+            i < SMALL_CLASS_COUNT ?
+                m_small_allocs[i].get_peak_reserved_size() :
+                m_medium_allocs[i - SMALL_CLASS_COUNT].get_peak_reserved_size();
+        ret[i] = cap(peak_reserved_size, used_size, area_size);
+    }
+    // the blocks of TLSF come with a header & leave gaps at the end of the
+    // areas, twice the live bytes is a generous bound of what they take
+    ret[MEDIUM_STATS_SLOT] =
+        cap(m_upto_5kbyte_alloc.get_peak_reserved_size(),
+            2 * m_stats[MEDIUM_STATS_SLOT].peak_live_size,
+            m_pool.get_area_size(m_pool.find_pool(medium_growth_factor)));
+    ret[LARGE_STATS_SLOT] =
+        cap(m_upto_50kbyte_alloc.get_peak_reserved_size(),
+            2 * m_stats[LARGE_STATS_SLOT].peak_live_size, large_growth_factor);
+    return ret;
+}
+
+void AggregateAllocator::reserve(Profile const& profile) noexcept {
+    // count the areas each allocator still needs from the memory pool, so
+    // that the pool maps the ones of each pool at once
+    std::vector<size_t> area_counts(m_pool.get_pool_count(), 0);
+    auto const count_areas = [this, &area_counts](size_t growth_factor,
+                                 size_t reserved_size, size_t target_size) {
+        if (target_size <= reserved_size)
+            return;
+        size_t const pool_idx = m_pool.find_pool(growth_factor);
+        size_t const area_size = m_pool.get_area_size(pool_idx);
+        area_counts[pool_idx] +=
+            (target_size - reserved_size + area_size - 1) / area_size;
+    };
+    for (size_t i = 0; i < SMALL_CLASS_COUNT; ++i) {
+        count_areas(small_growth_factor, m_small_allocs[i].get_reserved_size(),
+            profile[i]);
+    }
+    for (size_t i = 0; i < MEDIUM_CLASS_COUNT; ++i) {
+        count_areas(medium_growth_factor,
+            m_medium_allocs[i].get_reserved_size(),
+            profile[SMALL_CLASS_COUNT + i]);
+    }
+    count_areas(medium_growth_factor, m_upto_5kbyte_alloc.get_reserved_size(),
+        profile[MEDIUM_STATS_SLOT]);
+    m_pool.reserve(area_counts);
+
+    for (size_t i = 0; i < SMALL_CLASS_COUNT; ++i) {
+        m_small_allocs[i].reserve(profile[i]);
+    }
+    for (size_t i = 0; i < MEDIUM_CLASS_COUNT; ++i) {
+        m_medium_allocs[i].reserve(profile[SMALL_CLASS_COUNT + i]);
+    }
+    m_upto_5kbyte_alloc.reserve(profile[MEDIUM_STATS_SLOT]);
+    // committed from its own virtual address range
+    m_upto_50kbyte_alloc.reserve(profile[LARGE_STATS_SLOT]);
+}
+
+void AggregateAllocator::end_warm_up() noexcept {
+    m_pool.end_warm_up();
+}
+
+size_t AggregateAllocator::get_committed_size() const noexcept {
+    return m_pool.get_reserved_size() +
+           m_upto_50kbyte_alloc.get_reserved_size() +
+           m_stats[GIANT_STATS_SLOT].live_size;
+}
+
+size_t AggregateAllocator::trim() noexcept {
+    for (auto& alloc : m_small_allocs) {
+        alloc.shrink();
+    }
+    for (auto& alloc : m_medium_allocs) {
+        alloc.shrink();
+    }
+    m_upto_5kbyte_alloc.shrink();
+    return m_pool.trim();
+}
+
+size_t AggregateAllocator::get_stats_slot(size_t size) noexcept {
+    if (size <= size_class::max_size)
+        return size_class::get_index(size);
+    if (size <= medium_alloc_max_size)
+        return MEDIUM_STATS_SLOT;
+    if (size <= large_alloc_max_size)
+        return LARGE_STATS_SLOT;
+    return GIANT_STATS_SLOT;
+}
+
+struct ThreadCachedAllocator::ThreadCache {
+    struct Magazine {
+        std::array<void*, MAGAZINE_CAPACITY> blocks{};
+        size_t count = 0;
+    };
+
+    std::array<Magazine, CACHED_CLASS_COUNT> magazines{};
+    std::array<CallerCounts, CACHED_CLASS_COUNT> counts{};
+    // reset to `nullptr` once the allocator is gone
+    std::atomic<ThreadCachedAllocator*> owner = nullptr;
+};
+
+namespace {
+
+// serialize a thread releasing its caches against the destruction of their
+// allocators, or one could drain through an allocator that's already gone
+WARNING_PUSH
+CLANG_DISABLE_WARNING("-Wexit-time-destructors")
+constinit std::mutex s_registry_mutex{};
+WARNING_POP
+
+// set once the registry of the thread is destroyed. it's trivially
+// destructible, so it can still be read by the destructors of thread locals &
+// statics that free memory afterwards
+constinit thread_local bool s_registry_dead = false;
+
+}  // namespace
+
+// all the thread caches created by the current thread, one per allocator
+struct ThreadCachedAllocator::ThreadCacheRegistry {
+    std::vector<std::shared_ptr<ThreadCache>> caches;
+    ThreadCache* last = nullptr;
+
+    ~ThreadCacheRegistry() noexcept {
+        s_registry_dead = true;
+        std::lock_guard<std::mutex> lock{s_registry_mutex};
+        for (auto const& cache : caches) {
+            if (auto const owner = cache->owner.load(std::memory_order_acquire))
+                owner->release_thread_cache(*cache);
+        }
+    }
+};
+
+ThreadCachedAllocator::ThreadCachedAllocator(MemoryPool& pool) noexcept
+    : m_pool(pool), m_backend(pool) {
+}
+
+ThreadCachedAllocator::~ThreadCachedAllocator() noexcept {
+    // the caches of other threads are drained here, keep their threads from
+    // releasing them at the same time
+    std::lock_guard<std::mutex> registry_lock{s_registry_mutex};
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (auto& cache : m_thread_caches) {
+        for (size_t i = 0; i < CACHED_CLASS_COUNT; ++i) {
+            drain(*cache, i, cache->magazines[i].count);
+        }
+        cache->owner.store(nullptr, std::memory_order_release);
+    }
+    m_thread_caches.clear();
+}
+
+void* ThreadCachedAllocator::allocate(size_t size, size_t alignment) noexcept {
+    COUST_ASSERT(size != 0, "Allocation memory with size 0 is problematic");
+    detail::AllocationReport report{AllocationSource::default_alloc, size};
+    size_t const class_idx = get_class_index(size);
+    void* ret_ptr = nullptr;
+    if (class_idx >= CACHED_CLASS_COUNT ||
+        alignment > get_class_alignment(class_idx)) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ret_ptr = m_backend.allocate(size, alignment);
+        if (class_idx < CACHED_CLASS_COUNT)
+            count_request(m_shared_counts[class_idx], size, true);
+    } else {
+        ret_ptr = allocate_cached(class_idx, size);
+    }
+    trace(AllocationEvent::Kind::allocate, ret_ptr, size, alignment);
+    return ret_ptr;
+}
+
+void ThreadCachedAllocator::deallocate(void* p, size_t size) noexcept {
+    if (p == nullptr)
+        return;
+    trace(AllocationEvent::Kind::deallocate, p, size, 0);
+    size_t const class_idx = get_class_index(size);
+    if (class_idx >= CACHED_CLASS_COUNT) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_backend.deallocate(p, size);
+    }
+    deallocate_cached(p, class_idx);
+}
+
+bool ThreadCachedAllocator::try_expand(
+    void* p, size_t old_size, size_t new_size) noexcept {
+    size_t const class_idx = get_class_index(old_size);
+    size_t const new_class_idx = get_class_index(new_size);
+    bool expanded = false;
+    if (class_idx < CACHED_CLASS_COUNT || new_class_idx < CACHED_CLASS_COUNT) {
+        expanded = class_idx == new_class_idx;
+        if (expanded) {
+            ThreadCache* const cache = get_thread_cache();
+            std::unique_lock<std::mutex> lock{m_mutex, std::defer_lock};
+            if (cache == nullptr)
+                lock.lock();
+            CallerCounts& counts = cache ? cache->counts[class_idx] :
+                                           m_shared_counts[class_idx];
+            count_request(counts, old_size, false);
+            count_request(counts, new_size, true);
+        }
     } else {
-        return m_gaigantic_alloc.deallocate(p, size);
+        std::lock_guard<std::mutex> lock{m_mutex};
+        expanded = m_backend.try_expand(p, old_size, new_size);
+    }
+    // replayed as a reallocation, like the back end does
+    if (expanded) {
+        trace(AllocationEvent::Kind::deallocate, p, old_size, 0);
+        trace(AllocationEvent::Kind::allocate, p, new_size, DEFAULT_ALIGNMENT);
     }
+    return expanded;
 }
 
+void ThreadCachedAllocator::flush_thread_cache() noexcept {
+    ThreadCache* const cache = get_thread_cache();
+    if (cache == nullptr)
+        return;
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (size_t i = 0; i < CACHED_CLASS_COUNT; ++i) {
+        drain(*cache, i, cache->magazines[i].count);
+    }
+}
+
+size_t ThreadCachedAllocator::trim() noexcept {
+    flush_thread_cache();
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_backend.trim();
+}
+
+size_t ThreadCachedAllocator::get_committed_size() noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_backend.get_committed_size();
+}
+
+AggregateAllocator::Profile ThreadCachedAllocator::get_profile() noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_backend.get_profile();
+}
+
+void ThreadCachedAllocator::reserve(
+    AggregateAllocator::Profile const& profile) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_backend.reserve(profile);
+}
+
+void ThreadCachedAllocator::end_warm_up() noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_backend.end_warm_up();
+}
+
+AllocationStats ThreadCachedAllocator::get_stats(size_t slot) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return get_stats_unlocked(slot);
+}
+
+AllocationStats ThreadCachedAllocator::get_stats_unlocked(
+    size_t slot) noexcept {
+    AllocationStats ret = m_backend.get_stats(slot);
+    if (slot >= CACHED_CLASS_COUNT)
+        return ret;
+    CallerCounts counts = m_shared_counts[slot];
+    for (auto const& cache : m_thread_caches) {
+        add_counts(counts, cache->counts[slot]);
+    }
+    ret.allocation_count = counts.allocation_count;
+    ret.deallocation_count = counts.deallocation_count;
+    ret.size_histogram = counts.size_histogram;
+    return ret;
+}
+
+std::string ThreadCachedAllocator::dump_stats_json() noexcept {
+    std::string ret{"{\"allocator\":"};
+    std::lock_guard<std::mutex> lock{m_mutex};
+    AggregateAllocator::dump_stats_json(
+        ret, [this](size_t slot) { return get_stats_unlocked(slot); });
+    ret += ",\"memory_pool\":";
+    m_pool.dump_stats_json(ret);
+    ret += "}";
+    return ret;
+}
+
+void ThreadCachedAllocator::start_trace(
+    std::filesystem::path const& path) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_trace_recorder = std::make_unique<AllocationTraceRecorder>(path);
+    m_tracing.store(true, std::memory_order_relaxed);
+}
+
+size_t ThreadCachedAllocator::stop_trace() noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_tracing.store(false, std::memory_order_relaxed);
+    if (!m_trace_recorder)
+        return 0;
+    size_t const ret = m_trace_recorder->get_event_count();
+    m_trace_recorder.reset();
+    return ret;
+}
+
+void ThreadCachedAllocator::record_trace(AllocationEvent::Kind kind, void* p,
+    size_t size, size_t alignment) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_trace_recorder) {
+        m_trace_recorder->record(kind, p, size, alignment,
+            AggregateAllocator::get_stats_slot(size));
+    }
+}
+
+ThreadCachedAllocator::ThreadCache*
+    ThreadCachedAllocator::get_thread_cache() noexcept {
+    if (s_registry_dead)
+        return nullptr;
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wexit-time-destructors")
+    thread_local ThreadCacheRegistry registry{};
+    WARNING_POP
+    if (registry.last &&
+        registry.last->owner.load(std::memory_order_relaxed) == this)
+        return registry.last;
+    for (auto const& cache : registry.caches) {
+        if (cache->owner.load(std::memory_order_relaxed) == this) {
+            registry.last = cache.get();
+            return cache.get();
+        }
+    }
+    // forget the caches whose allocators have been destroyed
+    std::erase_if(registry.caches, [](auto const& cache) {
+        return cache->owner.load(std::memory_order_acquire) == nullptr;
+    });
+    auto cache = std::make_shared<ThreadCache>();
+    cache->owner.store(this, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_thread_caches.push_back(cache);
+    }
+    registry.last = cache.get();
+    registry.caches.push_back(std::move(cache));
+    return registry.last;
+}
+
+void* ThreadCachedAllocator::allocate_cached(
+    size_t class_idx, size_t size) noexcept {
+    ThreadCache* const cache = get_thread_cache();
+    if (cache == nullptr) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        count_request(m_shared_counts[class_idx], size, true);
+        return m_backend.allocate(
+            get_class_size(class_idx), get_class_alignment(class_idx));
+    }
+    count_request(cache->counts[class_idx], size, true);
+    auto& magazine = cache->magazines[class_idx];
+    if (magazine.count == 0)
+        refill(*cache, class_idx);
+    return magazine.blocks[--magazine.count];
+}
+
+void ThreadCachedAllocator::deallocate_cached(
+    void* p, size_t class_idx) noexcept {
+    ThreadCache* const cache = get_thread_cache();
+    if (cache == nullptr) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        count_request(
+            m_shared_counts[class_idx], get_class_size(class_idx), false);
+        return m_backend.deallocate(p, get_class_size(class_idx));
+    }
+    count_request(cache->counts[class_idx], get_class_size(class_idx), false);
+    auto& magazine = cache->magazines[class_idx];
+    if (magazine.count == MAGAZINE_CAPACITY) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        drain(*cache, class_idx, BATCH_SIZE);
+    }
+    magazine.blocks[magazine.count++] = p;
+}
+
+void ThreadCachedAllocator::refill(
+    ThreadCache& cache, size_t class_idx) noexcept {
+    auto& magazine = cache.magazines[class_idx];
+    size_t const class_size = get_class_size(class_idx);
+    size_t const class_alignment = get_class_alignment(class_idx);
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        magazine.blocks[magazine.count++] =
+            m_backend.allocate(class_size, class_alignment);
+    }
+}
+
+void ThreadCachedAllocator::drain(
+    ThreadCache& cache, size_t class_idx, size_t count) noexcept {
+    auto& magazine = cache.magazines[class_idx];
+    size_t const class_size = get_class_size(class_idx);
+    for (size_t i = 0; i < count; ++i) {
+        m_backend.deallocate(magazine.blocks[--magazine.count], class_size);
+    }
+}
+
+void ThreadCachedAllocator::release_thread_cache(ThreadCache& cache) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (size_t i = 0; i < CACHED_CLASS_COUNT; ++i) {
+        drain(cache, i, cache.magazines[i].count);
+        add_counts(m_shared_counts[i], cache.counts[i]);
+    }
+    cache.owner.store(nullptr, std::memory_order_release);
+    std::erase_if(m_thread_caches,
+        [&cache](auto const& c) { return c.get() == &cache; });
+}
+
+void ThreadCachedAllocator::count_request(
+    CallerCounts& counts, size_t size, bool is_allocation) noexcept {
+    auto const increase = [](size_t& count) {
+        std::atomic_ref<size_t> const ref{count};
+        ref.store(ref.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+    };
+    if (is_allocation) {
+        increase(counts.allocation_count);
+        increase(
+            counts.size_histogram[AllocationStats::get_histogram_bucket(size)]);
+    } else {
+        increase(counts.deallocation_count);
+    }
+}
+
+void ThreadCachedAllocator::add_counts(
+    CallerCounts& to, CallerCounts& from) noexcept {
+    auto const load = [](size_t& count) {
+        return std::atomic_ref<size_t>{count}.load(std::memory_order_relaxed);
+    };
+    to.allocation_count += load(from.allocation_count);
+    to.deallocation_count += load(from.deallocation_count);
+    for (size_t i = 0; i < to.size_histogram.size(); ++i) {
+        to.size_histogram[i] += load(from.size_histogram[i]);
+    }
+}
+
+size_t ThreadCachedAllocator::get_class_index(size_t size) noexcept {
+    if (size > size_class::get_size(CACHED_CLASS_COUNT - 1))
+        return CACHED_CLASS_COUNT;
+    return size_class::get_index(size);
+}
+
+size_t ThreadCachedAllocator::get_class_size(size_t class_idx) noexcept {
+    return size_class::get_size(class_idx);
+}
+
+
 }  // namespace memory
 
+namespace {
+
+// the profile is only reserved by an engine with the same size classes
+struct DefaultAllocProfileFile {
+    uint32_t magic;
+    uint32_t slot_count;
+    size_t small_growth_factor;
+    size_t medium_growth_factor;
+    memory::AggregateAllocator::Profile profile;
+};
+
+uint32_t constexpr DEFAULT_ALLOC_PROFILE_MAGIC = 0x636f7573;
+
+}  // namespace
+
 WARNING_PUSH
 CLANG_DISABLE_WARNING("-Wexit-time-destructors")
 DefaultAlloc& get_default_alloc() noexcept {
     static DefaultAlloc s_default_allocator{memory::get_global_memory_pool()};
     return s_default_allocator;
 }
+
+FrameAlloc& get_frame_alloc() noexcept {
+    static FrameAlloc s_frame_allocator{
+        memory::max_frame_in_flight + 1, memory::frame_arena_size};
+    return s_frame_allocator;
+}
+
+ScratchAlloc& get_scratch_alloc() noexcept {
+    thread_local ScratchAlloc s_scratch_allocator{memory::scratch_block_size};
+    return s_scratch_allocator;
+}
+
+SlabAlloc& get_slab_alloc() noexcept {
+    static SlabAlloc s_slab_allocator{};
+    return s_slab_allocator;
+}
 WARNING_POP
 
+void save_default_alloc_profile(std::filesystem::path const& path) noexcept {
+    DefaultAllocProfileFile const profile_file{
+        .magic = DEFAULT_ALLOC_PROFILE_MAGIC,
+        .slot_count = memory::AggregateAllocator::PROFILE_SLOT_COUNT,
+        .small_growth_factor = memory::small_growth_factor,
+        .medium_growth_factor = memory::medium_growth_factor,
+        .profile = get_default_alloc().get_profile(),
+    };
+    std::error_code ec{};
+    std::filesystem::create_directories(path.parent_path(), ec);
+    file::ByteArray const data{&profile_file, sizeof(profile_file),
+        alignof(DefaultAllocProfileFile)};
+    file::write_file_whole(path, data, data.size());
+}
+
+bool reserve_default_alloc_from_profile(
+    std::filesystem::path const& path) noexcept {
+    std::error_code ec{};
+    if (std::filesystem::file_size(path, ec) != sizeof(DefaultAllocProfileFile))
+        return false;
+    file::ByteArray const data =
+        file::read_file_whole(path, alignof(DefaultAllocProfileFile));
+    DefaultAllocProfileFile profile_file{};
+    std::memcpy(&profile_file, data.data(), sizeof(profile_file));
+    if (profile_file.magic != DEFAULT_ALLOC_PROFILE_MAGIC ||
+        profile_file.slot_count !=
+            memory::AggregateAllocator::PROFILE_SLOT_COUNT ||
+        profile_file.small_growth_factor != memory::small_growth_factor ||
+        profile_file.medium_growth_factor != memory::medium_growth_factor)
+        return false;
+    get_default_alloc().reserve(profile_file.profile);
+    return true;
+}
+
+void end_default_alloc_warm_up() noexcept {
+    get_default_alloc().end_warm_up();
+}
+
 }  // namespace coust
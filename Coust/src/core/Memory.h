@@ -2,9 +2,22 @@
 
 #include "utils/allocators/MemoryPool.h"
 #include "utils/allocators/GrowthPolicy.h"
-#include "utils/allocators/FreeListAllocator.h"
+#include "utils/allocators/TLSFAllocator.h"
 #include "utils/allocators/HeapAllocator.h"
 #include "utils/allocators/PoolAllocator.h"
+#include "utils/allocators/SizeClass.h"
+#include "utils/allocators/AllocationCheck.h"
+#include "utils/allocators/AllocationStats.h"
+#include "utils/allocators/AllocationTrace.h"
+#include "utils/allocators/FrameArena.h"
+#include "utils/allocators/StackAllocator.h"
+#include "utils/allocators/SlabAllocator.h"
+#include "utils/allocators/VirtualArea.h"
+#include "utils/allocators/Composition.h"
+
+#include <mutex>
+#include <memory>
+#include <vector>
 
 namespace coust {
 namespace memory {
@@ -20,22 +33,48 @@ Size constexpr large_growth_factor = kbyte_50;
 
 size_t constexpr global_memory_pool_alignment = DEFAULT_ALIGNMENT;
 
+// the address space reserved by the pool of large allocations, it's committed
+// as the pool grows
+size_t constexpr large_alloc_reserved_size = size_t{1} << 30;
+
+// one slot of the frame arena for each frame the cpu can record ahead of the
+// gpu, plus the one being recorded
+size_t constexpr max_frame_in_flight = 2;
+size_t constexpr frame_arena_size = kbyte_50;
+
+size_t constexpr scratch_block_size = 20 * kbyte_50;
+
 using HomoAlloc_S =
     GrowableAllocator<GrowthType::attached, small_growth_factor, PoolAllocator>;
 
+using HomoAlloc_M = GrowableAllocator<GrowthType::attached,
+    medium_growth_factor, PoolAllocator>;
+
+// TLSF gives O(1) allocation & deallocation with bounded fragmentation, which
+// the best-fit search of `FreeListAllocator` can't
 using GeneralAlloc_M = GrowableAllocator<GrowthType::attached,
-    medium_growth_factor, FreeListAllocator>;
+    medium_growth_factor, TLSFAllocator>;
+
+// large allocations grow in place inside a reserved range, so a block can
+// span several growth steps, and the range can be backed by huge pages
+using GeneralAlloc_L = GrowableAllocator<GrowthType::virtual_memory,
+    large_growth_factor, TLSFAllocator>;
 
-using GeneralAlloc_L = GrowableAllocator<GrowthType::attached,
-    large_growth_factor, FreeListAllocator>;
+// giant allocations (file reads, vertex data, images, ...) below a huge page
+// are left to malloc, which recycles them from its heap, instead of mapping &
+// unmapping pages for each of them. from a huge page up, they get their own
+// pages backed by transparent huge pages
+using GiantAlloc =
+    Segregator<detail::HUGE_PAGE_SIZE - 1, HeapAllocator, PageAllocator>;
 
 MemoryPool& get_global_memory_pool() noexcept;
 
-// techinically, this class should be a abstract template like
-// `Aggreagator<Raw_Alloc1, Size, Raw_Alloc2>`, and we can compose them like
-// `Aggregator<Aggregator<...>, Size, Aggregator<...>>`, but that would
-// introduce too much template instantiation. since we just use it once (or
-// twice in render backend?), the fallback logic is directly written here
+// the general purpose allocator behind `DefaultAlloc`. tuned allocators for
+// a single subsystem (e.g. the bookkeeping of `file::Caches`) are composed
+// from the templates in "utils/allocators/Composition.h" (`Segregator`,
+// `Bucketizer`, ...) instead, while this one keeps its dispatch written by
+// hand, since the stats & the trace of every slot and the giant allocations
+// hook into it
 class AggregateAllocator {
 public:
     AggregateAllocator() = delete;
@@ -54,11 +93,52 @@ public:
 
     void deallocate(void* p, size_t size) noexcept;
 
+    // the block stays in place as long as both sizes are served by the same
+    // pool, and the pool can resize it
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept;
+
+    // the size class is resolved at compile time, and the allocation goes to
+    // the pool of the class directly
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        detail::AllocationReport report{AllocationSource::aggregate, Size};
+        size_t constexpr slot = get_fixed_stats_slot<Size>();
+        if constexpr (slot < size_class::count) {
+            m_stats[slot].record_allocation(Size);
+            void* const ret_ptr =
+                get_class_alloc<slot>().allocate(Size, Alignment);
+            if (m_trace_recorder) {
+                m_trace_recorder->record(AllocationEvent::Kind::allocate,
+                    ret_ptr, Size, Alignment, slot);
+            }
+            return ret_ptr;
+        } else {
+            return allocate(Size, Alignment);
+        }
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        size_t constexpr slot = get_fixed_stats_slot<Size>();
+        if constexpr (slot < size_class::count) {
+            if (p == nullptr)
+                return;
+            m_stats[slot].record_deallocation(Size);
+            if (m_trace_recorder) {
+                m_trace_recorder->record(
+                    AllocationEvent::Kind::deallocate, p, Size, 0, slot);
+            }
+            get_class_alloc<slot>().deallocate(p, Size);
+        } else {
+            deallocate(p, Size);
+        }
+    }
+
     template <typename T, typename... Args>
     T* construct(Args&&... args) noexcept
         requires(std::is_constructible_v<T, Args...>)
     {
-        T* ptr = (T*) allocate(sizeof(T), alignof(T));
+        T* ptr = (T*) allocate_fixed<sizeof(T), alignof(T)>();
         std::construct_at(ptr, std::forward<Args>(args)...);
         return ptr;
     }
@@ -66,26 +146,364 @@ public:
     template <typename T>
     void destruct(T* ptr) noexcept {
         ptr->~T();
-        deallocate(ptr, sizeof(T));
+        deallocate_fixed<sizeof(T)>(ptr);
     }
 
+public:
+    // one slot per size class, followed by the slots of medium, large and giant
+    // allocations
+    static size_t constexpr STATS_SLOT_COUNT = size_class::count + 3u;
+
+    AllocationStats get_stats(size_t slot) const noexcept;
+
+    // the statistics slot an allocation of `size` is accounted in
+    static size_t get_stats_slot(size_t size) noexcept;
+
+    void dump_stats_json(std::string& out) const noexcept;
+
+    // the same layout, with the stats of every slot from `get_slot_stats`
+    template <typename Stats_Func>
+    static void dump_stats_json(
+        std::string& out, Stats_Func const& get_slot_stats) noexcept;
+
+    // record every allocation & deallocation to `path` until `stop_trace()`,
+    // the trace can be fed to other allocators by `replay_allocation_trace()`
+    void start_trace(std::filesystem::path const& path) noexcept;
+
+    // return the number of events recorded
+    size_t stop_trace() noexcept;
+
+public:
+    // the most bytes the allocator of every size class, and of the medium &
+    // large allocations, has grown to, capped by the areas its peak usage
+    // takes, so it's the peak usage of the run even after a `trim()`, and a
+    // reserve the run doesn't use isn't part of it (indexed like the stats
+    // slots)
+    static size_t constexpr PROFILE_SLOT_COUNT = size_class::count + 2u;
+
+    using Profile = std::array<size_t, PROFILE_SLOT_COUNT>;
+
+    Profile get_profile() const noexcept;
+
+    // grow every allocator to its size in `profile` up front. the areas they
+    // need from the memory pool are reserved in a raw area per pool, which is
+    // kept until `end_warm_up()`
+    void reserve(Profile const& profile) noexcept;
+
+    // let `trim()` release each raw area of `reserve()` once none of its areas
+    // is in use, see `MemoryPool::end_warm_up()`
+    void end_warm_up() noexcept;
+
+    // the bytes taken from the system: the memory pool (shared with other
+    // allocators), the committed part of the large allocations' range, and
+    // the giant allocations
+    size_t get_committed_size() const noexcept;
+
+    // give the areas without any live block back to the memory pool, then
+    // release the raw areas of the pool which are no longer used, see
+    // `MemoryPool::trim()`. return the bytes released by the pool
+    size_t trim() noexcept;
+
+private:
+    static size_t constexpr MEDIUM_STATS_SLOT = size_class::count;
+    static size_t constexpr LARGE_STATS_SLOT = size_class::count + 1u;
+    static size_t constexpr GIANT_STATS_SLOT = size_class::count + 2u;
+
 private:
-    HomoAlloc_S m_8byte_alloc;
-    HomoAlloc_S m_16byte_alloc;
-    HomoAlloc_S m_32byte_alloc;
-    HomoAlloc_S m_64byte_alloc;
-    HomoAlloc_S m_128byte_alloc;
+    // every size class has its own pool. the classes above 128 B grow with
+    // larger areas, so that an area always holds a few blocks
+    static size_t constexpr SMALL_CLASS_COUNT =
+        size_class::get_index(byte_128) + 1;
+    static size_t constexpr MEDIUM_CLASS_COUNT =
+        size_class::count - SMALL_CLASS_COUNT;
+
+    template <size_t... Small_Idx, size_t... Medium_Idx>
+    AggregateAllocator(MemoryPool& pool, std::index_sequence<Small_Idx...>,
+        std::index_sequence<Medium_Idx...>) noexcept;
+
+    // `size_class::count` for sizes beyond the size classes, they are
+    // dispatched at runtime anyway
+    template <size_t Size>
+    static consteval size_t get_fixed_stats_slot() noexcept {
+        static_assert(
+            Size != 0, "Allocation memory with size 0 is problematic");
+        if constexpr (Size <= size_class::max_size)
+            return size_class::get_index(Size);
+        else
+            return size_class::count;
+    }
+
+    template <size_t Slot>
+    auto& get_class_alloc() noexcept {
+        if constexpr (Slot < SMALL_CLASS_COUNT)
+            return m_small_allocs[Slot];
+        else
+            return m_medium_allocs[Slot - SMALL_CLASS_COUNT];
+    }
+
+private:
+    MemoryPool& m_pool;
+    std::array<HomoAlloc_S, SMALL_CLASS_COUNT> m_small_allocs;
+    std::array<HomoAlloc_M, MEDIUM_CLASS_COUNT> m_medium_allocs;
     GeneralAlloc_M m_upto_5kbyte_alloc;
     GeneralAlloc_L m_upto_50kbyte_alloc;
-    HeapAllocator m_gaigantic_alloc;
+    GiantAlloc m_gaigantic_alloc;
+    std::array<AllocationStats, STATS_SLOT_COUNT> m_stats{};
+    std::unique_ptr<AllocationTraceRecorder> m_trace_recorder{};
 };
 
-static_assert(detail::Allocator<AggregateAllocator>);
+static_assert(detail::FixedSizeAllocator<AggregateAllocator>);
+static_assert(detail::ExpandableAllocator<AggregateAllocator>);
+
+// Thread-safe front end of `AggregateAllocator`. Every thread owns a magazine
+// of free blocks per small size class, so the hot path never takes a lock. The
+// shared back end is only touched (under a mutex) to refill or to drain a
+// magazine in batches, and for sizes that aren't cached at all.
+// A block freed on a thread other than the one allocating it simply lands in
+// the magazine of the freeing thread: blocks of the same size class are
+// interchangeable, and they find their way back to the back end once that
+// magazine overflows or the thread exits.
+// The allocator must outlive every thread that allocates from it.
+class ThreadCachedAllocator {
+public:
+    ThreadCachedAllocator() = delete;
+    ThreadCachedAllocator(ThreadCachedAllocator&&) = delete;
+    ThreadCachedAllocator(ThreadCachedAllocator const&) = delete;
+    ThreadCachedAllocator& operator=(ThreadCachedAllocator&&) = delete;
+    ThreadCachedAllocator& operator=(ThreadCachedAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+public:
+    ThreadCachedAllocator(MemoryPool& pool) noexcept;
+
+    ~ThreadCachedAllocator() noexcept;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    void deallocate(void* p, size_t size) noexcept;
+
+    // a cached block can only be resized within its size class, the others
+    // are resized by the back end
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept;
+
+    // the size class is resolved at compile time, so cached sizes go to the
+    // magazine of the calling thread without any dispatch
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        detail::AllocationReport report{AllocationSource::default_alloc, Size};
+        size_t constexpr class_idx = get_fixed_class_index<Size>();
+        if constexpr (class_idx < CACHED_CLASS_COUNT &&
+                      Alignment <= get_class_alignment(class_idx)) {
+            void* const ret_ptr = allocate_cached(class_idx, Size);
+            trace(AllocationEvent::Kind::allocate, ret_ptr, Size, Alignment);
+            return ret_ptr;
+        } else {
+            return allocate(Size, Alignment);
+        }
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        size_t constexpr class_idx = get_fixed_class_index<Size>();
+        if constexpr (class_idx < CACHED_CLASS_COUNT) {
+            if (p == nullptr)
+                return;
+            trace(AllocationEvent::Kind::deallocate, p, Size, 0);
+            deallocate_cached(p, class_idx);
+        } else {
+            deallocate(p, Size);
+        }
+    }
+
+    template <typename T, typename... Args>
+    T* construct(Args&&... args) noexcept
+        requires(std::is_constructible_v<T, Args...>)
+    {
+        T* ptr = (T*) allocate_fixed<sizeof(T), alignof(T)>();
+        std::construct_at(ptr, std::forward<Args>(args)...);
+        return ptr;
+    }
+
+    template <typename T>
+    void destruct(T* ptr) noexcept {
+        ptr->~T();
+        deallocate_fixed<sizeof(T)>(ptr);
+    }
+
+    // return all the blocks cached by the calling thread to the back end
+    void flush_thread_cache() noexcept;
+
+    // flush the cache of the calling thread, then trim the back end, see
+    // `AggregateAllocator::trim()`. the blocks cached by other threads still
+    // keep their areas in use
+    size_t trim() noexcept;
+
+    // see `AggregateAllocator::get_committed_size()`
+    size_t get_committed_size() noexcept;
+
+    // statistics of the back end. for the cached size classes, the counts &
+    // the histogram are the requests of the callers, while the live & peak
+    // sizes are the blocks the back end handed out, where the blocks cached
+    // by threads count as live ones
+    AllocationStats get_stats(size_t slot) noexcept;
+
+    // the statistics of the back end and its memory pool
+    std::string dump_stats_json() noexcept;
+
+    // see `AggregateAllocator::get_profile()` & `AggregateAllocator::reserve()`
+    AggregateAllocator::Profile get_profile() noexcept;
+
+    void reserve(AggregateAllocator::Profile const& profile) noexcept;
+
+    void end_warm_up() noexcept;
+
+    // see `AggregateAllocator::start_trace()`. the events are recorded as the
+    // callers make them, not as the batches the thread caches are refilled &
+    // drained with, so a replay sees the real pattern of small allocations.
+    // while tracing, every allocation takes the lock to record its event
+    void start_trace(std::filesystem::path const& path) noexcept;
+
+    size_t stop_trace() noexcept;
+
+private:
+    struct ThreadCache;
+    struct ThreadCacheRegistry;
+
+    // the size classes served by `HomoAlloc_S` in the back end: 8 B ~ 128 B
+    static size_t constexpr CACHED_CLASS_COUNT =
+        size_class::get_index(byte_128) + 1;
+    static size_t constexpr MAGAZINE_CAPACITY = 64u;
+    static size_t constexpr BATCH_SIZE = 32u;
+
+    static_assert(BATCH_SIZE <= MAGAZINE_CAPACITY);
+
+    // the requests of the callers for a cached size class, the back end only
+    // sees the batches the magazines are refilled & drained with
+    struct CallerCounts {
+        size_t allocation_count = 0;
+        size_t deallocation_count = 0;
+        std::array<size_t, AllocationStats::HISTOGRAM_BUCKET_COUNT>
+            size_histogram{};
+    };
+
+private:
+    // return `nullptr` once the thread's caches are torn down, i.e. in the
+    // destructors of thread locals & statics that run after that. the caller
+    // goes to the back end under `m_mutex` then
+    ThreadCache* get_thread_cache() noexcept;
+
+    // `size` is the one requested, for the stats
+    void* allocate_cached(size_t class_idx, size_t size) noexcept;
+
+    void deallocate_cached(void* p, size_t class_idx) noexcept;
+
+    void refill(ThreadCache& cache, size_t class_idx) noexcept;
+
+    // the caller must hold `m_mutex`
+    void drain(ThreadCache& cache, size_t class_idx, size_t count) noexcept;
+
+    // called when the owning thread exits
+    void release_thread_cache(ThreadCache& cache) noexcept;
+
+    // the counts of a thread cache are only written by its own thread, but
+    // read by others, so they're accessed atomically. the writes needn't be
+    // atomic read-modify-writes though
+    static void count_request(
+        CallerCounts& counts, size_t size, bool is_allocation) noexcept;
+
+    static void add_counts(CallerCounts& to, CallerCounts& from) noexcept;
+
+    // the caller must hold `m_mutex`
+    AllocationStats get_stats_unlocked(size_t slot) noexcept;
+
+    void trace(AllocationEvent::Kind kind, void* p, size_t size,
+        size_t alignment) noexcept {
+        if (m_tracing.load(std::memory_order_relaxed)) [[unlikely]]
+            record_trace(kind, p, size, alignment);
+    }
+
+    void record_trace(AllocationEvent::Kind kind, void* p, size_t size,
+        size_t alignment) noexcept;
+
+    // return `CACHED_CLASS_COUNT` if the size isn't cached
+    static size_t get_class_index(size_t size) noexcept;
+
+    template <size_t Size>
+    static consteval size_t get_fixed_class_index() noexcept {
+        static_assert(
+            Size != 0, "Allocation memory with size 0 is problematic");
+        if constexpr (Size <= size_class::get_size(CACHED_CLASS_COUNT - 1))
+            return size_class::get_index(Size);
+        else
+            return CACHED_CLASS_COUNT;
+    }
+
+    static size_t get_class_size(size_t class_idx) noexcept;
+
+    static constexpr size_t get_class_alignment(size_t class_idx) noexcept {
+        return size_class::get_alignment(class_idx);
+    }
+
+private:
+    std::mutex m_mutex;
+    MemoryPool& m_pool;
+    AggregateAllocator m_backend;
+    std::vector<std::shared_ptr<ThreadCache>> m_thread_caches;
+    // guarded by `m_mutex`, the requests served without a thread cache, and
+    // the ones of the thread caches released so far
+    std::array<CallerCounts, CACHED_CLASS_COUNT> m_shared_counts{};
+    // guarded by `m_mutex`, the flag lets the hot path skip the lock
+    std::unique_ptr<AllocationTraceRecorder> m_trace_recorder{};
+    std::atomic<bool> m_tracing = false;
+};
+
+static_assert(detail::FixedSizeAllocator<ThreadCachedAllocator>);
+static_assert(detail::ExpandableAllocator<ThreadCachedAllocator>);
 
 }  // namespace memory
 
-using DefaultAlloc = memory::AggregateAllocator;
+using DefaultAlloc = memory::ThreadCachedAllocator;
 
 DefaultAlloc& get_default_alloc() noexcept;
 
+// The profile of the default allocator is saved when the application exits,
+// and the next launch reserves the memory it describes before anything else,
+// so the warm-up (the first frames, loading a scene, ...) doesn't stall on
+// growing the pools block by block. The profile is the peak usage of the last
+// run, which the memory reserved from the previous profile doesn't add to. The
+// memory it reserves beyond the steady state is given back by trimming after
+// `end_default_alloc_warm_up()`.
+void save_default_alloc_profile(std::filesystem::path const& path) noexcept;
+
+// return false if there's no profile at `path`, or it's made by an engine with
+// other size classes
+bool reserve_default_alloc_from_profile(
+    std::filesystem::path const& path) noexcept;
+
+// the warm-up the profile was reserved for is over (e.g. the scene is loaded),
+// the reserved memory left unused can be trimmed from now on
+void end_default_alloc_warm_up() noexcept;
+
+using FrameAlloc = memory::FrameArena;
+
+// memory for containers which live no longer than the frame they are created
+// in. Only the render thread should use it, and the slots are recycled by the
+// render driver
+FrameAlloc& get_frame_alloc() noexcept;
+
+using ScratchAlloc = memory::StackAllocator;
+
+// memory for temporary work of the calling thread, it should be used through
+// `memory::ScratchScope`, so that it's released as soon as the work is done
+ScratchAlloc& get_scratch_alloc() noexcept;
+
+using SlabAlloc = memory::SlabAllocator;
+
+// memory for the medium objects which are created & destroyed all the time,
+// e.g. the wrappers of vulkan objects handed out as `shared_ptr`s, and the
+// entries of the render caches. Only the render thread should use it
+SlabAlloc& get_slab_alloc() noexcept;
+
 }  // namespace coust
@@ -0,0 +1,128 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "core/Memory.h"
+#include "core/MemoryBudget.h"
+
+namespace coust {
+namespace memory {
+
+MemoryBudget::MemoryBudget(
+    Config const& config, UsageFunc query_usage, ReclaimFunc reclaim) noexcept
+    : m_query_usage(query_usage ? std::move(query_usage) : UsageFunc{[] {
+          return get_default_alloc().get_committed_size();
+      }}),
+      m_reclaim(reclaim ? std::move(reclaim) : ReclaimFunc{[] {
+          return get_default_alloc().trim();
+      }}),
+      m_config(config) {
+    COUST_ASSERT(config.soft_limit <= config.hard_limit,
+        "The soft watermark {} of memory budget exceeds the hard one {}",
+        config.soft_limit, config.hard_limit);
+}
+
+MemoryBudget::Handle MemoryBudget::register_subsystem(
+    std::string_view name, EvictFunc&& evict) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    Handle const handle = m_next_handle++;
+    m_subsystems.push_back(Subsystem{
+        .name = name,
+        .evict = std::move(evict),
+        .handle = handle,
+    });
+    return handle;
+}
+
+void MemoryBudget::unregister_subsystem(Handle handle) noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto const iter =
+        std::ranges::find(m_subsystems, handle, &Subsystem::handle);
+    COUST_ASSERT(iter != m_subsystems.end(),
+        "Subsystem {} isn't registered to the memory budget", handle);
+    m_subsystems.erase(iter);
+}
+
+MemoryPressure MemoryBudget::update() noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_usage = m_query_usage();
+    m_pressure = get_pressure_of(m_usage);
+    // the subsystems emptied by the last round have little left to release,
+    // draining them every frame of a sustained pressure only thrashes them
+    if (m_cooldown_count > 0) {
+        --m_cooldown_count;
+        if (m_pressure <= m_evicted_pressure)
+            return m_pressure;
+    }
+    if (m_pressure == MemoryPressure::none)
+        return m_pressure;
+
+    // release a bit more than the excess, see `Config::hysteresis`
+    size_t const margin = std::min(m_config.hysteresis, m_config.soft_limit);
+    size_t const target = m_config.soft_limit - margin;
+    size_t usage = m_usage;
+    for (auto iter = m_subsystems.rbegin(); iter != m_subsystems.rend();
+         ++iter) {
+        // at hard pressure every subsystem is notified
+        if (m_pressure == MemoryPressure::soft && usage <= target)
+            break;
+        size_t const remaining = usage - std::min(usage, target);
+        m_released_size += iter->evict(m_pressure, remaining);
+        // what a subsystem reports isn't necessarily given back yet, or
+        // might not be part of the usage at all
+        m_reclaimed_size += m_reclaim();
+        usage = m_query_usage();
+    }
+    m_evicted_pressure = m_pressure;
+    m_cooldown_count = m_config.cooldown_update_count;
+    return m_pressure;
+}
+
+void MemoryBudget::set_config(Config const& config) noexcept {
+    COUST_ASSERT(config.soft_limit <= config.hard_limit,
+        "The soft watermark {} of memory budget exceeds the hard one {}",
+        config.soft_limit, config.hard_limit);
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_config = config;
+    m_cooldown_count = 0;
+}
+
+size_t MemoryBudget::get_usage() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_usage;
+}
+
+MemoryPressure MemoryBudget::get_pressure() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_pressure;
+}
+
+size_t MemoryBudget::get_released_size() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_released_size;
+}
+
+size_t MemoryBudget::get_reclaimed_size() const noexcept {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_reclaimed_size;
+}
+
+MemoryPressure MemoryBudget::get_pressure_of(size_t usage) const noexcept {
+    if (usage > m_config.hard_limit)
+        return MemoryPressure::hard;
+    if (usage > m_config.soft_limit)
+        return MemoryPressure::soft;
+    return MemoryPressure::none;
+}
+
+}  // namespace memory
+
+WARNING_PUSH
+CLANG_DISABLE_WARNING("-Wexit-time-destructors")
+memory::MemoryBudget& get_memory_budget() noexcept {
+    static memory::MemoryBudget s_budget{memory::MemoryBudget::Config{}};
+    return s_budget;
+}
+WARNING_POP
+
+}  // namespace coust
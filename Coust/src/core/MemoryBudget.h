@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace coust {
+namespace memory {
+
+enum class MemoryPressure {
+    // the usage is below the soft watermark
+    none,
+    // the usage crossed the soft watermark, subsystems drop their least
+    // recently used entries until the usage is back under it
+    soft,
+    // the usage crossed the hard watermark, subsystems drop everything they
+    // can rebuild
+    hard,
+};
+
+// Keeps the memory usage of the process inside a fixed envelope. Caches
+// register an eviction callback, and once per frame `update()` samples the
+// usage and, above the soft watermark, asks them to release memory.
+// Subsystems are asked from the last registered one on, so that the caches
+// built on top of others release their entries first. What they release is
+// handed back to the system by the reclaim callback after each of them, and
+// the usage is sampled again, so only the memory which actually left the
+// process counts (not the blocks sitting free in an allocator, nor the memory
+// of another kind, e.g. on the gpu). After a round of eviction they're left
+// alone for a while.
+class MemoryBudget {
+public:
+    MemoryBudget() = delete;
+    MemoryBudget(MemoryBudget&&) = delete;
+    MemoryBudget(MemoryBudget const&) = delete;
+    MemoryBudget& operator=(MemoryBudget&&) = delete;
+    MemoryBudget& operator=(MemoryBudget const&) = delete;
+
+public:
+    // get the pressure & the bytes still to release to get back under the soft
+    // watermark (which might be 0 at hard pressure), return the bytes released
+    using EvictFunc = std::function<size_t(MemoryPressure, size_t)>;
+
+    using UsageFunc = std::function<size_t()>;
+
+    // give the memory freed by the subsystems back to the system, return the
+    // bytes released
+    using ReclaimFunc = std::function<size_t()>;
+
+    using Handle = uint32_t;
+
+    // the default is the envelope of long-running sessions
+    struct Config {
+        size_t soft_limit = size_t{768} << 20;
+        size_t hard_limit = size_t{1} << 30;
+        // the subsystems release memory until the usage is this far under the
+        // soft watermark, so that it doesn't cross it again right away
+        size_t hysteresis = size_t{64} << 20;
+        // the updates after a round of eviction during which the subsystems
+        // are asked again only if the pressure gets worse
+        uint32_t cooldown_update_count = 60;
+    };
+
+public:
+    // the usage is the memory committed by the default allocator by default,
+    // and it's reclaimed by trimming the default allocator
+    MemoryBudget(Config const& config, UsageFunc query_usage = {},
+        ReclaimFunc reclaim = {}) noexcept;
+
+    // the callback is invoked under the lock of the budget, so it must not
+    // register or unregister any subsystem
+    Handle register_subsystem(
+        std::string_view name, EvictFunc&& evict) noexcept;
+
+    void unregister_subsystem(Handle handle) noexcept;
+
+    // sample the usage and notify subsystems if it crossed a watermark
+    MemoryPressure update() noexcept;
+
+    void set_config(Config const& config) noexcept;
+
+    // the usage sampled by the last `update()`
+    size_t get_usage() const noexcept;
+
+    MemoryPressure get_pressure() const noexcept;
+
+    // the bytes the subsystems reported to release so far
+    size_t get_released_size() const noexcept;
+
+    // the bytes reclaimed so far
+    size_t get_reclaimed_size() const noexcept;
+
+private:
+    struct Subsystem {
+        std::string_view name;
+        EvictFunc evict;
+        Handle handle;
+    };
+
+private:
+    MemoryPressure get_pressure_of(size_t usage) const noexcept;
+
+private:
+    mutable std::mutex m_mutex;
+    UsageFunc m_query_usage;
+    ReclaimFunc m_reclaim;
+    // `std::vector` instead of memory::vector, the budget watches the default
+    // allocator and shouldn't depend on it
+    std::vector<Subsystem> m_subsystems;
+    Config m_config;
+    size_t m_usage = 0;
+    size_t m_released_size = 0;
+    size_t m_reclaimed_size = 0;
+    MemoryPressure m_pressure = MemoryPressure::none;
+    // the pressure of the last round of eviction
+    MemoryPressure m_evicted_pressure = MemoryPressure::none;
+    uint32_t m_cooldown_count = 0;
+    Handle m_next_handle = 0;
+};
+
+}  // namespace memory
+
+// The usage is the memory committed by the default allocator, which is trimmed
+// after every subsystem asked to release memory. The limits can be changed by
+// `set_config()`.
+memory::MemoryBudget& get_memory_budget() noexcept;
+
+}  // namespace coust
@@ -18,20 +18,20 @@ RenderLayer::RenderLayer(std::string_view name) noexcept : m_name(name) {
 
 void RenderLayer::on_attach() noexcept {
     m_renderer.initialize();
+    m_gltf_path = file::get_absolute_path_from(
+        "Coust", "asset", "test", "Sponza", "glTF", "Sponza.gltf");
+    m_vert_path =
+        file::get_absolute_path_from("Coust", "shader", "test", "minimal.vert");
+    m_frag_path =
+        file::get_absolute_path_from("Coust", "shader", "test", "minimal.frag");
+    m_comp_path = file::get_absolute_path_from(
+        "Coust", "shader", "test", "tran_calc.comp");
 }
 
 void RenderLayer::on_detach() noexcept {
 }
 
 void RenderLayer::on_update(TimeStep ts) noexcept {
-    std::filesystem::path gltf_path = file::get_absolute_path_from(
-        "Coust", "asset", "test", "Sponza", "glTF", "Sponza.gltf");
-    std::filesystem::path vert_path =
-        file::get_absolute_path_from("Coust", "shader", "test", "minimal.vert");
-    std::filesystem::path frag_path =
-        file::get_absolute_path_from("Coust", "shader", "test", "minimal.frag");
-    std::filesystem::path comp_path = file::get_absolute_path_from(
-        "Coust", "shader", "test", "tran_calc.comp");
     WARNING_PUSH
     CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
     const uint8_t* keyboard =
@@ -49,7 +49,8 @@ void RenderLayer::on_update(TimeStep ts) noexcept {
         m_renderer.get().get_camera().move_right(ts);
     }
     WARNING_POP
-    m_renderer.get().prepare(comp_path, gltf_path, vert_path, frag_path);
+    m_renderer.get().prepare(
+        m_comp_path, m_gltf_path, m_vert_path, m_frag_path);
     m_renderer.get().begin_frame();
     m_renderer.get().render();
     m_renderer.get().end_frame();
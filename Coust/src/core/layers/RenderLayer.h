@@ -68,6 +68,12 @@ public:
 private:
     AlignedStorage<render::Renderer> m_renderer;
     std::string_view m_name;
+
+    // resolved once, so that a frame doesn't build them over again
+    std::filesystem::path m_gltf_path{};
+    std::filesystem::path m_vert_path{};
+    std::filesystem::path m_frag_path{};
+    std::filesystem::path m_comp_path{};
 };
 
 static_assert(detail::Layer<RenderLayer>);
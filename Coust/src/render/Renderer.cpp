@@ -60,37 +60,48 @@ Renderer::~Renderer() noexcept {
     m_vk_driver.destroy();
 }
 
-void Renderer::prepare(std::filesystem::path transformation_comp_shader_path,
-    std::filesystem::path gltf_path, std::filesystem::path vert_shader_path,
-    std::filesystem::path frag_shader_path) noexcept {
-    auto idx_iter =
-        m_path_to_idx.find({gltf_path.string().c_str(), get_default_alloc()});
-    if (idx_iter != m_path_to_idx.end()) {
-        m_cur_idx = idx_iter.mapped();
-    } else {
-        size_t gltf_hash_tag = calc_std_hash(gltf_path);
-        auto [byte_array, cache_status] =
-            file::Caches::get_instance().get_cache_data(
-                gltf_path.string(), gltf_hash_tag);
-        if (cache_status == file::Caches::Status::available) {
-            m_gltfes.push_back(
-                file::from_byte_array<MeshAggregate>(byte_array));
+void Renderer::prepare(
+    std::filesystem::path const& transformation_comp_shader_path,
+    std::filesystem::path const& gltf_path,
+    std::filesystem::path const& vert_shader_path,
+    std::filesystem::path const& frag_shader_path) noexcept {
+    // the scene usually stays the same from frame to frame, in which case
+    // nothing is looked up or loaded
+    bool const is_new_scene = gltf_path != m_cur_gltf_path;
+    if (is_new_scene) {
+        auto idx_iter = m_path_to_idx.find(
+            {gltf_path.string().c_str(), get_default_alloc()});
+        if (idx_iter != m_path_to_idx.end()) {
+            m_cur_idx = idx_iter.mapped();
         } else {
-            m_gltfes.push_back(process_gltf(gltf_path));
-            file::Caches::get_instance().add_cache_data(gltf_path.string(),
-                gltf_hash_tag, file::to_byte_array(m_gltfes.back()), true);
+            size_t gltf_hash_tag = calc_std_hash(gltf_path);
+            auto [byte_array, cache_status] =
+                file::Caches::get_instance().get_cache_data(
+                    gltf_path.string(), gltf_hash_tag);
+            if (cache_status == file::Caches::Status::available) {
+                m_gltfes.push_back(
+                    file::from_byte_array<MeshAggregate>(byte_array));
+            } else {
+                m_gltfes.push_back(process_gltf(gltf_path));
+                file::Caches::get_instance().add_cache_data(
+                    gltf_path.string(), gltf_hash_tag,
+                    file::to_byte_array(m_gltfes.back()), true);
+            }
+            m_vertex_index_bufes.push_back(
+                m_vk_driver.get().create_vertex_index_buffer(
+                    m_gltfes.back()));
+            m_transformation_bufes.push_back(
+                m_vk_driver.get().create_transformation_buffer(
+                    m_gltfes.back()));
+            m_material_bufes.push_back(
+                m_vk_driver.get().create_material_buffer(m_gltfes.back()));
+            m_cur_idx = (uint32_t) m_gltfes.size() - 1;
+            m_path_to_idx.emplace(
+                memory::string<DefaultAlloc>{
+                    gltf_path.string().c_str(), get_default_alloc()},
+                m_cur_idx);
         }
-        m_vertex_index_bufes.push_back(
-            m_vk_driver.get().create_vertex_index_buffer(m_gltfes.back()));
-        m_transformation_bufes.push_back(
-            m_vk_driver.get().create_transformation_buffer(m_gltfes.back()));
-        m_material_bufes.push_back(
-            m_vk_driver.get().create_material_buffer(m_gltfes.back()));
-        m_cur_idx = (uint32_t) m_gltfes.size() - 1;
-        m_path_to_idx.emplace(
-            memory::string<DefaultAlloc>{
-                gltf_path.string().c_str(), get_default_alloc()},
-            m_cur_idx);
+        m_cur_gltf_path = gltf_path;
     }
     m_vk_driver.get().bind_shader(VK_PIPELINE_BIND_POINT_GRAPHICS,
         VK_SHADER_STAGE_VERTEX_BIT, vert_shader_path);
@@ -98,6 +109,16 @@ void Renderer::prepare(std::filesystem::path transformation_comp_shader_path,
         VK_SHADER_STAGE_FRAGMENT_BIT, frag_shader_path);
     m_vk_driver.get().bind_shader(VK_PIPELINE_BIND_POINT_COMPUTE,
         VK_SHADER_STAGE_COMPUTE_BIT, transformation_comp_shader_path);
+    if (is_new_scene) {
+        // the memory used only for loading isn't needed any more, and neither
+        // is the memory reserved from the profile for the warm-up
+        end_default_alloc_warm_up();
+        size_t const released_size = get_default_alloc().trim();
+        if (released_size > 0) {
+            COUST_INFO(
+                "Released {} bytes of memory after loading", released_size);
+        }
+    }
 }
 
 void Renderer::begin_frame() noexcept {
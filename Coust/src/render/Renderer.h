@@ -19,9 +19,10 @@ public:
 
     ~Renderer() noexcept;
 
-    void prepare(std::filesystem::path transformation_comp_shader_path,
-        std::filesystem::path gltf_path, std::filesystem::path vert_shader_path,
-        std::filesystem::path frag_shader_path) noexcept;
+    void prepare(std::filesystem::path const& transformation_comp_shader_path,
+        std::filesystem::path const& gltf_path,
+        std::filesystem::path const& vert_shader_path,
+        std::filesystem::path const& frag_shader_path) noexcept;
 
     void begin_frame() noexcept;
 
@@ -51,6 +52,9 @@ private:
         DefaultAlloc>
         m_path_to_idx{get_default_alloc()};
 
+    // the scene `m_cur_idx` refers to
+    std::filesystem::path m_cur_gltf_path{};
+
     FPSCamera m_camera;
 
     uint32_t m_cur_idx;
@@ -60,9 +60,22 @@ constexpr VkSamplerAddressMode convert_gltf_wrap_mode(int gltf_wrap) {
 WARNING_PUSH
 CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
 CLANG_DISABLE_WARNING("-Wcast-align")
-// return the start index of current attribute.
+// the number of floats `copy_vertex_data_from_gltf_buffer()` appends for the
+// accessor
+inline size_t get_vertex_float_count(tinygltf::Model const& model,
+    size_t accessor_idx, bool is_color) noexcept {
+    auto const& gltf_accessor = model.accessors[accessor_idx];
+    size_t const element_component_count =
+        (size_t) tinygltf::GetNumComponentsInType(
+            (uint32_t) gltf_accessor.type);
+    bool const is_rgb_color = is_color && element_component_count == 3;
+    return gltf_accessor.count * (is_rgb_color ? 4 : element_component_count);
+}
+
+// return the start index of current attribute. the caller reserves the space
+// of all the primitives up front, see `get_vertex_float_count()`
 inline size_t copy_vertex_data_from_gltf_buffer(tinygltf::Model const& model,
-    size_t accessor_idx, memory::vector<float, DefaultAlloc>& out_attrib_data,
+    size_t accessor_idx, memory::vector<float, ScratchAlloc>& out_attrib_data,
     // we stipulate that the type color must be vec4. so if the rgb color is
     // provided, we need to suffix the data with 1.0f.
     bool is_color) noexcept {
@@ -95,11 +108,6 @@ inline size_t copy_vertex_data_from_gltf_buffer(tinygltf::Model const& model,
     size_t const element_size = (size_t) tinygltf::GetComponentSizeInBytes(
                                     (uint32_t) gltf_accessor.componentType) *
                                 element_component_count;
-    size_t const float_count_to_reserve =
-        out_attrib_data.size() +
-        (is_rgb_color ? gltf_accessor.count * 4 :
-                        gltf_accessor.count * element_component_count);
-    out_attrib_data.reserve(float_count_to_reserve);
     size_t const inserted_vertex_begin = out_attrib_data.size();
     size_t const stride_size =
         gltf_bufview.byteStride == 0 ? element_size : gltf_bufview.byteStride;
@@ -220,16 +228,43 @@ MeshAggregate process_gltf(std::filesystem::path path) noexcept {
         tinygltf_err, tinygltf_warn);
 
     MeshAggregate mesh_aggregate{};
-    std::array<memory::vector<float, DefaultAlloc>, 8> all_attrib_data{
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
-        memory::vector<float, DefaultAlloc>{get_default_alloc()},
+    // the attribute data is packed into the vertex buffer in the end, so it's
+    // dropped at once when the scope exits
+    memory::ScratchScope scratch{get_scratch_alloc()};
+    std::array<memory::vector<float, ScratchAlloc>, 8> all_attrib_data{
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
+        memory::vector<float, ScratchAlloc>{scratch.get()},
     };
+    // a vector regrowing on the scratch stack would leave its old buffer
+    // stranded there until the scope exits, so each attribute is reserved for
+    // all the primitives at once
+    {
+        std::array<size_t, 8> attrib_float_counts{};
+        for (auto const& gltf_mesh : model.meshes) {
+            for (auto const& gltf_primitive : gltf_mesh.primitives) {
+                for (auto const& [gltf_attrib_name, gltf_accessor_idx] :
+                    gltf_primitive.attributes) {
+                    auto const [is_needed, attrib_idx] =
+                        to_vertex_attrib(gltf_attrib_name);
+                    if (!is_needed)
+                        continue;
+                    attrib_float_counts[attrib_idx] +=
+                        detail::get_vertex_float_count(model,
+                            (size_t) gltf_accessor_idx,
+                            attrib_idx == VertexAttrib::color_0);
+                }
+            }
+        }
+        for (size_t i = 0; i < all_attrib_data.size(); ++i) {
+            all_attrib_data[i].reserve(attrib_float_counts[i]);
+        }
+    }
 
     WARNING_PUSH
     CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
@@ -0,0 +1,164 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/math/Hash.h"
+#include "utils/filesystem/FileIO.h"
+#include "render/vulkan/ShaderSource.h"
+
+namespace coust {
+namespace render {
+
+WARNING_PUSH
+CLANG_DISABLE_WARNING("-Wexit-time-destructors")
+CLANG_DISABLE_WARNING("-Wglobal-constructors")
+// the interned paths & strings are defined first, so they're destroyed last
+memory::deque<std::filesystem::path, DefaultAlloc>
+    ShaderSource::s_interned_paths{get_default_alloc()};
+
+memory::robin_map<std::filesystem::path, std::filesystem::path const*,
+    DefaultAlloc>
+    ShaderSource::s_path_to_interned{get_default_alloc()};
+
+memory::deque_nested<memory::string<DefaultAlloc>, DefaultAlloc>
+    ShaderSource::s_interned_strings{get_default_alloc()};
+
+memory::robin_set<std::string_view, DefaultAlloc>
+    ShaderSource::s_string_to_interned{get_default_alloc()};
+
+memory::robin_map<std::filesystem::path const*, ShaderSource::Content,
+    DefaultAlloc>
+    ShaderSource::s_source_contents{get_default_alloc()};
+WARNING_POP
+
+uint64_t ShaderSource::s_access_count = 0;
+
+namespace {
+
+memory::string<DefaultAlloc> read_code(
+    std::filesystem::path const& path) noexcept {
+    file::ByteArray byte_array = file::read_file_whole(path);
+    return memory::string<DefaultAlloc>{
+        byte_array.to_string_view(), get_default_alloc()};
+}
+
+}  // namespace
+
+size_t ShaderSource::evict_source_contents(
+    memory::MemoryPressure pressure, size_t size) noexcept {
+    memory::vector<std::pair<uint64_t, std::filesystem::path const*>,
+        FrameAlloc>
+        lru{get_frame_alloc()};
+    lru.reserve(s_source_contents.size());
+    for (auto const& [path, content] : s_source_contents) {
+        if (content.is_loaded)
+            lru.emplace_back(content.last_accessed, path);
+    }
+    std::ranges::sort(lru, {}, &decltype(lru)::value_type::first);
+    size_t released = 0;
+    for (auto const& [last_accessed, path] : lru) {
+        if (pressure != memory::MemoryPressure::hard && released >= size)
+            break;
+        Content& content = s_source_contents.at(path);
+        released += content.code.capacity();
+        content.code = memory::string<DefaultAlloc>{get_default_alloc()};
+        content.is_loaded = false;
+    }
+    return released;
+}
+
+std::filesystem::path const* ShaderSource::intern_path(
+    std::filesystem::path const& path) noexcept {
+    auto iter = s_path_to_interned.find(path);
+    if (iter == s_path_to_interned.end()) {
+        std::filesystem::path const* interned =
+            &s_interned_paths.emplace_back(path);
+        iter = s_path_to_interned.emplace(path, interned).first;
+    }
+    return iter.mapped();
+}
+
+std::string_view ShaderSource::intern_string(std::string_view str) noexcept {
+    auto iter = s_string_to_interned.find(str);
+    if (iter == s_string_to_interned.end()) {
+        // the deque never moves its elements, views into them stay valid
+        std::string_view const interned = s_interned_strings.emplace_back(str);
+        iter = s_string_to_interned.insert(interned).first;
+    }
+    return *iter;
+}
+
+ShaderSource::ShaderSource(std::filesystem::path const& path) noexcept
+    : m_path(intern_path(path)) {
+}
+
+memory::string<DefaultAlloc> const& ShaderSource::get_code() const noexcept {
+    return get_content(true).code;
+}
+
+size_t ShaderSource::get_code_hash() const noexcept {
+    return get_content(false).hash;
+}
+
+ShaderSource::Content& ShaderSource::get_content(
+    bool needs_code) const noexcept {
+    auto iter = s_source_contents.find(m_path);
+    if (iter == s_source_contents.end()) {
+        memory::string<DefaultAlloc> code = read_code(*m_path);
+        size_t const hash = calc_std_hash(std::string_view{code});
+        iter = s_source_contents
+                   .emplace(m_path, Content{std::move(code), hash, 0, true})
+                   .first;
+    } else if (needs_code && !iter.mapped().is_loaded) {
+        // the hash stays the one the source was first seen with
+        iter.mapped().code = read_code(*m_path);
+        iter.mapped().is_loaded = true;
+    }
+    Content& content = iter.mapped();
+    content.last_accessed = ++s_access_count;
+    return content;
+}
+
+void ShaderSource::add_macro(
+    std::string_view name, std::string_view value) noexcept {
+    m_macros.insert_or_assign(intern_string(name), intern_string(value));
+}
+
+void ShaderSource::set_dynamic_buffer_size(
+    std::string_view name, size_t size) noexcept {
+    m_dynamic_buffer_size.insert_or_assign(intern_string(name), size);
+}
+
+std::filesystem::path const& ShaderSource::get_path() const noexcept {
+    return *m_path;
+}
+
+bool ShaderSource::operator==(ShaderSource const& other) const noexcept {
+    return m_path == other.m_path && m_macros == other.m_macros &&
+           m_dynamic_buffer_size == other.m_dynamic_buffer_size;
+}
+
+auto ShaderSource::get_macros() const noexcept -> decltype(m_macros) const& {
+    return m_macros;
+}
+
+auto ShaderSource::get_dynamic_buffer_sizes() const noexcept
+    -> decltype(m_dynamic_buffer_size) const& {
+    return m_dynamic_buffer_size;
+}
+
+}  // namespace render
+}  // namespace coust
+
+namespace std {
+
+std::size_t hash<coust::render::ShaderSource>::operator()(
+    coust::render::ShaderSource const& key) const noexcept {
+    size_t hash = key.get_code_hash();
+    for (auto const& [name, val] : key.get_macros()) {
+        coust::hash_combine(hash, name);
+        coust::hash_combine(hash, val);
+    }
+    return hash;
+}
+
+}  // namespace std
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "utils/Compiler.h"
+#include "core/Memory.h"
+#include "core/MemoryBudget.h"
+#include "utils/allocators/StlContainer.h"
+
+#include <filesystem>
+
+namespace coust {
+namespace render {
+
+class ShaderSource {
+public:
+    ShaderSource() = delete;
+
+    ShaderSource(ShaderSource&&) noexcept = default;
+    ShaderSource(ShaderSource const&) noexcept = default;
+    ShaderSource& operator=(ShaderSource&&) noexcept = default;
+    ShaderSource& operator=(ShaderSource const&) noexcept = default;
+
+public:
+    struct Content {
+        memory::string<DefaultAlloc> code;
+        // kept when the code is evicted, the source is hashed all the time
+        // & the maps keyed by it must still find it
+        size_t hash;
+        // the value of `s_access_count` when the content was last read
+        uint64_t last_accessed;
+        // the code isn't evicted
+        bool is_loaded;
+    };
+
+    // keyed by the interned path
+    static memory::robin_map<std::filesystem::path const*, Content,
+        DefaultAlloc>
+        s_source_contents;
+
+    static uint64_t s_access_count;
+
+    // drop the code of the least recently read contents, it's read from disk
+    // again when needed. return the bytes released
+    static size_t evict_source_contents(
+        memory::MemoryPressure pressure, size_t size) noexcept;
+
+public:
+    explicit ShaderSource(std::filesystem::path const& path) noexcept;
+
+    memory::string<DefaultAlloc> const& get_code() const noexcept;
+
+    size_t get_code_hash() const noexcept;
+
+    void add_macro(std::string_view name, std::string_view value) noexcept;
+
+    void set_dynamic_buffer_size(std::string_view name, size_t size) noexcept;
+
+    std::filesystem::path const& get_path() const noexcept;
+
+    bool operator==(ShaderSource const& other) const noexcept;
+
+private:
+    // read the content from disk if it isn't cached, and its code if it's
+    // needed but evicted
+    Content& get_content(bool needs_code) const noexcept;
+
+    // the paths & the strings a source refers to are kept here for the whole
+    // run, a source only holds a pointer & views into them. interning only
+    // allocates the first time a path or a string is seen
+    static std::filesystem::path const* intern_path(
+        std::filesystem::path const& path) noexcept;
+
+    // the views returned are null terminated
+    static std::string_view intern_string(std::string_view str) noexcept;
+
+    static memory::deque<std::filesystem::path, DefaultAlloc> s_interned_paths;
+
+    static memory::robin_map<std::filesystem::path,
+        std::filesystem::path const*, DefaultAlloc>
+        s_path_to_interned;
+
+    static memory::deque_nested<memory::string<DefaultAlloc>, DefaultAlloc>
+        s_interned_strings;
+
+    static memory::robin_set<std::string_view, DefaultAlloc>
+        s_string_to_interned;
+
+private:
+    std::filesystem::path const* m_path;
+
+    // a shader rarely has more than a handful of macros, with the strings
+    // interned & the maps holding them inline, copying a source (e.g. into a
+    // cache key) doesn't allocate unless it has more macros than that
+    memory::flat_map<std::string_view, std::string_view, 4, DefaultAlloc>
+        m_macros{get_default_alloc()};
+
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc>
+        m_dynamic_buffer_size{get_default_alloc()};
+
+public:
+    auto get_macros() const noexcept -> decltype(m_macros) const&;
+
+    auto get_dynamic_buffer_sizes() const noexcept
+        -> decltype(m_dynamic_buffer_size) const&;
+};
+
+}  // namespace render
+}  // namespace coust
+
+namespace std {
+
+template <>
+struct hash<coust::render::ShaderSource> {
+    std::size_t operator()(
+        coust::render::ShaderSource const& key) const noexcept;
+};
+
+}  // namespace std
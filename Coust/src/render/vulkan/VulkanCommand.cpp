@@ -103,9 +103,9 @@ bool VulkanCommandBufferCache::flush() noexcept {
     if (m_last_submission_signal != VK_NULL_HANDLE) {
         m_injected_signals.push_back(m_last_submission_signal);
     }
-    memory::vector<VkPipelineStageFlags, DefaultAlloc> wait_stages{
+    memory::vector<VkPipelineStageFlags, FrameAlloc> wait_stages{
         m_injected_signals.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-        get_default_alloc()};
+        get_frame_alloc()};
     VkSubmitInfo submit_info{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .waitSemaphoreCount = (uint32_t) m_injected_signals.size(),
@@ -119,6 +119,7 @@ bool VulkanCommandBufferCache::flush() noexcept {
     COUST_VK_CHECK(vkQueueSubmit(m_queue, 1, &submit_info, cmdbuf.fence),
         "Can't sumbit {} th vulkan command buffer", m_cmdbuf_idx.value());
     cmdbuf.state = VulkanCommandBuffer::State::pending;
+    cmdbuf.serial = ++m_submission_serial;
     m_last_submission_signal = m_submission_signals[m_cmdbuf_idx.value()];
     m_injected_signals.clear();
     m_cmdbuf_idx.reset();
@@ -184,6 +185,43 @@ void VulkanCommandBufferCache::wait() noexcept {
             "");
 }
 
+uint64_t VulkanCommandBufferCache::get_submission_serial() const noexcept {
+    return m_submission_serial;
+}
+
+uint64_t VulkanCommandBufferCache::get_recorded_serial() const noexcept {
+    return m_cmdbuf_idx.has_value() ? m_submission_serial + 1 :
+                                      m_submission_serial;
+}
+
+uint64_t VulkanCommandBufferCache::get_retired_serial() const noexcept {
+    // the submissions retire in order, so every one before the oldest pending
+    // one has retired. the fences are only polled in `gc()`, which keeps this
+    // conservative
+    uint64_t retired = m_submission_serial;
+    for (auto const& cmdbuf : m_cmdbufs) {
+        if (cmdbuf.state == VulkanCommandBuffer::State::pending)
+            retired = std::min(retired, cmdbuf.serial - 1);
+    }
+    return retired;
+}
+
+void VulkanCommandBufferCache::wait(uint64_t serial) noexcept {
+    std::array<VkFence, GARBAGE_COLLECTION_PERIOD> fences_to_wait{};
+    uint32_t idx = 0;
+    for (uint32_t i = 0; i < GARBAGE_COLLECTION_PERIOD; ++i) {
+        if (m_cmdbufs[i].state != VulkanCommandBuffer::State::pending ||
+            m_cmdbufs[i].serial > serial)
+            continue;
+        fences_to_wait[idx++] = m_cmdbufs[i].fence;
+        m_cmdbufs[i].state = VulkanCommandBuffer::State::invalid;
+    }
+    if (idx > 0)
+        COUST_VK_CHECK(vkWaitForFences(m_dev, idx, fences_to_wait.data(),
+                           VK_TRUE, std::numeric_limits<uint64_t>::max()),
+            "");
+}
+
 void VulkanCommandBufferCache::set_command_buffer_changed_callback(
     CommandBufferChangedCallback&& callback) noexcept {
     m_cmdbuf_changed_callback = std::move(callback);
@@ -68,6 +68,9 @@ struct VulkanCommandBuffer {
 
     State state = State::initial;
 
+    // serial of the latest submission of this command buffer
+    uint64_t serial = 0;
+
     VkFence fence = VK_NULL_HANDLE;
     VkCommandBuffer handle = VK_NULL_HANDLE;
 };
@@ -114,6 +117,23 @@ public:
     // Wait for all the command buffers in the cache
     void wait() noexcept;
 
+    // Serial of the latest submission, every submission gets a serial larger
+    // than all the previous ones. 0 means nothing has been submitted yet.
+    uint64_t get_submission_serial() const noexcept;
+
+    // Serial of the submission covering every command recorded so far, that
+    // is the one the command buffer being recorded gets when it's flushed.
+    uint64_t get_recorded_serial() const noexcept;
+
+    // Serial of the latest retired submission, the ones with a serial no
+    // larger than it have all completed on the device.
+    uint64_t get_retired_serial() const noexcept;
+
+    // Wait for the submission with `serial` and all the ones before it. The
+    // submissions of the cache are chained by semaphores, so they retire in
+    // order.
+    void wait(uint64_t serial) noexcept;
+
     void set_command_buffer_changed_callback(
         CommandBufferChangedCallback&& callback) noexcept;
 
@@ -131,6 +151,8 @@ private:
     std::optional<uint32_t> m_cmdbuf_idx{};
     uint32_t m_available_cmdbuf_cnt = GARBAGE_COLLECTION_PERIOD;
 
+    uint64_t m_submission_serial = 0;
+
     std::array<VulkanCommandBuffer, GARBAGE_COLLECTION_PERIOD> m_cmdbufs{};
 
     std::array<VkSemaphore, GARBAGE_COLLECTION_PERIOD> m_submission_signals{};
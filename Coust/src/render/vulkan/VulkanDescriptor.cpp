@@ -298,8 +298,8 @@ VulkanDescriptorSet::~VulkanDescriptorSet() noexcept {
 }
 
 void VulkanDescriptorSet::apply_write() const noexcept {
-    memory::vector<VkWriteDescriptorSet, DefaultAlloc> writes{
-        get_default_alloc()};
+    memory::vector<VkWriteDescriptorSet, FrameAlloc> writes{
+        get_frame_alloc()};
     writes.reserve(m_write_buf_infos.size() + m_write_img_infos.size());
     for (auto const &buf_info : m_write_buf_infos) {
         static_assert(std::is_standard_layout_v<WriteBufferInfo>);
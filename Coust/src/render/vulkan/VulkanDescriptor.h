@@ -31,13 +31,16 @@ struct BoundImage {
     auto operator<=>(BoundImage const &other) const noexcept = default;
 };
 
+// most bindings hold a single descriptor, bindless arrays spill to the heap
 struct BoundBufferArray {
-    memory::vector<BoundBuffer, DefaultAlloc> buffers{get_default_alloc()};
+    memory::small_vector<BoundBuffer, 2, DefaultAlloc> buffers{
+        get_default_alloc()};
     uint32_t binding = ~(0u);
 };
 
 struct BoundImageArray {
-    memory::vector<BoundImage, DefaultAlloc> images{get_default_alloc()};
+    memory::small_vector<BoundImage, 2, DefaultAlloc> images{
+        get_default_alloc()};
     uint32_t binding = ~(0u);
 };
 
@@ -106,9 +109,10 @@ public:
 
     struct Param {
         class VulkanDescriptorSetAllocator *allocator;
-        memory::vector<BoundBufferArray, DefaultAlloc> buffer_infos{
+        // indexed by the binding, sets rarely go past a few of them
+        memory::small_vector<BoundBufferArray, 4, DefaultAlloc> buffer_infos{
             get_default_alloc()};
-        memory::vector<BoundImageArray, DefaultAlloc> image_infos{
+        memory::small_vector<BoundImageArray, 4, DefaultAlloc> image_infos{
             get_default_alloc()};
         VkCommandBuffer attached_cmdbuf = VK_NULL_HANDLE;
         uint32_t set;
@@ -134,8 +134,8 @@ void VulkanDescriptorCache::reset() noexcept {
     m_pipeline_layouts.clear();
 }
 
-void VulkanDescriptorCache::gc() noexcept {
-    m_gc_timer.tick();
+void VulkanDescriptorCache::gc(SubmissionSerials const& recorded) noexcept {
+    m_gc_timer.tick(recorded);
     for (auto iter = m_descriptor_sets.begin();
          iter != m_descriptor_sets.end();) {
         auto& [set, last_accessed] = iter->second;
@@ -160,6 +160,28 @@ void VulkanDescriptorCache::gc() noexcept {
     }
 }
 
+size_t VulkanDescriptorCache::evict(SubmissionSerials const& retired,
+    memory::MemoryPressure pressure, size_t size) noexcept {
+    size_t released = evict_least_recently_used(m_descriptor_sets, m_gc_timer,
+        retired, pressure, size, [](VulkanDescriptorSet const&) {
+            return sizeof(VulkanDescriptorSet::Param) +
+                   sizeof(VulkanDescriptorSet);
+        });
+    released += evict_least_recently_used(m_pipeline_layouts, m_gc_timer,
+        retired, pressure, size - std::min(released, size),
+        [this](auto const& layout) {
+            auto const alloc_iter =
+                m_descriptor_set_allocators.find(layout.get());
+            COUST_ASSERT(alloc_iter != m_descriptor_set_allocators.end(), "");
+            size_t const allocator_size =
+                alloc_iter.mapped().size() *
+                sizeof(VulkanDescriptorSetAllocator);
+            m_descriptor_set_allocators.erase(alloc_iter);
+            return sizeof(VulkanPipelineLayout) + allocator_size;
+        });
+    return released;
+}
+
 const VulkanPipelineLayout* VulkanDescriptorCache::get_pipeline_layout(
     std::span<VulkanShaderModule*> modules) noexcept {
     VulkanPipelineLayout::Param param{modules};
@@ -172,7 +194,7 @@ const VulkanPipelineLayout* VulkanDescriptorCache::get_pipeline_layout(
     } else {
         m_hit_pipeline_layout_counter.miss();
         auto layout = memory::allocate_unique<VulkanPipelineLayout>(
-            get_default_alloc(), m_dev, m_phy_dev, param);
+            get_slab_alloc(), m_dev, m_phy_dev, param);
         auto [layout_insert_iter, layout_insert_success] =
             m_pipeline_layouts.emplace(param,
                 std::make_pair(std::move(layout), m_gc_timer.current_count()));
@@ -182,8 +204,8 @@ const VulkanPipelineLayout* VulkanDescriptorCache::get_pipeline_layout(
         {
             auto [alloc_insert_iter, alloc_insert_success] =
                 m_descriptor_set_allocators.emplace(inserted_layout,
-                    memory::vector<VulkanDescriptorSetAllocator, DefaultAlloc>{
-                        get_default_alloc()});
+                    memory::vector<VulkanDescriptorSetAllocator, SlabAlloc>{
+                        get_slab_alloc()});
             COUST_ASSERT(layout_insert_success, "");
             for (auto const& descriptor_set_layout :
                 inserted_layout->get_descriptor_set_layouts()) {
@@ -203,8 +225,8 @@ std::span<VulkanDescriptorSetAllocator> VulkanDescriptorCache::get_allocator(
 void VulkanDescriptorCache::bind_descriptor_sets(VkCommandBuffer cmdbuf,
     VkPipelineBindPoint bind_point, VulkanPipelineLayout const& layout,
     std::span<const VulkanDescriptorSet::Param> params) noexcept {
-    memory::vector<VkDescriptorSet, DefaultAlloc> sets_to_bind{
-        get_default_alloc()};
+    memory::vector<VkDescriptorSet, FrameAlloc> sets_to_bind{
+        get_frame_alloc()};
     sets_to_bind.reserve(params.size());
     // The descriptor requriement has already been sorted by set index. The
     // spec says: Values are taken from pDynamicOffsets in an order such that
@@ -59,7 +59,12 @@ public:
 
     void reset() noexcept;
 
-    void gc() noexcept;
+    void gc(SubmissionSerials const& recorded) noexcept;
+
+    // evict the least recently used descriptor sets & pipeline layouts that the
+    // submissions in flight don't use, return the bytes released
+    size_t evict(SubmissionSerials const& retired,
+        memory::MemoryPressure pressure, size_t size) noexcept;
 
     const VulkanPipelineLayout* get_pipeline_layout(
         std::span<VulkanShaderModule*> modules) noexcept;
@@ -72,15 +77,16 @@ public:
         std::span<const VulkanDescriptorSet::Param> params) noexcept;
 
 private:
+    // the layouts & the allocators of their sets come and go with the pipelines
+    // in use, so they're carved from the slabs
     memory::robin_map<VulkanPipelineLayout::Param,
-        std::pair<memory::unique_ptr<VulkanPipelineLayout, DefaultAlloc>,
+        std::pair<memory::unique_ptr<VulkanPipelineLayout, SlabAlloc>,
             uint32_t>,
         DefaultAlloc>
         m_pipeline_layouts{get_default_alloc()};
 
-    memory::robin_map_nested<const VulkanPipelineLayout*,
-        memory::vector<VulkanDescriptorSetAllocator, DefaultAlloc>,
-        DefaultAlloc>
+    memory::robin_map<const VulkanPipelineLayout*,
+        memory::vector<VulkanDescriptorSetAllocator, SlabAlloc>, DefaultAlloc>
         m_descriptor_set_allocators{get_default_alloc()};
 
     memory::robin_map<VulkanDescriptorSet::Param,
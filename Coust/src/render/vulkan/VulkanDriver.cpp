@@ -418,6 +418,7 @@ VulkanDriver::VulkanDriver(
         VmaAllocatorCreateInfo vma_alloc_info{
             .physicalDevice = m_phydev,
             .device = m_dev,
+            .pAllocationCallbacks = COUST_VULKAN_ALLOC_CALLBACK,
             .pVulkanFunctions = &vma_loading_func,
             .instance = m_instance,
             .vulkanApiVersion = COUST_VULKAN_API_VERSION,
@@ -464,9 +465,40 @@ VulkanDriver::VulkanDriver(
 
     m_swapchain.get().prepare();
     m_swapchain.get().create();
+
+    // the ones registered later release their memory first, so the pipelines
+    // go before the layouts they are created with
+    memory::MemoryBudget& budget = get_memory_budget();
+    m_budget_handles = {
+        budget.register_subsystem(
+            "Shader Source", &ShaderSource::evict_source_contents),
+        budget.register_subsystem("Vulkan Descriptor Cache",
+            [this](memory::MemoryPressure pressure, size_t size) {
+                return m_descriptor_cache.get().evict(
+                    get_retired_serials(), pressure, size);
+            }),
+        budget.register_subsystem("Vulkan Graphics Pipeline Cache",
+            [this](memory::MemoryPressure pressure, size_t size) {
+                return m_graphics_pipeline_cache.get().evict(
+                    get_retired_serials(), pressure, size);
+            }),
+        budget.register_subsystem("Vulkan Compute Pipeline Cache",
+            [this](memory::MemoryPressure pressure, size_t size) {
+                return m_compute_pipeline_cache.get().evict(
+                    get_retired_serials(), pressure, size);
+            }),
+        budget.register_subsystem("Vulkan Stage Pool",
+            [this](memory::MemoryPressure pressure, size_t size) {
+                return m_stage_pool.get().evict(pressure, size);
+            }),
+    };
 }
 
 VulkanDriver::~VulkanDriver() noexcept {
+    for (auto const handle : m_budget_handles) {
+        get_memory_budget().unregister_subsystem(handle);
+    }
+
     m_graphics_cmdbuf_cache.destroy();
 
     m_compute_cmdbuf_cache.destroy();
@@ -489,12 +521,16 @@ VulkanDriver::~VulkanDriver() noexcept {
 
     vmaDestroyAllocator(m_vma_alloc);
     vkDestroyDevice(m_dev, COUST_VULKAN_ALLOC_CALLBACK);
-    vkDestroySurfaceKHR(m_instance, m_surface, COUST_VULKAN_ALLOC_CALLBACK);
+    // the surface is created by SDL without allocation callbacks, so it must be
+    // destroyed without them as well
+    vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
 #if defined(COUST_VK_DBG)
     vkDestroyDebugUtilsMessengerEXT(
         m_instance, m_dbg_messenger, COUST_VULKAN_ALLOC_CALLBACK);
 #endif
     vkDestroyInstance(m_instance, COUST_VULKAN_ALLOC_CALLBACK);
+
+    log_vulkan_host_allocation_stats();
 }
 
 void VulkanDriver::wait() noexcept {
@@ -505,12 +541,34 @@ void VulkanDriver::wait() noexcept {
 void VulkanDriver::gc() noexcept {
     m_graphics_cmdbuf_cache.get().gc();
     m_compute_cmdbuf_cache.get().gc();
-    m_descriptor_cache.get().gc();
-    m_stage_pool.get().gc();
-    m_fbo_cache.get().gc();
+    SubmissionSerials const recorded{
+        .graphics = m_graphics_cmdbuf_cache.get().get_recorded_serial(),
+        .compute = m_compute_cmdbuf_cache.get().get_recorded_serial(),
+    };
+    m_descriptor_cache.get().gc(recorded);
+    m_stage_pool.get().gc(recorded);
+    m_fbo_cache.get().gc(recorded);
+}
+
+SubmissionSerials VulkanDriver::get_retired_serials() const noexcept {
+    return {
+        .graphics = m_graphics_cmdbuf_cache.get().get_retired_serial(),
+        .compute = m_compute_cmdbuf_cache.get().get_retired_serial(),
+    };
 }
 
 void VulkanDriver::begin_frame() noexcept {
+    // everything recorded so far used the current slot of the frame arena.
+    // the compute work of a frame is waited by its graphics submission, so
+    // once the graphics submission retires, the slot can be reused
+    FrameAlloc& frame_alloc = get_frame_alloc();
+    VulkanCommandBufferCache& cmdbuf_cache = m_graphics_cmdbuf_cache.get();
+    m_frame_submission_serials[frame_alloc.get_frame_idx()] =
+        cmdbuf_cache.get_submission_serial();
+    size_t const next_frame_idx =
+        (frame_alloc.get_frame_idx() + 1) % frame_alloc.get_frame_count();
+    cmdbuf_cache.wait(m_frame_submission_serials[next_frame_idx]);
+    frame_alloc.next_frame();
 }
 
 void VulkanDriver::end_frame() noexcept {
@@ -795,11 +853,13 @@ SpecializationConstantInfo& VulkanDriver::bind_specialization_info(
 
 void VulkanDriver::bind_shader(VkPipelineBindPoint bind_point,
     VkShaderStageFlagBits vk_shader_stage,
-    std::filesystem::path source_path) noexcept {
+    std::filesystem::path const& source_path) noexcept {
     COUST_ASSERT(bind_point == VK_PIPELINE_BIND_POINT_COMPUTE ||
                      bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS,
         "");
-    ShaderSource source{source_path};
+    // the path is interned & the module is cached by the shader pool, binding
+    // a shader that was bound before is only a couple of lookups
+    ShaderSource const source{source_path};
     if (bind_point == VK_PIPELINE_BIND_POINT_COMPUTE) {
         m_compute_pipeline_cache.get().bind_shader({vk_shader_stage, source});
     } else {
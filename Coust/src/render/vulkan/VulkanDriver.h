@@ -3,6 +3,7 @@
 #include "render/vulkan/VulkanRenderTarget.h"
 #include "utils/Compiler.h"
 #include "core/Memory.h"
+#include "core/MemoryBudget.h"
 #include "utils/allocators/StlContainer.h"
 #include "utils/AlignedStorage.h"
 #include "render/vulkan/VulkanCommand.h"
@@ -103,7 +104,7 @@ public:
 
     void bind_shader(VkPipelineBindPoint bind_point,
         VkShaderStageFlagBits vk_shader_stage,
-        std::filesystem::path source_path) noexcept;
+        std::filesystem::path const& source_path) noexcept;
 
     void set_update_mode(VkPipelineBindPoint bind_point, std::string_view name,
         ShaderResourceUpdateMode update_mode) noexcept;
@@ -134,6 +135,10 @@ public:
 
     void add_compute_to_graphics_dependency() noexcept;
 
+private:
+    // the serials of the latest retired graphics & compute submissions
+    SubmissionSerials get_retired_serials() const noexcept;
+
 private:
     int32_t m_max_msaa_sample = 1;
     uint32_t m_graphics_queue_family_idx = std::numeric_limits<uint32_t>::max();
@@ -184,6 +189,15 @@ private:
     uint32_t m_cur_subpass = 0;
 
     uint8_t m_cur_subpass_mask = 0;
+
+private:
+    // the latest graphics submission recorded with each slot of the frame
+    // arena
+    std::array<uint64_t, memory::max_frame_in_flight + 1>
+        m_frame_submission_serials{};
+
+    // the caches registered to the memory budget
+    std::array<memory::MemoryBudget::Handle, 5> m_budget_handles{};
 };
 
 }  // namespace render
@@ -52,8 +52,8 @@ VulkanFramebuffer const &VulkanFBOCache::get_framebuffer(
     }
 }
 
-void VulkanFBOCache::gc() noexcept {
-    m_gc_timer.tick();
+void VulkanFBOCache::gc(SubmissionSerials const &recorded) noexcept {
+    m_gc_timer.tick(recorded);
     for (auto iter = m_framebuffer.begin(); iter != m_framebuffer.end();) {
         auto const &[framebuffer, last_access] = iter.mapped();
         if (m_gc_timer.should_recycle(last_access)) {
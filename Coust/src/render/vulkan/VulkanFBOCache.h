@@ -26,7 +26,7 @@ public:
     VulkanFramebuffer const &get_framebuffer(
         VulkanFramebuffer::Param const &param) noexcept;
 
-    void gc() noexcept;
+    void gc(SubmissionSerials const &recorded) noexcept;
 
     void reset() noexcept;
 
@@ -51,7 +51,9 @@ VulkanFramebuffer::VulkanFramebuffer(VkDevice dev, Param const &param) noexcept
         .layers = param.layers,
     };
     COUST_VK_CHECK(
-        vkCreateFramebuffer(m_dev, &framebuffer_info, nullptr, &m_handle), "");
+        vkCreateFramebuffer(m_dev, &framebuffer_info,
+            COUST_VULKAN_ALLOC_CALLBACK, &m_handle),
+        "");
 }
 
 VulkanFramebuffer::VulkanFramebuffer(VulkanFramebuffer &&other) noexcept
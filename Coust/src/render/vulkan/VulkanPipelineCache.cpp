@@ -25,9 +25,8 @@ void VulkanGraphicsPipelineCache::reset() noexcept {
     m_graphics_pipelines_requirement = {};
 }
 
-void VulkanGraphicsPipelineCache::gc(
-    [[maybe_unused]] const VulkanCommandBuffer &buf) noexcept {
-    m_gc_timer.tick();
+void VulkanGraphicsPipelineCache::gc(const VulkanCommandBuffer &buf) noexcept {
+    m_gc_timer.tick({.graphics = buf.serial});
     m_graphics_pipelines_requirement.special_const_info = {};
     m_cur_shader_modules.clear();
     m_cur_graphics_pipeline = nullptr;
@@ -44,6 +43,15 @@ void VulkanGraphicsPipelineCache::gc(
     }
 }
 
+size_t VulkanGraphicsPipelineCache::evict(SubmissionSerials const &retired,
+    memory::MemoryPressure pressure, size_t size) noexcept {
+    return evict_least_recently_used(m_graphics_pipelines, m_gc_timer, retired,
+        pressure, size, [](VulkanGraphicsPipeline const &) {
+            return sizeof(VulkanGraphicsPipeline::Param) +
+                   sizeof(VulkanGraphicsPipeline);
+        });
+}
+
 SpecializationConstantInfo &
     VulkanGraphicsPipelineCache::bind_specialization_constant() noexcept {
     return m_graphics_pipelines_requirement.special_const_info;
@@ -135,7 +143,7 @@ void VulkanGraphicsPipelineCache::bind_graphics_pipeline(
         m_cur_graphics_pipeline->get_handle());
 }
 
-memory::vector<VulkanShaderModule *, DefaultAlloc> &
+memory::small_vector<VulkanShaderModule *, 4, DefaultAlloc> &
     VulkanGraphicsPipelineCache::get_cur_shader_modules() noexcept {
     return m_cur_shader_modules;
 }
@@ -159,9 +167,8 @@ void VulkanComputePipelineCache::reset() noexcept {
     m_specialzation_const_info = {};
 }
 
-void VulkanComputePipelineCache::gc(
-    [[maybe_unused]] VulkanCommandBuffer const &buf) noexcept {
-    m_gc_timer.tick();
+void VulkanComputePipelineCache::gc(VulkanCommandBuffer const &buf) noexcept {
+    m_gc_timer.tick({.compute = buf.serial});
     m_cur_shader_module = nullptr;
     m_cur_pipeline_layout = nullptr;
     m_cur_compute_pipeline = nullptr;
@@ -177,6 +184,15 @@ void VulkanComputePipelineCache::gc(
     }
 }
 
+size_t VulkanComputePipelineCache::evict(SubmissionSerials const &retired,
+    memory::MemoryPressure pressure, size_t size) noexcept {
+    return evict_least_recently_used(m_compute_pipelines, m_gc_timer, retired,
+        pressure, size, [](VulkanComputePipeline const &) {
+            return sizeof(VulkanComputePipeline::Param) +
+                   sizeof(VulkanComputePipeline);
+        });
+}
+
 SpecializationConstantInfo &
     VulkanComputePipelineCache::bind_specialization_constant() noexcept {
     return m_specialzation_const_info;
@@ -38,6 +38,11 @@ public:
 
     void gc(const VulkanCommandBuffer &buf) noexcept;
 
+    // evict the least recently used pipelines that the submissions in flight
+    // don't use, return the bytes released
+    size_t evict(SubmissionSerials const &retired,
+        memory::MemoryPressure pressure, size_t size) noexcept;
+
     SpecializationConstantInfo &bind_specialization_constant() noexcept;
 
     void bind_shader(VulkanShaderModule::Param const &param) noexcept;
@@ -67,7 +72,7 @@ public:
 
     void bind_graphics_pipeline(VkCommandBuffer cmdbuf) noexcept;
 
-    memory::vector<VulkanShaderModule *, DefaultAlloc> &
+    memory::small_vector<VulkanShaderModule *, 4, DefaultAlloc> &
         get_cur_shader_modules() noexcept;
 
 private:
@@ -81,8 +86,9 @@ private:
 
     VulkanDescriptorBuilder m_descriptor_builder;
 
-    memory::vector<VulkanShaderModule *, DefaultAlloc> m_cur_shader_modules{
-        get_default_alloc()};
+    // one module per stage, a graphics pipeline seldom has more than 4
+    memory::small_vector<VulkanShaderModule *, 4, DefaultAlloc>
+        m_cur_shader_modules{get_default_alloc()};
 
     const VulkanPipelineLayout *m_cur_pipeline_layout = nullptr;
 
@@ -117,6 +123,11 @@ public:
 
     void gc(VulkanCommandBuffer const &buf) noexcept;
 
+    // evict the least recently used pipelines that the submissions in flight
+    // don't use, return the bytes released
+    size_t evict(SubmissionSerials const &retired,
+        memory::MemoryPressure pressure, size_t size) noexcept;
+
     SpecializationConstantInfo &bind_specialization_constant() noexcept;
 
     void bind_shader(VulkanShaderModule::Param const &param) noexcept;
@@ -18,81 +18,6 @@ WARNING_POP
 namespace coust {
 namespace render {
 
-WARNING_PUSH
-CLANG_DISABLE_WARNING("-Wexit-time-destructors")
-CLANG_DISABLE_WARNING("-Wglobal-constructors")
-memory::robin_map_nested<std::filesystem::path,
-    std::pair<memory::string<DefaultAlloc>, size_t>, DefaultAlloc>
-    ShaderSource::s_source_contents{get_default_alloc()};
-WARNING_POP
-
-ShaderSource::ShaderSource(std::filesystem::path path) noexcept
-    : m_path(std::move(path)) {
-}
-
-memory::string<DefaultAlloc> const& ShaderSource::get_code() const noexcept {
-    auto const iter = s_source_contents.find(m_path);
-    if (iter != s_source_contents.end()) {
-        return iter->second.first;
-    } else {
-        file::ByteArray byte_array = file::read_file_whole(m_path);
-        memory::string<DefaultAlloc> content{
-            byte_array.to_string_view(), get_default_alloc()};
-        size_t const hash = calc_std_hash(content);
-        auto const [iiter, inserted] = s_source_contents.emplace(
-            m_path, std::make_pair(std::move(content), hash));
-        return iiter->second.first;
-    }
-}
-
-size_t ShaderSource::get_code_hash() const noexcept {
-    auto const iter = s_source_contents.find(m_path);
-    if (iter != s_source_contents.end()) {
-        return iter->second.second;
-    } else {
-        file::ByteArray byte_array = file::read_file_whole(m_path);
-        memory::string<DefaultAlloc> content{
-            byte_array.to_string_view(), get_default_alloc()};
-        size_t const hash = calc_std_hash(content);
-        auto const [iiter, inserted] = s_source_contents.emplace(
-            m_path, std::make_pair(std::move(content), hash));
-        return iiter->second.second;
-    }
-}
-
-void ShaderSource::add_macro(
-    std::string_view name, std::string_view value) noexcept {
-    memory::string<DefaultAlloc> nstr{name, get_default_alloc()};
-    memory::string<DefaultAlloc> vstr{value, get_default_alloc()};
-    m_macros.insert_or_assign(std::move(nstr), std::move(vstr));
-}
-
-void ShaderSource::set_dynamic_buffer_size(
-    std::string_view name, size_t size) noexcept {
-    memory::string<DefaultAlloc> nstr{name, get_default_alloc()};
-    m_dynamic_buffer_size.insert_or_assign(std::move(nstr), size);
-}
-
-std::filesystem::path const& ShaderSource::get_path() const noexcept {
-    return m_path;
-}
-
-bool ShaderSource::operator==(ShaderSource const& other) const noexcept {
-    return m_path == other.m_path &&
-           std::ranges::equal(m_macros, other.m_macros) &&
-           std::ranges::equal(
-               m_dynamic_buffer_size, other.m_dynamic_buffer_size);
-}
-
-auto ShaderSource::get_macros() const noexcept -> decltype(m_macros) const& {
-    return m_macros;
-}
-
-auto ShaderSource::get_dynamic_buffer_sizes() const noexcept
-    -> decltype(m_dynamic_buffer_size) const& {
-    return m_dynamic_buffer_size;
-}
-
 VkDevice VulkanShaderModule::get_device() const noexcept {
     return m_dev;
 }
@@ -247,16 +172,6 @@ static_assert(detail::IsVulkanResource<VulkanShaderModule>);
 
 namespace std {
 
-std::size_t hash<coust::render::ShaderSource>::operator()(
-    coust::render::ShaderSource const& key) const noexcept {
-    size_t hash = key.get_code_hash();
-    for (auto const& [name, val] : key.get_macros()) {
-        coust::hash_combine(hash, name);
-        coust::hash_combine(hash, val);
-    }
-    return hash;
-}
-
 std::size_t hash<coust::render::VulkanShaderModule::Param>::operator()(
     coust::render::VulkanShaderModule::Param const& key) const noexcept {
     size_t hash = coust::calc_std_hash(key.source);
@@ -2,7 +2,9 @@
 
 #include "utils/Compiler.h"
 #include "core/Memory.h"
+#include "core/MemoryBudget.h"
 #include "utils/allocators/StlContainer.h"
+#include "render/vulkan/ShaderSource.h"
 #include "render/vulkan/utils/SpirVReflection.h"
 
 WARNING_PUSH
@@ -13,52 +15,6 @@ WARNING_POP
 namespace coust {
 namespace render {
 
-class ShaderSource {
-public:
-    ShaderSource() = delete;
-
-    ShaderSource(ShaderSource&&) noexcept = default;
-    ShaderSource(ShaderSource const&) noexcept = default;
-    ShaderSource& operator=(ShaderSource&&) noexcept = default;
-    ShaderSource& operator=(ShaderSource const&) noexcept = default;
-
-public:
-    static memory::robin_map_nested<std::filesystem::path,
-        std::pair<memory::string<DefaultAlloc>, size_t>, DefaultAlloc>
-        s_source_contents;
-
-public:
-    explicit ShaderSource(std::filesystem::path path) noexcept;
-
-    memory::string<DefaultAlloc> const& get_code() const noexcept;
-
-    size_t get_code_hash() const noexcept;
-
-    void add_macro(std::string_view name, std::string_view value) noexcept;
-
-    void set_dynamic_buffer_size(std::string_view name, size_t size) noexcept;
-
-    std::filesystem::path const& get_path() const noexcept;
-
-    bool operator==(ShaderSource const& other) const noexcept;
-
-private:
-    std::filesystem::path m_path{};
-
-    memory::robin_map_nested<memory::string<DefaultAlloc>,
-        memory::string<DefaultAlloc>, DefaultAlloc>
-        m_macros{get_default_alloc()};
-
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t, DefaultAlloc>
-        m_dynamic_buffer_size{get_default_alloc()};
-
-public:
-    auto get_macros() const noexcept -> decltype(m_macros) const&;
-
-    auto get_dynamic_buffer_sizes() const noexcept
-        -> decltype(m_dynamic_buffer_size) const&;
-};
-
 class VulkanShaderModule {
 public:
     VulkanShaderModule() = delete;
@@ -129,12 +85,6 @@ public:
 
 namespace std {
 
-template <>
-struct hash<coust::render::ShaderSource> {
-    std::size_t operator()(
-        coust::render::ShaderSource const& key) const noexcept;
-};
-
 template <>
 struct hash<coust::render::VulkanShaderModule::Param> {
     std::size_t operator()(
@@ -19,7 +19,7 @@ VulkanShaderModule *VulkanShaderPool::get_shader(
         return iter.mapped().get();
     } else {
         auto shader_module = memory::allocate_unique<VulkanShaderModule>(
-            get_default_alloc(), m_dev, param);
+            get_slab_alloc(), m_dev, param);
         auto [emplace_iter, success] =
             m_shader_modules.emplace(param, std::move(shader_module));
         COUST_ASSERT(success, "");
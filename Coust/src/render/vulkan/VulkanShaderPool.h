@@ -27,8 +27,9 @@ public:
 private:
     VkDevice m_dev = VK_NULL_HANDLE;
 
+    // the modules live in slabs, the table of them in the default allocator
     memory::robin_map<VulkanShaderModule::Param,
-        memory::unique_ptr<VulkanShaderModule, DefaultAlloc>, DefaultAlloc>
+        memory::unique_ptr<VulkanShaderModule, SlabAlloc>, DefaultAlloc>
         m_shader_modules{get_default_alloc()};
 };
 
@@ -1,5 +1,6 @@
 #include "pch.h"
 
+#include "render/vulkan/utils/VulkanFormat.h"
 #include "render/vulkan/VulkanStagePool.h"
 
 namespace coust {
@@ -41,7 +42,7 @@ memory::shared_ptr<VulkanBuffer> VulkanStagePool::acquire_staging_buf(
             VK_QUEUE_FAMILY_IGNORED,
             VK_QUEUE_FAMILY_IGNORED,
         };
-        auto buf = memory::allocate_shared<VulkanBuffer>(get_default_alloc(),
+        auto buf = memory::allocate_shared<VulkanBuffer>(get_slab_alloc(),
             m_dev, m_alloc, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VulkanBuffer::Usage::staging, related_queues);
         m_used_staging_bufs.emplace_back(
@@ -68,15 +69,15 @@ memory::shared_ptr<VulkanHostImage> VulkanStagePool::acquire_staging_img(
     } else {
         m_image_hit_counter.miss();
         auto stage_img = memory::allocate_shared<VulkanHostImage>(
-            get_default_alloc(), m_dev, m_alloc, cmdbuf, format, width, height);
+            get_slab_alloc(), m_dev, m_alloc, cmdbuf, format, width, height);
         m_used_staging_imgs.push_back(
             StagingImage{stage_img, m_gc_timer.current_count()});
         return stage_img;
     }
 }
 
-void VulkanStagePool::gc() noexcept {
-    m_gc_timer.tick();
+void VulkanStagePool::gc(SubmissionSerials const& recorded) noexcept {
+    m_gc_timer.tick(recorded);
     {
         memory::vector<StagingBuffer, DefaultAlloc> tmp{get_default_alloc()};
         tmp.swap(m_free_staging_bufs);
@@ -133,5 +134,33 @@ void VulkanStagePool::reset() noexcept {
     m_used_staging_imgs.clear();
 }
 
+size_t VulkanStagePool::evict(
+    memory::MemoryPressure pressure, size_t size) noexcept {
+    // the free ones are unused for a whole garbage collection period already,
+    // so none of them is referenced by a frame in flight
+    auto const by_last_accessed = [](auto const& lhs, auto const& rhs) {
+        return lhs.last_accessed > rhs.last_accessed;
+    };
+    std::ranges::sort(m_free_staging_bufs, by_last_accessed);
+    std::ranges::sort(m_free_staging_imgs, by_last_accessed);
+    size_t released = 0;
+    auto const should_evict = [&] {
+        return pressure == memory::MemoryPressure::hard || released < size;
+    };
+    // the least recently used ones are at the back
+    while (!m_free_staging_bufs.empty() && should_evict()) {
+        released += m_free_staging_bufs.back().buf->get_size();
+        m_free_staging_bufs.pop_back();
+    }
+    while (!m_free_staging_imgs.empty() && should_evict()) {
+        auto const& img = m_free_staging_imgs.back().img;
+        auto const [width, height] = img->get_extent();
+        released += (size_t) width * height *
+                    get_byte_per_pixel_from_format(img->get_format());
+        m_free_staging_imgs.pop_back();
+    }
+    return released;
+}
+
 }  // namespace render
 }  // namespace coust
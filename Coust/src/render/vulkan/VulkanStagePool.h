@@ -35,10 +35,14 @@ public:
         VkCommandBuffer cmdbuf, VkFormat format, uint32_t width,
         uint32_t height) noexcept;
 
-    void gc() noexcept;
+    void gc(SubmissionSerials const& recorded) noexcept;
 
     void reset() noexcept;
 
+    // release the free staging buffers & images, least recently used first,
+    // return the bytes released
+    size_t evict(memory::MemoryPressure pressure, size_t size) noexcept;
+
 private:
     struct StagingBuffer {
         memory::shared_ptr<VulkanBuffer> buf;
@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include "utils/Log.h"
+#include "utils/Assert.h"
 #include "render/vulkan/utils/CacheSetting.h"
 
 namespace coust {
@@ -8,9 +9,11 @@ namespace render {
 
 GCTimer::GCTimer(uint32_t gc_period) noexcept
     : m_gc_period(gc_period), m_count(gc_period) {
+    COUST_ASSERT(gc_period <= GARBAGE_COLLECTION_PERIOD, "");
 }
 
-void GCTimer::tick() noexcept {
+void GCTimer::tick(SubmissionSerials const& recorded) noexcept {
+    m_recorded[m_count % m_recorded.size()] = recorded;
     ++m_count;
 }
 
@@ -18,6 +21,20 @@ bool GCTimer::should_recycle(uint32_t last_accessed) const noexcept {
     return (m_count - m_gc_period) > last_accessed;
 }
 
+bool GCTimer::can_evict(
+    uint32_t last_accessed, SubmissionSerials const& retired) const noexcept {
+    // the ones accessed in the current period might be recorded any time
+    if (last_accessed >= m_count)
+        return false;
+    // the ones older than the latest periods are recycled already
+    if (m_count - last_accessed > m_recorded.size())
+        return true;
+    SubmissionSerials const& recorded =
+        m_recorded[last_accessed % m_recorded.size()];
+    return recorded.graphics <= retired.graphics &&
+           recorded.compute <= retired.compute;
+}
+
 uint32_t GCTimer::current_count() const noexcept {
     return m_count;
 }
@@ -1,25 +1,79 @@
 #pragma once
 
+#include "core/Memory.h"
+#include "core/MemoryBudget.h"
+
 namespace coust {
 namespace render {
 
 uint32_t constexpr GARBAGE_COLLECTION_PERIOD = 10;
 
+// Serials of the graphics & compute submissions, see
+// `VulkanCommandBufferCache::get_submission_serial`
+struct SubmissionSerials {
+    uint64_t graphics = 0;
+    uint64_t compute = 0;
+};
+
 class GCTimer {
 public:
     explicit GCTimer(uint32_t gc_period) noexcept;
 
-    void tick() noexcept;
+    // `recorded` are the serials of the submissions covering every command
+    // recorded so far, see `VulkanCommandBufferCache::get_recorded_serial`
+    void tick(SubmissionSerials const& recorded) noexcept;
 
     bool should_recycle(uint32_t last_accessed) const noexcept;
 
+    // under memory pressure, entries are evicted before the garbage collection
+    // period is over, but only after the submissions that might use them have
+    // retired on the device
+    bool can_evict(uint32_t last_accessed,
+        SubmissionSerials const& retired) const noexcept;
+
     uint32_t current_count() const noexcept;
 
 private:
     uint32_t const m_gc_period;
     uint32_t m_count = 0;
+
+    // the submissions recorded by the end of each of the latest periods
+    std::array<SubmissionSerials, GARBAGE_COLLECTION_PERIOD> m_recorded{};
 };
 
+// Evict the least recently used entries of a cache whose mapped values are
+// `std::pair<Object, uint32_t last_accessed>`, until `size` bytes are released,
+// or every evictable entry at hard pressure. `on_evict` is called right before
+// an entry is erased and returns the bytes it holds. `retired` are the serials
+// of the latest retired submissions, the entries that the ones still in flight
+// might use are kept. Entries surviving the garbage collection span only a few
+// periods, so the cache is swept once per period, oldest first.
+template <typename Cache, typename OnEvict>
+size_t evict_least_recently_used(Cache& cache, GCTimer const& timer,
+    SubmissionSerials const& retired, memory::MemoryPressure pressure,
+    size_t size, OnEvict&& on_evict) noexcept {
+    if (cache.empty())
+        return 0;
+    uint32_t oldest = std::numeric_limits<uint32_t>::max();
+    for (auto const& [key, value] : cache) {
+        oldest = std::min(oldest, value.second);
+    }
+    size_t released = 0;
+    for (uint32_t period = oldest; timer.can_evict(period, retired); ++period) {
+        if (pressure != memory::MemoryPressure::hard && released >= size)
+            break;
+        for (auto iter = cache.begin(); iter != cache.end();) {
+            if (iter->second.second == period) {
+                released += on_evict(iter->second.first);
+                iter = cache.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+    return released;
+}
+
 class CacheHitCounter {
 public:
     CacheHitCounter(std::string_view name) noexcept;
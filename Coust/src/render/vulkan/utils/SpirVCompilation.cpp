@@ -94,8 +94,9 @@ memory::vector<uint32_t, DefaultAlloc> compile_glst_to_spv(
         get_shaderc_evn_ver(COUST_VULKAN_API_VERSION));
     opt.SetOptimizationLevel(shaderc_optimization_level_zero);
     opt.AddMacroDefinition("__VK_GLSL__", "1");
+    // the macros are interned, their views are null terminated
     for (auto const &[name, val] : source.get_macros()) {
-        opt.AddMacroDefinition(name.c_str(), val.c_str());
+        opt.AddMacroDefinition(name.data(), val.data());
     }
     auto result = compiler.CompileGlslToSpv(source.get_code().c_str(),
         source.get_code().length(),
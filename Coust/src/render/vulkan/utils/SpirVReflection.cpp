@@ -190,8 +190,8 @@ FORCE_INLINE static void read_shader_resource_array_size(
 FORCE_INLINE static void read_shader_resource_size(
     spirv_cross::CompilerGLSL const& compiler,
     spirv_cross::Resource const& spirv_resource,
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t,
-        DefaultAlloc> const& desired_runtime_size,
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc> const&
+        desired_runtime_size,
     ShaderResource& out_shader_resource) noexcept {
     auto const& spirv_type = read_spirv_type(compiler, spirv_resource);
     size_t array_size = 0;
@@ -404,8 +404,8 @@ FORCE_INLINE static void get_shader_uniform_buffer(
     spirv_cross::CompilerGLSL const& compiler,
     spirv_cross::ShaderResources const& spirv_resources,
     VkShaderStageFlagBits stage,
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t,
-        DefaultAlloc> const& desired_runtime_size,
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc> const&
+        desired_runtime_size,
     memory::vector<ShaderResource, DefaultAlloc>&
         out_shader_resources) noexcept {
     for (auto& res : spirv_resources.uniform_buffers) {
@@ -429,8 +429,8 @@ FORCE_INLINE static void get_shader_storage_buffer(
     spirv_cross::CompilerGLSL const& compiler,
     spirv_cross::ShaderResources const& spirv_resources,
     VkShaderStageFlagBits stage,
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t,
-        DefaultAlloc> const& desired_runtime_size,
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc> const&
+        desired_runtime_size,
     memory::vector<ShaderResource, DefaultAlloc>&
         out_shader_resources) noexcept {
     for (auto& res : spirv_resources.storage_buffers) {
@@ -456,8 +456,8 @@ FORCE_INLINE static void get_shader_push_constant(
     spirv_cross::CompilerGLSL const& compiler,
     spirv_cross::ShaderResources const& spirv_resources,
     VkShaderStageFlagBits stage,
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t,
-        DefaultAlloc> const& desired_runtime_size,
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc> const&
+        desired_runtime_size,
     memory::vector<ShaderResource, DefaultAlloc>&
         out_shader_resources) noexcept {
     for (auto& res : spirv_resources.push_constant_buffers) {
@@ -506,8 +506,8 @@ FORCE_INLINE static void get_shader_specialization_constant(
 }
 
 auto spirv_reflection(std::span<const uint32_t> byte_code, int vk_shader_stage,
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t,
-        DefaultAlloc> const& desired_runtime_size) noexcept
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc> const&
+        desired_runtime_size) noexcept
     -> memory::vector<ShaderResource, DefaultAlloc> {
     try {
         spirv_cross::CompilerGLSL compiler{byte_code.data(), byte_code.size()};
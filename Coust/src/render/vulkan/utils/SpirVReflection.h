@@ -87,8 +87,8 @@ struct ShaderResource {
 namespace detail {
 
 auto spirv_reflection(std::span<const uint32_t> byte_code, int vk_shader_stage,
-    memory::robin_map_nested<memory::string<DefaultAlloc>, size_t,
-        DefaultAlloc> const &desired_runtime_size) noexcept
+    memory::flat_map<std::string_view, size_t, 4, DefaultAlloc> const
+        &desired_runtime_size) noexcept
     -> memory::vector<ShaderResource, DefaultAlloc>;
 
 }  // namespace detail
@@ -0,0 +1,122 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Log.h"
+#include "render/vulkan/utils/VulkanAllocation.h"
+
+#include <chrono>
+
+namespace coust {
+namespace render {
+
+namespace {
+
+WARNING_PUSH
+CLANG_DISABLE_WARNING("-Wexit-time-destructors")
+VulkanHostAlloc& get_vulkan_host_alloc() noexcept {
+    static VulkanHostAlloc s_vulkan_host_alloc{get_default_alloc()};
+    return s_vulkan_host_alloc;
+}
+WARNING_POP
+
+VKAPI_ATTR void* VKAPI_CALL vulkan_allocation_callback(void*, size_t size,
+    size_t alignment, VkSystemAllocationScope scope) {
+    return get_vulkan_host_alloc().allocate(size, alignment, (size_t) scope);
+}
+
+VKAPI_ATTR void* VKAPI_CALL vulkan_reallocation_callback(void*,
+    void* original, size_t size, size_t alignment,
+    VkSystemAllocationScope scope) {
+    return get_vulkan_host_alloc().reallocate(
+        original, size, alignment, (size_t) scope);
+}
+
+VKAPI_ATTR void VKAPI_CALL vulkan_free_callback(void*, void* p) {
+    get_vulkan_host_alloc().deallocate(p);
+}
+
+VKAPI_ATTR void VKAPI_CALL vulkan_internal_allocation_callback(void*,
+    size_t size, VkInternalAllocationType, VkSystemAllocationScope scope) {
+    get_vulkan_host_alloc().record_internal_allocation(size, (size_t) scope);
+}
+
+VKAPI_ATTR void VKAPI_CALL vulkan_internal_free_callback(void*, size_t size,
+    VkInternalAllocationType, VkSystemAllocationScope scope) {
+    get_vulkan_host_alloc().record_internal_deallocation(size, (size_t) scope);
+}
+
+VkAllocationCallbacks constexpr s_vulkan_alloc_callbacks{
+    .pUserData = nullptr,
+    .pfnAllocation = vulkan_allocation_callback,
+    .pfnReallocation = vulkan_reallocation_callback,
+    .pfnFree = vulkan_free_callback,
+    .pfnInternalAllocation = vulkan_internal_allocation_callback,
+    .pfnInternalFree = vulkan_internal_free_callback,
+};
+
+std::string_view constexpr get_scope_name(size_t scope) noexcept {
+    switch ((VkSystemAllocationScope) scope) {
+        case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:
+            return "Command";
+        case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:
+            return "Object";
+        case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:
+            return "Cache";
+        case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:
+            return "Device";
+        case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE:
+            return "Instance";
+        default:
+            return "Unknown";
+    }
+}
+
+}  // namespace
+
+VkAllocationCallbacks const* get_vulkan_alloc_callbacks() noexcept {
+    return &s_vulkan_alloc_callbacks;
+}
+
+VulkanHostAlloc::TagStats get_vulkan_host_allocation_stats(
+    VkSystemAllocationScope scope) noexcept {
+    return get_vulkan_host_alloc().get_stats((size_t) scope);
+}
+
+void log_vulkan_host_allocation_stats() noexcept {
+    using Clock = std::chrono::steady_clock;
+    static Clock::time_point s_last_time = Clock::now();
+    static std::array<size_t, VULKAN_ALLOCATION_SCOPE_COUNT>
+        s_last_allocation_counts{};
+
+    Clock::time_point const now = Clock::now();
+    double const seconds =
+        std::max(std::chrono::duration<double>(now - s_last_time).count(),
+            std::numeric_limits<double>::min());
+    s_last_time = now;
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    for (size_t scope = 0; scope < VULKAN_ALLOCATION_SCOPE_COUNT; ++scope) {
+        auto const tag_stats = get_vulkan_host_alloc().get_stats(scope);
+        memory::AllocationStats const& stats = tag_stats.stats;
+        size_t const allocation_count =
+            stats.allocation_count + tag_stats.reallocation_count;
+        double const rate =
+            (double) (allocation_count - s_last_allocation_counts[scope]) /
+            seconds;
+        s_last_allocation_counts[scope] = allocation_count;
+        if (allocation_count == 0 &&
+            tag_stats.internal_stats.allocation_count == 0)
+            continue;
+        COUST_INFO(
+            "Vulkan Host Memory [{}]: {} bytes live in {} blocks, {} bytes "
+            "peak, {:.1f} allocations/s, {} allocations & {} reallocations "
+            "in total, {} bytes live internally",
+            get_scope_name(scope), stats.live_size, stats.live_count,
+            stats.peak_live_size, rate, stats.allocation_count,
+            tag_stats.reallocation_count, tag_stats.internal_stats.live_size);
+    }
+    WARNING_POP
+}
+
+}  // namespace render
+}  // namespace coust
@@ -1,3 +1,38 @@
 #pragma once
 
-#define COUST_VULKAN_ALLOC_CALLBACK nullptr
+#include "utils/Compiler.h"
+#include "core/Memory.h"
+#include "utils/allocators/CallbackAllocator.h"
+
+WARNING_PUSH
+DISABLE_ALL_WARNING
+#include "volk.h"
+WARNING_POP
+
+namespace coust {
+namespace render {
+
+// command, object, cache, device & instance
+size_t constexpr VULKAN_ALLOCATION_SCOPE_COUNT =
+    (size_t) VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+using VulkanHostAlloc =
+    memory::CallbackAllocator<DefaultAlloc, VULKAN_ALLOCATION_SCOPE_COUNT>;
+
+// The host memory of the driver & VMA comes from the default allocator
+// instead of libc, and it's accounted per `VkSystemAllocationScope`, e.g.
+// the command scope is the transient memory of pipeline & descriptor creation.
+VkAllocationCallbacks const* get_vulkan_alloc_callbacks() noexcept;
+
+VulkanHostAlloc::TagStats get_vulkan_host_allocation_stats(
+    VkSystemAllocationScope scope) noexcept;
+
+// log the live & peak bytes of every scope, and the allocations per second
+// since the last call
+void log_vulkan_host_allocation_stats() noexcept;
+
+}  // namespace render
+}  // namespace coust
+
+#define COUST_VULKAN_ALLOC_CALLBACK \
+    (::coust::render::get_vulkan_alloc_callbacks())
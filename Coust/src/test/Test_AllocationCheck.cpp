@@ -0,0 +1,114 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/AllocationCheck.h"
+#include "utils/allocators/HeapAllocator.h"
+#include "utils/allocators/StlAdaptor.h"
+
+TEST_CASE(
+    "[Coust] [utils] [allocators] AllocationCheck" * doctest::skip(true)) {
+    using namespace coust;
+    using namespace coust::memory;
+    using Mode = AllocationCheckScope::Mode;
+
+#if !defined(COUST_REL)
+    SUBCASE("Every source is counted once") {
+        MemoryPool pool{{small_growth_factor, medium_growth_factor},
+            global_memory_pool_alignment};
+        AggregateAllocator aggregate{pool};
+        // the thread cache of the calling thread is created on first use
+        get_default_alloc().deallocate(
+            get_default_alloc().allocate(byte_64, byte_8), byte_64);
+
+        AllocationCheckScope scope{"sources", Mode::count};
+        void* const p_default = get_default_alloc().allocate(byte_64, byte_8);
+        void* const p_aggregate = aggregate.allocate(kbyte_1, byte_8);
+        {
+            std::vector<uint32_t, StdAllocator<uint32_t, DefaultAlloc>> v{
+                get_default_alloc()};
+            v.reserve(100);
+        }
+        // the checks may allocate by themselves
+        size_t const count = scope.get_allocation_count();
+        CHECK(count == 3);
+        CHECK(scope.get_allocation_size() ==
+              byte_64 + kbyte_1 + 100 * sizeof(uint32_t));
+        auto const& offenders = scope.get_offenders();
+        REQUIRE(offenders.size() == 3);
+        CHECK(offenders[0].source == AllocationSource::default_alloc);
+        CHECK(offenders[1].source == AllocationSource::aggregate);
+        CHECK(offenders[2].source == AllocationSource::std_allocator);
+        size_t const count_before_deallocation = scope.get_allocation_count();
+        aggregate.deallocate(p_aggregate, kbyte_1);
+        get_default_alloc().deallocate(p_default, byte_64);
+        // deallocation is never an offense
+        CHECK(scope.get_allocation_count() == count_before_deallocation);
+    }
+
+    #if defined(COUST_CHECK_GLOBAL_NEW)
+    SUBCASE("Global new") {
+        AllocationCheckScope scope{"global new", Mode::count};
+        // new-expressions may be elided, the allocation function can't
+        void* const p = ::operator new(byte_16);
+        size_t const count = scope.get_allocation_count();
+        CHECK(count == 1);
+        REQUIRE(scope.get_offenders().size() == 1);
+        CHECK(scope.get_offenders()[0].source == AllocationSource::global_new);
+        ::operator delete(p);
+        CHECK(scope.get_allocation_count() == count);
+    }
+    #endif
+
+    SUBCASE("Arena only counts when it overflows") {
+        FrameArena arena{2, byte_256};
+        AllocationCheckScope scope{"arena", Mode::count};
+        std::vector<uint32_t, StdAllocator<uint32_t, FrameArena>> v{arena};
+        v.reserve(byte_128 / sizeof(uint32_t));
+        size_t const count_in_arena = scope.get_allocation_count();
+        v.reserve(byte_256);
+        size_t const count_overflow = scope.get_allocation_count();
+        CHECK(count_in_arena == 0);
+        REQUIRE(count_overflow == 1);
+        CHECK(scope.get_offenders()[0].source ==
+              AllocationSource::std_allocator);
+    }
+
+    SUBCASE("Nested scopes") {
+        HeapAllocator heap{};
+        AllocationCheckScope outer{"outer", Mode::count};
+        void* const p0 = heap.allocate(byte_16, byte_8);
+        size_t inner_count = 0;
+        {
+            AllocationCheckScope inner{"inner", Mode::count};
+            void* const p1 = heap.allocate(byte_16, byte_8);
+            void* const p2 = heap.allocate(byte_16, byte_8);
+            inner_count = inner.get_allocation_count();
+            heap.deallocate(p2, byte_16);
+            heap.deallocate(p1, byte_16);
+        }
+        size_t const outer_count = outer.get_allocation_count();
+        CHECK(inner_count == 2);
+        CHECK(outer_count == 1);
+        heap.deallocate(p0, byte_16);
+    }
+
+    SUBCASE("Offenders are capped") {
+        size_t constexpr count = 100;
+        std::vector<void*> ptrs{};
+        ptrs.reserve(count);
+        HeapAllocator heap{};
+        AllocationCheckScope scope{"capped", Mode::count};
+        for (size_t i = 0; i < count; ++i) {
+            ptrs.push_back(heap.allocate(byte_16, byte_8));
+        }
+        CHECK(scope.get_allocation_count() == count);
+        CHECK(scope.get_offenders().size() ==
+              AllocationCheckScope::MAX_OFFENDER_COUNT);
+        for (void* p : ptrs) {
+            heap.deallocate(p, byte_16);
+        }
+    }
+#endif
+}
@@ -0,0 +1,124 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/AllocationStats.h"
+
+TEST_CASE("[Coust] [utils] [allocators] AllocationStats" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    SUBCASE("Counters") {
+        AllocationStats stats{};
+        stats.record_allocation(1);
+        stats.record_allocation(100);
+        stats.record_allocation(128);
+        stats.record_deallocation(100);
+        CHECK(stats.live_size == 129);
+        CHECK(stats.peak_live_size == 229);
+        CHECK(stats.live_count == 2);
+        CHECK(stats.allocation_count == 3);
+        CHECK(stats.deallocation_count == 1);
+        CHECK(stats.size_histogram[0] == 1);
+        CHECK(stats.size_histogram[7] == 2);
+        stats.reserved_size = 258;
+        CHECK(stats.get_fragmentation_ratio() == doctest::Approx(0.5));
+    }
+
+    SUBCASE("AggregateAllocator & MemoryPool") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        AggregateAllocator alloc{mp};
+        std::vector<void*> small_ptrs{};
+        for (size_t i = 0; i < 10; ++i) {
+            small_ptrs.push_back(alloc.allocate(byte_32, alignof(uint32_t)));
+        }
+        void* medium_ptr = alloc.allocate(kbyte_3, alignof(uint32_t));
+        void* giant_ptr = alloc.allocate(2 * kbyte_50, alignof(uint32_t));
+        alloc.deallocate(small_ptrs.back(), byte_32);
+        small_ptrs.pop_back();
+
+        auto const small_stats =
+            alloc.get_stats(size_class::get_index(byte_32));
+        CHECK(small_stats.live_size == 9 * byte_32);
+        CHECK(small_stats.peak_live_size == 10 * byte_32);
+        CHECK(small_stats.allocation_count == 10);
+        CHECK(small_stats.deallocation_count == 1);
+        CHECK(small_stats.reserved_size == small_growth_factor);
+        CHECK(small_stats.get_fragmentation_ratio() ==
+              doctest::Approx(1.0 - 9.0 * byte_32 / small_growth_factor));
+
+        auto const medium_stats =
+            alloc.get_stats(AggregateAllocator::STATS_SLOT_COUNT - 3);
+        CHECK(medium_stats.live_size == kbyte_3);
+        CHECK(medium_stats.reserved_size == medium_growth_factor);
+        auto const giant_stats =
+            alloc.get_stats(AggregateAllocator::STATS_SLOT_COUNT - 1);
+        CHECK(giant_stats.live_count == 1);
+        CHECK(giant_stats.get_fragmentation_ratio() == 0.0);
+
+        // the pool has lent one area to the small class, and another to the
+        // medium allocator
+        for (size_t i = 0; i < mp.get_pool_count(); ++i) {
+            auto const pool_stats = mp.get_stats(i);
+            size_t const expected_live =
+                mp.get_area_size(i) == large_growth_factor ? 0u : 1u;
+            CHECK(pool_stats.live_count == expected_live);
+            CHECK(pool_stats.live_size == expected_live * mp.get_area_size(i));
+        }
+
+        std::string json{};
+        alloc.dump_stats_json(json);
+        CHECK(json.front() == '{');
+        CHECK(json.back() == '}');
+        CHECK(std::ranges::count(json, '{') == std::ranges::count(json, '}'));
+        CHECK(std::ranges::count(json, '[') == std::ranges::count(json, ']'));
+        CHECK(json.find("\"giant\":{\"live_size\":102400") !=
+              std::string::npos);
+        json.clear();
+        mp.dump_stats_json(json);
+        CHECK(std::ranges::count(json, '{') == std::ranges::count(json, '}'));
+        CHECK(json.find("\"area_size\":1024") != std::string::npos);
+
+        for (void* p : small_ptrs) {
+            alloc.deallocate(p, byte_32);
+        }
+        alloc.deallocate(medium_ptr, kbyte_3);
+        alloc.deallocate(giant_ptr, 2 * kbyte_50);
+        CHECK(alloc.get_stats(size_class::get_index(byte_32)).live_count == 0);
+    }
+
+    SUBCASE("ThreadCachedAllocator") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        ThreadCachedAllocator alloc{mp};
+        size_t const slot = size_class::get_index(byte_16);
+        void* p = alloc.allocate(byte_16, alignof(uint32_t));
+        void* q = alloc.allocate(12, alignof(uint32_t));
+        auto stats = alloc.get_stats(slot);
+        // the magazine is refilled in batches
+        CHECK(stats.live_count > 2);
+        // but the counts are the callers' requests
+        CHECK(stats.allocation_count == 2);
+        CHECK(stats.deallocation_count == 0);
+        CHECK(stats.size_histogram[AllocationStats::get_histogram_bucket(
+                  byte_16)] == 2);
+        alloc.deallocate(q, 12);
+        // the counts of a thread are kept after its cache is released
+        std::thread{[&]() {
+            alloc.deallocate(
+                alloc.allocate(byte_16, alignof(uint32_t)), byte_16);
+        }}.join();
+        stats = alloc.get_stats(slot);
+        CHECK(stats.allocation_count == 3);
+        CHECK(stats.deallocation_count == 2);
+        alloc.deallocate(p, byte_16);
+        std::string const json = alloc.dump_stats_json();
+        CHECK(json.starts_with("{\"allocator\":{\"size_classes\":[{"));
+        CHECK(json.find("\"memory_pool\":{") != std::string::npos);
+    }
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/AllocationTrace.h"
+#include "utils/allocators/HeapAllocator.h"
+
+TEST_CASE("[Coust] [utils] [allocators] AllocationTrace" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    std::filesystem::path const path =
+        std::filesystem::temp_directory_path() / "coust_allocation_trace.bin";
+
+    SUBCASE("Record & replay") {
+        {
+            MemoryPool mp{
+                {small_growth_factor, medium_growth_factor},
+                global_memory_pool_alignment
+            };
+            AggregateAllocator alloc{mp};
+            // not in the trace
+            void* before = alloc.allocate(byte_64, alignof(uint32_t));
+            alloc.start_trace(path);
+            std::vector<std::pair<void*, size_t>> ptrs{};
+            for (size_t i = 0; i < 10000; ++i) {
+                size_t const size = (i * 37) % (2 * kbyte_50) + 1;
+                ptrs.emplace_back(
+                    alloc.allocate(size, alignof(uint32_t)), size);
+                if (i % 3 == 0) {
+                    alloc.deallocate(ptrs.back().first, ptrs.back().second);
+                    ptrs.pop_back();
+                }
+            }
+            alloc.deallocate(before, byte_64);
+            for (auto const& [p, size] : ptrs) {
+                alloc.deallocate(p, size);
+            }
+            CHECK(alloc.stop_trace() == 10000 + 3334 + 1 + 6666);
+            // recording is stopped
+            void* after = alloc.allocate(byte_64, alignof(uint32_t));
+            alloc.deallocate(after, byte_64);
+        }
+
+        auto const events = read_allocation_trace(path);
+        REQUIRE(events.size() == 10000 + 3334 + 1 + 6666);
+        CHECK(events[0].kind == AllocationEvent::Kind::allocate);
+        CHECK(events[0].size == 1);
+        CHECK(events[0].alignment == alignof(uint32_t));
+        CHECK(events[0].size_class == size_class::get_index(1));
+        CHECK(events[1].kind == AllocationEvent::Kind::deallocate);
+        CHECK(events[1].address == events[0].address);
+        CHECK(std::ranges::is_sorted(events, {}, &AllocationEvent::timestamp));
+        CHECK(std::ranges::all_of(events,
+            [&](auto const& e) { return e.thread == events[0].thread; }));
+
+        HeapAllocator heap{};
+        auto const report = replay_allocation_trace(events, heap);
+        // the deallocation of `before` is skipped
+        CHECK(report.operation_count == events.size() - 1);
+        CHECK(report.failed_count == 0);
+        CHECK(report.peak_live_size > 0);
+        CHECK(report.get_operations_per_second() > 0.0);
+        CHECK(report.get_fragmentation_ratio() >= 0.0);
+        CHECK(report.get_fragmentation_ratio() < 1.0);
+
+        std::filesystem::remove(path);
+    }
+
+    SUBCASE("Thread caches record the calls, not their batches") {
+        {
+            MemoryPool mp{
+                {small_growth_factor, medium_growth_factor},
+                global_memory_pool_alignment
+            };
+            ThreadCachedAllocator alloc{mp};
+            alloc.start_trace(path);
+            std::vector<void*> ptrs{};
+            for (size_t i = 0; i < 100; ++i) {
+                ptrs.push_back(alloc.allocate(24, alignof(uint64_t)));
+            }
+            for (void* p : ptrs) {
+                alloc.deallocate(p, 24);
+            }
+            CHECK(alloc.stop_trace() == 200);
+        }
+
+        auto const events = read_allocation_trace(path);
+        REQUIRE(events.size() == 200);
+        CHECK(std::ranges::all_of(events, [](auto const& e) {
+            return e.size == 24 && e.size_class == size_class::get_index(24);
+        }));
+        CHECK(events[0].alignment == alignof(uint64_t));
+        CHECK(events[100].kind == AllocationEvent::Kind::deallocate);
+        CHECK(events[100].address == events[0].address);
+
+        std::filesystem::remove(path);
+    }
+
+    SUBCASE("Slots of reused addresses") {
+        std::vector<AllocationEvent> events{
+            {.address = 16, .size = 8, .kind = AllocationEvent::Kind::allocate},
+            {.address = 16, .size = 8,
+             .kind = AllocationEvent::Kind::deallocate},
+            {.address = 16, .size = 8, .kind = AllocationEvent::Kind::allocate},
+            {.address = 32, .size = 8,
+             .kind = AllocationEvent::Kind::deallocate},
+            {.address = 16, .size = 8,
+             .kind = AllocationEvent::Kind::deallocate},
+        };
+        auto const [event_slots, slot_count] =
+            coust::memory::detail::resolve_replay_slots(events);
+        CHECK(slot_count == 2);
+        CHECK(event_slots ==
+              std::vector<uint32_t>{0, 0, 1,
+                  coust::memory::detail::INVALID_SLOT, 1});
+    }
+}
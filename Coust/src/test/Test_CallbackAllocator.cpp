@@ -0,0 +1,107 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/CallbackAllocator.h"
+#include "utils/allocators/HeapAllocator.h"
+#include "utils/allocators/MonotonicAllocator.h"
+
+TEST_CASE(
+    "[Coust] [utils] [allocators] CallbackAllocator" * doctest::skip(true)) {
+    using namespace coust;
+    using namespace coust::memory;
+
+    HeapAllocator upstream{};
+    CallbackAllocator<HeapAllocator, 3> alloc{upstream};
+
+    SUBCASE("Alignment") {
+        for (size_t alignment = 1; alignment <= kbyte_1; alignment *= 2) {
+            void* const p = alloc.allocate(byte_64, alignment, 0);
+            REQUIRE(p != nullptr);
+            CHECK(ptr_math::is_aligned(p, alignment));
+            std::memset(p, 0xcd, byte_64);
+            alloc.deallocate(p);
+        }
+        CHECK(alloc.get_stats(0).stats.live_count == 0);
+    }
+
+    SUBCASE("Tiny blocks of the default allocator") {
+        // the upstream blocks of the size classes aren't all 16 B aligned
+        CallbackAllocator<DefaultAlloc, 1> da{get_default_alloc()};
+        std::vector<std::pair<uint8_t*, size_t>> blocks{};
+        for (size_t size = 1; size <= byte_64; ++size) {
+            uint8_t* const p = (uint8_t*) da.allocate(size, byte_16, 0);
+            REQUIRE(p != nullptr);
+            CHECK(ptr_math::is_aligned(p, byte_16));
+            std::memset(p, (int) size, size);
+            blocks.emplace_back(p, size);
+        }
+        // no block overruns its upstream block into a neighbouring one
+        for (auto const [p, size] : blocks) {
+            CHECK(std::all_of(
+                p, p + size, [size](uint8_t v) { return v == (uint8_t) size; }));
+            da.deallocate(p);
+        }
+        CHECK(da.get_stats(0).stats.live_count == 0);
+    }
+
+    SUBCASE("Stats per tag") {
+        void* const p0 = alloc.allocate(byte_128, byte_8, 0);
+        void* const p1 = alloc.allocate(byte_256, byte_8, 1);
+        void* const p2 = alloc.allocate(byte_64, byte_8, 1);
+        alloc.record_internal_allocation(kbyte_1, 2);
+        CHECK(alloc.get_stats(0).stats.live_size == byte_128);
+        CHECK(alloc.get_stats(1).stats.live_size == byte_256 + byte_64);
+        CHECK(alloc.get_stats(1).stats.live_count == 2);
+        CHECK(alloc.get_stats(2).stats.live_size == 0);
+        CHECK(alloc.get_stats(2).internal_stats.live_size == kbyte_1);
+        alloc.deallocate(p1);
+        alloc.record_internal_deallocation(kbyte_1, 2);
+        auto const stats = alloc.get_stats(1);
+        CHECK(stats.stats.live_size == byte_64);
+        CHECK(stats.stats.peak_live_size == byte_256 + byte_64);
+        CHECK(stats.stats.allocation_count == 2);
+        CHECK(alloc.get_stats(2).internal_stats.live_size == 0);
+        alloc.deallocate(p0);
+        alloc.deallocate(p2);
+        alloc.deallocate(nullptr);
+        CHECK(alloc.get_stats(0).stats.live_size == 0);
+        CHECK(alloc.get_stats(1).stats.live_size == 0);
+    }
+
+    SUBCASE("Reallocation") {
+        uint8_t* p = (uint8_t*) alloc.reallocate(nullptr, byte_16, byte_8, 0);
+        REQUIRE(p != nullptr);
+        std::iota(p, p + byte_16, uint8_t{0});
+        // shrinking stays in place
+        CHECK(alloc.reallocate(p, byte_8, byte_8, 0) == p);
+        CHECK(alloc.get_stats(0).stats.live_size == byte_8);
+        // a stricter alignment moves the block
+        p = (uint8_t*) alloc.reallocate(p, kbyte_1, byte_256, 1);
+        REQUIRE(p != nullptr);
+        CHECK(ptr_math::is_aligned(p, byte_256));
+        CHECK(std::ranges::equal(std::span{p, byte_8},
+            std::views::iota(uint8_t{0}, uint8_t{byte_8})));
+        CHECK(alloc.get_stats(0).stats.live_size == 0);
+        CHECK(alloc.get_stats(0).reallocation_count == 1);
+        CHECK(alloc.get_stats(1).stats.live_size == kbyte_1);
+        CHECK(alloc.get_stats(1).reallocation_count == 1);
+        CHECK(alloc.reallocate(p, 0, byte_256, 1) == nullptr);
+        CHECK(alloc.get_stats(1).stats.live_size == 0);
+    }
+
+    SUBCASE("Growing in place") {
+        std::array<uint8_t, kbyte_1> area{};
+        MonotonicAllocator monotonic{
+            area.data(), ptr_math::add(area.data(), area.size())};
+        CallbackAllocator<MonotonicAllocator, 1> ma{monotonic};
+        void* const p = ma.reallocate(nullptr, byte_16, byte_8, 0);
+        REQUIRE(p != nullptr);
+        CHECK(ma.reallocate(p, byte_512, byte_8, 0) == p);
+        auto const stats = ma.get_stats(0);
+        CHECK(stats.stats.live_size == byte_512);
+        CHECK(stats.reallocation_count == 1);
+        ma.deallocate(p);
+    }
+}
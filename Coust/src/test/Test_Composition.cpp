@@ -0,0 +1,152 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/Composition.h"
+#include "utils/allocators/GrowthPolicy.h"
+#include "utils/allocators/HeapAllocator.h"
+#include "utils/allocators/MemoryPool.h"
+#include "utils/allocators/MonotonicAllocator.h"
+#include "utils/allocators/PoolAllocator.h"
+#include "utils/allocators/SmartPtr.h"
+#include "utils/allocators/TLSFAllocator.h"
+
+TEST_CASE("[Coust] [utils] [allocators] Composition" * doctest::skip(true)) {
+    using namespace coust;
+    using namespace coust::memory;
+
+    using Pool =
+        GrowableAllocator<GrowthType::attached, kbyte_1, PoolAllocator>;
+    using General =
+        GrowableAllocator<GrowthType::attached, kbyte_5, TLSFAllocator>;
+    using Buckets = Bucketizer<Pool, 0, byte_128, byte_32>;
+    using Composed = Segregator<byte_128, Buckets, General>;
+
+    MemoryPool pool{{kbyte_1, kbyte_5}, DEFAULT_ALIGNMENT};
+
+    static_assert(memory::detail::FixedSizeAllocator<Composed>);
+    static_assert(memory::detail::ExpandableAllocator<Composed>);
+    static_assert(memory::detail::OwningAllocator<Composed>);
+    static_assert(!memory::detail::is_concurrent_allocator<Composed>);
+
+    SUBCASE("Segregator & bucketizer") {
+        static_assert(Buckets::BUCKET_COUNT == 4);
+        CHECK(Buckets::get_bucket_index(1) == 0);
+        CHECK(Buckets::get_bucket_index(byte_32) == 0);
+        CHECK(Buckets::get_bucket_index(byte_32 + 1) == 1);
+        CHECK(Buckets::get_bucket_index(byte_128) == 3);
+
+        Composed alloc{std::piecewise_construct, std::forward_as_tuple(pool),
+            std::forward_as_tuple(pool)};
+        std::vector<std::pair<uint8_t*, size_t>> blocks{};
+        for (size_t size = 1; size <= kbyte_1; size += 7) {
+            uint8_t* const p = (uint8_t*) alloc.allocate(size, byte_8);
+            REQUIRE(p != nullptr);
+            std::memset(p, uint8_t(size), size);
+            blocks.emplace_back(p, size);
+        }
+        for (auto const& [p, size] : blocks) {
+            CHECK(alloc.contained(p));
+            // the pool of each bucket serves its largest size
+            if (size <= byte_128) {
+                size_t const bucket_idx = Buckets::get_bucket_index(size);
+                CHECK(alloc.get_small().get_bucket(bucket_idx).contained(p));
+            } else {
+                CHECK(alloc.get_large().contained(p));
+            }
+        }
+        for (auto const& [p, size] : blocks) {
+            CHECK(std::all_of(
+                p, p + size, [size](uint8_t b) { return b == uint8_t(size); }));
+            alloc.deallocate(p, size);
+        }
+        int i = 0;
+        CHECK_FALSE(alloc.contained(&i));
+    }
+
+    SUBCASE("Fixed sizes are dispatched at compile time") {
+        Composed alloc{std::piecewise_construct, std::forward_as_tuple(pool),
+            std::forward_as_tuple(pool)};
+        void* const small = alloc.allocate_fixed<byte_64, byte_8>();
+        void* const large = alloc.allocate_fixed<byte_256, byte_8>();
+        CHECK(alloc.get_small().get_bucket(1).contained(small));
+        CHECK(alloc.get_large().contained(large));
+        alloc.deallocate_fixed<byte_64>(small);
+        alloc.deallocate_fixed<byte_256>(large);
+    }
+
+    SUBCASE("Try expand") {
+        Composed alloc{std::piecewise_construct, std::forward_as_tuple(pool),
+            std::forward_as_tuple(pool)};
+        void* const p = alloc.allocate(byte_256, byte_8);
+        void* const q = alloc.allocate(byte_64, byte_8);
+        // never across the threshold or the buckets
+        CHECK_FALSE(alloc.try_expand(q, byte_64, byte_256));
+        CHECK_FALSE(alloc.try_expand(q, byte_64, byte_128));
+        CHECK_FALSE(alloc.try_expand(p, byte_256, byte_64));
+        CHECK(alloc.try_expand(p, byte_256, byte_512));
+        alloc.deallocate(p, byte_512);
+        alloc.deallocate(q, byte_64);
+    }
+
+    SUBCASE("Fallback") {
+        using Primary = AreaAllocator<MonotonicAllocator>;
+        alignas(byte_64) std::array<char, byte_256> stack_area{};
+        FallbackAllocator<Primary, HeapAllocator> alloc{
+            std::piecewise_construct, std::forward_as_tuple(stack_area),
+            std::tuple<>{}};
+        std::vector<void*> ptrs{};
+        for (size_t i = 0; i < 8; ++i) {
+            ptrs.push_back(alloc.allocate(byte_64, byte_8));
+            REQUIRE(ptrs.back() != nullptr);
+        }
+        size_t const on_stack_count =
+            (size_t) std::ranges::count_if(ptrs, [&alloc](void* p) {
+                return alloc.get_primary().contained(p);
+            });
+        CHECK(on_stack_count == byte_256 / byte_64);
+        for (void* p : ptrs) {
+            alloc.deallocate(p, byte_64);
+        }
+    }
+
+    SUBCASE("Stats") {
+        StatsWrapper<Composed> alloc{std::piecewise_construct,
+            std::forward_as_tuple(pool), std::forward_as_tuple(pool)};
+        void* const p0 = alloc.allocate(byte_32, byte_8);
+        void* const p1 = alloc.allocate(kbyte_1, byte_8);
+        void* const p2 = alloc.allocate_fixed<byte_128, byte_8>();
+        AllocationStats stats = alloc.get_stats();
+        CHECK(stats.live_size == byte_32 + kbyte_1 + byte_128);
+        CHECK(stats.live_count == 3);
+        alloc.deallocate(p1, kbyte_1);
+        alloc.deallocate(p0, byte_32);
+        alloc.deallocate_fixed<byte_128>(p2);
+        stats = alloc.get_stats();
+        CHECK(stats.live_size == 0);
+        CHECK(stats.peak_live_size == byte_32 + kbyte_1 + byte_128);
+        CHECK(stats.allocation_count == 3);
+        CHECK(stats.deallocation_count == 3);
+    }
+
+    SUBCASE("Smart pointers") {
+        struct Obj {
+            int* destruct_count;
+            std::array<uint8_t, 40> payload{};
+
+            Obj(int* count) noexcept : destruct_count(count) {}
+
+            ~Obj() { (*destruct_count)++; }
+        };
+
+        Composed alloc{std::piecewise_construct, std::forward_as_tuple(pool),
+            std::forward_as_tuple(pool)};
+        int count = 0;
+        {
+            auto unique = allocate_unique<Obj>(alloc, &count);
+            std::shared_ptr<Obj> shared = allocate_shared<Obj>(alloc, &count);
+            CHECK(alloc.contained(unique.get()));
+        }
+        CHECK(count == 2);
+    }
+}
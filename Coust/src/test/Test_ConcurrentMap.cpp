@@ -0,0 +1,234 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/StlContainer.h"
+#include "utils/containers/ConcurrentMap.h"
+
+#include <thread>
+
+TEST_CASE(
+    "[Coust] [utils] [containers] Concurrent Map" * doctest::skip(false)) {
+    using namespace coust;
+
+    SUBCASE("Single thread") {
+        container::concurrent_map<uint32_t, uint32_t> m0{};
+        CHECK(m0.empty());
+        CHECK(!m0.find(1u).has_value());
+        CHECK(m0.find_or_emplace(1u, 10u) == std::make_pair(10u, true));
+        CHECK(m0.find_or_emplace(1u, 0u) == std::make_pair(10u, false));
+        CHECK(m0.find(1u) == 10u);
+        CHECK(!m0.insert_or_assign(1u, 11u));
+        CHECK(m0.insert_or_assign(2u, 20u));
+        uint32_t visited = 0;
+        CHECK(m0.visit(1u, [&](uint32_t v) { visited = v; }));
+        CHECK(visited == 11u);
+        CHECK(!m0.visit(3u, [&](uint32_t v) { visited = v; }));
+        for (uint32_t i = 0; i < 1000; ++i) {
+            m0.find_or_emplace(i, i);
+        }
+        CHECK(m0.size() == 1000);
+        uint64_t sum = 0;
+        m0.for_each([&](uint32_t k, uint32_t) { sum += k; });
+        CHECK(sum == 999u * 1000u / 2u);
+        CHECK(m0.erase(0u) == 1);
+        CHECK(m0.erase(0u) == 0);
+        CHECK(m0.erase_if([](uint32_t k, uint32_t) { return k % 2 == 0; }) ==
+              499);
+        CHECK(m0.size() == 500);
+        CHECK(m0.contains(1u));
+        CHECK(!m0.contains(2u));
+        m0.clear();
+        CHECK(m0.empty());
+    }
+
+    SUBCASE("Transparent lookup") {
+        container::concurrent_map<std::string, uint32_t, string_hash,
+            std::equal_to<>>
+            m0{};
+        CHECK(m0.find_or_emplace("One", 1u).second);
+        CHECK(!m0.find_or_emplace(std::string_view{"One"}, 0u).second);
+        CHECK(m0.find(std::string_view{"One"}) == 1u);
+        CHECK(m0.contains("One"));
+        CHECK(m0.erase("One") == 1);
+    }
+
+    SUBCASE("Keys made with the allocator of the map") {
+        memory::concurrent_map<memory::string<DefaultAlloc>, uint32_t,
+            DefaultAlloc>
+            m0{get_default_alloc()};
+        std::string_view constexpr long_key =
+            "a key that never fits in the small string buffer";
+        // a default constructed `StdAllocator` has no allocator behind it, a
+        // key made without the allocator of the map couldn't hold this string
+        CHECK(m0.find_or_emplace(long_key, 1u).second);
+        CHECK(m0.find(long_key) == 1u);
+        m0.clear();
+    }
+
+    SUBCASE("Every value is made once") {
+        container::concurrent_map<uint32_t, uint32_t> m0{};
+        uint32_t constexpr key_cnt = 2000;
+        size_t constexpr thread_cnt = 8;
+        std::atomic<uint32_t> made_cnt = 0;
+        std::array<std::atomic<uint32_t>, thread_cnt> wrong_cnt{};
+        std::vector<std::thread> threads{};
+        for (size_t t = 0; t < thread_cnt; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t i = 0; i < key_cnt; ++i) {
+                    // every thread walks the keys from a different place
+                    uint32_t const key = (i + (uint32_t) t * 97u) % key_cnt;
+                    auto const [v, _] = m0.find_or_emplace_with(key, [&]() {
+                        made_cnt.fetch_add(1, std::memory_order_relaxed);
+                        return key * 3u;
+                    });
+                    if (v != key * 3u)
+                        wrong_cnt[t].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(made_cnt.load() == key_cnt);
+        CHECK(m0.size() == key_cnt);
+        for (auto const& cnt : wrong_cnt) {
+            CHECK(cnt.load() == 0);
+        }
+    }
+
+    SUBCASE("RCU snapshots") {
+        container::rcu_map<uint32_t, uint32_t> m0{};
+        CHECK(m0.find_or_emplace(1u, 10u) == std::make_pair(10u, true));
+        auto const snapshot = m0.snapshot();
+        CHECK(m0.find_or_emplace(2u, 20u).second);
+        CHECK(!m0.find_or_emplace(2u, 0u).second);
+        // a snapshot never changes under its reader
+        CHECK(snapshot->size() == 1);
+        CHECK(!snapshot->contains(2u));
+        CHECK(m0.find(2u) == 20u);
+        CHECK(m0.erase(1u) == 1);
+        CHECK(m0.erase(1u) == 0);
+        CHECK(snapshot->contains(1u));
+        CHECK(m0.size() == 1);
+        m0.clear();
+        CHECK(m0.empty());
+    }
+
+    SUBCASE("RCU readers alongside a writer") {
+        container::rcu_map<uint32_t, uint32_t> m0{};
+        uint32_t constexpr key_cnt = 500;
+        std::atomic<bool> done = false;
+        std::atomic<uint32_t> wrong_cnt = 0;
+        std::vector<std::thread> readers{};
+        for (size_t t = 0; t < 4; ++t) {
+            readers.emplace_back([&]() {
+                while (!done.load(std::memory_order_acquire)) {
+                    auto const snapshot = m0.snapshot();
+                    // keys are published in order, a snapshot holds a prefix
+                    uint32_t const size = (uint32_t) snapshot->size();
+                    for (uint32_t i = 0; i < size; ++i) {
+                        auto const iter = snapshot->find(i);
+                        if (iter == snapshot->end() || iter->second != i + 1)
+                            wrong_cnt.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (uint32_t i = 0; i < key_cnt; ++i) {
+            m0.find_or_emplace(i, i + 1);
+        }
+        done.store(true, std::memory_order_release);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        CHECK(wrong_cnt.load() == 0);
+        CHECK(m0.size() == key_cnt);
+    }
+}
+
+TEST_CASE("[Coust] [utils] [containers] Concurrent Map Benchmark" *
+          doctest::skip(true)) {
+    using namespace coust;
+
+    uint32_t constexpr key_cnt = 1 << 14;
+    size_t constexpr op_cnt = 4'000'000;
+
+    // a robin map behind one lock, how the caches would be shared otherwise
+    struct locked_map {
+        uint32_t find_or_emplace(uint32_t key) {
+            std::lock_guard<std::mutex> lock{mutex};
+            return map.try_emplace(key, key).first->second;
+        }
+
+        std::mutex mutex{};
+        container::robin_map<uint32_t, uint32_t> map{};
+    };
+
+    // each thread does its share of the operations, mostly hits after the
+    // first touches of every key, like a warmed up cache. `make_op` is called
+    // once per thread, so a thread can keep some state around (e.g. a snapshot)
+    auto const run = [&](size_t thread_cnt, auto&& make_op) {
+        std::vector<std::thread> threads{};
+        std::atomic<uint64_t> sum = 0;
+        auto const begin = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < thread_cnt; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 gen{(uint32_t) t};
+                std::uniform_int_distribution<uint32_t> key_dist{
+                    0, key_cnt - 1};
+                auto op = make_op();
+                uint64_t local_sum = 0;
+                for (size_t i = 0; i < op_cnt / thread_cnt; ++i) {
+                    local_sum += op(key_dist(gen));
+                }
+                sum.fetch_add(local_sum, std::memory_order_relaxed);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double const ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin)
+                              .count();
+        return std::make_pair(ms, sum.load());
+    };
+
+    for (size_t thread_cnt : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        locked_map locked{};
+        container::concurrent_map<uint32_t, uint32_t> sharded{};
+        container::rcu_map<uint32_t, uint32_t> rcu{};
+        for (uint32_t i = 0; i < key_cnt; ++i) {
+            rcu.find_or_emplace(i, i);
+        }
+        auto const [locked_ms, locked_sum] = run(thread_cnt, [&]() {
+            return [&](uint32_t key) { return locked.find_or_emplace(key); };
+        });
+        auto const [sharded_ms, sharded_sum] = run(thread_cnt, [&]() {
+            return [&](uint32_t key) {
+                return sharded.find_or_emplace(key, key).first;
+            };
+        });
+        // a snapshot per lookup, the worst case of the rcu map
+        auto const [rcu_ms, rcu_sum] = run(thread_cnt, [&]() {
+            return [&](uint32_t key) {
+                return rcu.find_or_emplace(key, key).first;
+            };
+        });
+        // a snapshot per thread, the map is fully warmed up
+        auto const [snapshot_ms, snapshot_sum] = run(thread_cnt, [&]() {
+            return [snapshot = rcu.snapshot()](uint32_t key) {
+                return snapshot->at(key);
+            };
+        });
+        CHECK(locked_sum == sharded_sum);
+        CHECK(locked_sum == rcu_sum);
+        CHECK(locked_sum == snapshot_sum);
+        MESSAGE(thread_cnt << " threads, one lock: " << locked_ms << " ms");
+        MESSAGE(thread_cnt << " threads, sharded: " << sharded_ms << " ms");
+        MESSAGE(thread_cnt << " threads, rcu: " << rcu_ms << " ms");
+        MESSAGE(thread_cnt << " threads, rcu with a snapshot per thread: "
+                           << snapshot_ms << " ms");
+    }
+}
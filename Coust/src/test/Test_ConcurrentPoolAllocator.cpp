@@ -0,0 +1,200 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/Area.h"
+#include "utils/allocators/GrowthPolicy.h"
+#include "utils/allocators/ConcurrentPoolAllocator.h"
+
+namespace {
+
+struct Payload {
+    uint32_t thread;
+    uint32_t iteration;
+    uint64_t checksum;
+
+    void fill(uint32_t t, uint32_t i) noexcept {
+        thread = t;
+        iteration = i;
+        checksum = ((uint64_t) t << 32 | i) * 0x9E3779B97F4A7C15ull;
+    }
+
+    bool is_intact(uint32_t t, uint32_t i) const noexcept {
+        return thread == t && iteration == i &&
+               checksum == ((uint64_t) t << 32 | i) * 0x9E3779B97F4A7C15ull;
+    }
+};
+
+// every thread keeps a window of live blocks and frees them in random order,
+// returns the number of blocks found corrupted
+template <typename Alloc>
+size_t churn(Alloc& alloc, uint32_t thread, size_t iteration_cnt) noexcept {
+    size_t constexpr window = 64;
+    std::mt19937 gen{thread};
+    std::vector<std::pair<Payload*, uint32_t>> live{};
+    live.reserve(window);
+    size_t corrupted_cnt = 0;
+    for (uint32_t i = 0; i < iteration_cnt; ++i) {
+        if (live.size() == window || (!live.empty() && gen() % 3 == 0)) {
+            std::swap(live[gen() % live.size()], live.back());
+            auto const [p, iteration] = live.back();
+            live.pop_back();
+            if (!p->is_intact(thread, iteration))
+                ++corrupted_cnt;
+            alloc.deallocate(p, sizeof(Payload));
+        }
+        Payload* p =
+            (Payload*) alloc.allocate(sizeof(Payload), alignof(Payload));
+        if (p == nullptr)
+            continue;
+        p->fill(thread, i);
+        live.emplace_back(p, i);
+    }
+    for (auto const& [p, iteration] : live) {
+        if (!p->is_intact(thread, iteration))
+            ++corrupted_cnt;
+        alloc.deallocate(p, sizeof(Payload));
+    }
+    return corrupted_cnt;
+}
+
+}  // namespace
+
+TEST_CASE("[Coust] [utils] [allocators] ConcurrentPoolAllocator" *
+          doctest::skip(true)) {
+    using namespace coust::memory;
+
+    size_t const thread_cnt =
+        std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+
+    SUBCASE("Single thread") {
+        size_t constexpr node_cnt = 100;
+        ConcurrentPoolAllocator probe{sizeof(Payload)};
+        Area area{node_cnt * probe.get_node_stride(),
+            alignof(std::max_align_t)};
+        ConcurrentPoolAllocator pa{area.begin(), area.end(), sizeof(Payload)};
+        std::set<void*> ptrs{};
+        for (size_t i = 0; i < node_cnt; ++i) {
+            void* p = pa.allocate(sizeof(Payload), alignof(Payload));
+            REQUIRE(p != nullptr);
+            CHECK(area.contained(p));
+            ptrs.insert(p);
+        }
+        CHECK(ptrs.size() == node_cnt);
+        CHECK(pa.allocate(sizeof(Payload), alignof(Payload)) == nullptr);
+        for (void* p : ptrs) {
+            pa.deallocate(p, sizeof(Payload));
+        }
+        // the freed nodes are handed out again
+        for (size_t i = 0; i < node_cnt; ++i) {
+            CHECK(ptrs.contains(
+                pa.allocate(sizeof(Payload), alignof(Payload))));
+        }
+    }
+
+    SUBCASE("Shared fixed pool") {
+        size_t constexpr iteration_cnt = 100000;
+        ConcurrentPoolAllocator probe{sizeof(Payload)};
+        // fewer nodes than the threads could hold, so some allocations fail
+        // and the free list keeps running dry
+        Area area{thread_cnt * 32 * probe.get_node_stride(),
+            alignof(std::max_align_t)};
+        ConcurrentPoolAllocator pa{area.begin(), area.end(), sizeof(Payload)};
+        std::atomic<size_t> corrupted_cnt = 0;
+        std::vector<std::thread> threads{};
+        for (uint32_t t = 0; t < thread_cnt; ++t) {
+            threads.emplace_back([&, t] {
+                corrupted_cnt += churn(pa, t, iteration_cnt);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(corrupted_cnt == 0);
+        // every node is back to the free list
+        std::set<void*> ptrs{};
+        while (void* p = pa.allocate(sizeof(Payload), alignof(Payload))) {
+            ptrs.insert(p);
+        }
+        CHECK(ptrs.size() == thread_cnt * 32);
+    }
+
+    SUBCASE("Free on other threads") {
+        size_t constexpr block_cnt = 20000;
+        ConcurrentPoolAllocator probe{sizeof(Payload)};
+        Area area{block_cnt * probe.get_node_stride(),
+            alignof(std::max_align_t)};
+        ConcurrentPoolAllocator pa{area.begin(), area.end(), sizeof(Payload)};
+        // each slot is handed from its producer to its consumer through an
+        // atomic, the payload itself is synchronized by the allocator
+        std::vector<std::atomic<Payload*>> slots(block_cnt);
+        std::atomic<size_t> corrupted_cnt = 0;
+        std::vector<std::thread> threads{};
+        size_t const pair_cnt = thread_cnt / 2;
+        for (uint32_t t = 0; t < 2 * pair_cnt; ++t) {
+            threads.emplace_back([&, t] {
+                bool const is_producer = t % 2 == 0;
+                for (size_t i = t / 2; i < block_cnt; i += pair_cnt) {
+                    if (is_producer) {
+                        Payload* p = (Payload*) pa.allocate(
+                            sizeof(Payload), alignof(Payload));
+                        p->fill(0, (uint32_t) i);
+                        slots[i].store(p, std::memory_order_release);
+                    } else {
+                        Payload* p = nullptr;
+                        while (!(p = slots[i].load(std::memory_order_acquire)))
+                            std::this_thread::yield();
+                        if (!p->is_intact(0, (uint32_t) i))
+                            ++corrupted_cnt;
+                        pa.deallocate(p, sizeof(Payload));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(corrupted_cnt == 0);
+    }
+
+    SUBCASE("Alignment") {
+        size_t constexpr node_cnt = 100;
+        // the blocks are aligned even if the area or the node size isn't
+        Area area{kbyte_1 * 16, alignof(std::max_align_t)};
+        void* const begin = coust::ptr_math::add(area.begin(), 4u);
+        for (size_t const alignment : {alignof(std::max_align_t), size_t{64}}) {
+            ConcurrentPoolAllocator pa{begin, area.end(), 12, alignment};
+            CHECK(pa.get_node_stride() % alignment == 0);
+            for (size_t i = 0; i < node_cnt; ++i) {
+                void* const p = pa.allocate(12, alignment);
+                REQUIRE(p != nullptr);
+                CHECK(coust::ptr_math::is_aligned(p, alignment));
+                CHECK(p >= begin);
+                CHECK(coust::ptr_math::add(p, 12u) <= area.end());
+            }
+        }
+        // the memory pool isn't thread-safe
+        static_assert(!std::constructible_from<
+                      GrowableAllocator<GrowthType::attached, kbyte_1,
+                          ConcurrentPoolAllocator>,
+                      MemoryPool&, size_t>);
+    }
+
+    SUBCASE("Concurrent growth") {
+        size_t constexpr iteration_cnt = 20000;
+        GrowableAllocator<GrowthType::heap, kbyte_1, ConcurrentPoolAllocator>
+            ga{sizeof(Payload)};
+        std::atomic<size_t> corrupted_cnt = 0;
+        std::vector<std::thread> threads{};
+        for (uint32_t t = 0; t < thread_cnt; ++t) {
+            threads.emplace_back([&, t] {
+                corrupted_cnt += churn(ga, t, iteration_cnt);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(corrupted_cnt == 0);
+        CHECK(ga.get_reserved_size() >= kbyte_1);
+    }
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/AllocationCheck.h"
+#include "utils/allocators/StlContainer.h"
+#include "utils/containers/FlatMap.h"
+
+TEST_CASE("[Coust] [utils] [containers] Flat Map" * doctest::skip(false)) {
+    using namespace coust;
+
+    SUBCASE("Construction and Assignment") {
+        container::flat_map<std::string, uint32_t, 4> m0{
+            {"Two",   2u},
+            {"One",   1u},
+            {"Three", 3u},
+        };
+        CHECK(m0.size() == 3);
+        CHECK(m0.is_inline());
+        // sorted by the key
+        CHECK(m0.begin()->first == "One");
+        CHECK((m0.end() - 1)->first == "Two");
+        container::flat_map<std::string, uint32_t, 4> m1 = m0;
+        CHECK(m1 == m0);
+        container::flat_map<std::string, uint32_t, 4> m2 = std::move(m1);
+        CHECK(m1.empty());
+        CHECK(m2 == m0);
+        m1 = {
+            {"Four", 4u}
+        };
+        CHECK(m1 != m0);
+        m1 = m2;
+        CHECK(m1 == m0);
+        m2.swap(m1);
+        CHECK(m2.at(std::string{"Three"}) == 3u);
+    }
+
+    SUBCASE("Modifier and LookUp") {
+        container::flat_map<uint32_t, uint32_t, 4> m0{};
+        CHECK(m0.try_emplace(3u, 30u).second);
+        CHECK(m0.try_emplace(1u, 10u).second);
+        CHECK(!m0.try_emplace(3u, 0u).second);
+        CHECK(!m0.insert_or_assign(3u, 33u).second);
+        CHECK(m0.insert({2u, 20u}).second);
+        CHECK(m0.emplace(0u, 0u).second);
+        CHECK(m0.at(3u) == 33u);
+        CHECK(m0.find(4u) == m0.end());
+        CHECK(m0.is_inline());
+        // past the inline capacity, the elements move to the heap
+        CHECK(m0.try_emplace(4u, 40u).second);
+        CHECK(!m0.is_inline());
+        CHECK(m0.capacity() >= 5);
+        CHECK(std::ranges::is_sorted(m0,
+            [](auto const& l, auto const& r) { return l.first < r.first; }));
+        CHECK(m0.erase(1u) == 1);
+        CHECK(m0.erase(1u) == 0);
+        CHECK(!m0.contains(1u));
+        auto iter = m0.erase(m0.begin());
+        CHECK(iter->first == 2u);
+        CHECK(m0.size() == 3);
+        m0.clear();
+        CHECK(m0.empty());
+    }
+
+    SUBCASE("Against std::map") {
+        container::flat_map<uint32_t, uint32_t, 8> m0{};
+        std::map<uint32_t, uint32_t> ref{};
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<uint32_t> key_dist{0, 64};
+        std::uniform_int_distribution<uint32_t> op_dist{0, 2};
+        for (size_t i = 0; i < 10'000; ++i) {
+            uint32_t const key = key_dist(gen);
+            switch (op_dist(gen)) {
+                case 0:
+                    CHECK(m0.insert_or_assign(key, key * 2).second ==
+                          ref.insert_or_assign(key, key * 2).second);
+                    break;
+                case 1:
+                    CHECK(m0.erase(key) == ref.erase(key));
+                    break;
+                default:
+                    CHECK(m0.contains(key) == ref.contains(key));
+                    break;
+            }
+        }
+        REQUIRE(m0.size() == ref.size());
+        CHECK(std::equal(m0.begin(), m0.end(), ref.begin(), ref.end(),
+            [](auto const& l, auto const& r) {
+                return l.first == r.first && l.second == r.second;
+            }));
+    }
+
+    SUBCASE("Equality and hash ignore the insertion order") {
+        container::flat_map<std::string, uint32_t, 4, std::less<>> m0{};
+        container::flat_map<std::string, uint32_t, 4, std::less<>> m1{};
+        m0.try_emplace("One", 1u);
+        m0.try_emplace("Two", 2u);
+        m1.try_emplace("Two", 2u);
+        m1.try_emplace("One", 1u);
+        CHECK(m0 == m1);
+        CHECK(calc_std_hash(m0) == calc_std_hash(m1));
+        m1.insert_or_assign("One", 11u);
+        CHECK(m0 != m1);
+    }
+
+    SUBCASE("Transparent lookup") {
+        container::flat_map<std::string, uint32_t, 4, std::less<>> m0{};
+        m0.try_emplace(std::string_view{"One"}, 1u);
+        CHECK(m0.contains("One"));
+        CHECK(m0.at(std::string_view{"One"}) == 1u);
+        CHECK(m0.erase("One") == 1);
+    }
+
+#if !defined(COUST_REL)
+    SUBCASE("Copies inside the inline capacity never allocate") {
+        using Mode = memory::AllocationCheckScope::Mode;
+        memory::flat_map<uint32_t, uint64_t, 4, DefaultAlloc> m0{
+            get_default_alloc()};
+        memory::AllocationCheckScope scope{"flat map", Mode::count};
+        for (uint32_t i = 0; i < 4; ++i) {
+            m0.try_emplace(i, i);
+        }
+        memory::flat_map<uint32_t, uint64_t, 4, DefaultAlloc> m1 = m0;
+        bool const equal = m1 == m0;
+        size_t const count = scope.get_allocation_count();
+        CHECK(count == 0);
+        CHECK(equal);
+    }
+#endif
+
+    SUBCASE("Keys constructed with the allocator") {
+        memory::flat_map_nested<memory::string<DefaultAlloc>,
+            memory::string<DefaultAlloc>, 2, DefaultAlloc>
+            m0{get_default_alloc()};
+        std::string_view constexpr long_str =
+            "a string that never fits in the small string buffer";
+        // past the inline capacity as well
+        for (char c = 'a'; c < 'e'; ++c) {
+            std::string const key = std::string{c} + std::string{long_str};
+            m0.try_emplace(std::string_view{key}, long_str);
+        }
+        m0.insert_or_assign(std::string_view{long_str}, long_str);
+        auto m1 = m0;
+        CHECK(m1.size() == 5);
+        CHECK(m1.at(long_str) == long_str);
+        CHECK(m1 == m0);
+    }
+}
@@ -0,0 +1,70 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/FrameArena.h"
+#include "utils/allocators/StlAdaptor.h"
+
+TEST_CASE("[Coust] [utils] [allocators] FrameArena" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    SUBCASE("Slots are recycled in order") {
+        size_t constexpr frame_count = 3;
+        FrameArena arena{frame_count, kbyte_1};
+        std::vector<void*> first_ptrs{};
+        for (size_t frame = 0; frame < frame_count; ++frame) {
+            CHECK(arena.get_frame_idx() == frame);
+            void* p = arena.allocate(byte_64, alignof(std::max_align_t));
+            REQUIRE(p != nullptr);
+            std::memset(p, (int) frame, byte_64);
+            first_ptrs.push_back(p);
+            CHECK(arena.get_used_size() == byte_64);
+            arena.next_frame();
+        }
+        // back to the first slot, which starts from scratch
+        CHECK(arena.get_frame_idx() == 0);
+        CHECK(arena.get_used_size() == 0);
+        CHECK(arena.get_peak_used_size() == byte_64);
+        for (size_t frame = 0; frame < frame_count; ++frame) {
+            void* p = arena.allocate(byte_128, alignof(std::max_align_t));
+            CHECK(p == first_ptrs[frame]);
+            arena.next_frame();
+        }
+        CHECK(arena.get_peak_used_size() == byte_128);
+        CHECK(arena.get_overflow_count() == 0);
+    }
+
+    SUBCASE("Overflow") {
+        FrameArena arena{2, byte_256};
+        void* p1 = arena.allocate(byte_128, byte_16);
+        void* p2 = arena.allocate(byte_256, byte_16);
+        REQUIRE(p1 != nullptr);
+        REQUIRE(p2 != nullptr);
+        CHECK(arena.get_overflow_count() == 1);
+        std::memset(p2, 0xFF, byte_256);
+        arena.deallocate(p2, byte_256);
+        arena.deallocate(p1, byte_128);
+        // the slot is still usable after the overflow
+        void* p3 = arena.allocate(byte_128, byte_16);
+        CHECK(p3 == coust::ptr_math::add(p1, byte_128));
+    }
+
+    SUBCASE("Standard container") {
+        FrameArena arena{2, kbyte_5};
+        size_t constexpr frame_count = 10;
+        for (size_t frame = 0; frame < frame_count; ++frame) {
+            std::vector<uint32_t, StdAllocator<uint32_t, FrameArena>> v{
+                arena};
+            v.reserve(100);
+            for (uint32_t i = 0; i < 100; ++i) {
+                v.push_back(i * (uint32_t) frame);
+            }
+            for (uint32_t i = 0; i < 100; ++i) {
+                CHECK(v[i] == i * (uint32_t) frame);
+            }
+            CHECK(arena.get_used_size() == 100 * sizeof(uint32_t));
+            arena.next_frame();
+        }
+        CHECK(arena.get_overflow_count() == 0);
+    }
+}
@@ -50,6 +50,41 @@ TEST_CASE(
         }
     }
 
+    SUBCASE("Expand in place") {
+        size_t constexpr area_size = kbyte_1;
+        Area area{area_size, alignof(std::max_align_t)};
+        FreeListAllocator fa{area.begin(), area.end()};
+        uint8_t* p0 = (uint8_t*) fa.allocate(byte_64, alignof(uint32_t));
+        void* p1 = fa.allocate(byte_64, alignof(uint32_t));
+        void* p2 = fa.allocate(byte_64, alignof(uint32_t));
+        REQUIRE((p0 && p1 && p2));
+        std::memset(p0, 0xAB, byte_64);
+        // shrinking keeps the block as it is
+        CHECK(fa.try_expand(p0, byte_64, byte_32));
+        // the next block is in use
+        CHECK(!fa.try_expand(p0, byte_64, byte_128));
+        fa.deallocate(p1, byte_64);
+        fa.is_malfunctioning();
+        // absorb a part of the free block right after it
+        CHECK(fa.try_expand(p0, byte_64, byte_64 + byte_8));
+        fa.is_malfunctioning();
+        CHECK(std::ranges::all_of(
+            std::span{p0, byte_64}, [](uint8_t b) { return b == 0xAB; }));
+        std::memset(p0, 0xCD, byte_64 + byte_8);
+        // and some more
+        CHECK(fa.try_expand(p0, byte_64 + byte_8, byte_128));
+        fa.is_malfunctioning();
+        std::memset(p0, 0xCD, byte_128);
+        CHECK(!fa.try_expand(p0, byte_128, byte_256));
+        fa.deallocate(p0, byte_128);
+        fa.deallocate(p2, byte_64);
+        fa.is_malfunctioning();
+        // everything is merged back
+        void* whole = fa.allocate(area_size - byte_64, alignof(uint32_t));
+        CHECK(whole != nullptr);
+        fa.deallocate(whole, area_size - byte_64);
+    }
+
     SUBCASE("Manually growth") {
         MemoryPool mp{byte_32, byte_64};
         size_t constexpr experiment_cnt = 50;
@@ -0,0 +1,195 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "core/MemoryBudget.h"
+
+TEST_CASE("[Coust] [core] MemoryBudget" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    size_t constexpr soft_limit = 1000;
+    size_t constexpr hard_limit = 2000;
+
+    // every subsystem holds some bytes and releases the requested size at
+    // soft pressure, or everything at hard pressure
+    struct FakeCache {
+        size_t size;
+        std::vector<std::pair<MemoryPressure, size_t>> requests{};
+    };
+    std::array<FakeCache, 3> caches{
+        FakeCache{.size = 300},
+        FakeCache{.size = 300},
+        FakeCache{.size = 300},
+    };
+    size_t base_usage = 0;
+    auto const get_usage = [&] {
+        size_t ret = base_usage;
+        for (auto const& cache : caches) {
+            ret += cache.size;
+        }
+        return ret;
+    };
+    // every update may evict, unless a subcase says otherwise
+    MemoryBudget::Config const config{
+        .soft_limit = soft_limit,
+        .hard_limit = hard_limit,
+        .hysteresis = 0,
+        .cooldown_update_count = 0,
+    };
+    // the caches hand their bytes straight back, nothing is left to reclaim
+    size_t reclaim_count = 0;
+    auto const reclaim = [&] {
+        ++reclaim_count;
+        return size_t{0};
+    };
+    MemoryBudget budget{config, get_usage, reclaim};
+    std::array<MemoryBudget::Handle, 3> handles{};
+    for (size_t i = 0; i < caches.size(); ++i) {
+        handles[i] = budget.register_subsystem(
+            "Fake Cache", [&cache = caches[i]](MemoryPressure pressure,
+                              size_t size) {
+                cache.requests.emplace_back(pressure, size);
+                size_t const released = pressure == MemoryPressure::hard ?
+                                            cache.size :
+                                            std::min(size, cache.size);
+                cache.size -= released;
+                return released;
+            });
+    }
+
+    SUBCASE("Under the soft watermark") {
+        CHECK(budget.update() == MemoryPressure::none);
+        CHECK(budget.get_usage() == 900);
+        CHECK(std::ranges::all_of(
+            caches, [](auto const& c) { return c.requests.empty(); }));
+    }
+
+    SUBCASE("Soft pressure") {
+        base_usage = 499;
+        CHECK(budget.update() == MemoryPressure::soft);
+        // the last registered one is asked first, and the others are left
+        // alone once the usage is back under the soft watermark
+        CHECK(caches[2].requests ==
+              std::vector{std::pair{MemoryPressure::soft, size_t{399}}});
+        CHECK(caches[1].requests ==
+              std::vector{std::pair{MemoryPressure::soft, size_t{99}}});
+        CHECK(caches[0].requests.empty());
+        CHECK(budget.get_released_size() == 399);
+        // after each subsystem asked
+        CHECK(reclaim_count == 2);
+        CHECK(budget.update() == MemoryPressure::none);
+    }
+
+    SUBCASE("Only the memory which left the usage counts") {
+        // one cache frees its blocks to an allocator, which keeps them until
+        // reclaimed, and another one releases memory the usage doesn't count
+        size_t freed_size = 0;
+        MemoryBudget reclaiming_budget{
+            config, [&] { return get_usage() + freed_size; }, [&] {
+                size_t const ret = freed_size;
+                freed_size = 0;
+                return ret;
+            }};
+        std::vector<size_t> requests{};
+        reclaiming_budget.register_subsystem(
+            "Freeing Cache", [&](MemoryPressure, size_t size) {
+                requests.push_back(size);
+                size_t const released = std::min(size, caches[0].size);
+                caches[0].size -= released;
+                freed_size += released;
+                return released;
+            });
+        reclaiming_budget.register_subsystem(
+            "GPU Cache", [&](MemoryPressure, size_t size) {
+                requests.push_back(size);
+                return size;
+            });
+        base_usage = 199;
+        CHECK(reclaiming_budget.update() == MemoryPressure::soft);
+        // the gpu cache didn't lower the usage, so the other one is asked
+        // for the whole excess
+        CHECK(requests == std::vector<size_t>{99, 99});
+        CHECK(reclaiming_budget.get_reclaimed_size() == 99);
+        CHECK(reclaiming_budget.update() == MemoryPressure::none);
+        CHECK(reclaiming_budget.get_usage() == 1000);
+    }
+
+    SUBCASE("Hard pressure") {
+        base_usage = 1500;
+        CHECK(budget.update() == MemoryPressure::hard);
+        // every subsystem is notified even if the first one released enough
+        for (auto const& cache : caches) {
+            CHECK(cache.requests.size() == 1);
+            CHECK(cache.requests[0].first == MemoryPressure::hard);
+            CHECK(cache.size == 0);
+        }
+        CHECK(caches[2].requests[0].second == 1400);
+        CHECK(caches[0].requests[0].second == 800);
+        CHECK(budget.get_released_size() == 900);
+        CHECK(budget.update() == MemoryPressure::soft);
+    }
+
+    SUBCASE("Unregister & change limits") {
+        budget.unregister_subsystem(handles[2]);
+        base_usage = 500;
+        CHECK(budget.update() == MemoryPressure::soft);
+        CHECK(caches[2].requests.empty());
+        CHECK(caches[1].requests.size() == 1);
+        budget.set_config(
+            {.soft_limit = 2000, .hard_limit = 3000, .hysteresis = 0});
+        CHECK(budget.update() == MemoryPressure::none);
+    }
+
+    SUBCASE("Hysteresis") {
+        budget.set_config({.soft_limit = soft_limit,
+            .hard_limit = hard_limit,
+            .hysteresis = 100,
+            .cooldown_update_count = 0});
+        base_usage = 499;
+        CHECK(budget.update() == MemoryPressure::soft);
+        // released down to 100 bytes under the soft watermark
+        CHECK(caches[2].requests ==
+              std::vector{std::pair{MemoryPressure::soft, size_t{499}}});
+        CHECK(caches[1].requests ==
+              std::vector{std::pair{MemoryPressure::soft, size_t{199}}});
+        CHECK(budget.get_usage() == 1399);
+        CHECK(budget.update() == MemoryPressure::none);
+        CHECK(budget.get_usage() == 900);
+    }
+
+    SUBCASE("Cooldown") {
+        budget.set_config({.soft_limit = soft_limit,
+            .hard_limit = hard_limit,
+            .hysteresis = 0,
+            .cooldown_update_count = 2});
+        // the usage stays above the soft watermark whatever is released
+        base_usage = 1500;
+        caches[0].size = 0;
+        caches[1].size = 0;
+        caches[2].size = 0;
+        CHECK(budget.update() == MemoryPressure::soft);
+        CHECK(caches[2].requests.size() == 1);
+        // the subsystems are left alone for 2 updates
+        CHECK(budget.update() == MemoryPressure::soft);
+        CHECK(budget.update() == MemoryPressure::soft);
+        CHECK(caches[2].requests.size() == 1);
+        CHECK(budget.update() == MemoryPressure::soft);
+        CHECK(caches[2].requests.size() == 2);
+        // unless the pressure gets worse
+        base_usage = 2500;
+        CHECK(budget.update() == MemoryPressure::hard);
+        CHECK(caches[2].requests.size() == 3);
+        CHECK(caches[2].requests.back().first == MemoryPressure::hard);
+        CHECK(budget.update() == MemoryPressure::hard);
+        CHECK(caches[2].requests.size() == 3);
+    }
+
+    SUBCASE("Committed memory of the default allocator by default") {
+        MemoryBudget default_budget{config};
+        default_budget.update();
+        CHECK(default_budget.get_usage() > 0);
+        CHECK(default_budget.get_usage() ==
+              coust::get_default_alloc().get_committed_size());
+    }
+}
@@ -101,4 +101,90 @@ TEST_CASE("[Coust] [utils] [allocators] MemoryPool" * doctest::skip(true)) {
         CHECK((*(int*) area2.begin()) == i);
         CHECK((*(char*) area3.begin()) == c);
     }
+
+    SUBCASE("Trim releases fully free raw areas") {
+        // every raw area is split into 4 areas of 32 bytes
+        std::vector<Area> areas{};
+        for (size_t i = 0; i < 8; ++i) {
+            areas.push_back(mp.allocate_area(byte_32, DEFAULT_ALIGNMENT));
+        }
+        CHECK(mp.get_reserved_size() == 2 * byte_128);
+        // the first raw area still has an area handed out
+        for (size_t i = 1; i < areas.size(); ++i) {
+            mp.deallocate_area(std::move(areas[i]));
+        }
+        CHECK(mp.trim() == byte_128);
+        CHECK(mp.get_reserved_size() == byte_128);
+        mp.deallocate_area(std::move(areas[0]));
+        CHECK(mp.trim() == byte_128);
+        CHECK(mp.get_reserved_size() == 0);
+        CHECK(mp.get_peak_reserved_size() == 2 * byte_128);
+        // the pool still works after being trimmed
+        Area area{mp.allocate_area(byte_64, DEFAULT_ALIGNMENT)};
+        CHECK(area.size() == byte_64);
+        CHECK(mp.get_reserved_size() == byte_128);
+        mp.deallocate_area(std::move(area));
+    }
+
+    SUBCASE("High-water mark") {
+        mp.set_high_water_mark(byte_128);
+        std::vector<Area> areas{};
+        for (size_t i = 0; i < 3; ++i) {
+            areas.push_back(mp.allocate_area(byte_128, DEFAULT_ALIGNMENT));
+        }
+        CHECK(mp.get_reserved_size() == 3 * byte_128);
+        for (auto& area : areas) {
+            mp.deallocate_area(std::move(area));
+        }
+        // raw areas are released as they become free, until the mark is met
+        CHECK(mp.get_reserved_size() == byte_128);
+        CHECK(mp.get_peak_reserved_size() == 3 * byte_128);
+        CHECK(mp.trim() == byte_128);
+    }
+
+    SUBCASE("Reserve carves the areas of a pool from one raw area") {
+        std::array<size_t, 3> constexpr counts{3, 0, 2};
+        mp.reserve(counts);
+        CHECK(mp.get_reserved_size() == 3 * byte_32 + 2 * byte_128);
+        // already enough free areas, nothing more is reserved
+        mp.reserve(counts);
+        CHECK(mp.get_reserved_size() == 3 * byte_32 + 2 * byte_128);
+        std::vector<Area> areas{};
+        for (size_t i = 0; i < 3; ++i) {
+            areas.push_back(mp.allocate_area(byte_32, DEFAULT_ALIGNMENT));
+        }
+        for (size_t i = 0; i < 2; ++i) {
+            areas.push_back(mp.allocate_area(byte_128, DEFAULT_ALIGNMENT));
+        }
+        // all served by the reserved areas, which are contiguous in each pool
+        CHECK(mp.get_reserved_size() == 3 * byte_32 + 2 * byte_128);
+        auto const get_span = [](std::span<Area const> pool_areas) {
+            auto const [lowest, highest] = std::ranges::minmax(
+                pool_areas | std::views::transform([](Area const& a) {
+                    return (uint8_t*) a.begin();
+                }));
+            return (size_t) (highest - lowest);
+        };
+        CHECK(get_span(std::span{areas}.first(3)) < 3 * byte_32);
+        CHECK(get_span(std::span{areas}.last(2)) < 2 * byte_128);
+        // the first area stays in use after the warm-up
+        for (size_t i = 1; i < areas.size(); ++i) {
+            mp.deallocate_area(std::move(areas[i]));
+        }
+        // reserved areas outlive trimming during the warm-up
+        CHECK(mp.trim() == 0);
+        CHECK(mp.get_reserved_size() == 3 * byte_32 + 2 * byte_128);
+        mp.end_warm_up();
+        // but not after, each of them once none of its areas is in use, and the
+        // area in use only keeps the reserve of its own pool
+        CHECK(mp.trim() == 2 * byte_128);
+        CHECK(mp.get_reserved_size() == 3 * byte_32);
+        mp.deallocate_area(std::move(areas[0]));
+        CHECK(mp.trim() == 3 * byte_32);
+        CHECK(mp.get_reserved_size() == 0);
+        // the pool still works after its reserve is gone
+        Area area{mp.allocate_area(byte_32, DEFAULT_ALIGNMENT)};
+        CHECK(mp.get_reserved_size() == byte_128);
+        mp.deallocate_area(std::move(area));
+    }
 }
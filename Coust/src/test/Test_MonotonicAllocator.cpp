@@ -34,6 +34,23 @@ TEST_CASE(
         }
     }
 
+    SUBCASE("Expand in place") {
+        std::array<char, byte_128> stack_area{};
+        MonotonicAllocator ma{stack_area.data(),
+            coust::ptr_math::add(stack_area.data(), stack_area.size())};
+        void* p0 = ma.allocate(byte_16, alignof(float));
+        void* p1 = ma.allocate(byte_16, alignof(float));
+        // only the latest allocation can grow
+        CHECK(!ma.try_expand(p0, byte_16, byte_32));
+        CHECK(ma.try_expand(p0, byte_16, byte_8));
+        CHECK(ma.try_expand(p1, byte_16, byte_64));
+        CHECK(!ma.try_expand(p1, byte_64, byte_128));
+        // shrinking the latest allocation gives the space back
+        CHECK(ma.try_expand(p1, byte_64, byte_32));
+        void* p2 = ma.allocate(byte_16, alignof(float));
+        CHECK(p2 == coust::ptr_math::add(p1, byte_32));
+    }
+
     SUBCASE("Auto growth (attached)") {
         GrowableAllocator<GrowthType::attached, byte_64, MonotonicAllocator> ga{
             mp};
@@ -211,6 +211,22 @@ TEST_CASE(
         CHECK(std::ranges::equal(monsters, from_byte));
     }
 
+    SUBCASE("Grow byte array") {
+        // from the pool of large allocations to the giant ones
+        for (size_t size : {size_t{1024}, size_t{20} * 1024,
+                 size_t{100} * 1024}) {
+            file::ByteArray byte_array{size, alignof(uint32_t)};
+            std::memset(byte_array.data(), 0xAB, size);
+            byte_array.grow_to(2 * size);
+            CHECK(byte_array.size() == 2 * size);
+            auto const bytes = byte_array.to_span();
+            CHECK(std::ranges::all_of(bytes.first(size),
+                [](char b) { return (uint8_t) b == 0xAB; }));
+            CHECK(std::ranges::all_of(
+                bytes.last(size), [](char b) { return b == 0; }));
+        }
+    }
+
     SUBCASE("Nested vector") {
         std::vector<std::vector<float>> nested{};
         for (int i = 0; i < 30; ++i) {
@@ -5,6 +5,10 @@
 #include "utils/containers/RobinHash.h"
 #include "utils/containers/RobinSet.h"
 #include "utils/containers/RobinMap.h"
+#include "utils/containers/SwissMap.h"
+#include "utils/allocators/AllocationCheck.h"
+#include "utils/allocators/StlContainer.h"
+#include "core/Memory.h"
 
 TEST_CASE("[Coust] [utils] [containers] RobinHash" * doctest::skip(false)) {
     using namespace coust;
@@ -299,6 +303,22 @@ TEST_CASE("[Coust] [utils] [containers] RobinHash" * doctest::skip(false)) {
             CHECK(h0.contains(key));
         }
     }
+
+    SUBCASE("More buckets than the truncated hash can address") {
+        size_t constexpr exp_cnt = 200'000;
+        coust::container::robin_map<size_t, size_t> m0{};
+        for (size_t i = 0; i < exp_cnt; ++i) {
+            m0.try_emplace(i * 7, i);
+        }
+        CHECK(m0.size() == exp_cnt);
+        CHECK(m0.bucket_count() > (1u << 16));
+        bool all_found = true;
+        for (size_t i = 0; i < exp_cnt; ++i) {
+            auto iter = m0.find(i * 7);
+            all_found &= iter != m0.end() && iter->second == i;
+        }
+        CHECK(all_found);
+    }
 }
 
 TEST_CASE("[Coust] [utils] [containers] Robin Set" * doctest::skip(false)) {
@@ -449,6 +469,21 @@ TEST_CASE("[Coust] [utils] [containers] Robin Set" * doctest::skip(false)) {
             CHECK(*iter == std::string{"Three"});
         }
     }
+
+    SUBCASE("Batched LookUp") {
+        coust::container::robin_set<std::string, coust::string_hash,
+            std::equal_to<>>
+            s0{"One", "Two", "Three"};
+        std::array<std::string_view, 4> const keys{
+            "One", "Four", "Three", "Two"};
+        std::array<decltype(s0)::iterator, 4> iters{};
+        s0.find_batch(std::span<std::string_view const>{keys},
+            std::span<decltype(s0)::iterator>{iters});
+        CHECK(*iters[0] == "One");
+        CHECK(iters[1] == s0.end());
+        CHECK(*iters[2] == "Three");
+        CHECK(*iters[3] == "Two");
+    }
 }
 
 TEST_CASE("[Coust] [utils] [containers] Robin Map" * doctest::skip(false)) {
@@ -685,4 +720,165 @@ TEST_CASE("[Coust] [utils] [containers] Robin Map" * doctest::skip(false)) {
             CHECK(m == content[10].second);
         }
     }
+
+    SUBCASE("Batched LookUp") {
+        coust::container::robin_map<uint32_t, uint32_t> s0{};
+        for (uint32_t i = 0; i < 1000; ++i) {
+            s0.try_emplace(i * 2, i);
+        }
+        // more than one batch, half of them missing
+        std::vector<uint32_t> keys(100);
+        std::iota(keys.begin(), keys.end(), 900u);
+        std::vector<decltype(s0)::iterator> iters(keys.size());
+        s0.find_batch(std::span<uint32_t const>{keys}, std::span{iters});
+        for (size_t i = 0; i < keys.size(); ++i) {
+            CHECK(iters[i] == s0.find(keys[i]));
+        }
+        auto const& cs0 = s0;
+        std::vector<decltype(s0)::const_iterator> citers(keys.size());
+        cs0.find_batch(std::span<uint32_t const>{keys}, std::span{citers});
+        for (size_t i = 0; i < keys.size(); ++i) {
+            CHECK(citers[i] == cs0.find(keys[i]));
+        }
+        // nothing to find in an empty map
+        coust::container::robin_map<uint32_t, uint32_t> s1{};
+        s1.find_batch(std::span<uint32_t const>{keys}, std::span{iters});
+        for (size_t i = 0; i < keys.size(); ++i) {
+            CHECK(iters[i] == s1.end());
+        }
+    }
+}
+
+TEST_CASE("[Coust] [utils] [containers] Transparent LookUp" *
+          doctest::skip(false)) {
+    using namespace coust;
+
+    // longer than any small string buffer
+    std::string_view constexpr long_key =
+        "a key that never fits in the small string buffer";
+
+    SUBCASE("Robin Map") {
+        container::robin_map<std::string, uint32_t, string_hash,
+            std::equal_to<>>
+            s0{
+                {"One",                    1u},
+                {"Two",                    2u},
+                {std::string{long_key}, 3u},
+        };
+        CHECK(s0.at(std::string_view{"One"}) == 1u);
+        CHECK(s0.at(long_key) == 3u);
+        CHECK(s0.contains("Two"));
+        CHECK(!s0.contains(std::string_view{"Four"}));
+        auto iter = s0.find(long_key);
+        REQUIRE(iter != s0.end());
+        CHECK(iter.key() == long_key);
+        auto const& cs0 = s0;
+        CHECK(cs0.find("Two") != cs0.end());
+        CHECK(cs0.at("Two") == 2u);
+        CHECK(s0.erase(long_key) == 1);
+        CHECK(s0.erase("Four") == 0);
+        CHECK(s0.size() == 2);
+    }
+
+    SUBCASE("Robin Set") {
+        container::robin_set<std::string, string_hash, std::equal_to<>> s0{
+            "One", "Two", std::string{long_key}};
+        CHECK(s0.contains(long_key));
+        CHECK(!s0.contains("Three"));
+        auto iter = s0.find(std::string_view{"One"});
+        REQUIRE(iter != s0.end());
+        CHECK(*iter == "One");
+        CHECK(s0.erase("Two") == 1);
+        CHECK(s0.size() == 2);
+    }
+
+    SUBCASE("Swiss Map") {
+        container::swiss_map<std::string, uint32_t, string_hash,
+            std::equal_to<>>
+            s0{
+                {"One",                    1u},
+                {std::string{long_key}, 2u},
+        };
+        CHECK(s0.at(long_key) == 2u);
+        CHECK(s0.contains("One"));
+        CHECK(!s0.contains(std::string_view{"Two"}));
+        CHECK(s0.find(long_key) != s0.end());
+        CHECK(s0.erase(long_key) == 1);
+        CHECK(s0.size() == 1);
+    }
+
+#if !defined(COUST_REL)
+    SUBCASE("Lookup never allocates a key") {
+        using Mode = memory::AllocationCheckScope::Mode;
+        memory::robin_map<memory::string<DefaultAlloc>, uint32_t, DefaultAlloc>
+            s0{get_default_alloc()};
+        s0.try_emplace(
+            memory::string<DefaultAlloc>{long_key, get_default_alloc()}, 1u);
+        s0.reserve(16);
+        size_t found_cnt = 0;
+        memory::AllocationCheckScope scope{"transparent lookup", Mode::count};
+        found_cnt += s0.contains(long_key);
+        found_cnt += s0.find(long_key) != s0.end();
+        found_cnt += s0.at(long_key.data()) == 1u;
+        found_cnt += s0.contains("absent");
+        size_t const count = scope.get_allocation_count();
+        CHECK(count == 0);
+        CHECK(found_cnt == 3);
+    }
+#endif
+}
+
+TEST_CASE("[Coust] [utils] [containers] Robin Map Batched LookUp Benchmark" *
+          doctest::skip(true)) {
+    using namespace coust;
+
+    // far larger than the caches, every lookup is a miss to memory
+    size_t constexpr key_cnt = 1 << 21;
+    size_t constexpr lookup_cnt = 1 << 22;
+    size_t constexpr batch_size = 64;
+
+    std::vector<uint64_t> keys(key_cnt);
+    std::mt19937_64 gen{42};
+    std::ranges::generate(keys, [&gen]() { return gen(); });
+    container::robin_map<uint64_t, uint64_t> map{};
+    map.reserve(key_cnt);
+    for (uint64_t key : keys) {
+        map.try_emplace(key, key);
+    }
+    std::vector<uint64_t> lookups(lookup_cnt);
+    std::uniform_int_distribution<size_t> idx_dist{0, key_cnt - 1};
+    std::ranges::generate(lookups, [&]() { return keys[idx_dist(gen)]; });
+
+    auto const time = [](auto&& func) {
+        auto const begin = std::chrono::steady_clock::now();
+        uint64_t const sum = func();
+        double const ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin)
+                              .count();
+        return std::make_pair(ms, sum);
+    };
+
+    auto const [one_by_one_ms, one_by_one_sum] = time([&]() {
+        uint64_t sum = 0;
+        for (uint64_t key : lookups) {
+            sum += map.find(key)->second;
+        }
+        return sum;
+    });
+    auto const [batched_ms, batched_sum] = time([&]() {
+        uint64_t sum = 0;
+        std::array<decltype(map)::iterator, batch_size> iters{};
+        for (size_t i = 0; i < lookup_cnt; i += batch_size) {
+            map.find_batch(
+                std::span<uint64_t const>{lookups}.subspan(i, batch_size),
+                std::span{iters});
+            for (auto iter : iters) {
+                sum += iter->second;
+            }
+        }
+        return sum;
+    });
+    CHECK(one_by_one_sum == batched_sum);
+    MESSAGE("one by one: " << one_by_one_ms << " ms");
+    MESSAGE("batched: " << batched_ms << " ms");
 }
@@ -0,0 +1,86 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/AllocationCheck.h"
+#include "utils/filesystem/FileIO.h"
+#include "render/vulkan/ShaderSource.h"
+
+TEST_CASE("[Coust] [render] [vulkan] Shader Source" * doctest::skip(false)) {
+    using namespace coust;
+    using namespace coust::render;
+
+    // long enough for neither the path nor the strings to fit in their small
+    // buffers
+    std::filesystem::path const path =
+        std::filesystem::temp_directory_path() /
+        "coust_shader_source_test_with_a_rather_long_file_name.glsl";
+    std::string_view constexpr code = "void main() {}";
+    std::string_view constexpr long_name = "MACRO_WITH_A_RATHER_LONG_NAME";
+    std::string_view constexpr long_value = "a value that is rather long too";
+    {
+        std::string content{code};
+        file::write_file_whole(path, std::span<char>{content});
+    }
+
+    SUBCASE("Equality and hash ignore the insertion order") {
+        ShaderSource s0{path};
+        ShaderSource s1{path};
+        s0.add_macro(long_name, long_value);
+        s0.add_macro("ONE", "1");
+        s1.add_macro("ONE", "1");
+        s1.add_macro(long_name, long_value);
+        s0.set_dynamic_buffer_size(long_name, 16);
+        s1.set_dynamic_buffer_size(long_name, 16);
+        CHECK(s0 == s1);
+        CHECK(calc_std_hash(s0) == calc_std_hash(s1));
+        CHECK(s0.get_code() == code);
+        CHECK(s0.get_path() == path);
+        s1.add_macro("ONE", "2");
+        CHECK(!(s0 == s1));
+        CHECK(calc_std_hash(s0) != calc_std_hash(s1));
+    }
+
+#if !defined(COUST_REL)
+    SUBCASE("Copies & rebuilt sources never allocate") {
+        using Mode = memory::AllocationCheckScope::Mode;
+        ShaderSource s0{path};
+        s0.add_macro(long_name, long_value);
+        s0.add_macro("ONE", "1");
+        s0.set_dynamic_buffer_size(long_name, 16);
+        memory::AllocationCheckScope scope{"shader source", Mode::count};
+        ShaderSource const s1 = s0;
+        // the path & the strings are interned already
+        ShaderSource s2{path};
+        s2.add_macro("ONE", "1");
+        s2.add_macro(long_name, long_value);
+        s2.set_dynamic_buffer_size(long_name, 16);
+        bool const equal = s1 == s0 && s2 == s0;
+        size_t const count = scope.get_allocation_count();
+        CHECK(count == 0);
+        CHECK(equal);
+    }
+
+    SUBCASE("Eviction drops the code but keeps the hash") {
+        using Mode = memory::AllocationCheckScope::Mode;
+        ShaderSource const s0{path};
+        size_t const hash = calc_std_hash(s0);
+        CHECK(ShaderSource::evict_source_contents(
+                  memory::MemoryPressure::hard, 0) >= code.size());
+        {
+            // the source isn't read back from disk to be hashed
+            memory::AllocationCheckScope scope{"shader hash", Mode::count};
+            size_t const evicted_hash = calc_std_hash(s0);
+            size_t const count = scope.get_allocation_count();
+            CHECK(count == 0);
+            CHECK(evicted_hash == hash);
+        }
+        // but it is once the code is needed
+        CHECK(s0.get_code() == code);
+        CHECK(calc_std_hash(s0) == hash);
+    }
+#endif
+
+    std::filesystem::remove(path);
+}
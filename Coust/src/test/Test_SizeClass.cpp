@@ -0,0 +1,123 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/SizeClass.h"
+
+TEST_CASE("[Coust] [utils] [allocators] SizeClass" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    SUBCASE("Lookup") {
+        for (size_t size = 1; size <= size_class::max_size; ++size) {
+            size_t const idx = size_class::get_index(size);
+            REQUIRE(idx < size_class::count);
+            // the smallest class which can hold the size
+            CHECK(size_class::get_size(idx) >= size);
+            if (idx > 0)
+                CHECK(size_class::get_size(idx - 1) < size);
+            // requests are always served with proper alignment, even if their
+            // size isn't a multiple of it (e.g. 20 B aligned to 16 B)
+            size_t const max_alignment =
+                std::min(std::bit_ceil(size), size_t{DEFAULT_ALIGNMENT});
+            for (size_t alignment = 1; alignment <= max_alignment;
+                 alignment *= 2) {
+                CHECK(size_class::get_alignment(idx) >= alignment);
+            }
+        }
+    }
+
+    SUBCASE("AggregateAllocator") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        AggregateAllocator alloc{mp};
+        std::vector<std::pair<uint8_t*, size_t>> blocks{};
+        for (size_t size = 1; size <= kbyte_10; size += 7) {
+            size_t const alignment = std::min(
+                size_t{1} << std::countr_zero(size), DEFAULT_ALIGNMENT);
+            uint8_t* p = (uint8_t*) alloc.allocate(size, alignment);
+            REQUIRE(p != nullptr);
+            CHECK(coust::ptr_math::is_aligned(p, alignment));
+            std::memset(p, (int) (size & 0xFF), size);
+            blocks.emplace_back(p, size);
+        }
+        // sizes which aren't a multiple of their alignment
+        for (size_t const size : {20, 24, 36, 40, 52, 56, 100}) {
+            uint8_t* p = (uint8_t*) alloc.allocate(size, DEFAULT_ALIGNMENT);
+            REQUIRE(p != nullptr);
+            CHECK(coust::ptr_math::is_aligned(p, DEFAULT_ALIGNMENT));
+            std::memset(p, (int) (size & 0xFF), size);
+            blocks.emplace_back(p, size);
+        }
+        // over-aligned blocks too large for a medium area along with their
+        // gap go elsewhere, instead of growing the medium allocations in vain
+        size_t const reserved_size = mp.get_reserved_size();
+        for (size_t const alignment : {byte_64, byte_256}) {
+            for (size_t const size : {5000, 5050, 5088}) {
+                uint8_t* p = (uint8_t*) alloc.allocate(size, alignment);
+                REQUIRE(p != nullptr);
+                CHECK(coust::ptr_math::is_aligned(p, alignment));
+                std::memset(p, (int) (size & 0xFF), size);
+                blocks.emplace_back(p, size);
+            }
+        }
+        CHECK(mp.get_reserved_size() == reserved_size);
+        for (auto const [p, size] : blocks) {
+            CHECK(std::all_of(p, p + size,
+                [size](uint8_t v) { return v == (uint8_t) (size & 0xFF); }));
+            alloc.deallocate(p, size);
+        }
+    }
+
+    SUBCASE("Internal fragmentation report") {
+        // allocation sizes shaped like the engine's: containers growing by
+        // doubling, short strings, and small objects
+        std::vector<size_t> trace{};
+        for (size_t element_size : {4, 8, 12, 16, 24, 32, 48, 64, 80}) {
+            for (size_t capacity = 1;
+                 capacity * element_size <= size_class::max_size;
+                 capacity *= 2) {
+                trace.push_back(capacity * element_size);
+            }
+        }
+        for (size_t length = 1; length < size_class::max_size; ++length) {
+            trace.push_back(length + 1);
+        }
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> size_dist{
+            1, size_class::max_size};
+        for (size_t i = 0; i < 10'000; ++i) {
+            trace.push_back(size_dist(gen));
+        }
+
+        // one class per power of 2 up to 128 B, TLSF above
+        auto const before = [](size_t size) {
+            if (size <= byte_128)
+                return std::max(std::bit_ceil(size), size_t{byte_8});
+            return coust::ptr_math::round_up_to_alinged(size, 16) +
+                   TLSFAllocator::BOOKKEEPING_SIZE / 2;
+        };
+        auto const after = [](size_t size) {
+            return (size_t) size_class::get_size(size_class::get_index(size));
+        };
+        auto const fragmentation = [&trace](auto const& block_size) {
+            size_t requested = 0;
+            size_t consumed = 0;
+            for (size_t size : trace) {
+                requested += size;
+                consumed += block_size(size);
+            }
+            return 1.0 - (double) requested / (double) consumed;
+        };
+        double const before_ratio = fragmentation(before);
+        double const after_ratio = fragmentation(after);
+        MESSAGE("Internal fragmentation with power of 2 classes up to 128 B: "
+                << before_ratio * 100.0 << "%");
+        MESSAGE("Internal fragmentation with " << size_class::count
+                                               << " size classes up to 256 B: "
+                                               << after_ratio * 100.0 << "%");
+        CHECK(after_ratio < before_ratio);
+    }
+}
@@ -0,0 +1,170 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/SlabAllocator.h"
+#include "utils/allocators/SmartPtr.h"
+
+TEST_CASE("[Coust] [utils] [allocators] SlabAllocator" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    SUBCASE("Size classes") {
+        CHECK(SlabAllocator::get_class_index(1, 1) == 0);
+        CHECK(SlabAllocator::get_class_index(byte_64, 8) == 0);
+        CHECK(SlabAllocator::get_class_index(65, 8) == 1);
+        CHECK(SlabAllocator::get_class_index(80, 8) == 1);
+        CHECK(SlabAllocator::get_class_index(81, 8) == 2);
+        CHECK(SlabAllocator::get_class_index(byte_128, 8) == 4);
+        CHECK(SlabAllocator::get_class_index(129, 8) == 5);
+        CHECK(SlabAllocator::get_class_index(byte_512, 8) ==
+              SlabAllocator::CLASS_COUNT - 1);
+        CHECK(SlabAllocator::get_class_index(byte_512 + 1, 8) ==
+              SlabAllocator::CLASS_COUNT);
+        // 80 B slots are only aligned to 16 B
+        CHECK(SlabAllocator::get_class_index(80, 32) == 2);
+        for (size_t size = 1; size <= SlabAllocator::MAX_SIZE; ++size) {
+            size_t const idx = SlabAllocator::get_class_index(size, 1);
+            REQUIRE(idx < SlabAllocator::CLASS_COUNT);
+            CHECK(SlabAllocator::get_class_size(idx) >= size);
+            if (idx > 0)
+                CHECK(SlabAllocator::get_class_size(idx - 1) < size);
+        }
+    }
+
+    SUBCASE("Lowest free slot first") {
+        SlabAllocator sa{};
+        void* p0 = sa.allocate(byte_64, byte_16);
+        void* p1 = sa.allocate(byte_64, byte_16);
+        void* p2 = sa.allocate(byte_64, byte_16);
+        CHECK(coust::ptr_math::sub(p1, p0) == byte_64);
+        CHECK(coust::ptr_math::sub(p2, p1) == byte_64);
+        sa.deallocate(p1, byte_64);
+        CHECK(sa.allocate(byte_64, byte_16) == p1);
+        sa.deallocate(p0, byte_64);
+        sa.deallocate(p1, byte_64);
+        sa.deallocate(p2, byte_64);
+        CHECK(sa.get_slab_count() == 1);
+    }
+
+    SUBCASE("Empty slabs are recycled") {
+        struct alignas(32) Obj {
+            uint32_t i;
+            uint32_t data[39];
+        };
+        static_assert(sizeof(Obj) == 160);
+        size_t constexpr count = 10000;
+        SlabAllocator sa{};
+        std::vector<Obj*> objs{};
+        objs.reserve(count);
+        for (size_t round = 0; round < 3; ++round) {
+            for (uint32_t i = 0; i < count; ++i) {
+                Obj* const obj =
+                    (Obj*) sa.allocate_fixed<sizeof(Obj), alignof(Obj)>();
+                REQUIRE(obj != nullptr);
+                CHECK(coust::ptr_math::is_aligned(obj, alignof(Obj)));
+                obj->i = i;
+                std::ranges::fill(obj->data, i);
+                objs.push_back(obj);
+            }
+            size_t const slab_count = sa.get_slab_count();
+            CHECK(slab_count * SlabAllocator::SLAB_SIZE <
+                  count * sizeof(Obj) * 11 / 10);
+            std::random_device rd;
+            std::mt19937 gen{rd()};
+            std::ranges::shuffle(objs, gen);
+            for (Obj* obj : objs) {
+                CHECK(std::ranges::all_of(
+                    obj->data, [obj](uint32_t d) { return d == obj->i; }));
+                sa.deallocate_fixed<sizeof(Obj)>(obj);
+            }
+            objs.clear();
+            CHECK(sa.get_slab_count() == SlabAllocator::MAX_EMPTY_SLAB_COUNT);
+            CHECK(sa.get_empty_slab_count() ==
+                  SlabAllocator::MAX_EMPTY_SLAB_COUNT);
+        }
+        CHECK(sa.trim() ==
+              SlabAllocator::MAX_EMPTY_SLAB_COUNT * SlabAllocator::SLAB_SIZE);
+        CHECK(sa.get_slab_count() == 0);
+    }
+
+    SUBCASE("Slabs are cut from reserved pages") {
+        size_t constexpr slab_count = SlabAllocator::SLABS_PER_RESERVATION + 1;
+        size_t constexpr block_per_slab = SlabAllocator::SLAB_SIZE / byte_512;
+        SlabAllocator sa{};
+        std::vector<void*> blocks{};
+        while (sa.get_slab_count() < slab_count) {
+            blocks.push_back(sa.allocate(byte_512, byte_64));
+        }
+        CHECK(sa.get_reserved_size() ==
+              2 * SlabAllocator::SLABS_PER_RESERVATION *
+                  SlabAllocator::SLAB_SIZE);
+        CHECK(blocks.size() > (slab_count - 1) * (block_per_slab - 1));
+        void* const first = blocks.front();
+        for (void* p : blocks) {
+            sa.deallocate(p, byte_512);
+        }
+        CHECK(sa.trim() == SlabAllocator::SLAB_SIZE);
+        CHECK(sa.get_slab_count() == 0);
+        // the decommitted slabs are committed again instead of reserving more
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i] = sa.allocate(byte_512, byte_64);
+        }
+        CHECK(blocks.front() == first);
+        CHECK(sa.get_reserved_size() ==
+              2 * SlabAllocator::SLABS_PER_RESERVATION *
+                  SlabAllocator::SLAB_SIZE);
+        for (void* p : blocks) {
+            sa.deallocate(p, byte_512);
+        }
+    }
+
+    SUBCASE("Mixed sizes") {
+        SlabAllocator sa{};
+        std::vector<std::pair<uint8_t*, size_t>> blocks{};
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<size_t> size_dist{1, kbyte_1};
+        for (size_t i = 0; i < 20000; ++i) {
+            if (!blocks.empty() && gen() % 3 == 0) {
+                size_t const idx = gen() % blocks.size();
+                auto const [p, size] = blocks[idx];
+                CHECK(std::all_of(p, p + size,
+                    [size](uint8_t b) { return b == uint8_t(size); }));
+                sa.deallocate(p, size);
+                blocks[idx] = blocks.back();
+                blocks.pop_back();
+            } else {
+                size_t const size = size_dist(gen);
+                uint8_t* const p = (uint8_t*) sa.allocate(size, byte_8);
+                REQUIRE(p != nullptr);
+                std::memset(p, uint8_t(size), size);
+                blocks.emplace_back(p, size);
+            }
+        }
+        for (auto const& [p, size] : blocks) {
+            sa.deallocate(p, size);
+        }
+        CHECK(sa.get_slab_count() == sa.get_empty_slab_count());
+    }
+
+    SUBCASE("Smart pointers") {
+        struct Obj {
+            int* destruct_count;
+            std::array<uint8_t, 200> payload{};
+
+            Obj(int* count) noexcept : destruct_count(count) {}
+
+            ~Obj() { (*destruct_count)++; }
+        };
+
+        SlabAllocator sa{};
+        int count = 0;
+        {
+            auto unique = allocate_unique<Obj>(sa, &count);
+            std::shared_ptr<Obj> shared = allocate_shared<Obj>(sa, &count);
+            std::shared_ptr<Obj> shared_1{shared};
+            CHECK(sa.get_slab_count() > 0);
+        }
+        CHECK(count == 2);
+        CHECK(sa.get_slab_count() == sa.get_empty_slab_count());
+    }
+}
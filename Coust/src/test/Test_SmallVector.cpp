@@ -0,0 +1,180 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+#include "utils/allocators/AllocationCheck.h"
+#include "utils/allocators/StlContainer.h"
+#include "utils/containers/SmallVector.h"
+#include "utils/filesystem/NaiveSerialization.h"
+
+TEST_CASE("[Coust] [utils] [containers] Small Vector" * doctest::skip(false)) {
+    using namespace coust;
+
+    SUBCASE("Construction and Assignment") {
+        container::small_vector<std::string, 4> v0{"One", "Two", "Three"};
+        CHECK(v0.size() == 3);
+        CHECK(v0.is_inline());
+        CHECK(v0.front() == "One");
+        CHECK(v0.back() == "Three");
+        container::small_vector<std::string, 4> v1 = v0;
+        CHECK(v1 == v0);
+        container::small_vector<std::string, 4> v2 = std::move(v1);
+        CHECK(v1.empty());
+        CHECK(v2 == v0);
+        v1 = {"Four"};
+        CHECK(v1 != v0);
+        v1 = v2;
+        CHECK(v1 == v0);
+        v2.swap(v1);
+        CHECK(v2[2] == "Three");
+        container::small_vector<uint32_t, 2> v3(5, 7u);
+        CHECK(!v3.is_inline());
+        CHECK(std::ranges::count(v3, 7u) == 5);
+        // a heap block is handed over as is
+        uint32_t const* const data = v3.data();
+        container::small_vector<uint32_t, 2> v4 = std::move(v3);
+        CHECK(v4.data() == data);
+        CHECK(v3.is_inline());
+    }
+
+    SUBCASE("Modifier") {
+        container::small_vector<std::string, 2> v0{};
+        v0.push_back("Zero");
+        v0.emplace_back(3, 'a');
+        CHECK(v0.is_inline());
+        // past the inline capacity, the elements move to the heap
+        v0.push_back(v0.front());
+        CHECK(!v0.is_inline());
+        CHECK(v0.capacity() >= 3);
+        CHECK(v0[2] == "Zero");
+        v0.insert(v0.begin() + 1, "One");
+        v0.emplace(v0.end(), "End");
+        CHECK(v0.size() == 5);
+        CHECK(v0[1] == "One");
+        CHECK(v0[2] == "aaa");
+        CHECK(v0.back() == "End");
+        auto iter = v0.erase(v0.begin());
+        CHECK(*iter == "One");
+        iter = v0.erase(v0.begin() + 1, v0.begin() + 3);
+        CHECK(*iter == "End");
+        CHECK(v0.size() == 2);
+        v0.pop_back();
+        v0.resize(3, "Fill");
+        CHECK(v0[2] == "Fill");
+        v0.resize(1);
+        CHECK(v0.size() == 1);
+        v0.clear();
+        CHECK(v0.empty());
+    }
+
+    SUBCASE("Against std::vector") {
+        container::small_vector<uint64_t, 8> v0{};
+        container::small_vector<std::string, 8> v1{};
+        std::vector<uint64_t> ref{};
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<uint32_t> op_dist{0, 3};
+        for (uint64_t i = 0; i < 5'000; ++i) {
+            size_t const pos = ref.empty() ? 0 : gen() % ref.size();
+            switch (op_dist(gen)) {
+                case 0:
+                    v0.push_back(i);
+                    v1.push_back(std::to_string(i));
+                    ref.push_back(i);
+                    break;
+                case 1:
+                    v0.insert(v0.begin() + pos, i);
+                    v1.insert(v1.begin() + pos, std::to_string(i));
+                    ref.insert(ref.begin() + (ptrdiff_t) pos, i);
+                    break;
+                case 2:
+                    if (ref.empty())
+                        break;
+                    v0.erase(v0.begin() + pos);
+                    v1.erase(v1.begin() + pos);
+                    ref.erase(ref.begin() + (ptrdiff_t) pos);
+                    break;
+                default:
+                    if (ref.size() > 16) {
+                        v0.resize(pos);
+                        v1.resize(pos);
+                        ref.resize(pos);
+                    }
+                    break;
+            }
+        }
+        REQUIRE(v0.size() == ref.size());
+        REQUIRE(v1.size() == ref.size());
+        CHECK(std::ranges::equal(v0, ref));
+        CHECK(std::ranges::equal(v1, ref,
+            [](std::string const& s, uint64_t i) {
+                return s == std::to_string(i);
+            }));
+    }
+
+#if !defined(COUST_REL)
+    SUBCASE("Copies inside the inline capacity never allocate") {
+        using Mode = memory::AllocationCheckScope::Mode;
+        memory::small_vector<uint64_t, 4, DefaultAlloc> v0{
+            get_default_alloc()};
+        memory::AllocationCheckScope scope{"small vector", Mode::count};
+        for (uint64_t i = 0; i < 4; ++i) {
+            v0.push_back(i);
+        }
+        memory::small_vector<uint64_t, 4, DefaultAlloc> v1 = v0;
+        v1.resize(2);
+        v1.insert(v1.begin(), 42);
+        bool const equal = std::ranges::equal(v0, v1);
+        size_t const count = scope.get_allocation_count();
+        CHECK(count == 0);
+        CHECK(!equal);
+    }
+#endif
+
+    SUBCASE("Elements constructed with the allocator") {
+        memory::small_vector_nested<memory::string<DefaultAlloc>, 2,
+            DefaultAlloc>
+            v0{get_default_alloc()};
+        std::string_view constexpr long_str =
+            "a string that never fits in the small string buffer";
+        // past the inline capacity as well
+        for (size_t i = 0; i < 4; ++i) {
+            v0.emplace_back(long_str);
+        }
+        v0.emplace(v0.begin(), long_str);
+        v0.resize(6);
+        auto v1 = v0;
+        CHECK(v1.size() == 6);
+        CHECK(v1[4] == long_str);
+        CHECK(v1.back().empty());
+        CHECK(v1 == v0);
+    }
+
+    SUBCASE("Naive serialization") {
+        struct Bound {
+            uint32_t binding;
+            uint64_t offset;
+            auto operator<=>(Bound const&) const noexcept = default;
+        };
+        container::small_vector<Bound, 2> v0{
+            {0, 16},
+            {1, 32},
+            {2, 64},
+        };
+        file::ByteArray byte_array = file::to_byte_array(v0);
+        auto const v1 =
+            file::from_byte_array<container::small_vector<Bound, 2>>(
+                byte_array);
+        CHECK(v1 == v0);
+        memory::small_vector<uint32_t, 4, DefaultAlloc> v2{
+            {1u, 2u, 3u},
+            get_default_alloc()
+        };
+        byte_array = file::to_byte_array(v2);
+        memory::small_vector<uint32_t, 4, DefaultAlloc> v3{
+            get_default_alloc()};
+        file::from_byte_array(byte_array, v3);
+        CHECK(v3 == v2);
+        CHECK(v3.is_inline());
+    }
+}
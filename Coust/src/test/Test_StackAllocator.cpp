@@ -0,0 +1,108 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/StackAllocator.h"
+#include "utils/allocators/StlAdaptor.h"
+
+TEST_CASE("[Coust] [utils] [allocators] StackAllocator" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    SUBCASE("Rewind to marker") {
+        StackAllocator sa{kbyte_1};
+        auto const bottom = sa.get_marker();
+        void* p1 = sa.allocate(byte_64, byte_16);
+        REQUIRE(p1 != nullptr);
+        auto const marker = sa.get_marker();
+        void* p2 = sa.allocate(byte_128, byte_16);
+        void* p3 = sa.allocate(byte_32, byte_64);
+        CHECK(coust::ptr_math::is_aligned(p3, byte_64));
+        CHECK(p2 == coust::ptr_math::add(p1, byte_64));
+        sa.rewind(marker);
+        CHECK(sa.get_used_size() == byte_64);
+        // the memory after the marker is handed out again
+        CHECK(sa.allocate(byte_128, byte_16) == p2);
+        sa.rewind(bottom);
+        CHECK(sa.get_used_size() == 0);
+        CHECK(sa.allocate(byte_64, byte_16) == p1);
+    }
+
+    SUBCASE("Pop the top") {
+        StackAllocator sa{kbyte_1};
+        void* p1 = sa.allocate(byte_64, byte_16);
+        void* p2 = sa.allocate(byte_64, byte_16);
+        // not on the top, nothing happens
+        sa.deallocate(p1, byte_64);
+        CHECK(sa.get_used_size() == 2 * byte_64);
+        sa.deallocate(p2, byte_64);
+        CHECK(sa.get_used_size() == byte_64);
+    }
+
+    SUBCASE("Grow across blocks") {
+        StackAllocator sa{byte_256};
+        auto const bottom = sa.get_marker();
+        std::vector<uint8_t*> ptrs{};
+        for (size_t i = 0; i < 20; ++i) {
+            uint8_t* p = (uint8_t*) sa.allocate(byte_64 + i, byte_16);
+            REQUIRE(p != nullptr);
+            std::memset(p, (int) i, byte_64 + i);
+            ptrs.push_back(p);
+        }
+        // larger than a block
+        uint8_t* big = (uint8_t*) sa.allocate(kbyte_1, byte_16);
+        REQUIRE(big != nullptr);
+        std::memset(big, 0xFF, kbyte_1);
+        for (size_t i = 0; i < ptrs.size(); ++i) {
+            CHECK(std::all_of(ptrs[i], ptrs[i] + byte_64 + i,
+                [i](uint8_t v) { return v == (uint8_t) i; }));
+        }
+        CHECK(sa.get_reserved_size() > kbyte_1);
+        sa.rewind(bottom);
+        CHECK(sa.get_used_size() == 0);
+        // only one spare block of regular size is kept
+        CHECK(sa.get_reserved_size() == byte_256);
+        CHECK(sa.allocate(byte_64, byte_16) == ptrs[0]);
+    }
+
+    SUBCASE("Nested scopes") {
+        StackAllocator sa{kbyte_1};
+        void* outer_ptr = nullptr;
+        {
+            ScratchScope outer{sa};
+            outer_ptr = outer.get().allocate(byte_64, byte_16);
+            {
+                ScratchScope inner{sa};
+                inner.get().allocate(byte_128, byte_16);
+                {
+                    ScratchScope innermost{sa};
+                    innermost.get().allocate(byte_256, byte_16);
+                    CHECK(sa.get_used_size() == byte_64 + byte_128 + byte_256);
+                }
+                CHECK(sa.get_used_size() == byte_64 + byte_128);
+            }
+            CHECK(sa.get_used_size() == byte_64);
+        }
+        CHECK(sa.get_used_size() == 0);
+        CHECK(sa.allocate(byte_64, byte_16) == outer_ptr);
+    }
+
+    SUBCASE("Standard container") {
+        StackAllocator sa{kbyte_1};
+        {
+            ScratchScope scope{sa};
+            std::vector<float, StdAllocator<float, StackAllocator>> v1{
+                scope.get()};
+            std::vector<float, StdAllocator<float, StackAllocator>> v2{
+                scope.get()};
+            for (size_t i = 0; i < 1000; ++i) {
+                v1.push_back((float) i);
+                v2.push_back((float) (2 * i));
+            }
+            for (size_t i = 0; i < 1000; ++i) {
+                CHECK(v1[i] == (float) i);
+                CHECK(v2[i] == (float) (2 * i));
+            }
+        }
+        CHECK(sa.get_used_size() == 0);
+    }
+}
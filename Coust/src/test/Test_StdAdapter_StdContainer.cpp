@@ -434,4 +434,29 @@ TEST_CASE("[Coust] [utils] [allocators] StdAllocator MonotonicAllocator" *
             CHECK(std::ranges::equal(vv0[0][0], vv5[0][0]));
         }
     }
+
+    SUBCASE("expandable_vector<int>") {
+        memory::expandable_vector<int, test_alloc> v{ga};
+        v.push_back(0);
+        int const* const data = v.data();
+        for (int i = 1; i < 64; ++i) {
+            v.push_back(i);
+        }
+        // the only allocation of the area grows at the top of the stack
+        CHECK(v.data() == data);
+        CHECK(v.size() == 64);
+        for (int i = 0; i < 64; ++i) {
+            CHECK(v[(size_t) i] == i);
+        }
+        SUBCASE("copy ct") {
+            memory::expandable_vector<int, test_alloc> v2{v};
+            CHECK(std::ranges::equal(v, v2));
+        }
+        SUBCASE("move assign") {
+            memory::expandable_vector<int, test_alloc> v3{ga};
+            v3 = std::move(v);
+            CHECK(v3.size() == 64);
+            CHECK(v3.data() == data);
+        }
+    }
 }
@@ -0,0 +1,206 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/containers/RobinMap.h"
+#include "utils/containers/SwissMap.h"
+
+TEST_CASE("[Coust] [utils] [containers] Swiss Map" * doctest::skip(false)) {
+    using namespace coust;
+
+    SUBCASE("Construction and Assignment") {
+        container::swiss_map<std::string, uint32_t> s0{};
+        CHECK(s0.begin() == s0.end());
+        CHECK(s0.bucket_count() == 0);
+        CHECK(!s0.contains("One"));
+        s0 = {
+            {"One",   1u},
+            {"Two",   2u},
+            {"Three", 3u},
+        };
+        CHECK(s0.size() == 3);
+        // a whole group at least
+        CHECK(s0.bucket_count() == 15);
+        container::swiss_map<std::string, uint32_t> s1 = s0;
+        CHECK(s1.size() == 3);
+        CHECK(s1.at("Two") == 2u);
+        container::swiss_map<std::string, uint32_t> s2 = std::move(s1);
+        CHECK(s1.empty());
+        CHECK(s1.bucket_count() == 0);
+        CHECK(s2.at("Three") == 3u);
+        s1 = s2;
+        CHECK(s1.at("One") == 1u);
+        s2.swap(s0);
+        s0 = std::move(s1);
+        CHECK(s0.size() == 3);
+        CHECK(s1.empty());
+        std::array<std::pair<std::string, uint32_t>, 2> const arr{
+            std::make_pair("Four", 4u), std::make_pair("Five", 5u)};
+        container::swiss_map<std::string, uint32_t> s3{arr.begin(), arr.end()};
+        CHECK(s3.at("Five") == 5u);
+    }
+
+    SUBCASE("Modifier") {
+        container::swiss_map<std::string, uint32_t> s0{};
+        CHECK(s0.insert(std::make_pair(std::string{"One"}, 1u)).second);
+        CHECK(!s0.insert(std::make_pair(std::string{"One"}, 0u)).second);
+        CHECK(s0.at("One") == 1u);
+        CHECK(s0.try_emplace("Two", 2u).second);
+        CHECK(!s0.try_emplace("Two", 0u).second);
+        CHECK(!s0.insert_or_assign("Two", 22u).second);
+        CHECK(s0.at("Two") == 22u);
+        CHECK(s0.emplace("Three", 3u).second);
+        auto iter = s0.find("Three");
+        REQUIRE(iter != s0.end());
+        iter.mapped() = 33u;
+        CHECK(s0.at("Three") == 33u);
+        CHECK(s0.erase("Three") == 1);
+        CHECK(s0.erase("Three") == 0);
+        CHECK(!s0.contains("Three"));
+        CHECK(s0.size() == 2);
+        s0.clear();
+        CHECK(s0.empty());
+        CHECK(s0.begin() == s0.end());
+    }
+
+    SUBCASE("Against std::unordered_map") {
+        container::swiss_map<uint32_t, uint32_t> s0{};
+        std::unordered_map<uint32_t, uint32_t> ref{};
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<uint32_t> key_dist{0, 4096};
+        std::uniform_int_distribution<uint32_t> op_dist{0, 3};
+        for (size_t i = 0; i < 100'000; ++i) {
+            uint32_t const key = key_dist(gen);
+            switch (op_dist(gen)) {
+                case 0:
+                case 1:
+                    CHECK(s0.try_emplace(key, key * 2).second ==
+                          ref.try_emplace(key, key * 2).second);
+                    break;
+                case 2:
+                    CHECK(s0.erase(key) == ref.erase(key));
+                    break;
+                default:
+                    CHECK(s0.contains(key) == ref.contains(key));
+                    break;
+            }
+        }
+        REQUIRE(s0.size() == ref.size());
+        CHECK(s0.load_factor() <= s0.max_load_factor());
+        size_t iterated_count = 0;
+        for (auto iter = s0.begin(); iter != s0.end(); ++iter) {
+            ++iterated_count;
+            CHECK(ref.at(iter.key()) == iter.mapped());
+        }
+        CHECK(iterated_count == ref.size());
+    }
+
+    SUBCASE("Erase while iterating") {
+        container::swiss_map<uint32_t, std::string> s0{};
+        for (uint32_t i = 0; i < 1000; ++i) {
+            s0.try_emplace(i, std::to_string(i));
+        }
+        // erasing never moves the other values
+        std::string const* const kept = std::addressof(s0.at(1u));
+        for (auto iter = s0.begin(); iter != s0.end();) {
+            if (iter.key() % 2 == 0)
+                iter = s0.erase(iter);
+            else
+                ++iter;
+        }
+        CHECK(s0.size() == 500);
+        CHECK(std::addressof(s0.at(1u)) == kept);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            CHECK(s0.contains(i) == (i % 2 == 1));
+        }
+        CHECK(s0.erase(s0.begin(), s0.end()) == s0.end());
+        CHECK(s0.empty());
+    }
+
+    SUBCASE("Tombstones are reused") {
+        container::swiss_map<uint32_t, uint32_t> s0{};
+        s0.reserve(100);
+        size_t const bucket_count = s0.bucket_count();
+        // churn keeps the size while leaving tombstones behind
+        for (uint32_t i = 0; i < 100'000; ++i) {
+            s0.try_emplace(i, i);
+            if (i >= 50)
+                s0.erase(i - 50);
+        }
+        CHECK(s0.size() == 50);
+        CHECK(s0.bucket_count() == bucket_count);
+    }
+
+    SUBCASE("Rehash") {
+        container::swiss_map<uint32_t, uint32_t> s0{};
+        s0.rehash(100);
+        CHECK(s0.bucket_count() == 127);
+        for (uint32_t i = 0; i < 100; ++i) {
+            s0.try_emplace(i, i);
+        }
+        CHECK(s0.bucket_count() == 127);
+        for (uint32_t i = 100; i < 120; ++i) {
+            s0.try_emplace(i, i);
+        }
+        CHECK(s0.bucket_count() == 255);
+        for (uint32_t i = 100; i < 120; ++i) {
+            s0.erase(i);
+        }
+        // shrink to fit the size
+        s0.rehash(0);
+        CHECK(s0.bucket_count() == 127);
+        for (uint32_t i = 0; i < 100; ++i) {
+            CHECK(s0.at(i) == i);
+        }
+    }
+}
+
+TEST_CASE("[Coust] [utils] [containers] Swiss Map Benchmark" *
+          doctest::skip(true)) {
+    using namespace coust;
+
+    size_t constexpr key_cnt = 1 << 16;
+    size_t constexpr lookup_cnt = 4'000'000;
+
+    std::vector<uint64_t> keys(key_cnt);
+    std::mt19937_64 gen{42};
+    std::ranges::generate(keys, [&gen]() { return gen(); });
+    std::vector<uint64_t> hit_keys(lookup_cnt);
+    std::vector<uint64_t> miss_keys(lookup_cnt);
+    std::uniform_int_distribution<size_t> idx_dist{0, key_cnt - 1};
+    std::ranges::generate(hit_keys, [&]() { return keys[idx_dist(gen)]; });
+    std::ranges::generate(miss_keys, [&gen]() { return gen(); });
+
+    auto const run = [&](auto& map, std::vector<uint64_t> const& lookups) {
+        size_t found_cnt = 0;
+        auto const begin = std::chrono::steady_clock::now();
+        for (uint64_t key : lookups) {
+            found_cnt += map.contains(key);
+        }
+        double const ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin)
+                              .count();
+        return std::make_pair(ms, found_cnt);
+    };
+
+    // a value spanning a cache line, like the render cache entries
+    using Value = std::array<uint64_t, 8>;
+    container::robin_map<uint64_t, Value> robin{};
+    container::swiss_map<uint64_t, Value> swiss{};
+    for (uint64_t key : keys) {
+        robin.try_emplace(key, Value{});
+        swiss.try_emplace(key, Value{});
+    }
+
+    auto const [robin_hit_ms, robin_hit_cnt] = run(robin, hit_keys);
+    auto const [swiss_hit_ms, swiss_hit_cnt] = run(swiss, hit_keys);
+    auto const [robin_miss_ms, robin_miss_cnt] = run(robin, miss_keys);
+    auto const [swiss_miss_ms, swiss_miss_cnt] = run(swiss, miss_keys);
+    CHECK(robin_hit_cnt == lookup_cnt);
+    CHECK(swiss_hit_cnt == lookup_cnt);
+    CHECK(robin_miss_cnt == swiss_miss_cnt);
+    MESSAGE("robin_map, successful lookups: " << robin_hit_ms << " ms");
+    MESSAGE("swiss_map, successful lookups: " << swiss_hit_ms << " ms");
+    MESSAGE("robin_map, failed lookups: " << robin_miss_ms << " ms");
+    MESSAGE("swiss_map, failed lookups: " << swiss_miss_ms << " ms");
+}
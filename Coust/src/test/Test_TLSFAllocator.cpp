@@ -0,0 +1,268 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/MemoryPool.h"
+#include "utils/allocators/GrowthPolicy.h"
+#include "utils/allocators/TLSFAllocator.h"
+#include "utils/allocators/FreeListAllocator.h"
+
+TEST_CASE("[Coust] [utils] [allocators] TLSFAllocator" * doctest::skip(true)) {
+    using namespace coust::memory;
+    SUBCASE("Test memory leak") {
+        struct Obj {
+            int i1;
+            int i2;
+            int i3;
+            Obj(int i_) noexcept : i1(i_), i2(2 * i1), i3(3 * i1) {}
+        };
+        size_t constexpr max_ele_cnt = 50;
+        size_t constexpr area_size = 3 * max_ele_cnt * 32;
+        size_t constexpr experiment_cnt = 10;
+        Area area{area_size, alignof(Obj)};
+        TLSFAllocator ta{area.begin(), area.end()};
+        std::vector<Obj*> all_objs{};
+        all_objs.reserve(max_ele_cnt);
+        std::array<size_t, experiment_cnt> experiment_sizes{};
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            size_t constexpr inc = max_ele_cnt / experiment_cnt;
+            experiment_sizes[i] = (i + 1) * inc;
+        }
+        std::random_device rd;
+        std::mt19937 gen{rd()};
+        std::ranges::shuffle(experiment_sizes, gen);
+        for (auto s : experiment_sizes) {
+            for (size_t i = 0; i < s; ++i) {
+                Obj* op = (Obj*) ta.allocate(sizeof(Obj), alignof(Obj));
+                REQUIRE(op != nullptr);
+                std::construct_at<Obj>(op, (int) i);
+                all_objs.push_back(op);
+                ta.is_malfunctioning();
+            }
+            std::ranges::shuffle(all_objs, gen);
+            for (auto p : all_objs) {
+                CHECK(2 * p->i1 == p->i2);
+                CHECK(3 * p->i1 == p->i3);
+                ta.deallocate(p, sizeof(Obj));
+                ta.is_malfunctioning();
+            }
+            all_objs.clear();
+        }
+        // everything is merged back into a single block
+        void* p = ta.allocate(area_size - TLSFAllocator::BOOKKEEPING_SIZE,
+            alignof(Obj));
+        CHECK(p != nullptr);
+        ta.deallocate(p, area_size - TLSFAllocator::BOOKKEEPING_SIZE);
+        ta.is_malfunctioning();
+    }
+
+    SUBCASE("Over-aligned allocation") {
+        size_t constexpr area_size = kbyte_5;
+        Area area{area_size, alignof(std::max_align_t)};
+        TLSFAllocator ta{area.begin(), area.end()};
+        std::vector<void*> ptrs{};
+        for (size_t alignment : {32, 64, 128, 256}) {
+            void* p = ta.allocate(byte_8 * 3, alignment);
+            REQUIRE(p != nullptr);
+            CHECK((uintptr_t) p % alignment == 0);
+            std::memset(p, 0xFF, byte_8 * 3);
+            ptrs.push_back(p);
+            ta.is_malfunctioning();
+        }
+        for (void* p : ptrs) {
+            ta.deallocate(p, byte_8 * 3);
+            ta.is_malfunctioning();
+        }
+    }
+
+    SUBCASE("Expand in place") {
+        size_t constexpr area_size = kbyte_1;
+        Area area{area_size, alignof(std::max_align_t)};
+        TLSFAllocator ta{area.begin(), area.end()};
+        uint8_t* p0 = (uint8_t*) ta.allocate(byte_64, alignof(uint32_t));
+        void* p1 = ta.allocate(byte_64, alignof(uint32_t));
+        void* p2 = ta.allocate(byte_64, alignof(uint32_t));
+        REQUIRE((p0 && p1 && p2));
+        std::memset(p0, 0xAB, byte_64);
+        // the next block is in use
+        CHECK(!ta.try_expand(p0, byte_64, byte_128));
+        ta.deallocate(p1, byte_64);
+        ta.is_malfunctioning();
+        // absorb the free block right after it, and split off the rest
+        CHECK(ta.try_expand(p0, byte_64, byte_64 + byte_32));
+        ta.is_malfunctioning();
+        CHECK(std::ranges::all_of(
+            std::span{p0, byte_64}, [](uint8_t b) { return b == 0xAB; }));
+        std::memset(p0, 0xCD, byte_64 + byte_32);
+        // too large for the space before `p2`
+        CHECK(!ta.try_expand(p0, byte_64 + byte_32, byte_256));
+        // shrink to its original size, the tail becomes free again
+        CHECK(ta.try_expand(p0, byte_64 + byte_32, byte_64));
+        ta.is_malfunctioning();
+        p1 = ta.allocate(byte_64, alignof(uint32_t));
+        CHECK(p1 == p0 + byte_64 + 16);
+        ta.is_malfunctioning();
+        for (void* p : {(void*) p0, p1, p2}) {
+            ta.deallocate(p, byte_64);
+            ta.is_malfunctioning();
+        }
+    }
+
+    SUBCASE("Manually growth") {
+        MemoryPool mp{byte_64, byte_128};
+        size_t constexpr experiment_cnt = 50;
+        GrowthPolicy<GrowthType::attached, byte_64> gp{mp};
+        alignas(std::max_align_t) std::array<char, byte_64> stack_area{};
+        TLSFAllocator ta{stack_area.data(),
+            coust::ptr_math::add(stack_area.data(), stack_area.size())};
+        std::vector<float*> fps{};
+        fps.reserve(experiment_cnt);
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            float* fp = (float*) ta.allocate(sizeof(float), alignof(float));
+            if (fp == nullptr) {
+                auto const [ptr, size] = gp.do_growth(alignof(float));
+                ta.grow(ptr, size);
+                fp = (float*) ta.allocate(sizeof(float), alignof(float));
+            }
+            ta.is_malfunctioning();
+            *fp = (float) i;
+            fps.push_back(fp);
+        }
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            CHECK(*fps[i] == (float) i);
+        }
+    }
+
+    SUBCASE("Auto growth (attached)") {
+        MemoryPool mp{byte_64, byte_128};
+        size_t constexpr experiment_cnt = 50;
+        GrowableAllocator<GrowthType::attached, byte_128, TLSFAllocator> ga{mp};
+        std::vector<float*> fps{};
+        fps.reserve(experiment_cnt);
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            float* fp = (float*) ga.allocate(sizeof(float), alignof(float));
+            *fp = (float) i;
+            fps.push_back(fp);
+            ga.get_raw_allocator().is_malfunctioning();
+        }
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            CHECK(*fps[i] == (float) i);
+        }
+    }
+
+    SUBCASE("Auto growth (scope)") {
+        size_t constexpr experiment_cnt = 50;
+        size_t constexpr area_size = 40 * experiment_cnt * sizeof(float);
+        alignas(std::max_align_t) std::array<char, area_size> stack_area{};
+        GrowableAllocator<GrowthType::scope, byte_64, TLSFAllocator> ga{
+            stack_area};
+        std::vector<float*> fps{};
+        fps.reserve(experiment_cnt);
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            float* fp = (float*) ga.allocate(sizeof(float), alignof(float));
+            *fp = (float) i;
+            fps.push_back(fp);
+            ga.get_raw_allocator().is_malfunctioning();
+        }
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            CHECK(*fps[i] == (float) i);
+        }
+    }
+
+    SUBCASE("Auto growth (heap)") {
+        size_t constexpr experiment_cnt = 50;
+        GrowableAllocator<GrowthType::heap, byte_64, TLSFAllocator> ga{};
+        std::vector<float*> fps{};
+        fps.reserve(experiment_cnt);
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            float* fp = (float*) ga.allocate(sizeof(float), alignof(float));
+            *fp = (float) i;
+            fps.push_back(fp);
+            ga.get_raw_allocator().is_malfunctioning();
+        }
+        for (size_t i = 0; i < experiment_cnt; ++i) {
+            CHECK(*fps[i] == (float) i);
+        }
+    }
+
+    SUBCASE("Fragmentation & latency against FreeListAllocator") {
+        // medium sized allocations served by `AggregateAllocator`, with the
+        // live set kept close to the capacity of the area
+        size_t constexpr area_size = 4 * 1024 * 1024;
+        size_t constexpr target_live_size = area_size * 9 / 10;
+        size_t constexpr op_cnt = 200'000;
+
+        struct Result {
+            size_t failed_cnt = 0;
+            double total_ms = 0.0;
+            double worst_us = 0.0;
+        };
+
+        auto const run = [&](auto& alloc) {
+            struct Block {
+                void* ptr;
+                size_t size;
+            };
+            Result ret{};
+            std::mt19937 gen{42};
+            std::uniform_int_distribution<size_t> size_dist{byte_128, kbyte_5};
+            std::vector<Block> live{};
+            size_t live_size = 0;
+            bool failed = false;
+            for (size_t i = 0; i < op_cnt; ++i) {
+                // fill up to the target, then churn around it. a failed
+                // allocation means the free space is too fragmented, so free
+                // a block before trying again
+                bool const do_alloc = live.empty() ||
+                                      (live_size < target_live_size && !failed);
+                failed = false;
+                auto const begin = std::chrono::steady_clock::now();
+                if (do_alloc) {
+                    size_t const size = size_dist(gen);
+                    void* p = alloc.allocate(size, alignof(std::max_align_t));
+                    if (p) {
+                        live.push_back(Block{p, size});
+                        live_size += size;
+                    } else {
+                        ret.failed_cnt++;
+                        failed = true;
+                    }
+                } else {
+                    size_t const idx =
+                        std::uniform_int_distribution<size_t>{0,
+                            live.size() - 1}(gen);
+                    alloc.deallocate(live[idx].ptr, live[idx].size);
+                    live_size -= live[idx].size;
+                    live[idx] = live.back();
+                    live.pop_back();
+                }
+                double const us = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - begin)
+                                      .count();
+                ret.total_ms += us / 1000.0;
+                ret.worst_us = std::max(ret.worst_us, us);
+            }
+            for (auto const& b : live) {
+                alloc.deallocate(b.ptr, b.size);
+            }
+            return ret;
+        };
+
+        Area tlsf_area{area_size, alignof(std::max_align_t)};
+        TLSFAllocator ta{tlsf_area.begin(), tlsf_area.end()};
+        Result const tlsf = run(ta);
+        ta.is_malfunctioning();
+
+        Area free_list_area{area_size, alignof(std::max_align_t)};
+        FreeListAllocator fa{free_list_area.begin(), free_list_area.end()};
+        Result const free_list = run(fa);
+
+        MESSAGE("TLSFAllocator: " << tlsf.total_ms << " ms, worst op "
+                                  << tlsf.worst_us << " us, failed allocation "
+                                  << tlsf.failed_cnt);
+        MESSAGE("FreeListAllocator: "
+                << free_list.total_ms << " ms, worst op " << free_list.worst_us
+                << " us, failed allocation " << free_list.failed_cnt);
+        CHECK(tlsf.total_ms > 0.0);
+    }
+}
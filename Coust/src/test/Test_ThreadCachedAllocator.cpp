@@ -0,0 +1,349 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "core/Memory.h"
+
+TEST_CASE("[Coust] [core] ThreadCachedAllocator" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    struct Block {
+        uint8_t* ptr;
+        size_t size;
+    };
+
+    auto const fill = [](Block const& b) {
+        std::memset(b.ptr, (int) (b.size & 0xFF), b.size);
+    };
+    auto const is_intact = [](Block const& b) {
+        return std::all_of(b.ptr, b.ptr + b.size,
+            [&b](uint8_t v) { return v == (uint8_t) (b.size & 0xFF); });
+    };
+
+    SUBCASE("Multi-threaded stress") {
+        size_t constexpr thread_cnt = 4;
+        size_t constexpr round_cnt = 50;
+        size_t constexpr block_per_round = 200;
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        ThreadCachedAllocator alloc{mp};
+        // blocks allocated on one thread and freed on another
+        std::mutex handoff_mutex{};
+        std::vector<Block> handoff{};
+        std::atomic<size_t> corrupted_cnt = 0;
+
+        auto const worker = [&](size_t seed) {
+            std::mt19937 gen{(uint32_t) seed};
+            // mostly cached size classes, with some medium sized allocations
+            std::uniform_int_distribution<size_t> size_dist{1, 300};
+            std::vector<Block> blocks{};
+            blocks.reserve(block_per_round);
+            for (size_t r = 0; r < round_cnt; ++r) {
+                for (size_t i = 0; i < block_per_round; ++i) {
+                    size_t const size = size_dist(gen);
+                    Block b{(uint8_t*) alloc.allocate(size, alignof(uint8_t)),
+                        size};
+                    fill(b);
+                    blocks.push_back(b);
+                }
+                std::ranges::shuffle(blocks, gen);
+                std::vector<Block> remote{};
+                {
+                    std::lock_guard<std::mutex> lock{handoff_mutex};
+                    std::swap(remote, handoff);
+                    handoff.assign(blocks.begin(),
+                        blocks.begin() + (long) (blocks.size() / 2));
+                }
+                for (auto const& b : remote) {
+                    if (!is_intact(b))
+                        corrupted_cnt++;
+                    alloc.deallocate(b.ptr, b.size);
+                }
+                for (size_t i = blocks.size() / 2; i < blocks.size(); ++i) {
+                    if (!is_intact(blocks[i]))
+                        corrupted_cnt++;
+                    alloc.deallocate(blocks[i].ptr, blocks[i].size);
+                }
+                blocks.clear();
+            }
+        };
+
+        std::vector<std::thread> threads{};
+        for (size_t i = 0; i < thread_cnt; ++i) {
+            threads.emplace_back(worker, i + 1);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (auto const& b : handoff) {
+            if (!is_intact(b))
+                corrupted_cnt++;
+            alloc.deallocate(b.ptr, b.size);
+        }
+        CHECK(corrupted_cnt.load() == 0);
+    }
+
+    SUBCASE("Blocks are reused after thread exit") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        ThreadCachedAllocator alloc{mp};
+        void* p = nullptr;
+        std::thread{[&]() {
+            p = alloc.allocate(byte_32, alignof(uint32_t));
+            alloc.deallocate(p, byte_32);
+        }}.join();
+        alloc.flush_thread_cache();
+        // the exited thread returned its magazine, so the back end hands the
+        // same block out again
+        bool reused = false;
+        std::vector<void*> ptrs{};
+        for (size_t i = 0; i < kbyte_1 / byte_32; ++i) {
+            ptrs.push_back(alloc.allocate(byte_32, alignof(uint32_t)));
+            reused |= ptrs.back() == p;
+        }
+        CHECK(reused);
+        for (void* ptr : ptrs) {
+            alloc.deallocate(ptr, byte_32);
+        }
+    }
+
+    SUBCASE("Free from thread locals destroyed after the thread caches") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        ThreadCachedAllocator alloc{mp};
+        struct Holder {
+            ThreadCachedAllocator* alloc = nullptr;
+            void* p = nullptr;
+
+            ~Holder() noexcept {
+                if (p)
+                    alloc->deallocate(p, byte_32);
+            }
+        };
+        std::thread{[&]() {
+            // constructed before the registry of the thread's caches, so it's
+            // destroyed after it
+            thread_local Holder holder{};
+            holder.alloc = &alloc;
+            holder.p = alloc.allocate(byte_32, alignof(uint32_t));
+        }}.join();
+        // the block went straight back to the back end
+        CHECK(alloc.get_stats(size_class::get_index(byte_32)).live_count == 0);
+    }
+
+    SUBCASE("Trim gives the free areas back") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        ThreadCachedAllocator alloc{mp};
+        std::vector<Block> blocks{};
+        for (size_t i = 0; i < 10000; ++i) {
+            size_t const size = i % 2 == 0 ? 24 : kbyte_1;
+            blocks.push_back(
+                {(uint8_t*) alloc.allocate(size, alignof(uint64_t)), size});
+        }
+        for (auto const& b : blocks) {
+            alloc.deallocate(b.ptr, b.size);
+        }
+        size_t const reserved_size = mp.get_reserved_size();
+        auto const profile = alloc.get_profile();
+        size_t const released_size = alloc.trim();
+        CHECK(released_size > 0);
+        CHECK(mp.get_reserved_size() == reserved_size - released_size);
+        // the profile is the peak usage, which the trim doesn't lower
+        CHECK(alloc.get_profile() == profile);
+        // the allocator keeps working on the areas it grows again
+        void* p = alloc.allocate(24, alignof(uint64_t));
+        CHECK(p != nullptr);
+        alloc.deallocate(p, 24);
+    }
+
+    SUBCASE("Compile-time size classes") {
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        {
+            AggregateAllocator alloc{mp};
+            size_t constexpr small_slot = size_class::get_index(24);
+            size_t constexpr medium_slot = size_class::get_index(byte_256);
+            void* small = alloc.allocate_fixed<24, alignof(uint64_t)>();
+            void* medium = alloc.allocate_fixed<byte_256, alignof(uint64_t)>();
+            void* large = alloc.allocate_fixed<kbyte_1, alignof(uint64_t)>();
+            CHECK(alloc.get_stats(small_slot).live_count == 1);
+            CHECK(alloc.get_stats(medium_slot).live_count == 1);
+            // beyond the size classes
+            CHECK(alloc.get_stats(size_class::count).live_count == 1);
+            // the blocks are the same as the ones of the runtime dispatch
+            alloc.deallocate(small, 24);
+            CHECK(alloc.allocate(24, alignof(uint64_t)) == small);
+            alloc.deallocate_fixed<24>(small);
+            alloc.deallocate_fixed<byte_256>(medium);
+            alloc.deallocate_fixed<kbyte_1>(large);
+            CHECK(alloc.get_stats(small_slot).live_count == 0);
+            CHECK(alloc.get_stats(medium_slot).live_count == 0);
+        }
+        {
+            ThreadCachedAllocator alloc{mp};
+            void* p = alloc.allocate_fixed<byte_32, alignof(uint64_t)>();
+            alloc.deallocate(p, byte_32);
+            CHECK(alloc.allocate_fixed<byte_32, alignof(uint64_t)>() == p);
+            alloc.deallocate_fixed<byte_32>(p);
+            CHECK(alloc.allocate(byte_32, alignof(uint64_t)) == p);
+            alloc.deallocate_fixed<byte_32>(p);
+            // sizes beyond the cached classes go to the back end
+            void* large = alloc.allocate_fixed<kbyte_1, alignof(uint64_t)>();
+            alloc.deallocate_fixed<kbyte_1>(large);
+        }
+    }
+
+    SUBCASE("Reserve from a profile") {
+        AggregateAllocator::Profile profile{};
+        {
+            MemoryPool mp{
+                {small_growth_factor, medium_growth_factor,
+                 large_growth_factor},
+                global_memory_pool_alignment
+            };
+            AggregateAllocator alloc{mp};
+            std::vector<Block> blocks{};
+            for (size_t size = 1; size <= kbyte_5; size += 13) {
+                blocks.push_back(
+                    {(uint8_t*) alloc.allocate(size, alignof(uint8_t)), size});
+            }
+            for (auto const& b : blocks) {
+                alloc.deallocate(b.ptr, b.size);
+            }
+            profile = alloc.get_profile();
+        }
+        CHECK(std::ranges::any_of(profile | std::views::take(size_class::count),
+            [](size_t size) { return size != 0; }));
+        // the medium allocations
+        CHECK(profile[size_class::count] != 0);
+
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        AggregateAllocator alloc{mp};
+        // twice as much as the workload needs
+        AggregateAllocator::Profile oversized{};
+        std::ranges::transform(
+            profile, oversized.begin(), [](size_t size) { return 2 * size; });
+        alloc.reserve(oversized);
+        size_t const reserved_size = mp.get_reserved_size();
+        // the same workload doesn't grow any allocator
+        std::vector<Block> blocks{};
+        for (size_t size = 1; size <= kbyte_5; size += 13) {
+            blocks.push_back(
+                {(uint8_t*) alloc.allocate(size, alignof(uint8_t)), size});
+        }
+        // the first block, a small one, stays alive after the warm-up
+        for (size_t i = 1; i < blocks.size(); ++i) {
+            alloc.deallocate(blocks[i].ptr, blocks[i].size);
+        }
+        CHECK(mp.get_reserved_size() == reserved_size);
+        // the reserve the workload doesn't use isn't in the profile
+        auto const new_profile = alloc.get_profile();
+        for (size_t i = 0; i < size_class::count; ++i) {
+            CHECK(new_profile[i] == profile[i]);
+        }
+        CHECK(new_profile[size_class::count] < oversized[size_class::count]);
+        // the pool keeps the reserved areas during the warm-up
+        CHECK(mp.trim() == 0);
+        alloc.end_warm_up();
+        // the live block only keeps the reserve of the small areas
+        size_t const released_size = alloc.trim();
+        CHECK(released_size > 0);
+        CHECK(mp.get_reserved_size() == reserved_size - released_size);
+        CHECK(mp.get_reserved_size() != 0);
+        alloc.deallocate(blocks[0].ptr, blocks[0].size);
+        CHECK(alloc.trim() == reserved_size - released_size);
+        CHECK(mp.get_reserved_size() == 0);
+    }
+
+    SUBCASE("Profile file") {
+        std::filesystem::path const path =
+            std::filesystem::temp_directory_path() / "coust_test" /
+            "default_alloc_profile";
+        std::filesystem::remove(path);
+        CHECK_FALSE(coust::reserve_default_alloc_from_profile(path));
+        coust::save_default_alloc_profile(path);
+        auto const saved_profile = coust::get_default_alloc().get_profile();
+        CHECK(coust::reserve_default_alloc_from_profile(path));
+        // the peak usage of the process so far stays in the profile
+        auto const profile = coust::get_default_alloc().get_profile();
+        for (size_t i = 0; i < profile.size(); ++i) {
+            CHECK(profile[i] >= saved_profile[i]);
+        }
+        coust::end_default_alloc_warm_up();
+        std::filesystem::remove(path);
+    }
+
+    SUBCASE("Benchmark against single-threaded AggregateAllocator") {
+        size_t constexpr op_cnt = 1'000'000;
+        size_t constexpr live_cnt = 256;
+        std::array<size_t, 5> constexpr sizes{8, 24, 40, 72, 120};
+
+        auto const run = [&](auto& alloc) {
+            std::array<void*, live_cnt> live{};
+            auto const begin = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < op_cnt; ++i) {
+                size_t const slot = i % live_cnt;
+                size_t const size = sizes[slot % sizes.size()];
+                if (live[slot])
+                    alloc.deallocate(live[slot], size);
+                live[slot] = alloc.allocate(size, alignof(uint64_t));
+            }
+            for (size_t slot = 0; slot < live_cnt; ++slot) {
+                alloc.deallocate(live[slot], sizes[slot % sizes.size()]);
+            }
+            return std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - begin)
+                .count();
+        };
+
+        MemoryPool mp{
+            {small_growth_factor, medium_growth_factor, large_growth_factor},
+            global_memory_pool_alignment
+        };
+        double aggregate_ms = 0.0;
+        double cached_ms = 0.0;
+        double cached_mt_ms = 0.0;
+        {
+            AggregateAllocator alloc{mp};
+            aggregate_ms = run(alloc);
+        }
+        {
+            ThreadCachedAllocator alloc{mp};
+            cached_ms = run(alloc);
+        }
+        {
+            size_t constexpr thread_cnt = 4;
+            ThreadCachedAllocator alloc{mp};
+            auto const begin = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads{};
+            for (size_t i = 0; i < thread_cnt; ++i) {
+                threads.emplace_back([&]() { run(alloc); });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            cached_mt_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - begin)
+                               .count();
+        }
+        MESSAGE("AggregateAllocator, 1 thread: " << aggregate_ms << " ms");
+        MESSAGE("ThreadCachedAllocator, 1 thread: " << cached_ms << " ms");
+        MESSAGE("ThreadCachedAllocator, 4 threads (4x work): " << cached_mt_ms
+                                                               << " ms");
+        CHECK(cached_ms > 0.0);
+    }
+}
@@ -0,0 +1,127 @@
+#include "pch.h"
+
+#include "test/Test.h"
+
+#include "utils/allocators/VirtualArea.h"
+#include "utils/allocators/GrowthPolicy.h"
+#include "utils/allocators/TLSFAllocator.h"
+
+TEST_CASE("[Coust] [utils] [allocators] VirtualArea" * doctest::skip(true)) {
+    using namespace coust::memory;
+
+    SUBCASE("Commit & decommit") {
+        VirtualArea va{kbyte_50 * 100, PageType::regular};
+        size_t const page_size = va.get_page_size();
+        CHECK(va.get_committed_size() == 0);
+        CHECK(va.get_reserved_size() >= kbyte_50 * 100);
+        void* prev_end = va.begin();
+        for (size_t i = 0; i < 10; ++i) {
+            auto const [p, size] = va.commit(kbyte_5);
+            REQUIRE(p != nullptr);
+            // every commitment continues the previous one
+            CHECK(p == prev_end);
+            CHECK(size % page_size == 0);
+            CHECK(size >= kbyte_5);
+            std::memset(p, (int) i, size);
+            prev_end = coust::ptr_math::add(p, size);
+        }
+        CHECK(va.end() == prev_end);
+        CHECK(va.contained(va.begin()));
+        CHECK(!va.contained(va.end()));
+        va.decommit(page_size);
+        CHECK(va.get_committed_size() == page_size);
+        CHECK(*(uint8_t*) va.begin() == 0);
+        // the decommitted range can be committed again
+        auto const [p, size] = va.commit(kbyte_5);
+        CHECK(p == coust::ptr_math::add(va.begin(), page_size));
+        std::memset(p, 0xFF, size);
+    }
+
+    SUBCASE("Reservation used up") {
+        VirtualArea va{kbyte_50, PageType::regular};
+        size_t const reserved_size = va.get_reserved_size();
+        CHECK(va.commit(reserved_size).first != nullptr);
+        CHECK(va.commit(1).first == nullptr);
+    }
+
+    SUBCASE("Huge pages") {
+        for (PageType type :
+            {PageType::transparent_huge, PageType::explicit_huge}) {
+            VirtualArea va{size_t{1} << 26, type};
+            // windows only uses regular pages
+            if (va.get_page_type() != PageType::regular) {
+                CHECK((uintptr_t) va.begin() % detail::HUGE_PAGE_SIZE == 0);
+            }
+            auto const [p, size] = va.commit(kbyte_50);
+            REQUIRE(p != nullptr);
+            std::memset(p, 0xFF, size);
+        }
+    }
+
+    SUBCASE("Page allocator") {
+        PageAllocator pa{};
+        for (size_t size : {size_t{kbyte_50}, size_t{5} * 1024 * 1024}) {
+            uint8_t* p = (uint8_t*) pa.allocate(size, alignof(uint32_t));
+            REQUIRE(p != nullptr);
+            std::memset(p, 0xFF, size);
+            CHECK(p[size - 1] == 0xFF);
+            pa.deallocate(p, size);
+        }
+    }
+
+    SUBCASE("Page allocator expands in place") {
+        PageAllocator pa{};
+        size_t const page_size = detail::get_system_page_size();
+        size_t const size = 16 * page_size;
+        uint8_t* p = (uint8_t*) pa.allocate(size, alignof(uint32_t));
+        REQUIRE(p != nullptr);
+        std::memset(p, 0xAB, size);
+        // within the last page
+        CHECK(pa.try_expand(p, size - 1, size));
+        // shrinking always succeeds
+        CHECK(pa.try_expand(p, size, size / 2));
+        CHECK(p[size / 2 - 1] == 0xAB);
+        size_t cur_size = size / 2;
+        // the unmapped tail is free again, unless another thread took it
+        if (pa.try_expand(p, cur_size, size)) {
+            cur_size = size;
+            std::memset(p + size / 2, 0xCD, size / 2);
+            CHECK(p[0] == 0xAB);
+            CHECK(p[size - 1] == 0xCD);
+        }
+        pa.deallocate(p, cur_size);
+    }
+
+    SUBCASE("Grow in place") {
+        GrowableAllocator<GrowthType::virtual_memory, kbyte_5, TLSFAllocator>
+            ga{size_t{kbyte_50} * 10, PageType::regular};
+        std::vector<std::pair<void*, size_t>> blocks{};
+        for (size_t i = 0; i < 20; ++i) {
+            size_t const size = kbyte_1 + i * 16;
+            void* p = ga.allocate(size, alignof(std::max_align_t));
+            REQUIRE(p != nullptr);
+            std::memset(p, (int) i, size);
+            blocks.emplace_back(p, size);
+            ga.get_raw_allocator().is_malfunctioning();
+        }
+        // larger than a single growth step, only possible when the areas are
+        // merged
+        void* big = ga.allocate(kbyte_10, alignof(std::max_align_t));
+        REQUIRE(big != nullptr);
+        std::memset(big, 0xFF, kbyte_10);
+        ga.get_raw_allocator().is_malfunctioning();
+        for (auto const& [p, size] : blocks) {
+            ga.deallocate(p, size);
+            ga.get_raw_allocator().is_malfunctioning();
+        }
+        ga.deallocate(big, kbyte_10);
+        ga.get_raw_allocator().is_malfunctioning();
+        // everything is merged back into a single free block, so no more
+        // growth is needed
+        size_t const reserved_size = ga.get_reserved_size();
+        void* half = ga.allocate(reserved_size / 2, alignof(std::max_align_t));
+        CHECK(half != nullptr);
+        CHECK(ga.get_reserved_size() == reserved_size);
+        ga.deallocate(half, reserved_size / 2);
+    }
+}
@@ -3,6 +3,9 @@
 #include "test/Test.h"
 
 #include "utils/allocators/GrowthPolicy.h"
+#include "utils/allocators/PoolAllocator.h"
+#include "utils/allocators/TLSFAllocator.h"
+
 TEST_CASE("[Coust] [utils] [allocators] GrowthPolicy" * doctest::skip(true)) {
     using namespace coust::memory;
     SUBCASE("Scoped growth policy") {
@@ -92,6 +95,110 @@ TEST_CASE("[Coust] [utils] [allocators] GrowthPolicy" * doctest::skip(true)) {
         }
     }
 
+    SUBCASE("Shrink attached allocators") {
+        // every raw area of the pool is split into 4 areas
+        MemoryPool mp{byte_256, kbyte_1};
+        auto const check_shrink = [&mp](auto& alloc, size_t size) {
+            std::vector<void*> ptrs{};
+            for (size_t i = 0; i < 64; ++i) {
+                ptrs.push_back(alloc.allocate(size, DEFAULT_ALIGNMENT));
+            }
+            size_t const reserved_size = alloc.get_reserved_size();
+            // a live block keeps its area
+            void* const kept = ptrs.back();
+            ptrs.pop_back();
+            for (void* p : ptrs) {
+                alloc.deallocate(p, size);
+            }
+            CHECK(alloc.shrink() > 0);
+            CHECK(alloc.get_reserved_size() > 0);
+            CHECK(alloc.get_reserved_size() < reserved_size);
+            CHECK(alloc.get_peak_reserved_size() == reserved_size);
+            CHECK(alloc.contained(kept));
+            CHECK_FALSE(alloc.contained(ptrs.front()));
+            // the areas given back make up whole raw areas
+            CHECK(mp.trim() > 0);
+
+            void* const p = alloc.allocate(size, DEFAULT_ALIGNMENT);
+            CHECK(p != nullptr);
+            alloc.deallocate(p, size);
+            alloc.deallocate(kept, size);
+            alloc.shrink();
+            CHECK(alloc.get_reserved_size() == 0);
+            CHECK(mp.trim() > 0);
+            CHECK(mp.get_reserved_size() == 0);
+        };
+        {
+            GrowableAllocator<GrowthType::attached, byte_256, PoolAllocator>
+                alloc{mp, byte_32};
+            check_shrink(alloc, byte_32);
+        }
+        {
+            GrowableAllocator<GrowthType::attached, byte_256, TLSFAllocator>
+                alloc{mp};
+            check_shrink(alloc, byte_64);
+        }
+    }
+
+    SUBCASE("Ownership check") {
+        MemoryPool mp{byte_64, byte_128};
+        GrowthPolicy<GrowthType::attached, byte_64> gp{mp};
+        std::vector<std::pair<void*, size_t>> areas{};
+        for (int i = 0; i < 64; ++i) {
+            areas.push_back(gp.do_growth(DEFAULT_ALIGNMENT));
+        }
+        for (auto [ptr, size] : areas) {
+            CHECK(gp.contained(ptr));
+            CHECK(gp.contained(coust::ptr_math::add(ptr, size - 1)));
+        }
+        int outsider = 0;
+        CHECK(!gp.contained(&outsider));
+    }
+
+    SUBCASE("Free latency as the heap grows") {
+        // the ownership check in `GrowableAllocator::deallocate` used to walk
+        // all the areas, so the latency of free grew with the size of heap
+        size_t constexpr node_size = byte_64;
+        size_t constexpr sample_cnt = 100'000;
+        std::array<size_t, 4> constexpr heap_sizes{
+            4u << 20, 32u << 20, 128u << 20, 256u << 20};
+        MemoryPool mp{kbyte_5};
+        GrowableAllocator<GrowthType::attached, kbyte_5, PoolAllocator> ga{
+            mp, node_size};
+        std::vector<void*> live{};
+        std::mt19937 gen{42};
+        for (size_t const heap_size : heap_sizes) {
+            while (live.size() * node_size < heap_size) {
+                live.push_back(ga.allocate(node_size, DEFAULT_ALIGNMENT));
+            }
+            std::uniform_int_distribution<size_t> dist{0, live.size() - 1};
+            std::vector<size_t> samples(sample_cnt);
+            std::ranges::generate(samples, [&]() { return dist(gen); });
+            // the raw allocator skips the ownership check, the difference
+            // between the two is the cost of the check itself
+            auto const measure = [&](auto& alloc) {
+                auto const begin = std::chrono::steady_clock::now();
+                for (size_t const idx : samples) {
+                    alloc.deallocate(live[idx], node_size);
+                    live[idx] = alloc.allocate(node_size, DEFAULT_ALIGNMENT);
+                }
+                return std::chrono::duration<double, std::nano>(
+                           std::chrono::steady_clock::now() - begin)
+                           .count() /
+                       (double) sample_cnt;
+            };
+            double const raw_ns = measure(ga.get_raw_allocator());
+            double const checked_ns = measure(ga);
+            MESSAGE("heap " << (heap_size >> 20) << " MB: " << checked_ns
+                            << " ns per free + allocate, " << raw_ns
+                            << " ns without ownership check");
+        }
+        for (void* p : live) {
+            ga.deallocate(p, node_size);
+        }
+        CHECK(!live.empty());
+    }
+
     SUBCASE("Heap growth policy") {
         Size constexpr area_size = byte_128;
         GrowthPolicy<GrowthType::heap, area_size> gp{};
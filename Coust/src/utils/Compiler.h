@@ -25,7 +25,10 @@
         #define DEBUG_BREAK()
     #endif
     #define FORCE_INLINE __attribute__((always_inline))
+    // hint the cache line holding `addr` into the cache for reading
+    #define PREFETCH(addr) __builtin_prefetch(addr)
 #elif defined(_MSC_VER)
+    #include <intrin.h>
     #define RESTRICT __restrict
     #define ASSUME(exp) (__assume(exp))
     #define PRETTY_FUNC __FUNCSIG__
@@ -39,6 +42,12 @@
         COUST_IMPL_DO_PRAGMA(warning(disable : warn))
     #define DEBUG_BREAK() __debugbreak()
     #define FORCE_INLINE [[msvc::forceinline]]
+    // hint the cache line holding `addr` into the cache for reading
+    #if defined(_M_ARM64)
+        #define PREFETCH(addr) __prefetch(addr)
+    #else
+        #define PREFETCH(addr) _mm_prefetch((char const*) (addr), _MM_HINT_T0)
+    #endif
 #else
     #error Unsupported compiler
 #endif
@@ -0,0 +1,237 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/Log.h"
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/AllocationCheck.h"
+
+#if !defined(COUST_REL)
+    #if defined(_WIN32)
+WARNING_PUSH
+DISABLE_ALL_WARNING
+        #define WIN32_LEAN_AND_MEAN
+        #define NOMINMAX
+        #include <windows.h>
+WARNING_POP
+    #elif __has_include(<execinfo.h>)
+        #include <execinfo.h>
+    #endif
+#endif
+
+#include <new>
+#include <cstdlib>
+
+namespace coust {
+namespace memory {
+
+namespace {
+
+struct AllocationCheckState {
+    AllocationCheckScope* scope;
+    // depth of the `detail::AllocationReport`s alive on this thread
+    uint32_t report_depth;
+    AllocationSource tag_source;
+    bool tagged;
+};
+
+// trivial, so it's usable from `operator new` at any point of the thread's
+// lifetime
+thread_local AllocationCheckState s_check_state{};
+
+#if !defined(COUST_REL)
+
+// skip the frames of the allocation check itself
+int constexpr SKIPPED_FRAME_COUNT = 3;
+int constexpr MAX_FRAME_COUNT = 32;
+
+std::string capture_stack() noexcept {
+    #if defined(_WIN32)
+    void* frames[MAX_FRAME_COUNT];
+    USHORT const count = CaptureStackBackTrace(
+        SKIPPED_FRAME_COUNT, MAX_FRAME_COUNT, frames, nullptr);
+    std::string ret{};
+    for (USHORT i = 0; i < count; ++i) {
+        ret += std::format("\t{}\n", frames[i]);
+    }
+    return ret;
+    #elif __has_include(<execinfo.h>)
+    void* frames[MAX_FRAME_COUNT];
+    int const count = backtrace(frames, MAX_FRAME_COUNT);
+    char** const symbols = backtrace_symbols(frames, count);
+    if (symbols == nullptr)
+        return {};
+    std::string ret{};
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    for (int i = SKIPPED_FRAME_COUNT; i < count; ++i) {
+        ret += std::format("\t{}\n", symbols[i]);
+    }
+    WARNING_POP
+    std::free(symbols);
+    return ret;
+    #else
+    return {};
+    #endif
+}
+
+#endif
+
+}  // namespace
+
+std::string_view to_string(AllocationSource source) noexcept {
+    switch (source) {
+        case AllocationSource::default_alloc:
+            return "default_alloc";
+        case AllocationSource::aggregate:
+            return "aggregate";
+        case AllocationSource::heap:
+            return "heap";
+        case AllocationSource::std_allocator:
+            return "std_allocator";
+        case AllocationSource::global_new:
+            return "global_new";
+    }
+    ASSUME(0);
+}
+
+AllocationCheckScope::AllocationCheckScope(
+    std::string_view name, Mode mode) noexcept
+    : m_name(name), m_prev(s_check_state.scope), m_mode(mode) {
+    // the offenders are recorded while the allocators are in the middle of an
+    // allocation, which mustn't recurse into them. the bookkeeping of a scope
+    // isn't an offense of the outer one
+    s_check_state.report_depth++;
+    m_offenders.reserve(MAX_OFFENDER_COUNT);
+    s_check_state.report_depth--;
+    s_check_state.scope = this;
+}
+
+AllocationCheckScope::~AllocationCheckScope() noexcept {
+    COUST_ASSERT(s_check_state.scope == this,
+        "Allocation check scopes must be destroyed in order");
+    s_check_state.scope = m_prev;
+    if (m_allocation_count == 0)
+        return;
+    // the log itself allocates, which the outer scope doesn't care about
+    s_check_state.report_depth++;
+    COUST_WARN("{} allocation(s) ({} bytes) in allocation check scope {}",
+        m_allocation_count, m_allocation_size, m_name);
+    for (auto const& offender : m_offenders) {
+        COUST_WARN("{} bytes from {}\n{}", offender.size,
+            to_string(offender.source), offender.stack);
+    }
+    s_check_state.report_depth--;
+}
+
+size_t AllocationCheckScope::get_allocation_count() const noexcept {
+    return m_allocation_count;
+}
+
+size_t AllocationCheckScope::get_allocation_size() const noexcept {
+    return m_allocation_size;
+}
+
+std::vector<AllocationCheckScope::Offender> const&
+    AllocationCheckScope::get_offenders() const noexcept {
+    return m_offenders;
+}
+
+#if !defined(COUST_REL)
+
+void AllocationCheckScope::record(
+    AllocationSource source, size_t size) noexcept {
+    m_allocation_count++;
+    m_allocation_size += size;
+    if (m_offenders.size() == MAX_OFFENDER_COUNT && m_mode == Mode::count)
+        return;
+    std::string stack = capture_stack();
+    COUST_PANIC_IF(m_mode == Mode::trap,
+        "{} bytes allocated from {} in allocation check scope {}\n{}", size,
+        to_string(source), m_name, stack);
+    if (m_offenders.size() < MAX_OFFENDER_COUNT)
+        m_offenders.push_back(Offender{source, size, std::move(stack)});
+}
+
+namespace detail {
+
+AllocationReport::AllocationReport(
+    AllocationSource source, size_t size) noexcept {
+    auto& state = s_check_state;
+    if (state.report_depth++ > 0 || state.scope == nullptr) [[likely]]
+        return;
+    state.scope->record(state.tagged ? state.tag_source : source, size);
+}
+
+AllocationReport::~AllocationReport() noexcept {
+    s_check_state.report_depth--;
+}
+
+AllocationSourceTag::AllocationSourceTag(AllocationSource source) noexcept
+    : m_prev_source(s_check_state.tag_source),
+      m_prev_tagged(s_check_state.tagged) {
+    s_check_state.tag_source = source;
+    s_check_state.tagged = true;
+}
+
+AllocationSourceTag::~AllocationSourceTag() noexcept {
+    s_check_state.tag_source = m_prev_source;
+    s_check_state.tagged = m_prev_tagged;
+}
+
+}  // namespace detail
+
+#else
+
+void AllocationCheckScope::record(AllocationSource, size_t) noexcept {
+}
+
+#endif
+
+}  // namespace memory
+}  // namespace coust
+
+#if !defined(COUST_REL) && defined(COUST_CHECK_GLOBAL_NEW)
+
+// The replacements of the global allocation functions, so that the memory
+// allocated by `new` & the standard library is watched as well. The other
+// forms (array & nothrow) forward to these by default. Replacing them affects
+// the whole program, so it's only done when asked for by the cmake option
+// `COUST_CHECK_GLOBAL_NEW`.
+
+void* operator new(std::size_t size) {
+    coust::memory::detail::AllocationReport report{
+        coust::memory::AllocationSource::global_new, size};
+    void* const p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc{};
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    coust::memory::detail::AllocationReport report{
+        coust::memory::AllocationSource::global_new, size};
+    void* const p = coust::memory::aligned_alloc(
+        size == 0 ? 1 : size, (std::size_t) alignment);
+    if (p == nullptr)
+        throw std::bad_alloc{};
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    coust::memory::aligned_free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    coust::memory::aligned_free(p);
+}
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "utils/Compiler.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coust {
+namespace memory {
+
+enum class AllocationSource {
+    // `ThreadCachedAllocator`, i.e. `DefaultAlloc`
+    default_alloc,
+    aggregate,
+    // `HeapAllocator`, e.g. the overflow of `FrameArena`
+    heap,
+    // standard containers through `StdAllocator`
+    std_allocator,
+    global_new,
+};
+
+std::string_view to_string(AllocationSource source) noexcept;
+
+// Watch the heap allocations made by the calling thread while the scope is
+// alive, e.g. around a frame which shouldn't allocate anything once the scene
+// is loaded. Every allocation is counted, and the call stacks of the first few
+// are reported when the scope ends. In `trap` mode, the first one panics right
+// away, so the debugger stops at the offender.
+// Allocations are only watched when `COUST_REL` isn't defined, otherwise the
+// scope never sees any. The ones of the engine's allocators are always seen,
+// the ones of `new` & the standard library only if `COUST_CHECK_GLOBAL_NEW` is
+// defined. Scopes can be nested, the innermost one is reported to.
+class AllocationCheckScope {
+public:
+    AllocationCheckScope() = delete;
+    AllocationCheckScope(AllocationCheckScope&&) = delete;
+    AllocationCheckScope(AllocationCheckScope const&) = delete;
+    AllocationCheckScope& operator=(AllocationCheckScope&&) = delete;
+    AllocationCheckScope& operator=(AllocationCheckScope const&) = delete;
+
+public:
+    enum class Mode {
+        count,
+        trap,
+    };
+
+    struct Offender {
+        AllocationSource source;
+        size_t size;
+        // empty if the platform can't walk the stack
+        std::string stack;
+    };
+
+    static size_t constexpr MAX_OFFENDER_COUNT = 16u;
+
+public:
+    explicit AllocationCheckScope(
+        std::string_view name, Mode mode = Mode::count) noexcept;
+
+    // log the offenders if there is any
+    ~AllocationCheckScope() noexcept;
+
+    size_t get_allocation_count() const noexcept;
+
+    size_t get_allocation_size() const noexcept;
+
+    // the first `MAX_OFFENDER_COUNT` allocations
+    std::vector<Offender> const& get_offenders() const noexcept;
+
+    // called by the allocators, see `detail::AllocationReport`
+    void record(AllocationSource source, size_t size) noexcept;
+
+private:
+    std::vector<Offender> m_offenders{};
+    std::string_view m_name;
+    AllocationCheckScope* m_prev;
+    size_t m_allocation_count = 0;
+    size_t m_allocation_size = 0;
+    Mode m_mode;
+};
+
+namespace detail {
+
+#if !defined(COUST_REL)
+
+// Report an allocation to the innermost `AllocationCheckScope` of the calling
+// thread. Whatever is allocated underneath before it goes out of scope (e.g.
+// the back end refilling a thread cache) is part of the same allocation, so
+// it isn't reported again.
+class AllocationReport {
+public:
+    AllocationReport() = delete;
+    AllocationReport(AllocationReport&&) = delete;
+    AllocationReport(AllocationReport const&) = delete;
+    AllocationReport& operator=(AllocationReport&&) = delete;
+    AllocationReport& operator=(AllocationReport const&) = delete;
+
+public:
+    AllocationReport(AllocationSource source, size_t size) noexcept;
+
+    ~AllocationReport() noexcept;
+};
+
+// Attribute the allocations reported before it goes out of scope to `source`
+// without reporting anything by itself. A `StdAllocator` over an arena
+// doesn't touch the heap until the arena overflows.
+class AllocationSourceTag {
+public:
+    AllocationSourceTag() = delete;
+    AllocationSourceTag(AllocationSourceTag&&) = delete;
+    AllocationSourceTag(AllocationSourceTag const&) = delete;
+    AllocationSourceTag& operator=(AllocationSourceTag&&) = delete;
+    AllocationSourceTag& operator=(AllocationSourceTag const&) = delete;
+
+public:
+    explicit AllocationSourceTag(AllocationSource source) noexcept;
+
+    ~AllocationSourceTag() noexcept;
+
+private:
+    AllocationSource m_prev_source;
+    bool m_prev_tagged;
+};
+
+#else
+
+class AllocationReport {
+public:
+    AllocationReport(AllocationSource, size_t) noexcept {}
+};
+
+class AllocationSourceTag {
+public:
+    explicit AllocationSourceTag(AllocationSource) noexcept {}
+};
+
+#endif
+
+}  // namespace detail
+
+}  // namespace memory
+}  // namespace coust
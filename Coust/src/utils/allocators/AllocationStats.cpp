@@ -0,0 +1,53 @@
+#include "pch.h"
+
+#include "utils/allocators/AllocationStats.h"
+
+#include <bit>
+
+namespace coust {
+namespace memory {
+
+size_t AllocationStats::get_histogram_bucket(size_t size) noexcept {
+    return std::min(
+        (size_t) std::bit_width(size - 1), HISTOGRAM_BUCKET_COUNT - 1);
+}
+
+void AllocationStats::record_allocation(size_t size) noexcept {
+    live_size += size;
+    peak_live_size = std::max(peak_live_size, live_size);
+    live_count++;
+    peak_live_count = std::max(peak_live_count, live_count);
+    allocation_count++;
+    size_histogram[get_histogram_bucket(size)]++;
+}
+
+void AllocationStats::record_deallocation(size_t size) noexcept {
+    live_size -= size;
+    live_count--;
+    deallocation_count++;
+}
+
+double AllocationStats::get_fragmentation_ratio() const noexcept {
+    if (reserved_size == 0)
+        return 0.0;
+    return 1.0 - (double) live_size / (double) reserved_size;
+}
+
+void AllocationStats::dump_json(std::string& out) const noexcept {
+    std::format_to(std::back_inserter(out),
+        "{{\"live_size\":{},\"peak_live_size\":{},\"live_count\":{},"
+        "\"peak_live_count\":{},\"allocation_count\":{},"
+        "\"deallocation_count\":{},\"reserved_size\":{},"
+        "\"fragmentation_ratio\":{:.4f},\"size_histogram\":[",
+        live_size, peak_live_size, live_count, peak_live_count,
+        allocation_count, deallocation_count, reserved_size,
+        get_fragmentation_ratio());
+    for (size_t i = 0; i < size_histogram.size(); ++i) {
+        std::format_to(std::back_inserter(out), "{}{}", i == 0 ? "" : ",",
+            size_histogram[i]);
+    }
+    out += "]}";
+}
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+
+#include <array>
+#include <string>
+
+namespace coust {
+namespace memory {
+
+// Counters of the allocations served by an allocator. Recording costs a few
+// increments, so it's always on, and it's up to the owner of the counters to
+// keep them thread-safe.
+struct AllocationStats {
+    // bucket `i` counts the requests of size in (2^(i-1), 2^i]
+    static size_t constexpr HISTOGRAM_BUCKET_COUNT = 32u;
+
+    // the bytes requested and not freed yet
+    size_t live_size = 0;
+    size_t peak_live_size = 0;
+    size_t live_count = 0;
+    size_t peak_live_count = 0;
+    size_t allocation_count = 0;
+    size_t deallocation_count = 0;
+    // the memory the allocator holds from upstream. it isn't known to the
+    // allocation path, the owner fills it when the stats is queried
+    size_t reserved_size = 0;
+    std::array<size_t, HISTOGRAM_BUCKET_COUNT> size_histogram{};
+
+    // the bucket of `size` in `size_histogram`
+    static size_t get_histogram_bucket(size_t size) noexcept;
+
+    void record_allocation(size_t size) noexcept;
+
+    void record_deallocation(size_t size) noexcept;
+
+    // the share of reserved memory that isn't handed out, i.e. internal &
+    // external fragmentation plus the free space never touched
+    double get_fragmentation_ratio() const noexcept;
+
+    // append the stats as a JSON object. `std::string` is used on purpose, so
+    // that dumping the stats doesn't disturb the allocators being measured
+    void dump_json(std::string& out) const noexcept;
+};
+
+}  // namespace memory
+}  // namespace coust
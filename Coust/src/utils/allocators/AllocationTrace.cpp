@@ -0,0 +1,168 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/AllocationTrace.h"
+
+#if defined(_WIN32)
+WARNING_PUSH
+DISABLE_ALL_WARNING
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+WARNING_POP
+#else
+    #include <unistd.h>
+#endif
+
+namespace coust {
+namespace memory {
+
+namespace {
+
+struct TraceHeader {
+    uint32_t magic_number = AllocationTraceRecorder::MAGIC_NUMBER;
+    uint32_t version = AllocationTraceRecorder::VERSION;
+    uint32_t event_size = sizeof(AllocationEvent);
+    uint32_t padding = 0;
+};
+
+uint32_t get_thread_index() noexcept {
+    static std::atomic<uint32_t> s_thread_count{0};
+    thread_local uint32_t const s_thread_index =
+        s_thread_count.fetch_add(1, std::memory_order_relaxed);
+    return s_thread_index;
+}
+
+}  // namespace
+
+AllocationTraceRecorder::AllocationTraceRecorder(
+    std::filesystem::path const& path) noexcept
+    : m_file(path, std::ios::binary),
+      m_start(std::chrono::steady_clock::now()) {
+    COUST_PANIC_IF_NOT(m_file.is_open(),
+        "Can't open file {} to record allocation trace", path.string());
+    TraceHeader const header{};
+    m_file.write((char const*) &header, sizeof(header));
+    m_buffer.reserve(BUFFER_CAPACITY);
+}
+
+AllocationTraceRecorder::~AllocationTraceRecorder() noexcept {
+    flush();
+}
+
+void AllocationTraceRecorder::record(AllocationEvent::Kind kind, void* p,
+    size_t size, size_t alignment, size_t size_class) noexcept {
+    auto const timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start);
+    m_buffer.push_back(AllocationEvent{
+        .timestamp = (uint64_t) timestamp.count(),
+        .address = (uint64_t) (uintptr_t) p,
+        .size = size,
+        .thread = get_thread_index(),
+        .alignment = (uint16_t) alignment,
+        .size_class = (uint8_t) size_class,
+        .kind = kind,
+    });
+    ++m_event_count;
+    if (m_buffer.size() == BUFFER_CAPACITY)
+        flush();
+}
+
+void AllocationTraceRecorder::flush() noexcept {
+    m_file.write((char const*) m_buffer.data(),
+        (std::streamsize) (m_buffer.size() * sizeof(AllocationEvent)));
+    m_file.flush();
+    m_buffer.clear();
+}
+
+size_t AllocationTraceRecorder::get_event_count() const noexcept {
+    return m_event_count;
+}
+
+std::vector<AllocationEvent> read_allocation_trace(
+    std::filesystem::path const& path) noexcept {
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    COUST_PANIC_IF_NOT(file.is_open(), "Can't open allocation trace {}",
+        path.string());
+    size_t const file_size = (size_t) file.tellg();
+    file.seekg(0);
+    TraceHeader header{};
+    file.read((char*) &header, sizeof(header));
+    COUST_PANIC_IF(file_size < sizeof(header) ||
+                       header.magic_number !=
+                           AllocationTraceRecorder::MAGIC_NUMBER,
+        "{} isn't an allocation trace", path.string());
+    COUST_PANIC_IF(header.version != AllocationTraceRecorder::VERSION ||
+                       header.event_size != sizeof(AllocationEvent),
+        "Allocation trace {} is recorded in version {}, expected {}",
+        path.string(), header.version, AllocationTraceRecorder::VERSION);
+    std::vector<AllocationEvent> ret(
+        (file_size - sizeof(header)) / sizeof(AllocationEvent));
+    file.read((char*) ret.data(),
+        (std::streamsize) (ret.size() * sizeof(AllocationEvent)));
+    return ret;
+}
+
+double ReplayReport::get_operations_per_second() const noexcept {
+    if (seconds == 0.0)
+        return 0.0;
+    return (double) operation_count / seconds;
+}
+
+double ReplayReport::get_fragmentation_ratio() const noexcept {
+    if (peak_rss_size <= peak_live_size)
+        return 0.0;
+    return 1.0 - (double) peak_live_size / (double) peak_rss_size;
+}
+
+namespace detail {
+
+size_t get_resident_set_size() noexcept {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!K32GetProcessMemoryInfo(
+            GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (size_t) counters.WorkingSetSize;
+#else
+    // the second field is the number of resident pages
+    std::FILE* const file = std::fopen("/proc/self/statm", "r");
+    if (!file)
+        return 0;
+    size_t total_page_count = 0;
+    size_t resident_page_count = 0;
+    int const matched =
+        std::fscanf(file, "%zu %zu", &total_page_count, &resident_page_count);
+    std::fclose(file);
+    if (matched != 2)
+        return 0;
+    return resident_page_count * (size_t) sysconf(_SC_PAGESIZE);
+#endif
+}
+
+std::pair<std::vector<uint32_t>, size_t> resolve_replay_slots(
+    std::span<AllocationEvent const> events) noexcept {
+    std::vector<uint32_t> event_slots(events.size(), INVALID_SLOT);
+    // address -> slot of the live allocation at that address
+    std::unordered_map<uint64_t, uint32_t> live_slots{};
+    uint32_t slot_count = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        AllocationEvent const& event = events[i];
+        if (event.kind == AllocationEvent::Kind::allocate) {
+            event_slots[i] = slot_count;
+            live_slots[event.address] = slot_count++;
+        } else if (auto const iter = live_slots.find(event.address);
+                   iter != live_slots.end()) {
+            event_slots[i] = iter->second;
+            live_slots.erase(iter);
+        }
+    }
+    return {std::move(event_slots), (size_t) slot_count};
+}
+
+}  // namespace detail
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace coust {
+namespace memory {
+
+struct AllocationEvent {
+    enum class Kind : uint8_t {
+        allocate,
+        deallocate,
+    };
+
+    // nanoseconds since the recording started
+    uint64_t timestamp = 0;
+    // only used to pair a deallocation with its allocation
+    uint64_t address = 0;
+    uint64_t size = 0;
+    // threads are numbered in the order they first touch any recorder
+    uint32_t thread = 0;
+    uint16_t alignment = 0;
+    // the statistics slot of the allocator, i.e. the size class for small
+    // allocations
+    uint8_t size_class = 0;
+    Kind kind = Kind::allocate;
+};
+
+static_assert(sizeof(AllocationEvent) == 32);
+
+// Writes every event to a binary file: a small header followed by the raw
+// `AllocationEvent`s. Events are buffered and flushed in batches, and the
+// buffer comes from the standard allocator, so recording never goes through
+// the allocator being traced. Like `AllocationStats`, it's up to the owner to
+// keep it thread-safe.
+class AllocationTraceRecorder {
+public:
+    AllocationTraceRecorder() = delete;
+    AllocationTraceRecorder(AllocationTraceRecorder&&) = delete;
+    AllocationTraceRecorder(AllocationTraceRecorder const&) = delete;
+    AllocationTraceRecorder& operator=(AllocationTraceRecorder&&) = delete;
+    AllocationTraceRecorder& operator=(AllocationTraceRecorder const&) = delete;
+
+public:
+    static uint32_t constexpr MAGIC_NUMBER = 0x43545241;
+    static uint32_t constexpr VERSION = 1u;
+
+public:
+    explicit AllocationTraceRecorder(
+        std::filesystem::path const& path) noexcept;
+
+    ~AllocationTraceRecorder() noexcept;
+
+    void record(AllocationEvent::Kind kind, void* p, size_t size,
+        size_t alignment, size_t size_class) noexcept;
+
+    void flush() noexcept;
+
+    size_t get_event_count() const noexcept;
+
+private:
+    static size_t constexpr BUFFER_CAPACITY = 4096u;
+
+private:
+    std::ofstream m_file;
+    std::vector<AllocationEvent> m_buffer;
+    std::chrono::steady_clock::time_point m_start;
+    size_t m_event_count = 0;
+};
+
+std::vector<AllocationEvent> read_allocation_trace(
+    std::filesystem::path const& path) noexcept;
+
+struct ReplayReport {
+    size_t operation_count = 0;
+    // allocations that returned nullptr
+    size_t failed_count = 0;
+    // time spent inside the allocator, excluding the sampling of memory usage
+    double seconds = 0.0;
+    // the bytes requested by the trace at its peak
+    size_t peak_live_size = 0;
+    // the growth of resident memory over the one before replaying
+    size_t peak_rss_size = 0;
+
+    double get_operations_per_second() const noexcept;
+
+    // the share of resident memory that isn't requested by the trace
+    double get_fragmentation_ratio() const noexcept;
+};
+
+namespace detail {
+
+uint32_t constexpr INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+size_t get_resident_set_size() noexcept;
+
+// map the address of every event to the slot of its allocation. deallocations
+// of memory allocated before the recording started get `INVALID_SLOT`
+std::pair<std::vector<uint32_t>, size_t> resolve_replay_slots(
+    std::span<AllocationEvent const> events) noexcept;
+
+}  // namespace detail
+
+// Feed the trace to `alloc` in the recorded order as fast as possible. The
+// events of all threads are replayed on the calling thread, and every page of
+// a block is touched once like a real workload would.
+template <detail::Allocator Alloc>
+ReplayReport replay_allocation_trace(
+    std::span<AllocationEvent const> events, Alloc& alloc) noexcept {
+    using clock = std::chrono::steady_clock;
+    // sampling the resident memory is a system call, so do it once in a while
+    size_t constexpr SAMPLE_INTERVAL = 1024u;
+    size_t constexpr TOUCH_STRIDE = 4096u;
+
+    auto const [event_slots, slot_count] = detail::resolve_replay_slots(events);
+    std::vector<void*> slots(slot_count, nullptr);
+    ReplayReport ret{};
+    size_t const rss_baseline = detail::get_resident_set_size();
+    size_t live_size = 0;
+    clock::duration elapsed{};
+    auto sample_begin = clock::now();
+    for (size_t i = 0; i < events.size(); ++i) {
+        AllocationEvent const& event = events[i];
+        uint32_t const slot = event_slots[i];
+        if (slot == detail::INVALID_SLOT)
+            continue;
+        if (event.kind == AllocationEvent::Kind::allocate) {
+            char* p = (char*) alloc.allocate(event.size, event.alignment);
+            slots[slot] = p;
+            if (p) {
+                WARNING_PUSH
+                CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+                for (size_t offset = 0; offset < event.size;
+                     offset += TOUCH_STRIDE) {
+                    p[offset] = 0;
+                }
+                WARNING_POP
+                live_size += event.size;
+            } else {
+                ++ret.failed_count;
+            }
+        } else if (slots[slot]) {
+            alloc.deallocate(slots[slot], event.size);
+            slots[slot] = nullptr;
+            live_size -= event.size;
+        }
+        ++ret.operation_count;
+        ret.peak_live_size = std::max(ret.peak_live_size, live_size);
+        if (ret.operation_count % SAMPLE_INTERVAL == 0) {
+            elapsed += clock::now() - sample_begin;
+            size_t const rss = detail::get_resident_set_size();
+            ret.peak_rss_size =
+                std::max(ret.peak_rss_size, rss - std::min(rss, rss_baseline));
+            sample_begin = clock::now();
+        }
+    }
+    elapsed += clock::now() - sample_begin;
+    size_t const rss = detail::get_resident_set_size();
+    ret.peak_rss_size =
+        std::max(ret.peak_rss_size, rss - std::min(rss, rss_baseline));
+    ret.seconds = std::chrono::duration<double>(elapsed).count();
+    // the blocks still alive at the end of the trace
+    for (size_t i = 0; i < events.size(); ++i) {
+        uint32_t const slot = event_slots[i];
+        if (slot != detail::INVALID_SLOT && slots[slot]) {
+            alloc.deallocate(slots[slot], events[i].size);
+            slots[slot] = nullptr;
+        }
+    }
+    return ret;
+}
+
+}  // namespace memory
+}  // namespace coust
@@ -70,7 +70,8 @@ inline void* aligned_alloc(size_t size, size_t alignment) noexcept {
 #ifdef _MSC_VER
     p = _aligned_malloc(size, alignment);
 #else
-    p = std::aligned_alloc(size, alignment);
+    p = std::aligned_alloc(
+        alignment, ptr_math::round_up_to_alinged(size, alignment));
 #endif
     return p;
 }
@@ -102,6 +103,81 @@ concept GrowableAllocator = Allocator<T> && requires(T& a) {
     { a.grow((void*) nullptr, size_t{}) } noexcept -> std::same_as<void>;
 };
 
+// a growable allocator which can give up whole areas passed to `grow` again,
+// `shrink` returns false (and keeps using the range) if any block in the
+// range is still in use
+template <typename T>
+concept ShrinkableAllocator = GrowableAllocator<T> && requires(T& a) {
+    {
+        a.shrink((void*) nullptr, (void*) nullptr)
+    } noexcept -> std::same_as<bool>;
+};
+
+// an allocator which can serve a size known at compile time faster, e.g. by
+// resolving its size class at compile time
+template <typename T>
+concept FixedSizeAllocator = Allocator<T> && requires(T& a) {
+    { a.template allocate_fixed<8, 8>() } noexcept -> std::same_as<void*>;
+    {
+        a.template deallocate_fixed<8>((void*) nullptr)
+    } noexcept -> std::same_as<void>;
+};
+
+template <size_t Size, size_t Alignment, Allocator Alloc>
+void* allocate_fixed(Alloc& alloc) noexcept {
+    if constexpr (FixedSizeAllocator<Alloc>) {
+        return alloc.template allocate_fixed<Size, Alignment>();
+    } else {
+        return alloc.allocate(Size, Alignment);
+    }
+}
+
+template <size_t Size, Allocator Alloc>
+void deallocate_fixed(Alloc& alloc, void* p) noexcept {
+    if constexpr (FixedSizeAllocator<Alloc>) {
+        alloc.template deallocate_fixed<Size>(p);
+    } else {
+        alloc.deallocate(p, Size);
+    }
+}
+
+// an allocator which can resize a block without moving it, e.g. by merging it
+// with the free space right after it. `try_expand` returns false (and leaves
+// the block untouched) if the block can't hold `new_size` bytes in place,
+// otherwise the block must be deallocated with `new_size` afterwards
+template <typename T>
+concept ExpandableAllocator = Allocator<T> && requires(T& a) {
+    {
+        a.try_expand((void*) nullptr, size_t{}, size_t{})
+    } noexcept -> std::same_as<bool>;
+};
+
+template <Allocator Alloc>
+bool try_expand(
+    Alloc& alloc, void* p, size_t old_size, size_t new_size) noexcept {
+    if constexpr (ExpandableAllocator<Alloc>) {
+        return alloc.try_expand(p, old_size, new_size);
+    } else {
+        return false;
+    }
+}
+
+// an allocator which can tell whether a block comes from it, so that the
+// block can be handed back to the right allocator of a composition
+template <typename T>
+concept OwningAllocator = Allocator<T> && requires(T const& a) {
+    { a.contained((void*) nullptr) } noexcept -> std::same_as<bool>;
+};
+
+// an allocator declaring `concurrent` as `std::true_type` can be used by
+// several threads at once without any external synchronization
+template <typename T>
+bool constexpr is_concurrent_allocator = false;
+
+template <typename T>
+    requires requires { typename T::concurrent; }
+bool constexpr is_concurrent_allocator<T> = T::concurrent::value;
+
 }  // namespace detail
 }  // namespace memory
 }  // namespace coust
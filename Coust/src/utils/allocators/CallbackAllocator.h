@@ -0,0 +1,165 @@
+#pragma once
+
+#include "utils/Assert.h"
+#include "utils/PtrMath.h"
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/AllocationStats.h"
+
+#include <array>
+#include <mutex>
+#include <cstring>
+
+namespace coust {
+namespace memory {
+
+// Allocator behind the host allocation callbacks of C APIs, e.g.
+// `VkAllocationCallbacks`, which reallocate & free blocks without their size,
+// and ask for any alignment. Every block is preceded by a header recording
+// where it comes from, and the allocations are counted per tag (e.g. the
+// vulkan allocation scope), along with the ones the API makes by itself and
+// only notifies about.
+// It's as thread safe as `Upstream`, the stats are guarded by a mutex.
+template <detail::Allocator Upstream, size_t TagCount>
+class CallbackAllocator {
+public:
+    CallbackAllocator() = delete;
+    CallbackAllocator(CallbackAllocator&&) = delete;
+    CallbackAllocator(CallbackAllocator const&) = delete;
+    CallbackAllocator& operator=(CallbackAllocator&&) = delete;
+    CallbackAllocator& operator=(CallbackAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+    struct TagStats {
+        // the bytes requested through the callbacks, headers excluded
+        AllocationStats stats{};
+        size_t reallocation_count = 0;
+        // the bytes allocated by the API itself, e.g. executable memory
+        AllocationStats internal_stats{};
+    };
+
+public:
+    explicit CallbackAllocator(Upstream& upstream) noexcept
+        : m_upstream(upstream) {}
+
+    ~CallbackAllocator() noexcept = default;
+
+    // return nullptr on failure, as the callbacks are expected to
+    void* allocate(size_t size, size_t alignment, size_t tag) noexcept {
+        COUST_ASSERT(tag < TagCount, "");
+        alignment = std::max(alignment, DEFAULT_ALIGNMENT);
+        size_t const total_size = get_total_size(size, alignment);
+        void* const base = m_upstream.allocate(total_size, alignof(Header));
+        if (base == nullptr)
+            return nullptr;
+        void* const p =
+            ptr_math::align(ptr_math::add(base, HEADER_SPACE), alignment);
+        *get_header(p) = Header{base, total_size, size, tag};
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stats[tag].stats.record_allocation(size);
+        return p;
+    }
+
+    // `p` can be nullptr, then it's an allocation. `size` can be 0, then it's
+    // a deallocation. the block is resized in place whenever possible
+    void* reallocate(
+        void* p, size_t size, size_t alignment, size_t tag) noexcept {
+        if (p == nullptr)
+            return allocate(size, alignment, tag);
+        if (size == 0) {
+            deallocate(p);
+            return nullptr;
+        }
+        COUST_ASSERT(tag < TagCount, "");
+        Header* const header = get_header(p);
+        size_t const old_size = header->size;
+        if (ptr_math::is_aligned(p, std::max(alignment, DEFAULT_ALIGNMENT))) {
+            size_t const offset = ptr_math::sub(p, header->base);
+            size_t const new_total_size = offset + size;
+            if (new_total_size <= header->total_size ||
+                detail::try_expand(m_upstream, header->base,
+                    header->total_size, new_total_size)) {
+                header->total_size =
+                    std::max(header->total_size, new_total_size);
+                header->size = size;
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_stats[header->tag].stats.record_deallocation(old_size);
+                m_stats[tag].stats.record_allocation(size);
+                m_stats[tag].reallocation_count++;
+                header->tag = tag;
+                return p;
+            }
+        }
+        void* const new_p = allocate(size, alignment, tag);
+        if (new_p == nullptr)
+            return nullptr;
+        std::memcpy(new_p, p, std::min(old_size, size));
+        deallocate(p);
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stats[tag].reallocation_count++;
+        return new_p;
+    }
+
+    void deallocate(void* p) noexcept {
+        if (p == nullptr)
+            return;
+        Header const header = *get_header(p);
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_stats[header.tag].stats.record_deallocation(header.size);
+        }
+        m_upstream.deallocate(header.base, header.total_size);
+    }
+
+    void record_internal_allocation(size_t size, size_t tag) noexcept {
+        COUST_ASSERT(tag < TagCount, "");
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stats[tag].internal_stats.record_allocation(size);
+    }
+
+    void record_internal_deallocation(size_t size, size_t tag) noexcept {
+        COUST_ASSERT(tag < TagCount, "");
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stats[tag].internal_stats.record_deallocation(size);
+    }
+
+    TagStats get_stats(size_t tag) const noexcept {
+        COUST_ASSERT(tag < TagCount, "");
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_stats[tag];
+    }
+
+private:
+    struct Header {
+        // the block allocated from upstream
+        void* base;
+        size_t total_size;
+        // the size requested
+        size_t size;
+        size_t tag;
+    };
+
+    static size_t constexpr HEADER_SPACE =
+        ptr_math::round_up_to_alinged(sizeof(Header), DEFAULT_ALIGNMENT);
+
+    // upstream blocks might only be aligned to the header (e.g. a 40 B block
+    // of a size class), so the padding before the header is budgeted for the
+    // worst case
+    static constexpr size_t get_total_size(
+        size_t size, size_t alignment) noexcept {
+        return HEADER_SPACE + size + (alignment - 1);
+    }
+
+    static Header* get_header(void* p) noexcept {
+        return (Header*) ptr_math::sub(p, sizeof(Header));
+    }
+
+private:
+    Upstream& m_upstream;
+    std::array<TagStats, TagCount> m_stats{};
+    mutable std::mutex m_mutex{};
+};
+
+}  // namespace memory
+}  // namespace coust
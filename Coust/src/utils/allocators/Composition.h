@@ -0,0 +1,435 @@
+#pragma once
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/PtrMath.h"
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/AllocationStats.h"
+#include "utils/allocators/Area.h"
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+// Building blocks which compose allocators at compile time, e.g.
+//
+//  Segregator<byte_512, Bucketizer<HomoAlloc_S, 0, byte_512, byte_64>,
+//      FallbackAllocator<AreaAllocator<TLSFAllocator>, HeapAllocator>>
+//
+// Every block is an allocator itself, so the dispatch is resolved by the
+// types instead of a runtime switch, and sizes known at compile time skip it
+// entirely. A composition is concurrent if all of its parts are.
+
+namespace coust {
+namespace memory {
+
+// A raw allocator over a single area (e.g. on the stack) which never grows,
+// so it runs out of memory by returning nullptr, and it knows which blocks
+// are its own. It's the usual primary allocator of `FallbackAllocator`.
+template <detail::Allocator Raw_Alloc>
+class AreaAllocator {
+public:
+    AreaAllocator(AreaAllocator&&) = delete;
+    AreaAllocator(AreaAllocator const&) = delete;
+    AreaAllocator& operator=(AreaAllocator&&) = delete;
+    AreaAllocator& operator=(AreaAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+    using concurrent =
+        std::bool_constant<detail::is_concurrent_allocator<Raw_Alloc>>;
+
+public:
+    template <typename... Alloc_Args>
+    AreaAllocator(void* begin, void* end, Alloc_Args&&... args) noexcept
+        requires(std::constructible_from<Raw_Alloc, void*, void*,
+            Alloc_Args...>)
+        : m_area(begin, end),
+          m_raw_allocator(begin, end, std::forward<Alloc_Args>(args)...) {}
+
+    template <size_t Capacity, typename... Alloc_Args>
+    AreaAllocator(
+        std::array<char, Capacity>& stack_area, Alloc_Args&&... args) noexcept
+        requires(std::constructible_from<Raw_Alloc, void*, void*,
+            Alloc_Args...>)
+        : AreaAllocator((void*) stack_area.data(),
+              (void*) ptr_math::add(stack_area.data(), Capacity),
+              std::forward<Alloc_Args>(args)...) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        return m_raw_allocator.allocate(size, alignment);
+    }
+
+    void deallocate(void* p, size_t size) noexcept {
+        m_raw_allocator.deallocate(p, size);
+    }
+
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept
+        requires(detail::ExpandableAllocator<Raw_Alloc>)
+    {
+        return m_raw_allocator.try_expand(p, old_size, new_size);
+    }
+
+    bool contained(void* p) const noexcept { return m_area.contained(p); }
+
+    Raw_Alloc& get_raw_allocator() noexcept { return m_raw_allocator; }
+
+private:
+    Area m_area;
+    Raw_Alloc m_raw_allocator;
+};
+
+// Serve the blocks up to `Threshold` bytes from `Small`, and the others from
+// `Large`. The size picks the allocator both ways, so neither of them has to
+// know its own blocks.
+template <size_t Threshold, detail::Allocator Small, detail::Allocator Large>
+class Segregator {
+public:
+    Segregator(Segregator&&) = delete;
+    Segregator(Segregator const&) = delete;
+    Segregator& operator=(Segregator&&) = delete;
+    Segregator& operator=(Segregator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+    using concurrent =
+        std::bool_constant<detail::is_concurrent_allocator<Small> &&
+                           detail::is_concurrent_allocator<Large>>;
+
+public:
+    Segregator() noexcept
+        requires(std::is_default_constructible_v<Small> &&
+                 std::is_default_constructible_v<Large>)
+        : m_small(), m_large() {}
+
+    // the arguments of each allocator, like the piecewise construction of
+    // `std::pair`
+    template <typename... Small_Args, typename... Large_Args>
+    Segregator(std::piecewise_construct_t,
+        std::tuple<Small_Args...> small_args,
+        std::tuple<Large_Args...> large_args) noexcept
+        : m_small(std::make_from_tuple<Small>(std::move(small_args))),
+          m_large(std::make_from_tuple<Large>(std::move(large_args))) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        return size <= Threshold ? m_small.allocate(size, alignment) :
+                                   m_large.allocate(size, alignment);
+    }
+
+    void deallocate(void* p, size_t size) noexcept {
+        if (size <= Threshold)
+            m_small.deallocate(p, size);
+        else
+            m_large.deallocate(p, size);
+    }
+
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        if constexpr (Size <= Threshold)
+            return detail::allocate_fixed<Size, Alignment>(m_small);
+        else
+            return detail::allocate_fixed<Size, Alignment>(m_large);
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        if constexpr (Size <= Threshold)
+            detail::deallocate_fixed<Size>(m_small, p);
+        else
+            detail::deallocate_fixed<Size>(m_large, p);
+    }
+
+    // a block never moves across the threshold
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept
+        requires(detail::ExpandableAllocator<Small> ||
+                 detail::ExpandableAllocator<Large>)
+    {
+        if ((old_size <= Threshold) != (new_size <= Threshold))
+            return false;
+        return old_size <= Threshold ?
+                   detail::try_expand(m_small, p, old_size, new_size) :
+                   detail::try_expand(m_large, p, old_size, new_size);
+    }
+
+    bool contained(void* p) const noexcept
+        requires(detail::OwningAllocator<Small> &&
+                 detail::OwningAllocator<Large>)
+    {
+        return m_small.contained(p) || m_large.contained(p);
+    }
+
+    Small& get_small() noexcept { return m_small; }
+
+    Large& get_large() noexcept { return m_large; }
+
+private:
+    Small m_small;
+    Large m_large;
+};
+
+// Serve from `Primary` as long as it can, and from `Fallback` once it returns
+// nullptr. `Primary` tells which blocks go back to it.
+template <detail::OwningAllocator Primary, detail::Allocator Fallback>
+class FallbackAllocator {
+public:
+    FallbackAllocator(FallbackAllocator&&) = delete;
+    FallbackAllocator(FallbackAllocator const&) = delete;
+    FallbackAllocator& operator=(FallbackAllocator&&) = delete;
+    FallbackAllocator& operator=(FallbackAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+    using concurrent =
+        std::bool_constant<detail::is_concurrent_allocator<Primary> &&
+                           detail::is_concurrent_allocator<Fallback>>;
+
+public:
+    FallbackAllocator() noexcept
+        requires(std::is_default_constructible_v<Primary> &&
+                 std::is_default_constructible_v<Fallback>)
+        : m_primary(), m_fallback() {}
+
+    template <typename... Primary_Args, typename... Fallback_Args>
+    FallbackAllocator(std::piecewise_construct_t,
+        std::tuple<Primary_Args...> primary_args,
+        std::tuple<Fallback_Args...> fallback_args) noexcept
+        : m_primary(std::make_from_tuple<Primary>(std::move(primary_args))),
+          m_fallback(
+              std::make_from_tuple<Fallback>(std::move(fallback_args))) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* const p = m_primary.allocate(size, alignment);
+        return p ? p : m_fallback.allocate(size, alignment);
+    }
+
+    void deallocate(void* p, size_t size) noexcept {
+        if (p == nullptr)
+            return;
+        if (m_primary.contained(p))
+            m_primary.deallocate(p, size);
+        else
+            m_fallback.deallocate(p, size);
+    }
+
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        void* const p = detail::allocate_fixed<Size, Alignment>(m_primary);
+        return p ? p : detail::allocate_fixed<Size, Alignment>(m_fallback);
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        if (p == nullptr)
+            return;
+        if (m_primary.contained(p))
+            detail::deallocate_fixed<Size>(m_primary, p);
+        else
+            detail::deallocate_fixed<Size>(m_fallback, p);
+    }
+
+    // a block is only resized by the allocator it comes from
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept
+        requires(detail::ExpandableAllocator<Primary> ||
+                 detail::ExpandableAllocator<Fallback>)
+    {
+        return m_primary.contained(p) ?
+                   detail::try_expand(m_primary, p, old_size, new_size) :
+                   detail::try_expand(m_fallback, p, old_size, new_size);
+    }
+
+    bool contained(void* p) const noexcept
+        requires(detail::OwningAllocator<Fallback>)
+    {
+        return m_primary.contained(p) || m_fallback.contained(p);
+    }
+
+    Primary& get_primary() noexcept { return m_primary; }
+
+    Fallback& get_fallback() noexcept { return m_fallback; }
+
+private:
+    Primary m_primary;
+    Fallback m_fallback;
+};
+
+// Spread the sizes in (`Min`, `Max`] over `(Max - Min) / Step` instances of
+// `Alloc`, each serving a range of `Step` bytes, e.g. pools of different
+// block sizes. Every instance is constructed from the same arguments followed
+// by the largest size of its range.
+template <detail::Allocator Alloc, size_t Min, size_t Max, size_t Step>
+class Bucketizer {
+public:
+    Bucketizer(Bucketizer&&) = delete;
+    Bucketizer(Bucketizer const&) = delete;
+    Bucketizer& operator=(Bucketizer&&) = delete;
+    Bucketizer& operator=(Bucketizer const&) = delete;
+
+public:
+    using stateful = std::true_type;
+    using concurrent =
+        std::bool_constant<detail::is_concurrent_allocator<Alloc>>;
+
+    static_assert(Min < Max && Step > 0 && (Max - Min) % Step == 0,
+        "The range of a bucketizer must be made of whole steps");
+
+    static size_t constexpr BUCKET_COUNT = (Max - Min) / Step;
+
+    static constexpr size_t get_bucket_index(size_t size) noexcept {
+        return (size - Min - 1) / Step;
+    }
+
+    static constexpr size_t get_bucket_size(size_t bucket_idx) noexcept {
+        return Min + (bucket_idx + 1) * Step;
+    }
+
+public:
+    template <typename... Alloc_Args>
+    explicit Bucketizer(Alloc_Args&... args) noexcept
+        requires(std::constructible_from<Alloc, Alloc_Args&..., size_t>)
+        : Bucketizer(std::make_index_sequence<BUCKET_COUNT>{}, args...) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        return m_buckets[get_checked_bucket_index(size)].allocate(
+            size, alignment);
+    }
+
+    void deallocate(void* p, size_t size) noexcept {
+        m_buckets[get_checked_bucket_index(size)].deallocate(p, size);
+    }
+
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        static_assert(Min < Size && Size <= Max,
+            "The size is out of the range of the bucketizer");
+        return detail::allocate_fixed<Size, Alignment>(
+            std::get<get_bucket_index(Size)>(m_buckets));
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        static_assert(Min < Size && Size <= Max,
+            "The size is out of the range of the bucketizer");
+        detail::deallocate_fixed<Size>(
+            std::get<get_bucket_index(Size)>(m_buckets), p);
+    }
+
+    // a block never moves to another bucket
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept
+        requires(detail::ExpandableAllocator<Alloc>)
+    {
+        size_t const bucket_idx = get_checked_bucket_index(old_size);
+        if (new_size <= Min || get_bucket_index(new_size) != bucket_idx)
+            return false;
+        return m_buckets[bucket_idx].try_expand(p, old_size, new_size);
+    }
+
+    bool contained(void* p) const noexcept
+        requires(detail::OwningAllocator<Alloc>)
+    {
+        return std::ranges::any_of(m_buckets,
+            [p](Alloc const& bucket) { return bucket.contained(p); });
+    }
+
+    Alloc& get_bucket(size_t bucket_idx) noexcept {
+        return m_buckets[bucket_idx];
+    }
+
+private:
+    template <size_t... Idx, typename... Alloc_Args>
+    Bucketizer(std::index_sequence<Idx...>, Alloc_Args&... args) noexcept
+        : m_buckets{Alloc{args..., get_bucket_size(Idx)}...} {}
+
+    static size_t get_checked_bucket_index(size_t size) noexcept {
+        COUST_ASSERT(Min < size && size <= Max,
+            "Size {} is out of the range ({}, {}] of the bucketizer", size,
+            Min, Max);
+        return get_bucket_index(size);
+    }
+
+private:
+    std::array<Alloc, BUCKET_COUNT> m_buckets;
+};
+
+// Count the allocations served by `Alloc`, see `AllocationStats`. The counters
+// aren't guarded, so it isn't concurrent even if `Alloc` is.
+template <detail::Allocator Alloc>
+class StatsWrapper {
+public:
+    StatsWrapper(StatsWrapper&&) = delete;
+    StatsWrapper(StatsWrapper const&) = delete;
+    StatsWrapper& operator=(StatsWrapper&&) = delete;
+    StatsWrapper& operator=(StatsWrapper const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+public:
+    template <typename... Alloc_Args>
+    StatsWrapper(Alloc_Args&&... args) noexcept
+        requires(std::constructible_from<Alloc, Alloc_Args...>)
+        : m_allocator(std::forward<Alloc_Args>(args)...) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* const p = m_allocator.allocate(size, alignment);
+        if (p)
+            m_stats.record_allocation(size);
+        return p;
+    }
+
+    void deallocate(void* p, size_t size) noexcept {
+        if (p == nullptr)
+            return;
+        m_stats.record_deallocation(size);
+        m_allocator.deallocate(p, size);
+    }
+
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        void* const p = detail::allocate_fixed<Size, Alignment>(m_allocator);
+        if (p)
+            m_stats.record_allocation(Size);
+        return p;
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        if (p == nullptr)
+            return;
+        m_stats.record_deallocation(Size);
+        detail::deallocate_fixed<Size>(m_allocator, p);
+    }
+
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept
+        requires(detail::ExpandableAllocator<Alloc>)
+    {
+        if (!m_allocator.try_expand(p, old_size, new_size))
+            return false;
+        m_stats.record_deallocation(old_size);
+        m_stats.record_allocation(new_size);
+        return true;
+    }
+
+    bool contained(void* p) const noexcept
+        requires(detail::OwningAllocator<Alloc>)
+    {
+        return m_allocator.contained(p);
+    }
+
+    // the reserved size is filled if the allocator knows it
+    AllocationStats get_stats() const noexcept {
+        AllocationStats stats = m_stats;
+        if constexpr (requires { m_allocator.get_reserved_size(); })
+            stats.reserved_size = m_allocator.get_reserved_size();
+        return stats;
+    }
+
+    Alloc& get_allocator() noexcept { return m_allocator; }
+
+private:
+    Alloc m_allocator;
+    AllocationStats m_stats{};
+};
+
+}  // namespace memory
+}  // namespace coust
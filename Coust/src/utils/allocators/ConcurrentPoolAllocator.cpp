@@ -0,0 +1,130 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/ConcurrentPoolAllocator.h"
+
+#include <bit>
+
+namespace coust {
+namespace memory {
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(
+    size_t node_size, size_t alignment) noexcept
+    : m_head(pack_head(NULL_INDEX, 0)),
+      m_alignment(std::max(alignment, alignof(NodeHeader))),
+      m_block_offset(
+          ptr_math::round_up_to_alinged(sizeof(NodeHeader), m_alignment)),
+      m_node_stride(m_block_offset +
+                    ptr_math::round_up_to_alinged(node_size, m_alignment)) {
+    COUST_ASSERT(std::has_single_bit(alignment),
+        "The alignment {} of concurrent pool allocator isn't a power of 2",
+        alignment);
+}
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(
+    void* begin, void* end, size_t node_size, size_t alignment) noexcept
+    : ConcurrentPoolAllocator(node_size, alignment) {
+    grow(begin, ptr_math::sub(end, begin));
+}
+
+void* ConcurrentPoolAllocator::allocate(
+    [[maybe_unused]] size_t size, [[maybe_unused]] size_t alignment) noexcept {
+    COUST_ASSERT(size <= m_node_stride - m_block_offset,
+        "size requirement exceeds node size of pool allocator, requirement: "
+        "{}, node_size: {}",
+        size, m_node_stride - m_block_offset);
+    // acquire the area slot & the link of the node along with the head
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t const index = get_head_index(head);
+        if (index == NULL_INDEX)
+            return nullptr;
+        NodeHeader* const header = get_node_header(index);
+        // the node might have been taken by another thread already, which only
+        // makes the CAS fail since the tag has changed
+        uint32_t const next = header->next.load(std::memory_order_relaxed);
+        if (m_head.compare_exchange_weak(head,
+                pack_head(next, get_head_tag(head) + 1),
+                std::memory_order_acquire, std::memory_order_acquire)) {
+            void* const ret = header + 1;
+            COUST_ASSERT(ptr_math::is_aligned(ret, alignment),
+                "Pool Allocator can't meet the allocation alignment "
+                "requirement {}",
+                alignment);
+            return ret;
+        }
+    }
+}
+
+void ConcurrentPoolAllocator::deallocate(void* p, size_t) noexcept {
+    NodeHeader* const header = (NodeHeader*) p - 1;
+    push(header->index, header);
+}
+
+void ConcurrentPoolAllocator::grow(void* p, size_t size) noexcept {
+    void* const aligned_p = ptr_math::align(p, m_alignment);
+    if (ptr_math::sub(aligned_p, p) >= size)
+        return;
+    size_t node_count = (size - ptr_math::sub(aligned_p, p)) / m_node_stride;
+    // the header of the first node
+    p = ptr_math::add(aligned_p, m_block_offset - sizeof(NodeHeader));
+    while (node_count > 0) {
+        uint32_t const area_idx =
+            m_area_count.fetch_add(1, std::memory_order_relaxed);
+        COUST_PANIC_IF(area_idx >= MAX_AREA_COUNT,
+            "Concurrent pool allocator can't hold more than {} areas",
+            MAX_AREA_COUNT);
+        m_areas[area_idx] = p;
+        uint32_t const area_node_count =
+            (uint32_t) std::min(node_count, (size_t) MAX_AREA_NODE_COUNT);
+        uint32_t const first = area_idx << AREA_NODE_INDEX_BITS;
+        NodeHeader* header = nullptr;
+        for (uint32_t i = 0; i < area_node_count; ++i) {
+            header = std::construct_at(
+                (NodeHeader*) ptr_math::add(p, i * m_node_stride));
+            header->next.store(first + i + 1, std::memory_order_relaxed);
+            header->index = first + i;
+        }
+        push(first, header);
+        p = ptr_math::add(p, area_node_count * m_node_stride);
+        node_count -= area_node_count;
+    }
+}
+
+size_t ConcurrentPoolAllocator::get_node_stride() const noexcept {
+    return m_node_stride;
+}
+
+uint64_t ConcurrentPoolAllocator::pack_head(
+    uint32_t index, uint32_t tag) noexcept {
+    return ((uint64_t) tag << 32) | index;
+}
+
+uint32_t ConcurrentPoolAllocator::get_head_index(uint64_t head) noexcept {
+    return (uint32_t) head;
+}
+
+uint32_t ConcurrentPoolAllocator::get_head_tag(uint64_t head) noexcept {
+    return (uint32_t) (head >> 32);
+}
+
+ConcurrentPoolAllocator::NodeHeader* ConcurrentPoolAllocator::get_node_header(
+    uint32_t index) const noexcept {
+    uint32_t const area_idx = index >> AREA_NODE_INDEX_BITS;
+    uint32_t const node_idx = index & (MAX_AREA_NODE_COUNT - 1);
+    return (NodeHeader*) ptr_math::add(
+        m_areas[area_idx], node_idx * m_node_stride);
+}
+
+void ConcurrentPoolAllocator::push(uint32_t first, NodeHeader* last) noexcept {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    do {
+        last->next.store(get_head_index(head), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head,
+        pack_head(first, get_head_tag(head) + 1), std::memory_order_release,
+        std::memory_order_relaxed));
+}
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+namespace coust {
+namespace memory {
+
+// Lock-free counterpart of `PoolAllocator`, any number of threads can allocate,
+// deallocate and grow it at once.
+// The free list is a stack of node indices whose head carries a tag bumped by
+// every update, so a node popped and pushed back between the load and the CAS
+// of another thread (the ABA problem) fails that CAS. The links live in a small
+// header in front of every node instead of the free block itself, so no thread
+// ever reads the memory a user might be writing to. Every block is aligned to
+// the alignment given on construction, the header sits in the padding in front
+// of it.
+class ConcurrentPoolAllocator {
+public:
+    ConcurrentPoolAllocator(ConcurrentPoolAllocator&&) = delete;
+    ConcurrentPoolAllocator(ConcurrentPoolAllocator const&) = delete;
+    ConcurrentPoolAllocator& operator=(ConcurrentPoolAllocator&&) = delete;
+    ConcurrentPoolAllocator& operator=(ConcurrentPoolAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+    using concurrent = std::true_type;
+
+public:
+    ConcurrentPoolAllocator(size_t node_size,
+        size_t alignment = alignof(std::max_align_t)) noexcept;
+
+    ConcurrentPoolAllocator(void* begin, void* end, size_t node_size,
+        size_t alignment = alignof(std::max_align_t)) noexcept;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    void deallocate(void* p, size_t) noexcept;
+
+    void grow(void* p, size_t size) noexcept;
+
+    // the space a node takes up in an area, header & padding included
+    size_t get_node_stride() const noexcept;
+
+private:
+    struct NodeHeader {
+        std::atomic<uint32_t> next;
+        uint32_t index;
+    };
+
+    // a node index is made of the index of the area it lives in (the higher
+    // bits) and its index inside the area (the lower bits). an area larger
+    // than `MAX_AREA_NODE_COUNT` nodes takes up several slots
+    static uint32_t constexpr AREA_NODE_INDEX_BITS = 22u;
+    static uint32_t constexpr MAX_AREA_NODE_COUNT = 1u
+                                                    << AREA_NODE_INDEX_BITS;
+    // the last slot is left out, so that `NULL_INDEX` never refers to a node
+    static uint32_t constexpr MAX_AREA_COUNT =
+        (1u << (32u - AREA_NODE_INDEX_BITS)) - 1u;
+    static uint32_t constexpr NULL_INDEX = std::numeric_limits<uint32_t>::max();
+
+private:
+    static uint64_t pack_head(uint32_t index, uint32_t tag) noexcept;
+
+    static uint32_t get_head_index(uint64_t head) noexcept;
+
+    static uint32_t get_head_tag(uint64_t head) noexcept;
+
+    NodeHeader* get_node_header(uint32_t index) const noexcept;
+
+    // push the nodes linked from `first` to `last` in one go
+    void push(uint32_t first, NodeHeader* last) noexcept;
+
+private:
+    std::atomic<uint64_t> m_head;
+    std::atomic<uint32_t> m_area_count = 0;
+    // the first node header of every area. a slot is written before any node
+    // in it is published by the release CAS on `m_head`
+    std::array<void*, MAX_AREA_COUNT> m_areas{};
+    size_t const m_alignment;
+    // from the beginning of a node to its block, the header is right in front
+    // of the block
+    size_t const m_block_offset;
+    size_t const m_node_stride;
+};
+
+static_assert(detail::GrowableAllocator<ConcurrentPoolAllocator>, "");
+static_assert(detail::is_concurrent_allocator<ConcurrentPoolAllocator>, "");
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/FrameArena.h"
+
+namespace coust {
+namespace memory {
+
+FrameArena::FrameArena(size_t frame_count, size_t frame_size) noexcept
+    : m_area(frame_count * frame_size, DEFAULT_ALIGNMENT),
+      m_frame_count(frame_count),
+      m_frame_size(frame_size),
+      m_frame_begin(m_area.begin()),
+      m_cur(m_area.begin()),
+      m_frame_end(ptr_math::add(m_area.begin(), frame_size)) {
+    COUST_ASSERT(frame_count > 0 && frame_size % DEFAULT_ALIGNMENT == 0,
+        "Invalid frame arena layout: {} frames of {} bytes", frame_count,
+        frame_size);
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) noexcept {
+    void* const ret_ptr = ptr_math::align(m_cur, alignment);
+    void* const next_cur = ptr_math::add(ret_ptr, size);
+    if (next_cur > m_frame_end) {
+        m_overflow_count++;
+        return m_fallback.allocate(size, alignment);
+    }
+    m_cur = next_cur;
+    return ret_ptr;
+}
+
+void FrameArena::deallocate(void* p, size_t size) noexcept {
+    if (!m_area.contained(p))
+        m_fallback.deallocate(p, size);
+}
+
+void FrameArena::next_frame() noexcept {
+    m_peak_used_size = std::max(m_peak_used_size, get_used_size());
+    m_frame_idx = (m_frame_idx + 1) % m_frame_count;
+    m_frame_begin = ptr_math::add(m_area.begin(), m_frame_idx * m_frame_size);
+    m_cur = m_frame_begin;
+    m_frame_end = ptr_math::add(m_frame_begin, m_frame_size);
+}
+
+size_t FrameArena::get_frame_idx() const noexcept {
+    return m_frame_idx;
+}
+
+size_t FrameArena::get_frame_count() const noexcept {
+    return m_frame_count;
+}
+
+size_t FrameArena::get_frame_size() const noexcept {
+    return m_frame_size;
+}
+
+size_t FrameArena::get_used_size() const noexcept {
+    return ptr_math::sub(m_cur, m_frame_begin);
+}
+
+size_t FrameArena::get_peak_used_size() const noexcept {
+    return m_peak_used_size;
+}
+
+size_t FrameArena::get_overflow_count() const noexcept {
+    return m_overflow_count;
+}
+
+}  // namespace memory
+}  // namespace coust
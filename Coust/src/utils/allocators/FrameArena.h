@@ -0,0 +1,72 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/Area.h"
+#include "utils/allocators/HeapAllocator.h"
+
+namespace coust {
+namespace memory {
+
+// A linear arena split into one slot per frame in flight. Slots are used
+// round-robin, and everything allocated in a slot is dropped at once when the
+// slot is recycled, so deallocation never touches any free list.
+// Requests which don't fit into the rest of the current slot are forwarded to
+// the heap, so a frame with unexpected load still works, only slower.
+// It isn't thread safe, transient containers of one thread should use it.
+class FrameArena {
+public:
+    FrameArena() = delete;
+    FrameArena(FrameArena&&) = delete;
+    FrameArena(FrameArena const&) = delete;
+    FrameArena& operator=(FrameArena&&) = delete;
+    FrameArena& operator=(FrameArena const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+public:
+    FrameArena(size_t frame_count, size_t frame_size) noexcept;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    void deallocate(void* p, size_t size) noexcept;
+
+    // switch to the next slot and drop everything allocated in it. The caller
+    // must make sure that the frame which used this slot last time has retired
+    void next_frame() noexcept;
+
+    size_t get_frame_idx() const noexcept;
+
+    size_t get_frame_count() const noexcept;
+
+    size_t get_frame_size() const noexcept;
+
+    // bytes handed out from the current slot
+    size_t get_used_size() const noexcept;
+
+    // the largest `get_used_size()` of all the finished frames
+    size_t get_peak_used_size() const noexcept;
+
+    // count of allocations forwarded to the heap since the arena was created
+    size_t get_overflow_count() const noexcept;
+
+private:
+    Area m_area;
+    HeapAllocator m_fallback{};
+
+    size_t m_frame_count;
+    size_t m_frame_size;
+    size_t m_frame_idx = 0;
+
+    void* m_frame_begin = nullptr;
+    void* m_cur = nullptr;
+    void* m_frame_end = nullptr;
+
+    size_t m_peak_used_size = 0;
+    size_t m_overflow_count = 0;
+};
+
+static_assert(detail::Allocator<FrameArena>, "");
+
+}  // namespace memory
+}  // namespace coust
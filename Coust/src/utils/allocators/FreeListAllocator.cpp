@@ -209,6 +209,63 @@ void FreeListAllocator::deallocate(void* p, [[maybe_unused]] size_t) noexcept {
     }
 }
 
+bool FreeListAllocator::try_expand(
+    void* p, [[maybe_unused]] size_t, size_t new_size) noexcept {
+    uint32_t constexpr BOOKKEEPING_REQUIREMENT =
+        sizeof(BlockHeader) + sizeof(uint32_t);
+
+    uint32_t const* const RESTRICT head =
+        (uint32_t const*) ptr_math::sub(p, sizeof(uint32_t));
+    BlockHeader* const RESTRICT block = (BlockHeader*) ptr_math::sub(p, *head);
+    void* const block_end = ptr_math::add(block, block->size);
+    if ((size_t) ptr_math::sub(block_end, p) >= new_size)
+        return true;
+
+    // the free list is address ordered, look for the free block starting
+    // right at the end of this one
+    BlockHeader* RESTRICT next = m_first_free_block;
+    BlockHeader* RESTRICT next_pre = nullptr;
+    for (; next && next < block_end; next_pre = next, next = next->next) {}
+    if (next != block_end)
+        return false;
+    // the new header might overlap with the old one, so read it first
+    uint32_t const next_size = next->size;
+    BlockHeader* const next_next = next->next;
+    void* const next_end = ptr_math::add(next, next_size);
+    if ((size_t) ptr_math::sub(next_end, p) < new_size)
+        return false;
+
+    // same trimming as `allocate()`
+    void* const possible_new_header =
+        ptr_math::align(ptr_math::add(p, new_size), alignof(BlockHeader));
+    uint32_t const residual_size = possible_new_header < next_end ?
+                                       (uint32_t) ptr_math::sub(
+                                           next_end, possible_new_header) :
+                                       0u;
+    bool const can_be_trimmed = residual_size > BOOKKEEPING_REQUIREMENT + 1;
+    BlockHeader* const replacement =
+        can_be_trimmed ? (BlockHeader*) possible_new_header : next_next;
+    if (can_be_trimmed) {
+        replacement->size = residual_size;
+        replacement->next = next_next;
+    }
+    if (next_pre)
+        next_pre->next = replacement;
+    else
+        m_first_free_block = replacement;
+    uint32_t const absorbed_size =
+        can_be_trimmed ? next_size - residual_size : next_size;
+    block->size += absorbed_size;
+
+#if defined(COUST_TEST)
+    if (!can_be_trimmed)
+        m_free_block_count--;
+    m_free_block_size -= absorbed_size;
+#endif
+
+    return true;
+}
+
 void FreeListAllocator::grow(void* p, size_t size) noexcept {
 #if defined(COUST_TEST)
     m_free_block_size += size;
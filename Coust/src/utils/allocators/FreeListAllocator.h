@@ -25,6 +25,10 @@ public:
 
     void deallocate(void* p, size_t) noexcept;
 
+    // absorb (part of) the free block right after the block. a shrinking
+    // block keeps its size, the space is given back once it's deallocated
+    bool try_expand(void* p, size_t, size_t new_size) noexcept;
+
     void grow(void* p, size_t size) noexcept;
 
 private:
@@ -65,6 +69,7 @@ public:
 };
 
 static_assert(detail::GrowableAllocator<FreeListAllocator>, "");
+static_assert(detail::ExpandableAllocator<FreeListAllocator>, "");
 
 }  // namespace memory
 }  // namespace coust
@@ -3,11 +3,15 @@
 #include "utils/Compiler.h"
 #include "utils/allocators/Area.h"
 #include "utils/allocators/MemoryPool.h"
+#include "utils/allocators/VirtualArea.h"
 #include "utils/Assert.h"
 #include "utils/Log.h"
 #include "utils/TypeName.h"
+#include "utils/containers/RobinMap.h"
 
 #include <deque>
+#include <vector>
+#include <mutex>
 #include <utility>
 #include <type_traits>
 
@@ -23,15 +27,25 @@ struct GP_Scope {
     std::deque<Area>::const_iterator m_next_free_area;
 };
 
+struct GP_Virtual {
+    GP_Virtual(size_t reserved_size, PageType page_type) noexcept
+        : m_virtual_area(reserved_size, page_type) {}
+
+    VirtualArea m_virtual_area;
+};
+
 }  // namespace detail
 
 // 1) attached to a memory pool
 // 2) attached to a block of memory (on stack or heap)
 // 3) using aligned_alloc / aligend_free
+// 4) committing more of a reserved virtual address range, every new area
+//    continues the previous one
 enum class GrowthType {
     attached,
     scope,
     heap,
+    virtual_memory,
 };
 
 std::string_view constexpr to_string_view(GrowthType t) {
@@ -42,20 +56,27 @@ std::string_view constexpr to_string_view(GrowthType t) {
             return "scope";
         case GrowthType::heap:
             return "heap";
+        case GrowthType::virtual_memory:
+            return "virtual_memory";
     }
     ASSUME(0);
 }
 
+namespace detail {
+
+template <GrowthType Type>
+using GrowthPolicyBase =
+    std::conditional_t<Type == GrowthType::attached, GP_Attached,
+        std::conditional_t<Type == GrowthType::scope, GP_Scope,
+            std::conditional_t<Type == GrowthType::virtual_memory, GP_Virtual,
+                Empty>>>;
+
+}  // namespace detail
+
 template <GrowthType Type, Size Growth_Factor>
-class GrowthPolicy : public std::conditional_t<Type == GrowthType::attached,
-                         detail::GP_Attached,
-                         std::conditional_t<Type == GrowthType::scope,
-                             detail::GP_Scope, detail::Empty>> {
+class GrowthPolicy : public detail::GrowthPolicyBase<Type> {
 public:
-    using Base =
-        std::conditional_t<Type == GrowthType::attached, detail::GP_Attached,
-            std::conditional_t<Type == GrowthType::scope, detail::GP_Scope,
-                detail::Empty>>;
+    using Base = detail::GrowthPolicyBase<Type>;
 
 public:
     GrowthPolicy(GrowthPolicy&&) = delete;
@@ -88,6 +109,10 @@ public:
         requires(Type == GrowthType::heap)
     {}
 
+    GrowthPolicy(size_t reserved_size, PageType page_type) noexcept
+        requires(Type == GrowthType::virtual_memory)
+        : Base(reserved_size, page_type) {}
+
     ~GrowthPolicy() noexcept {
         if constexpr (Type == GrowthType::attached) {
             for (auto& area : m_areas) {
@@ -100,6 +125,10 @@ public:
         if constexpr (Type == GrowthType::attached) {
             auto const& free_area = m_areas.emplace_front(
                 Base::m_pool.allocate_area(Growth_Factor, alignment));
+            register_area(free_area);
+            m_reserved_size += free_area.size();
+            m_peak_reserved_size =
+                std::max(m_peak_reserved_size, m_reserved_size);
             // the size of area returned by memory pool might be bigger than the
             // growth factor, we return the actual size here
             return {free_area.begin(), free_area.size()};
@@ -109,22 +138,129 @@ public:
                 "Growth policy failed: there isn't enough space to grow");
             auto const& free_area = *Base::m_next_free_area;
             Base::m_next_free_area++;
+            m_reserved_size += free_area.size();
             return {free_area.begin(), free_area.size()};
         }
         if constexpr (Type == GrowthType::heap) {
             auto const& iter = m_areas.emplace_front(Growth_Factor, alignment);
+            m_reserved_size += iter.size();
             return {iter.begin(), iter.size()};
         }
+        if constexpr (Type == GrowthType::virtual_memory) {
+            VirtualArea& virtual_area = Base::m_virtual_area;
+            COUST_ASSERT(alignment <= virtual_area.get_page_size(),
+                "Alignment {} exceeds the page size of virtual memory",
+                alignment);
+            auto const [ptr, size] = virtual_area.commit(Growth_Factor);
+            COUST_PANIC_IF(ptr == nullptr,
+                "Growth policy failed: the reserved {} bytes of virtual "
+                "memory are used up",
+                virtual_area.get_reserved_size());
+            m_reserved_size += size;
+            return {ptr, size};
+        }
+    }
+
+    // give the areas the raw allocator no longer uses back to the memory pool,
+    // and return their total size. the raw allocator might have merged
+    // adjacent areas, so every run of them is given up as a whole
+    template <detail::ShrinkableAllocator Raw_Alloc>
+    size_t shrink(Raw_Alloc& raw_allocator) noexcept
+        requires(Type == GrowthType::attached)
+    {
+        std::vector<Area*> sorted_areas{};
+        sorted_areas.reserve(m_areas.size());
+        for (Area& area : m_areas) {
+            sorted_areas.push_back(&area);
+        }
+        std::ranges::sort(sorted_areas, {}, &Area::begin);
+        size_t released_size = 0;
+        for (auto run_begin = sorted_areas.begin();
+             run_begin != sorted_areas.end();) {
+            auto run_end = std::next(run_begin);
+            while (run_end != sorted_areas.end() &&
+                   (*std::prev(run_end))->end() == (*run_end)->begin()) {
+                ++run_end;
+            }
+            if (raw_allocator.shrink(
+                    (*run_begin)->begin(), (*std::prev(run_end))->end())) {
+                for (auto iter = run_begin; iter != run_end; ++iter) {
+                    released_size += (*iter)->size();
+                    Base::m_pool.deallocate_area(std::move(**iter));
+                }
+            }
+            run_begin = run_end;
+        }
+        if (released_size == 0)
+            return 0;
+        // the given up areas are left empty, and the page map refers to the
+        // elements of `m_areas`, so both are rebuilt
+        std::deque<Area> kept_areas{};
+        m_area_map.clear();
+        for (Area& area : m_areas) {
+            if (area.begin())
+                register_area(kept_areas.emplace_back(std::move(area)));
+        }
+        m_areas = std::move(kept_areas);
+        m_reserved_size -= released_size;
+        return released_size;
+    }
+
+    // the size of all areas handed to the raw allocator so far
+    size_t get_reserved_size() const noexcept { return m_reserved_size; }
+
+    // the most `get_reserved_size()` has ever been, only an attached growth
+    // policy ever shrinks
+    size_t get_peak_reserved_size() const noexcept {
+        if constexpr (Type == GrowthType::attached)
+            return m_peak_reserved_size;
+        else
+            return m_reserved_size;
     }
 
     bool contained(void* p) const noexcept
-        requires(Type == GrowthType::attached || Type == GrowthType::scope)
+        requires(Type == GrowthType::attached || Type == GrowthType::scope ||
+                 Type == GrowthType::virtual_memory)
     {
-        return std::ranges::any_of(
-            m_areas, [p](auto const& area) { return area.contained(p); });
+        if constexpr (Type == GrowthType::virtual_memory) {
+            return Base::m_virtual_area.contained(p);
+        } else {
+            auto const iter = m_area_map.find(get_chunk_index(p));
+            if (iter == m_area_map.end())
+                return false;
+            return std::ranges::any_of(iter->second, [p](Area const* area) {
+                return area && area->contained(p);
+            });
+        }
     }
 
 private:
+    // Every area is at least `Growth_Factor` bytes large (except for the last
+    // one split from a scope), so a chunk of `Growth_Factor` bytes overlaps
+    // with at most 2 areas, which makes the ownership check O(1).
+    using ChunkAreas = std::array<Area const*, 2>;
+
+    static uintptr_t get_chunk_index(void const* p) noexcept {
+        return (uintptr_t) p / Growth_Factor;
+    }
+
+    void register_area(Area const& area) noexcept
+        requires(Type == GrowthType::attached || Type == GrowthType::scope)
+    {
+        uintptr_t const first_chunk = get_chunk_index(area.begin());
+        uintptr_t const last_chunk =
+            get_chunk_index(ptr_math::sub(area.end(), 1u));
+        for (uintptr_t chunk = first_chunk; chunk <= last_chunk; ++chunk) {
+            ChunkAreas& chunk_areas =
+                m_area_map.try_emplace(chunk, ChunkAreas{}).first.mapped();
+            auto const slot = std::ranges::find(chunk_areas, nullptr);
+            COUST_ASSERT(slot != chunk_areas.end(),
+                "More than {} areas overlap with chunk {}", chunk_areas.size(),
+                chunk);
+            *slot = &area;
+        }
+    }
+
     void split_area(void* begin, void* end) noexcept
         requires(Type == GrowthType::scope)
     {
@@ -133,12 +269,17 @@ private:
              cur_area_begin < end; cur_area_begin = cur_area_end,
                   cur_area_end = std::min(
                       ptr_math::add(cur_area_end, Growth_Factor), end)) {
-            m_areas.push_back(Area{cur_area_begin, cur_area_end});
+            register_area(m_areas.emplace_back(cur_area_begin, cur_area_end));
         }
     }
 
 private:
+    // `std::deque` never invalidates references to its elements on insertion
+    // at either end, so the page map can refer to them directly
     std::deque<Area> m_areas;
+    container::robin_map<uintptr_t, ChunkAreas> m_area_map;
+    size_t m_reserved_size = 0;
+    size_t m_peak_reserved_size = 0;
 };
 
 // GrowableAllocator isn't "growable" according to the
@@ -156,9 +297,12 @@ public:
     using stateful = Raw_Alloc::stateful;
 
 public:
+    // the memory pool is shared with other allocators and isn't thread-safe,
+    // so a concurrent raw allocator can't grow from it
     template <typename... Alloc_Args>
     GrowableAllocator(MemoryPool& pool, Alloc_Args&&... args) noexcept
         requires(Type == GrowthType::attached &&
+                    !detail::is_concurrent_allocator<Raw_Alloc> &&
                     std::constructible_from<Raw_Alloc, Alloc_Args...>)
         : m_growth_policy(pool),
           m_raw_allocator(std::forward<Alloc_Args>(args)...) {}
@@ -190,20 +334,34 @@ public:
         : m_growth_policy(),
           m_raw_allocator(std::forward<Alloc_Args>(args)...) {}
 
+    template <typename... Alloc_Args>
+    GrowableAllocator(size_t reserved_size, PageType page_type,
+        Alloc_Args&&... args) noexcept
+        requires(Type == GrowthType::virtual_memory &&
+                    std::constructible_from<Raw_Alloc, Alloc_Args...>)
+        : m_growth_policy(reserved_size, page_type),
+          m_raw_allocator(std::forward<Alloc_Args>(args)...) {}
+
     void* allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT) noexcept {
         void* ret_ptr = m_raw_allocator.allocate(size, alignment);
-        if (!ret_ptr) {
-            auto const [new_area_ptr, new_area_size] =
-                m_growth_policy.do_growth(alignment);
-            m_raw_allocator.grow(new_area_ptr, new_area_size);
+        if (ret_ptr)
+            return ret_ptr;
+        if constexpr (is_concurrent) {
+            std::lock_guard<std::mutex> lock{m_growth_mutex};
+            // another thread might have grown the allocator in the meantime
             ret_ptr = m_raw_allocator.allocate(size, alignment);
-        }
-        return ret_ptr;
+            return ret_ptr ? ret_ptr : grow_and_allocate(size, alignment);
+        } else
+            return grow_and_allocate(size, alignment);
     }
 
+    // the ownership check reads the areas of the growth policy, which another
+    // thread might be growing, so it's skipped for a concurrent raw allocator
     void deallocate(void* p, size_t size) noexcept {
-        if constexpr (Type == GrowthType::attached ||
-                      Type == GrowthType::scope) {
+        if constexpr (!is_concurrent &&
+                      (Type == GrowthType::attached ||
+                          Type == GrowthType::scope ||
+                          Type == GrowthType::virtual_memory)) {
             COUST_PANIC_IF_NOT(m_growth_policy.contained(p),
                 "The instance of GrowableAllocator<{}, {}, {}> does not "
                 "contain the memory block: ptr {}, size {}",
@@ -214,15 +372,96 @@ public:
             m_raw_allocator.deallocate(p, size);
     }
 
+    // the block never leaves the area it's in, so no growth is involved
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept
+        requires(detail::ExpandableAllocator<Raw_Alloc>)
+    {
+        return m_raw_allocator.try_expand(p, old_size, new_size);
+    }
+
+    // see `deallocate()` for why a concurrent raw allocator can't tell
+    bool contained(void* p) const noexcept
+        requires((Type == GrowthType::attached || Type == GrowthType::scope ||
+                     Type == GrowthType::virtual_memory) &&
+                 !detail::is_concurrent_allocator<Raw_Alloc>)
+    {
+        return m_growth_policy.contained(p);
+    }
+
+    // grow until `size` bytes are reserved, so that the allocations up to
+    // that point don't have to
+    void reserve(size_t size) noexcept {
+        if constexpr (is_concurrent) {
+            std::lock_guard<std::mutex> lock{m_growth_mutex};
+            reserve_unlocked(size);
+        } else
+            reserve_unlocked(size);
+    }
+
+    // give the areas without any block in use back to the memory pool, and
+    // return their total size
+    size_t shrink() noexcept
+        requires(Type == GrowthType::attached &&
+                 detail::ShrinkableAllocator<Raw_Alloc>)
+    {
+        return m_growth_policy.shrink(m_raw_allocator);
+    }
+
     Raw_Alloc const& get_raw_allocator() const noexcept {
         return m_raw_allocator;
     }
 
     Raw_Alloc& get_raw_allocator() noexcept { return m_raw_allocator; }
 
+    size_t get_reserved_size() const noexcept {
+        if constexpr (is_concurrent) {
+            std::lock_guard<std::mutex> lock{m_growth_mutex};
+            return m_growth_policy.get_reserved_size();
+        } else
+            return m_growth_policy.get_reserved_size();
+    }
+
+    size_t get_peak_reserved_size() const noexcept {
+        if constexpr (is_concurrent) {
+            std::lock_guard<std::mutex> lock{m_growth_mutex};
+            return m_growth_policy.get_peak_reserved_size();
+        } else
+            return m_growth_policy.get_peak_reserved_size();
+    }
+
+private:
+    // only the growth is serialized for a concurrent raw allocator, which is
+    // why it can't be attached to a memory pool
+    static bool constexpr is_concurrent =
+        detail::is_concurrent_allocator<Raw_Alloc>;
+
+    void reserve_unlocked(size_t size) noexcept {
+        while (m_growth_policy.get_reserved_size() < size) {
+            auto const [new_area_ptr, new_area_size] =
+                m_growth_policy.do_growth(DEFAULT_ALIGNMENT);
+            m_raw_allocator.grow(new_area_ptr, new_area_size);
+        }
+    }
+
+    void* grow_and_allocate(size_t size, size_t alignment) noexcept {
+        void* ret_ptr = nullptr;
+        // newly committed virtual memory extends the previous commitment, so
+        // an allocation larger than one growth step fits after a few rounds
+        bool constexpr keep_growing = Type == GrowthType::virtual_memory;
+        do {
+            auto const [new_area_ptr, new_area_size] =
+                m_growth_policy.do_growth(alignment);
+            m_raw_allocator.grow(new_area_ptr, new_area_size);
+            ret_ptr = m_raw_allocator.allocate(size, alignment);
+        } while (keep_growing && !ret_ptr);
+        return ret_ptr;
+    }
+
 private:
     GrowthPolicy<Type, Growth_Factor> m_growth_policy;
     Raw_Alloc m_raw_allocator;
+    mutable std::conditional_t<is_concurrent, std::mutex, detail::Empty>
+        m_growth_mutex;
 };
 
 }  // namespace memory
@@ -1,12 +1,14 @@
 #include "pch.h"
 
 #include "utils/Compiler.h"
+#include "utils/allocators/AllocationCheck.h"
 #include "utils/allocators/HeapAllocator.h"
 
 namespace coust {
 namespace memory {
 
 void* HeapAllocator::allocate(size_t size, size_t alignment) noexcept {
+    detail::AllocationReport report{AllocationSource::heap, size};
     return aligned_alloc(size, alignment);
 }
 
@@ -12,6 +12,7 @@ MemoryPool::MemoryPool(
     : m_sizes(all_sizes), m_alignement(alignment) {
     std::ranges::sort(m_sizes);
     m_split_areas.resize(all_sizes.size());
+    m_stats.resize(all_sizes.size());
 }
 
 Area MemoryPool::allocate_area(size_t size, size_t alignment) noexcept {
@@ -22,17 +23,25 @@ Area MemoryPool::allocate_area(size_t size, size_t alignment) noexcept {
     size_t const pool_idx = find_pool(size);
     size_t const actual_allocation_size = m_sizes[pool_idx];
     std::deque<Area>& pool = m_split_areas[pool_idx];
+    m_stats[pool_idx].record_allocation(actual_allocation_size);
     if (!pool.empty()) {
         Area area = std::move(pool.front());
         pool.pop_front();
+        find_raw_area(area.begin())->lent_count++;
         return area;
     } else {
-        auto const& raw_area = m_raw_areas.emplace_back(
-            m_sizes.back() * RAW_AREA_SIZE_MULTIPLIER, alignment);
+        Area raw_area{m_sizes.back() * RAW_AREA_SIZE_MULTIPLIER, alignment};
         auto split_areas = Area::split_areas(raw_area, actual_allocation_size);
         Area ret = std::move(split_areas.back());
         split_areas.pop_back();
         std::ranges::move(split_areas, std::back_inserter(pool));
+        m_reserved_size += raw_area.size();
+        m_peak_reserved_size = std::max(m_peak_reserved_size, m_reserved_size);
+        auto const pos = std::ranges::upper_bound(m_raw_areas,
+            raw_area.begin(), std::less<>{},
+            [](RawArea const& r) { return r.area.begin(); });
+        m_raw_areas.insert(
+            pos, RawArea{std::move(raw_area), pool_idx, 1, false});
         return ret;
     }
 }
@@ -41,7 +50,102 @@ void MemoryPool::deallocate_area(Area&& free_area) noexcept {
     size_t const free_size = free_area.size();
     size_t const pool_idx = find_pool(free_size);
     std::deque<Area>& pool = m_split_areas[pool_idx];
+    auto const raw_area = find_raw_area(free_area.begin());
+    m_stats[pool_idx].record_deallocation(free_size);
     pool.push_front(std::move(free_area));
+    if (--raw_area->lent_count == 0 && !raw_area->pinned &&
+        m_reserved_size > m_high_water_mark)
+        release_raw_area(raw_area);
+}
+
+void MemoryPool::reserve(std::span<size_t const> area_counts) noexcept {
+    COUST_ASSERT(area_counts.size() == m_sizes.size(),
+        "Expect {} area counts, got {}", m_sizes.size(), area_counts.size());
+    for (size_t i = 0; i < m_sizes.size(); ++i) {
+        if (area_counts[i] <= m_split_areas[i].size())
+            continue;
+        size_t const missing_count = area_counts[i] - m_split_areas[i].size();
+        // one raw area per pool, so that an area still handed out after the
+        // warm-up only keeps the reserve of its own pool
+        Area raw_area{missing_count * m_sizes[i], m_alignement};
+        std::ranges::move(Area::split_areas(raw_area, m_sizes[i]),
+            std::back_inserter(m_split_areas[i]));
+        m_reserved_size += raw_area.size();
+        auto const pos = std::ranges::upper_bound(m_raw_areas,
+            raw_area.begin(), std::less<>{},
+            [](RawArea const& r) { return r.area.begin(); });
+        m_raw_areas.insert(
+            pos, RawArea{std::move(raw_area), i, 0, m_warming_up});
+    }
+    m_peak_reserved_size = std::max(m_peak_reserved_size, m_reserved_size);
+}
+
+void MemoryPool::end_warm_up() noexcept {
+    m_warming_up = false;
+    for (auto& r : m_raw_areas) {
+        r.pinned = false;
+    }
+}
+
+size_t MemoryPool::trim() noexcept {
+    for (auto& pool : m_split_areas) {
+        std::erase_if(pool, [this](Area const& area) {
+            auto const raw_area = find_raw_area(area.begin());
+            return raw_area->lent_count == 0 && !raw_area->pinned;
+        });
+    }
+    size_t released_size = 0;
+    std::erase_if(m_raw_areas, [&released_size](RawArea const& r) {
+        if (r.lent_count != 0 || r.pinned)
+            return false;
+        released_size += r.area.size();
+        return true;
+    });
+    m_reserved_size -= released_size;
+    return released_size;
+}
+
+void MemoryPool::set_high_water_mark(size_t mark) noexcept {
+    m_high_water_mark = mark;
+}
+
+size_t MemoryPool::get_reserved_size() const noexcept {
+    return m_reserved_size;
+}
+
+size_t MemoryPool::get_peak_reserved_size() const noexcept {
+    return m_peak_reserved_size;
+}
+
+size_t MemoryPool::get_pool_count() const noexcept {
+    return m_sizes.size();
+}
+
+size_t MemoryPool::get_area_size(size_t pool_idx) const noexcept {
+    return m_sizes[pool_idx];
+}
+
+AllocationStats MemoryPool::get_stats(size_t pool_idx) const noexcept {
+    AllocationStats ret = m_stats[pool_idx];
+    for (auto const& r : m_raw_areas) {
+        if (r.pool_idx == pool_idx)
+            ret.reserved_size += r.area.size();
+    }
+    return ret;
+}
+
+void MemoryPool::dump_stats_json(std::string& out) const noexcept {
+    std::format_to(std::back_inserter(out),
+        "{{\"reserved_size\":{},\"peak_reserved_size\":{},\"pools\":[",
+        m_reserved_size, m_peak_reserved_size);
+    for (size_t i = 0; i < get_pool_count(); ++i) {
+        std::format_to(std::back_inserter(out),
+            "{}{{\"area_size\":{},\"stats\":", i == 0 ? "" : ",",
+            get_area_size(i));
+        get_stats(i).dump_json(out);
+        out += "}";
+    }
+    out += "]}";
 }
 
 size_t MemoryPool::find_pool(size_t size) const noexcept {
@@ -52,5 +156,25 @@ size_t MemoryPool::find_pool(size_t size) const noexcept {
     return (size_t) std::distance(m_sizes.begin(), iter);
 }
 
+std::vector<MemoryPool::RawArea>::iterator MemoryPool::find_raw_area(
+    void* p) noexcept {
+    auto iter = std::ranges::upper_bound(m_raw_areas, p, std::less<>{},
+        [](RawArea const& r) { return r.area.begin(); });
+    COUST_ASSERT(
+        iter != m_raw_areas.begin() && std::prev(iter)->area.contained(p),
+        "The area {} doesn't come from this memory pool", p);
+    return std::prev(iter);
+}
+
+void MemoryPool::release_raw_area(
+    std::vector<RawArea>::iterator raw_area) noexcept {
+    std::erase_if(m_split_areas[raw_area->pool_idx],
+        [&raw_area](Area const& area) {
+            return raw_area->area.contained(area.begin());
+        });
+    m_reserved_size -= raw_area->area.size();
+    m_raw_areas.erase(raw_area);
+}
+
 }  // namespace memory
 }  // namespace coust
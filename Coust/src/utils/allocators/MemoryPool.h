@@ -2,8 +2,11 @@
 
 #include "utils/allocators/Allocator.h"
 #include "utils/allocators/Area.h"
+#include "utils/allocators/AllocationStats.h"
 
 #include <deque>
+#include <span>
+#include <vector>
 #include <initializer_list>
 
 namespace coust {
@@ -25,20 +28,74 @@ public:
 
     void deallocate_area(Area&& free_area) noexcept;
 
+    // make sure pool `i` holds at least `area_counts[i]` free areas. the
+    // missing ones of a pool are carved from a single raw area, which stays
+    // until `end_warm_up()`, so that the warm-up of the allocators growing
+    // from the pool doesn't hit the system for every area
+    void reserve(std::span<size_t const> area_counts) noexcept;
+
+    // from now on, the raw areas of `reserve()` are like any other: `trim()`
+    // releases each of them once none of its areas is handed out
+    void end_warm_up() noexcept;
+
+    // release every raw area whose split areas are all returned to the pool,
+    // except the reserved ones during the warm-up, and return the number of
+    // bytes released
+    size_t trim() noexcept;
+
+    // once the memory held by the pool exceeds the mark, a raw area is released
+    // as soon as all of its split areas are returned. by default the pool never
+    // releases anything on its own
+    void set_high_water_mark(size_t mark) noexcept;
+
+    // the memory currently held by raw areas
+    size_t get_reserved_size() const noexcept;
+
+    size_t get_peak_reserved_size() const noexcept;
+
+    size_t get_pool_count() const noexcept;
+
+    size_t get_area_size(size_t pool_idx) const noexcept;
+
+    // the pool serving areas of `size` bytes
+    size_t find_pool(size_t size) const noexcept;
+
+    // the areas handed out by the pool of `get_area_size(pool_idx)` bytes
+    AllocationStats get_stats(size_t pool_idx) const noexcept;
+
+    void dump_stats_json(std::string& out) const noexcept;
+
 private:
     static size_t constexpr RAW_AREA_SIZE_MULTIPLIER = 1u;
 
+    struct RawArea {
+        Area area;
+        size_t pool_idx;
+        // the number of split areas currently handed out
+        size_t lent_count;
+        // reserved during the warm-up, kept until it's over
+        bool pinned;
+    };
+
 private:
-    // raw areas control the actual allocation and deallocation (system call)
-    std::deque<Area> m_raw_areas;
+    // raw areas control the actual allocation and deallocation (system call),
+    // they're sorted by address so that a split area can find its owner
+    std::vector<RawArea> m_raw_areas;
     // to reduce fragmentation and allocation call, we split the raw areas into
     // smaller scoped areas and provide them to allocators instead of raw areas
     std::deque<std::deque<Area>> m_split_areas;
     std::deque<Size> m_sizes;
+    std::vector<AllocationStats> m_stats;
     [[maybe_unused]] size_t const m_alignement;
+    size_t m_high_water_mark = std::numeric_limits<size_t>::max();
+    size_t m_reserved_size = 0;
+    size_t m_peak_reserved_size = 0;
+    bool m_warming_up = true;
 
 private:
-    size_t find_pool(size_t size) const noexcept;
+    std::vector<RawArea>::iterator find_raw_area(void* p) noexcept;
+
+    void release_raw_area(std::vector<RawArea>::iterator raw_area) noexcept;
 };
 
 }  // namespace memory
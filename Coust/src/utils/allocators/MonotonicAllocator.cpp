@@ -23,6 +23,17 @@ void MonotonicAllocator::deallocate(
     [[maybe_unused]] void*, [[maybe_unused]] size_t) noexcept {
 }
 
+bool MonotonicAllocator::try_expand(
+    void* p, size_t old_size, size_t new_size) noexcept {
+    if (ptr_math::add(p, old_size) != m_cur_begin)
+        return new_size <= old_size;
+    void* const next_begin = ptr_math::add(p, new_size);
+    if (next_begin > m_cur_end)
+        return false;
+    m_cur_begin = next_begin;
+    return true;
+}
+
 void MonotonicAllocator::grow(void* p, size_t size) noexcept {
     m_cur_begin = p;
     m_cur_end = ptr_math::add(p, size);
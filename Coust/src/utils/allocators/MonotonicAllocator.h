@@ -25,6 +25,10 @@ public:
 
     void deallocate(void*, size_t) noexcept;
 
+    // only the latest allocation can be resized, by moving the top of the
+    // stack
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept;
+
     void grow(void* p, size_t size) noexcept;
 
 private:
@@ -33,6 +37,7 @@ private:
 };
 
 static_assert(detail::GrowableAllocator<MonotonicAllocator>, "");
+static_assert(detail::ExpandableAllocator<MonotonicAllocator>, "");
 
 }  // namespace memory
 }  // namespace coust
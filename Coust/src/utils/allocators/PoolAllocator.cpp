@@ -70,11 +70,14 @@ void PoolAllocator::deallocate(void* p, [[maybe_unused]] size_t) noexcept {
 }
 
 void PoolAllocator::grow(void* p, size_t size) noexcept {
-    COUST_ASSERT(
-        ptr_math::sub(m_unindexed_end, m_unindexed_begin) < m_node_size,
-        "Can't grow pool allocator while there's still unindexed free space, "
-        "node_size: {}, unindexed: {}, {}",
-        m_node_size, m_unindexed_begin, m_unindexed_end);
+    // growing ahead of the allocations (e.g. reserving several areas) leaves
+    // the nodes of the previous area unindexed, they join the free list
+    while (ptr_math::sub(m_unindexed_end, m_unindexed_begin) >= m_node_size) {
+        Node* RESTRICT const node = (Node*) m_unindexed_begin;
+        m_unindexed_begin = ptr_math::add(m_unindexed_begin, m_node_size);
+        node->next = m_first;
+        m_first = node;
+    }
     COUST_ASSERT(ptr_math::is_aligned(p, alignof(Node)),
         "Provided new area in {} doesn't meet the alignemnt requirement {}", p,
         alignof(Node));
@@ -82,5 +85,46 @@ void PoolAllocator::grow(void* p, size_t size) noexcept {
     m_unindexed_end = ptr_math::add(m_unindexed_begin, size);
 }
 
+bool PoolAllocator::shrink(void* begin, void* end) noexcept {
+    std::vector<void*> free_nodes{};
+    for (Node* node = m_first; node; node = node->next) {
+        if (node >= begin && node < end)
+            free_nodes.push_back(node);
+    }
+    bool const unindexed_inside =
+        m_unindexed_begin >= begin && m_unindexed_begin < end;
+    // an empty one might start right where the first node of the next area is
+    bool const unindexed_span =
+        unindexed_inside && m_unindexed_begin != m_unindexed_end;
+    if (unindexed_span)
+        free_nodes.push_back(m_unindexed_begin);
+    std::ranges::sort(free_nodes);
+    // the nodes of an area are packed from its beginning, and only its tail
+    // smaller than a node is left out. so a gap as large as a node between
+    // the free spans is a node in use
+    void* cursor = begin;
+    for (void* span_begin : free_nodes) {
+        if (ptr_math::sub(span_begin, cursor) >= m_node_size)
+            return false;
+        cursor = unindexed_span && span_begin == m_unindexed_begin ?
+                     m_unindexed_end :
+                     ptr_math::add(span_begin, m_node_size);
+    }
+    if (ptr_math::sub(end, cursor) >= m_node_size)
+        return false;
+
+    for (Node** link = &m_first; *link;) {
+        if (*link >= begin && *link < end)
+            *link = (*link)->next;
+        else
+            link = &(*link)->next;
+    }
+    if (unindexed_inside) {
+        m_unindexed_begin = nullptr;
+        m_unindexed_end = nullptr;
+    }
+    return true;
+}
+
 }  // namespace memory
 }  // namespace coust
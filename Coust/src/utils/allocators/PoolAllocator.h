@@ -27,6 +27,12 @@ public:
 
     void grow(void* p, size_t size) noexcept;
 
+    // stop using the memory of [begin, end) if none of its nodes is in use,
+    // and return whether it's given up. the range is made of whole areas
+    // passed to `grow()`. it walks the whole free list, so it's meant for a
+    // trim every now & then
+    bool shrink(void* begin, void* end) noexcept;
+
 private:
     struct Node {
         Node* next = nullptr;
@@ -39,6 +45,7 @@ private:
 };
 
 static_assert(detail::GrowableAllocator<PoolAllocator>, "");
+static_assert(detail::ShrinkableAllocator<PoolAllocator>, "");
 
 }  // namespace memory
 }  // namespace coust
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace coust {
+namespace memory {
+namespace size_class {
+
+// size classes of small allocations. after the 8 B class, classes up to 64 B
+// are spaced by 16 B, and every power of 2 above is split into 4 classes, so a
+// request wastes at most 20% of its block (65 B -> 80 B), instead of 50%
+// (33 B -> 64 B) when there's only one class per power of 2.
+// 8, 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256
+// every class above 8 B is a multiple of 16 B, so its blocks keep the 16 B
+// alignment of the area they're carved from: the class is picked by the size
+// alone (deallocation doesn't know the alignment), and a request of 20 B or
+// 36 B aligned to 16 B must still get a 16 B aligned block.
+// above 256 B, the 16 B header of `TLSFAllocator` wastes less than rounding up
+// to a class does, so the classes stop there
+size_t constexpr granularity = byte_8;
+size_t constexpr linear_step = byte_16;
+size_t constexpr linear_limit = byte_64;
+size_t constexpr classes_per_doubling = 4u;
+size_t constexpr max_size = byte_256;
+
+namespace detail {
+
+consteval size_t count_classes() noexcept {
+    size_t count = 1u + linear_limit / linear_step;
+    for (size_t s = linear_limit; s < max_size; s *= 2) {
+        count += classes_per_doubling;
+    }
+    return count;
+}
+
+template <size_t Count>
+consteval std::array<uint32_t, Count> generate_sizes() noexcept {
+    std::array<uint32_t, Count> sizes{};
+    size_t idx = 0;
+    sizes[idx++] = (uint32_t) granularity;
+    for (size_t s = linear_step; s <= linear_limit; s += linear_step) {
+        sizes[idx++] = (uint32_t) s;
+    }
+    for (size_t base = linear_limit; base < max_size; base *= 2) {
+        size_t const step = base / classes_per_doubling;
+        for (size_t i = 1; i <= classes_per_doubling; ++i) {
+            sizes[idx++] = (uint32_t) (base + i * step);
+        }
+    }
+    return sizes;
+}
+
+template <size_t Count>
+consteval std::array<uint8_t, max_size / granularity + 1> generate_index_table(
+    std::array<uint32_t, Count> const& sizes) noexcept {
+    std::array<uint8_t, max_size / granularity + 1> table{};
+    size_t idx = 0;
+    for (size_t slot = 1; slot < table.size(); ++slot) {
+        while (sizes[idx] < slot * granularity)
+            ++idx;
+        table[slot] = (uint8_t) idx;
+    }
+    return table;
+}
+
+}  // namespace detail
+
+size_t constexpr count = detail::count_classes();
+
+inline constexpr std::array<uint32_t, count> sizes =
+    detail::generate_sizes<count>();
+
+// indexed by the size rounded up to `granularity`
+inline constexpr std::array<uint8_t, max_size / granularity + 1> index_table =
+    detail::generate_index_table(sizes);
+
+static_assert(sizes.back() == max_size);
+static_assert(std::ranges::all_of(sizes,
+    [](uint32_t s) { return s == granularity || s % DEFAULT_ALIGNMENT == 0; }));
+static_assert(count <= std::numeric_limits<uint8_t>::max());
+
+// the smallest class which can hold `size`, `size` must be in (0, max_size]
+inline constexpr size_t get_index(size_t size) noexcept {
+    return index_table[(size + granularity - 1) / granularity];
+}
+
+inline constexpr size_t get_size(size_t class_idx) noexcept {
+    return sizes[class_idx];
+}
+
+// blocks of a class are carved one after another from an area aligned to
+// `DEFAULT_ALIGNMENT`, so they're aligned to the lowest set bit of the class
+// size at most. a request is always served with proper alignment as long as
+// its alignment doesn't exceed its size rounded up to a power of 2
+inline constexpr size_t get_alignment(size_t class_idx) noexcept {
+    return std::min(size_t{1} << std::countr_zero(sizes[class_idx]),
+        DEFAULT_ALIGNMENT);
+}
+
+}  // namespace size_class
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,211 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/SlabAllocator.h"
+#include "utils/allocators/VirtualArea.h"
+
+namespace coust {
+namespace memory {
+
+SlabAllocator::~SlabAllocator() noexcept {
+    for (auto& size_class : m_classes) {
+        for (SlabList* list :
+            {&size_class.partial, &size_class.full, &size_class.empty}) {
+            while (list->first) {
+                Slab* const slab = list->first;
+                list->remove(slab);
+                release_slab(slab);
+            }
+        }
+    }
+    for (auto const& [reservation, size] : m_reservations) {
+        detail::release_pages(reservation, size);
+    }
+}
+
+void* SlabAllocator::allocate(size_t size, size_t alignment) noexcept {
+    COUST_ASSERT(alignment <= SLOT_ALIGNMENT,
+        "Slab allocator can't meet the alignment requirement {}", alignment);
+    size_t const class_idx = get_class_index(size, alignment);
+    if (class_idx < CLASS_COUNT)
+        return allocate_from(class_idx);
+    return m_fallback.allocate(size, alignment);
+}
+
+void SlabAllocator::deallocate(void* p, size_t size) noexcept {
+    if (p == nullptr)
+        return;
+    if (size <= MAX_SIZE)
+        return deallocate_to(p);
+    m_fallback.deallocate(p, size);
+}
+
+size_t SlabAllocator::trim() noexcept {
+    size_t released_size = 0;
+    for (auto& size_class : m_classes) {
+        while (size_class.empty.first) {
+            Slab* const slab = size_class.empty.first;
+            size_class.empty.remove(slab);
+            release_slab(slab);
+            released_size += SLAB_SIZE;
+        }
+    }
+    return released_size;
+}
+
+size_t SlabAllocator::get_slab_count() const noexcept {
+    size_t count = 0;
+    for (auto const& size_class : m_classes) {
+        count += size_class.partial.count + size_class.full.count +
+                 size_class.empty.count;
+    }
+    return count;
+}
+
+size_t SlabAllocator::get_empty_slab_count() const noexcept {
+    size_t count = 0;
+    for (auto const& size_class : m_classes) {
+        count += size_class.empty.count;
+    }
+    return count;
+}
+
+size_t SlabAllocator::get_reserved_size() const noexcept {
+    return m_reservations.size() * SLABS_PER_RESERVATION * SLAB_SIZE;
+}
+
+void SlabAllocator::SlabList::push_front(Slab* slab) noexcept {
+    slab->prev = nullptr;
+    slab->next = first;
+    if (first)
+        first->prev = slab;
+    first = slab;
+    count++;
+}
+
+void SlabAllocator::SlabList::remove(Slab* slab) noexcept {
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        first = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+    count--;
+}
+
+void* SlabAllocator::allocate_from(size_t class_idx) noexcept {
+    SizeClass& size_class = m_classes[class_idx];
+    Slab* slab = size_class.partial.first;
+    if (slab == nullptr) {
+        slab = size_class.empty.first;
+        if (slab)
+            size_class.empty.remove(slab);
+        else
+            slab = create_slab(class_idx);
+        size_class.partial.push_front(slab);
+    }
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    uint32_t word_idx = slab->first_free_word;
+    while (slab->bitmap[word_idx] == 0) {
+        ++word_idx;
+    }
+    uint64_t& word = slab->bitmap[word_idx];
+    WARNING_POP
+    size_t const slot_idx = word_idx * 64u + (size_t) std::countr_zero(word);
+    // clear the lowest set bit
+    word &= word - 1;
+    slab->first_free_word = word_idx;
+    if (--slab->free_count == 0) {
+        size_class.partial.remove(slab);
+        size_class.full.push_front(slab);
+    }
+    return ptr_math::add(
+        slab, SLOT_OFFSET + slot_idx * get_class_size(class_idx));
+}
+
+void SlabAllocator::deallocate_to(void* p) noexcept {
+    Slab* const slab =
+        (Slab*) ((uintptr_t) p & ~(uintptr_t) (SLAB_SIZE - 1));
+    size_t const class_idx = slab->class_idx;
+    SizeClass& size_class = m_classes[class_idx];
+    size_t const slot_idx =
+        ptr_math::sub(p, ptr_math::add(slab, SLOT_OFFSET)) /
+        get_class_size(class_idx);
+    uint32_t const word_idx = uint32_t(slot_idx / 64u);
+    uint64_t const bit = uint64_t{1} << (slot_idx % 64u);
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    uint64_t& word = slab->bitmap[word_idx];
+    WARNING_POP
+    COUST_ASSERT((word & bit) == 0, "Double free of {} in slab allocator", p);
+    word |= bit;
+    slab->first_free_word = std::min(slab->first_free_word, word_idx);
+    if (slab->free_count++ == 0) {
+        size_class.full.remove(slab);
+        size_class.partial.push_front(slab);
+    }
+    if (slab->free_count == get_slot_count(class_idx)) {
+        size_class.partial.remove(slab);
+        if (size_class.empty.count < MAX_EMPTY_SLAB_COUNT)
+            size_class.empty.push_front(slab);
+        else
+            release_slab(slab);
+    }
+}
+
+SlabAllocator::Slab* SlabAllocator::create_slab(size_t class_idx) noexcept {
+    if (m_uncommitted_slabs.empty())
+        reserve_slabs();
+    Slab* const slab = (Slab*) m_uncommitted_slabs.back();
+    COUST_PANIC_IF_NOT(detail::commit_pages(slab, SLAB_SIZE),
+        "Can't commit a slab of {} bytes", SLAB_SIZE);
+    m_uncommitted_slabs.pop_back();
+    size_t const slot_count = get_slot_count(class_idx);
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    slab->class_idx = (uint32_t) class_idx;
+    slab->free_count = (uint32_t) slot_count;
+    slab->first_free_word = 0;
+    for (size_t i = 0; i < BITMAP_WORD_COUNT; ++i) {
+        size_t const first_slot = i * 64u;
+        WARNING_PUSH
+        CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+        if (first_slot + 64u <= slot_count)
+            slab->bitmap[i] = ~uint64_t{0};
+        else if (first_slot < slot_count)
+            slab->bitmap[i] = (uint64_t{1} << (slot_count - first_slot)) - 1;
+        else
+            slab->bitmap[i] = 0;
+        WARNING_POP
+    }
+    return slab;
+}
+
+void SlabAllocator::release_slab(Slab* slab) noexcept {
+    detail::decommit_pages(slab, SLAB_SIZE);
+    // the lowest slab is committed first, which keeps the committed ones
+    // packed at the start of the reservations
+    auto const pos = std::ranges::upper_bound(
+        m_uncommitted_slabs, (void*) slab, std::greater<>{});
+    m_uncommitted_slabs.insert(pos, slab);
+}
+
+void SlabAllocator::reserve_slabs() noexcept {
+    // the system only aligns the reservation to a page
+    size_t const size = (SLABS_PER_RESERVATION + 1) * SLAB_SIZE;
+    PageType page_type = PageType::regular;
+    void* const reservation = detail::reserve_pages(size, page_type);
+    COUST_PANIC_IF_NOT(reservation,
+        "Can't reserve {} bytes of virtual memory for slabs", size);
+    m_reservations.emplace_back(reservation, size);
+    void* const first_slab = ptr_math::align(reservation, SLAB_SIZE);
+    for (size_t i = SLABS_PER_RESERVATION; i > 0; --i) {
+        m_uncommitted_slabs.push_back(
+            ptr_math::add(first_slab, (i - 1) * SLAB_SIZE));
+    }
+}
+
+}  // namespace memory
+}  // namespace coust
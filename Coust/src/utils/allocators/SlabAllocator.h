@@ -0,0 +1,202 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/HeapAllocator.h"
+
+#include <array>
+#include <bit>
+#include <utility>
+#include <vector>
+
+namespace coust {
+namespace memory {
+
+// Allocator for medium objects (64 B ~ 512 B) which are created & destroyed
+// all the time, e.g. the wrappers of vulkan objects handed out as
+// `shared_ptr`s.
+// Every size class carves its blocks from slabs of `SLAB_SIZE` bytes. A slab
+// is aligned to its size, so the slab of a block is found by masking the
+// address, and which of its slots are free is kept in a bitmap in its header
+// instead of in the blocks themselves. Blocks carry no header at all, and the
+// lowest free slot is handed out first, so live objects stay packed at the
+// front of the slabs.
+// The slabs are cut from reservations of virtual memory, and only committed
+// while in use. Emptied slabs are kept for reuse up to `MAX_EMPTY_SLAB_COUNT`
+// per class, the others are decommitted right away, and their address range
+// is reused by the next slab. Larger requests go to the heap directly, and the
+// alignment can't exceed a cache line.
+// It isn't thread safe.
+class SlabAllocator {
+public:
+    SlabAllocator(SlabAllocator&&) = delete;
+    SlabAllocator(SlabAllocator const&) = delete;
+    SlabAllocator& operator=(SlabAllocator&&) = delete;
+    SlabAllocator& operator=(SlabAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+    static size_t constexpr SLAB_SIZE = 64 * kbyte_1;
+    static size_t constexpr MIN_SIZE = byte_64;
+    static size_t constexpr MAX_SIZE = byte_512;
+    static size_t constexpr MAX_EMPTY_SLAB_COUNT = 1u;
+    // the slabs reserved from the system at once
+    static size_t constexpr SLABS_PER_RESERVATION = 32u;
+
+    // 64, 80, 96, 112, 128, 160, ..., 448, 512, spaced like `size_class`
+    static size_t constexpr CLASSES_PER_DOUBLING = 4u;
+    static size_t constexpr CLASS_COUNT =
+        1 + CLASSES_PER_DOUBLING *
+                size_t(std::bit_width(MAX_SIZE) - std::bit_width(MIN_SIZE));
+
+public:
+    SlabAllocator() noexcept = default;
+
+    ~SlabAllocator() noexcept;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    void deallocate(void* p, size_t size) noexcept;
+
+    // the size class is resolved at compile time
+    template <size_t Size, size_t Alignment>
+    void* allocate_fixed() noexcept {
+        static_assert(Alignment <= SLOT_ALIGNMENT,
+            "Slab allocator can't meet the alignment requirement");
+        size_t constexpr class_idx = get_class_index(Size, Alignment);
+        if constexpr (class_idx < CLASS_COUNT) {
+            return allocate_from(class_idx);
+        } else {
+            return m_fallback.allocate(Size, Alignment);
+        }
+    }
+
+    template <size_t Size>
+    void deallocate_fixed(void* p) noexcept {
+        if constexpr (Size <= MAX_SIZE) {
+            if (p == nullptr)
+                return;
+            deallocate_to(p);
+        } else {
+            m_fallback.deallocate(p, Size);
+        }
+    }
+
+    // decommit the cached empty slabs, return the bytes released
+    size_t trim() noexcept;
+
+    size_t get_slab_count() const noexcept;
+
+    size_t get_empty_slab_count() const noexcept;
+
+    // the address space reserved for slabs, committed or not
+    size_t get_reserved_size() const noexcept;
+
+public:
+    static constexpr size_t get_class_size(size_t class_idx) noexcept {
+        if (class_idx == 0)
+            return MIN_SIZE;
+        size_t const doubling = (class_idx - 1) / CLASSES_PER_DOUBLING;
+        size_t const step = (MIN_SIZE / CLASSES_PER_DOUBLING) << doubling;
+        return (MIN_SIZE << doubling) +
+               ((class_idx - 1) % CLASSES_PER_DOUBLING + 1) * step;
+    }
+
+    // slots start on a cache line, so they're aligned to the lowest set bit
+    // of the class size at most
+    static constexpr size_t get_class_alignment(size_t class_idx) noexcept {
+        return std::min(
+            size_t{1} << std::countr_zero(get_class_size(class_idx)),
+            SLOT_ALIGNMENT);
+    }
+
+    // the smallest class which can hold `size` aligned to `alignment`,
+    // `CLASS_COUNT` if there's none
+    static constexpr size_t get_class_index(
+        size_t size, size_t alignment) noexcept {
+        if (size > MAX_SIZE)
+            return CLASS_COUNT;
+        size_t class_idx = 0;
+        if (size > MIN_SIZE) {
+            size_t const doubling =
+                size_t(std::bit_width(size - 1) - std::bit_width(MIN_SIZE));
+            size_t const step = (MIN_SIZE / CLASSES_PER_DOUBLING) << doubling;
+            class_idx = 1 + doubling * CLASSES_PER_DOUBLING +
+                        (size - 1 - (MIN_SIZE << doubling)) / step;
+        }
+        while (class_idx < CLASS_COUNT &&
+               get_class_alignment(class_idx) < alignment) {
+            ++class_idx;
+        }
+        return class_idx;
+    }
+
+private:
+    static size_t constexpr SLOT_ALIGNMENT = byte_64;
+    static size_t constexpr MAX_SLOT_COUNT = SLAB_SIZE / MIN_SIZE;
+    static size_t constexpr BITMAP_WORD_COUNT = MAX_SLOT_COUNT / 64;
+
+    struct Slab {
+        Slab* prev;
+        Slab* next;
+        uint32_t class_idx;
+        uint32_t free_count;
+        // no word before it has any free slot
+        uint32_t first_free_word;
+        // a set bit is a free slot
+        std::array<uint64_t, BITMAP_WORD_COUNT> bitmap;
+    };
+
+    static size_t constexpr SLOT_OFFSET =
+        (sizeof(Slab) + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+    static constexpr size_t get_slot_count(size_t class_idx) noexcept {
+        return (SLAB_SIZE - SLOT_OFFSET) / get_class_size(class_idx);
+    }
+
+    struct SlabList {
+        Slab* first = nullptr;
+        size_t count = 0;
+
+        void push_front(Slab* slab) noexcept;
+
+        void remove(Slab* slab) noexcept;
+    };
+
+    struct SizeClass {
+        // the slabs with both free & used slots, where blocks come from
+        SlabList partial{};
+        SlabList full{};
+        SlabList empty{};
+    };
+
+private:
+    void* allocate_from(size_t class_idx) noexcept;
+
+    void deallocate_to(void* p) noexcept;
+
+    Slab* create_slab(size_t class_idx) noexcept;
+
+    void release_slab(Slab* slab) noexcept;
+
+    // reserve the address range of `SLABS_PER_RESERVATION` more slabs
+    void reserve_slabs() noexcept;
+
+private:
+    std::array<SizeClass, CLASS_COUNT> m_classes{};
+    HeapAllocator m_fallback{};
+    // the reservations are padded, so that they hold whole aligned slabs
+    std::vector<std::pair<void*, size_t>> m_reservations{};
+    // the reserved slabs which aren't committed, the lowest one at the back
+    std::vector<void*> m_uncommitted_slabs{};
+};
+
+static_assert(SlabAllocator::get_class_size(0) == byte_64);
+static_assert(SlabAllocator::get_class_size(1) == 80u);
+static_assert(SlabAllocator::get_class_size(4) == byte_128);
+static_assert(
+    SlabAllocator::get_class_size(SlabAllocator::CLASS_COUNT - 1) == byte_512);
+static_assert(detail::FixedSizeAllocator<SlabAllocator>);
+
+}  // namespace memory
+}  // namespace coust
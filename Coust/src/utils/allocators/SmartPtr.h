@@ -22,7 +22,7 @@ public:
         static_assert(!std::is_abstract_v<value_type>,
             "Allocator deleter doesn't support abstract class");
         ptr->~value_type();
-        m_allocator_ptr->deallocate(ptr, sizeof(value_type));
+        deallocate_fixed<sizeof(value_type)>(*m_allocator_ptr, ptr);
     }
 
     Alloc& get_allocator() const noexcept { return *m_allocator_ptr; }
@@ -43,7 +43,7 @@ using shared_ptr = std::shared_ptr<T>;
 template <typename T, detail::Allocator Alloc, typename... Args>
 auto allocate_unique(Alloc& alloc, Args&&... args)
     -> std::unique_ptr<T, detail::AllocatorDeleter<T, Alloc>> {
-    T* raw_ptr = (T*) alloc.allocate(sizeof(T), alignof(T));
+    T* raw_ptr = (T*) detail::allocate_fixed<sizeof(T), alignof(T)>(alloc);
     std::construct_at(raw_ptr, std::forward<Args>(args)...);
     return {raw_ptr, {alloc}};
 }
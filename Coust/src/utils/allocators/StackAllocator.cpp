@@ -0,0 +1,112 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/StackAllocator.h"
+
+namespace coust {
+namespace memory {
+
+StackAllocator::StackAllocator(size_t block_size) noexcept
+    : m_block_size(block_size) {
+}
+
+void* StackAllocator::allocate(size_t size, size_t alignment) noexcept {
+    if (m_top) {
+        void* const ret_ptr = ptr_math::align(m_top, alignment);
+        void* const next_top = ptr_math::add(ret_ptr, size);
+        if (next_top <= m_end) {
+            m_top = next_top;
+            return ret_ptr;
+        }
+    }
+    return allocate_from_next_block(size, alignment);
+}
+
+void StackAllocator::deallocate(void* p, size_t size) noexcept {
+    if (ptr_math::add(p, size) == m_top)
+        m_top = p;
+}
+
+StackAllocator::Marker StackAllocator::get_marker() const noexcept {
+    return Marker{m_block_idx, m_top};
+}
+
+void StackAllocator::rewind(Marker marker) noexcept {
+    COUST_ASSERT(marker.block_idx < m_block_idx ||
+                     (marker.block_idx == m_block_idx && marker.top <= m_top),
+        "The stack is rewound to a marker above its top, the scopes might be "
+        "destroyed out of order");
+    m_block_idx = marker.block_idx;
+    m_top = marker.top;
+    m_end = m_top ? m_blocks[m_block_idx].end() : nullptr;
+    // keep one spare block of regular size, so a scope which keeps crossing
+    // the boundary of blocks doesn't hit the heap every time
+    size_t const used_block_cnt = m_top ? m_block_idx + 1 : 0;
+    size_t keep_cnt = std::min(used_block_cnt + 1, m_blocks.size());
+    if (keep_cnt > used_block_cnt &&
+        m_blocks[used_block_cnt].size() > m_block_size)
+        keep_cnt = used_block_cnt;
+    m_blocks.erase(
+        m_blocks.begin() + (std::ptrdiff_t) keep_cnt, m_blocks.end());
+}
+
+size_t StackAllocator::get_used_size() const noexcept {
+    if (!m_top)
+        return 0;
+    size_t ret = ptr_math::sub(m_top, m_blocks[m_block_idx].begin());
+    for (size_t i = 0; i < m_block_idx; ++i) {
+        ret += m_blocks[i].size();
+    }
+    return ret;
+}
+
+size_t StackAllocator::get_reserved_size() const noexcept {
+    size_t ret = 0;
+    for (auto const& block : m_blocks) {
+        ret += block.size();
+    }
+    return ret;
+}
+
+void* StackAllocator::allocate_from_next_block(
+    size_t size, size_t alignment) noexcept {
+    size_t const next_block_idx = m_top ? m_block_idx + 1 : 0;
+    bool reusable = false;
+    if (next_block_idx < m_blocks.size()) {
+        Area const& spare = m_blocks[next_block_idx];
+        reusable = ptr_math::add(ptr_math::align(spare.begin(), alignment),
+                       size) <= spare.end();
+        // the spare block is too small for this allocation
+        if (!reusable) {
+            m_blocks.erase(m_blocks.begin() + (std::ptrdiff_t) next_block_idx,
+                m_blocks.end());
+        }
+    }
+    if (!reusable) {
+        size_t const block_size = std::max(m_block_size,
+            size + std::max(alignment, DEFAULT_ALIGNMENT));
+        m_blocks.emplace_back(block_size, DEFAULT_ALIGNMENT);
+    }
+    Area const& block = m_blocks[next_block_idx];
+    m_block_idx = next_block_idx;
+    void* const ret_ptr = ptr_math::align(block.begin(), alignment);
+    m_top = ptr_math::add(ret_ptr, size);
+    m_end = block.end();
+    return ret_ptr;
+}
+
+ScratchScope::ScratchScope(StackAllocator& alloc) noexcept
+    : m_alloc(alloc), m_marker(alloc.get_marker()) {
+}
+
+ScratchScope::~ScratchScope() noexcept {
+    m_alloc.rewind(m_marker);
+}
+
+StackAllocator& ScratchScope::get() noexcept {
+    return m_alloc;
+}
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/Area.h"
+
+#include <vector>
+
+namespace coust {
+namespace memory {
+
+// A scratch allocator whose memory is released by rewinding the top of the
+// stack to a marker taken earlier, which frees everything allocated after the
+// marker in O(1).
+// Memory is carved from a chain of blocks on the heap, a new block is added
+// when the current one is used up, so the size of the scratch work doesn't
+// need to be known in advance.
+class StackAllocator {
+public:
+    StackAllocator() = delete;
+    StackAllocator(StackAllocator&&) = delete;
+    StackAllocator(StackAllocator const&) = delete;
+    StackAllocator& operator=(StackAllocator&&) = delete;
+    StackAllocator& operator=(StackAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+    struct Marker {
+        size_t block_idx = 0;
+        void* top = nullptr;
+    };
+
+public:
+    explicit StackAllocator(size_t block_size) noexcept;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    // only the allocation right on the top of the stack is popped, the rest
+    // is released when the stack is rewound
+    void deallocate(void* p, size_t size) noexcept;
+
+    Marker get_marker() const noexcept;
+
+    // release everything allocated after `marker`. Markers must be rewound in
+    // the reverse order of their creation
+    void rewind(Marker marker) noexcept;
+
+    // bytes between the bottom and the top of the stack, the unused tails of
+    // the blocks included
+    size_t get_used_size() const noexcept;
+
+    size_t get_reserved_size() const noexcept;
+
+private:
+    void* allocate_from_next_block(size_t size, size_t alignment) noexcept;
+
+private:
+    size_t m_block_size;
+
+    std::vector<Area> m_blocks{};
+
+    size_t m_block_idx = 0;
+    void* m_top = nullptr;
+    void* m_end = nullptr;
+};
+
+static_assert(detail::Allocator<StackAllocator>, "");
+
+// Rewind the stack to where it was when the scope was entered. Scopes can be
+// nested as long as they are destroyed in order, which is what RAII gives.
+class ScratchScope {
+public:
+    ScratchScope() = delete;
+    ScratchScope(ScratchScope&&) = delete;
+    ScratchScope(ScratchScope const&) = delete;
+    ScratchScope& operator=(ScratchScope&&) = delete;
+    ScratchScope& operator=(ScratchScope const&) = delete;
+
+public:
+    explicit ScratchScope(StackAllocator& alloc) noexcept;
+
+    ~ScratchScope() noexcept;
+
+    StackAllocator& get() noexcept;
+
+private:
+    StackAllocator& m_alloc;
+    StackAllocator::Marker m_marker;
+};
+
+}  // namespace memory
+}  // namespace coust
@@ -2,6 +2,7 @@
 
 #include "utils/Assert.h"
 #include "utils/allocators/Allocator.h"
+#include "utils/allocators/AllocationCheck.h"
 
 namespace coust {
 namespace memory {
@@ -72,16 +73,32 @@ public:
     }
 
 public:
+    // node containers & `std::allocate_shared` allocate one object at a time,
+    // whose size class is resolved at compile time
     T* allocate(std::size_t n) noexcept {
         COUST_ASSERT(m_alloc_ptr, "You forgot to assign alloctar!");
+        detail::AllocationSourceTag tag{AllocationSource::std_allocator};
+        if (n == 1)
+            return (T*) detail::allocate_fixed<sizeof(T), alignof(T)>(
+                *m_alloc_ptr);
         return (T*) m_alloc_ptr->allocate(n * sizeof(T), alignof(T));
     }
 
     void deallocate(T* p, std::size_t n) noexcept {
         COUST_ASSERT(m_alloc_ptr, "You forgot to assign alloctar!");
+        if (n == 1)
+            return detail::deallocate_fixed<sizeof(T)>(*m_alloc_ptr, p);
         m_alloc_ptr->deallocate(p, n * sizeof(T));
     }
 
+    // not part of the standard allocator requirements, only the containers
+    // aware of it (e.g. `container::expandable_vector`) grow in place
+    bool try_expand(T* p, std::size_t old_n, std::size_t new_n) noexcept {
+        COUST_ASSERT(m_alloc_ptr, "You forgot to assign alloctar!");
+        return detail::try_expand(
+            *m_alloc_ptr, p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
     StdAllocator<T, Alloc> select_on_container_copy_construction()
         const noexcept {
         return StdAllocator<T, Alloc>{*m_alloc_ptr};
@@ -4,6 +4,12 @@
 
 #include "utils/containers/RobinSet.h"
 #include "utils/containers/RobinMap.h"
+#include "utils/containers/SwissMap.h"
+#include "utils/containers/ConcurrentMap.h"
+#include "utils/containers/FlatMap.h"
+#include "utils/containers/ExpandableVector.h"
+#include "utils/containers/SmallVector.h"
+#include "utils/math/Hash.h"
 
 #include <scoped_allocator>
 
@@ -23,34 +29,106 @@ namespace memory {
 
 // collection of template aliasings to save typing
 
+namespace detail {
+
+// strings are hashed & compared transparently, so the hash containers keyed by
+// them can be looked up with string views & literals
+template <typename Key>
+struct lookup_traits {
+    using hasher = std::hash<Key>;
+    using key_equal = std::equal_to<Key>;
+};
+
+template <typename Alloc>
+struct lookup_traits<std::basic_string<char, std::char_traits<char>, Alloc>> {
+    using hasher = string_hash;
+    using key_equal = std::equal_to<>;
+};
+
+template <typename Key>
+using lookup_hash = typename lookup_traits<Key>::hasher;
+
+template <typename Key>
+using lookup_equal = typename lookup_traits<Key>::key_equal;
+
+}  // namespace detail
+
+
 template <typename T, detail::Allocator Alloc>
 using vector = std::vector<T, StdAllocator<T, Alloc>>;
 
+// grows in place when the allocator can resize the block, prefer it for large
+// buffers of trivially relocatable elements which mostly grow at the end
+template <typename T, detail::Allocator Alloc>
+using expandable_vector =
+    container::expandable_vector<T, StdAllocator<T, Alloc>>;
+
 template <typename T, detail::Allocator Alloc>
 using vector_nested =
     std::vector<T, std::scoped_allocator_adaptor<StdAllocator<T, Alloc>>>;
 
+// holds the first `N` elements inline, for the short lists built over and over
+template <typename T, size_t N, detail::Allocator Alloc>
+using small_vector = container::small_vector<T, N, StdAllocator<T, Alloc>>;
+
+template <typename T, size_t N, detail::Allocator Alloc>
+using small_vector_nested = container::small_vector<T, N,
+    std::scoped_allocator_adaptor<StdAllocator<T, Alloc>>>;
+
 template <detail::Allocator Alloc>
 using string =
     std::basic_string<char, std::char_traits<char>, StdAllocator<char, Alloc>>;
 
 template <typename T, detail::Allocator Alloc>
-using robin_set = container::robin_set<T, std::hash<T>, std::equal_to<T>,
-    StdAllocator<T, Alloc>>;
+using robin_set = container::robin_set<T, detail::lookup_hash<T>,
+    detail::lookup_equal<T>, StdAllocator<T, Alloc>>;
 
 template <typename T, detail::Allocator Alloc>
-using robin_set_nested = container::robin_set<T, std::hash<T>, std::equal_to<T>,
+using robin_set_nested = container::robin_set<T, detail::lookup_hash<T>,
+    detail::lookup_equal<T>,
     std::scoped_allocator_adaptor<StdAllocator<T, Alloc>>>;
 
 template <typename Key, typename Mapped, detail::Allocator Alloc>
-using robin_map = container::robin_map<Key, Mapped, std::hash<Key>,
-    std::equal_to<Key>, StdAllocator<std::pair<Key, Mapped>, Alloc>>;
+using robin_map = container::robin_map<Key, Mapped, detail::lookup_hash<Key>,
+    detail::lookup_equal<Key>, StdAllocator<std::pair<Key, Mapped>, Alloc>>;
 
 template <typename Key, typename Mapped, detail::Allocator Alloc>
-using robin_map_nested = container::robin_map<Key, Mapped, std::hash<Key>,
-    std::equal_to<Key>,
+using robin_map_nested = container::robin_map<Key, Mapped,
+    detail::lookup_hash<Key>, detail::lookup_equal<Key>,
     std::scoped_allocator_adaptor<StdAllocator<std::pair<Key, Mapped>, Alloc>>>;
 
+// probes the control bytes with SIMD. misses are cheaper than `robin_map`, but
+// hits touch both the control bytes & the value and measured ~20% slower, so
+// the render caches, which mostly hit, stay on `robin_map`
+template <typename Key, typename Mapped, detail::Allocator Alloc>
+using swiss_map = container::swiss_map<Key, Mapped, detail::lookup_hash<Key>,
+    detail::lookup_equal<Key>, StdAllocator<std::pair<Key, Mapped>, Alloc>>;
+
+template <typename Key, typename Mapped, detail::Allocator Alloc>
+using swiss_map_nested = container::swiss_map<Key, Mapped,
+    detail::lookup_hash<Key>, detail::lookup_equal<Key>,
+    std::scoped_allocator_adaptor<StdAllocator<std::pair<Key, Mapped>, Alloc>>>;
+
+// a sorted array holding the first `N` elements inline, for the tiny maps
+// carried around by value
+template <typename Key, typename Mapped, size_t N, detail::Allocator Alloc>
+using flat_map = container::flat_map<Key, Mapped, N, std::less<>,
+    StdAllocator<std::pair<Key, Mapped>, Alloc>>;
+
+template <typename Key, typename Mapped, size_t N, detail::Allocator Alloc>
+using flat_map_nested = container::flat_map<Key, Mapped, N, std::less<>,
+    std::scoped_allocator_adaptor<StdAllocator<std::pair<Key, Mapped>, Alloc>>>;
+
+// shared across threads, the allocator must be safe to use from all of them
+template <typename Key, typename Mapped, detail::Allocator Alloc>
+using concurrent_map = container::concurrent_map<Key, Mapped,
+    detail::lookup_hash<Key>, detail::lookup_equal<Key>,
+    StdAllocator<std::pair<Key, Mapped>, Alloc>>;
+
+template <typename Key, typename Mapped, detail::Allocator Alloc>
+using rcu_map = container::rcu_map<Key, Mapped, detail::lookup_hash<Key>,
+    detail::lookup_equal<Key>, StdAllocator<std::pair<Key, Mapped>, Alloc>>;
+
 template <typename T, detail::Allocator Alloc>
 using deque = std::deque<T, StdAllocator<T, Alloc>>;
 
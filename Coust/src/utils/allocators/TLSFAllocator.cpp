@@ -0,0 +1,332 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/TLSFAllocator.h"
+
+#include <bit>
+
+namespace coust {
+namespace memory {
+
+TLSFAllocator::TLSFAllocator(void* begin, void* end) noexcept {
+    grow(begin, ptr_math::sub(end, begin));
+}
+
+void* TLSFAllocator::allocate(size_t size, size_t alignment) noexcept {
+    COUST_ASSERT(size > 0,
+        "You shouldn't allocate memory of size 0 using TLSF allocator");
+    size_t const required_size =
+        std::max(ptr_math::round_up_to_alinged(size, ALIGN_SIZE) +
+                     BLOCK_HEADER_SIZE,
+            MIN_BLOCK_SIZE);
+    bool const over_aligned = alignment > ALIGN_SIZE;
+    // reserve enough space to split off a gap in front of the aligned pointer
+    size_t const search_size =
+        over_aligned ? required_size + alignment + MIN_BLOCK_SIZE :
+                       required_size;
+    auto const [fl, sl] = mapping_search(search_size);
+    BlockHeader* RESTRICT block = search_suitable_block(fl, sl);
+    if (!block) {
+        // the rounded-up search misses a block that fits exactly, which is
+        // common when a fresh area serves one allocation as large as itself.
+        // checking the head of the list the size maps to is still O(1)
+        auto const [exact_fl, exact_sl] = mapping_insert(search_size);
+        if (exact_fl >= FL_INDEX_COUNT)
+            return nullptr;
+        block = m_free_blocks[exact_fl][exact_sl];
+        if (!block || block_size(block) < search_size)
+            return nullptr;
+    }
+    remove_free_block(block);
+
+    if (over_aligned) {
+        void* const payload = ptr_math::add(block, BLOCK_HEADER_SIZE);
+        void* aligned_payload = ptr_math::align(payload, alignment);
+        // the gap must be able to hold a free block by itself
+        if (aligned_payload != payload &&
+            ptr_math::sub(aligned_payload, payload) < MIN_BLOCK_SIZE) {
+            aligned_payload = ptr_math::align(
+                ptr_math::add(payload, MIN_BLOCK_SIZE), alignment);
+        }
+        size_t const gap = ptr_math::sub(aligned_payload, payload);
+        if (gap > 0) {
+            size_t const origin_size = block_size(block);
+            BlockHeader* const RESTRICT aligned_block = (BlockHeader*)
+                ptr_math::sub(aligned_payload, BLOCK_HEADER_SIZE);
+            aligned_block->prev_phys = block;
+            aligned_block->size = (origin_size - gap) | PREV_FREE_BIT;
+            next_phys(aligned_block)->prev_phys = aligned_block;
+            block->size = gap | FREE_BIT | (block->size & PREV_FREE_BIT);
+            insert_free_block(block);
+            block = aligned_block;
+        }
+    }
+
+    split_block(block, required_size);
+    block->size &= ~FREE_BIT;
+    next_phys(block)->size &= ~PREV_FREE_BIT;
+    return ptr_math::add(block, BLOCK_HEADER_SIZE);
+}
+
+void TLSFAllocator::deallocate(void* p, [[maybe_unused]] size_t) noexcept {
+    BlockHeader* RESTRICT block =
+        (BlockHeader*) ptr_math::sub(p, BLOCK_HEADER_SIZE);
+    COUST_ASSERT(!is_free(block), "Double free of memory block {}", p);
+    block->size |= FREE_BIT;
+
+    // merge with previous block, the flags of the previous block are kept
+    if (is_prev_free(block)) {
+        BlockHeader* const RESTRICT prev = block->prev_phys;
+        remove_free_block(prev);
+        prev->size += block_size(block);
+        block = prev;
+    }
+    // merge with next block
+    BlockHeader* RESTRICT next = next_phys(block);
+    if (is_free(next)) {
+        remove_free_block(next);
+        block->size += block_size(next);
+        next = next_phys(block);
+    }
+    next->prev_phys = block;
+    next->size |= PREV_FREE_BIT;
+    insert_free_block(block);
+}
+
+bool TLSFAllocator::try_expand(
+    void* p, [[maybe_unused]] size_t, size_t new_size) noexcept {
+    BlockHeader* const RESTRICT block =
+        (BlockHeader*) ptr_math::sub(p, BLOCK_HEADER_SIZE);
+    COUST_ASSERT(!is_free(block), "Expanding a free memory block {}", p);
+    size_t const required_size =
+        std::max(ptr_math::round_up_to_alinged(new_size, ALIGN_SIZE) +
+                     BLOCK_HEADER_SIZE,
+            MIN_BLOCK_SIZE);
+    BlockHeader* RESTRICT next = next_phys(block);
+    bool const next_free = is_free(next);
+    size_t const available_size =
+        block_size(block) + (next_free ? block_size(next) : 0u);
+    if (available_size < required_size)
+        return false;
+    if (next_free) {
+        remove_free_block(next);
+        block->size += block_size(next);
+        next = next_phys(block);
+        next->prev_phys = block;
+        next->size &= ~PREV_FREE_BIT;
+    }
+    // the block after is never free here, so the residual needs no merging
+    split_block(block, required_size);
+    return true;
+}
+
+void TLSFAllocator::grow(void* p, size_t size) noexcept {
+    // round the end of area down to the alignment
+    void* const end = (void*) ((uintptr_t) ptr_math::add(p, size) &
+                               ~(uintptr_t) (ALIGN_SIZE - 1));
+    // the new area right after the last one is merged into it, the old
+    // sentinel becomes the header of the new free block
+    bool const contiguous = m_last_sentinel &&
+                            p == ptr_math::add(m_last_sentinel,
+                                     BLOCK_HEADER_SIZE);
+    BlockHeader* RESTRICT block =
+        contiguous ? m_last_sentinel :
+                     (BlockHeader*) ptr_math::align(p, ALIGN_SIZE);
+    COUST_ASSERT(end > block &&
+                     ptr_math::sub(end, block) >=
+                         MIN_BLOCK_SIZE + BLOCK_HEADER_SIZE,
+        "The new area ({}, {} bytes) is too small to be used by TLSF allocator",
+        p, size);
+    size_t const free_size = ptr_math::sub(end, block) - BLOCK_HEADER_SIZE;
+    COUST_ASSERT(free_size < (size_t{1} << FL_INDEX_MAX),
+        "The size of memory block exceeds the maximum size TLSF can manage");
+    if (contiguous) {
+        block->size = free_size | FREE_BIT | (block->size & PREV_FREE_BIT);
+    } else {
+        block->prev_phys = nullptr;
+        block->size = free_size | FREE_BIT;
+    }
+    BlockHeader* const RESTRICT sentinel = next_phys(block);
+    sentinel->size = PREV_FREE_BIT;
+    m_last_sentinel = sentinel;
+    if (is_prev_free(block)) {
+        BlockHeader* const RESTRICT prev = block->prev_phys;
+        remove_free_block(prev);
+        prev->size += block_size(block);
+        block = prev;
+    }
+    sentinel->prev_phys = block;
+    insert_free_block(block);
+}
+
+bool TLSFAllocator::shrink(void* begin, void* end) noexcept {
+    // an unused area (or a run of merged ones) is a single free block followed
+    // by its sentinel, and the next area of the range starts right after it
+    size_t constexpr min_area_size = MIN_BLOCK_SIZE + BLOCK_HEADER_SIZE;
+    auto const for_each_area = [begin, end](auto&& func) {
+        for (void* area = begin; ptr_math::sub(end, area) >= min_area_size;) {
+            BlockHeader* const block =
+                (BlockHeader*) ptr_math::align(area, ALIGN_SIZE);
+            if (!func(block))
+                return false;
+            area = ptr_math::add(next_phys(block), BLOCK_HEADER_SIZE);
+        }
+        return true;
+    };
+    bool const unused = for_each_area([](BlockHeader const* block) {
+        return is_free(block) && block_size(next_phys(block)) == 0;
+    });
+    if (!unused)
+        return false;
+    for_each_area([this](BlockHeader* block) {
+        remove_free_block(block);
+        if (next_phys(block) == m_last_sentinel)
+            m_last_sentinel = nullptr;
+        return true;
+    });
+    return true;
+}
+
+size_t TLSFAllocator::block_size(BlockHeader const* block) noexcept {
+    return block->size & ~FLAG_BITS;
+}
+
+bool TLSFAllocator::is_free(BlockHeader const* block) noexcept {
+    return (block->size & FREE_BIT) != 0;
+}
+
+bool TLSFAllocator::is_prev_free(BlockHeader const* block) noexcept {
+    return (block->size & PREV_FREE_BIT) != 0;
+}
+
+TLSFAllocator::BlockHeader* TLSFAllocator::next_phys(
+    BlockHeader const* block) noexcept {
+    return (BlockHeader*) ptr_math::add(block, block_size(block));
+}
+
+std::pair<size_t, size_t> TLSFAllocator::mapping_insert(size_t size) noexcept {
+    if (size < SMALL_BLOCK_SIZE)
+        return {0u, size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT)};
+    size_t const fl = (size_t) std::bit_width(size) - 1;
+    size_t const sl = (size >> (fl - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+    return {fl - (FL_INDEX_SHIFT - 1), sl};
+}
+
+std::pair<size_t, size_t> TLSFAllocator::mapping_search(size_t size) noexcept {
+    // round up to the next second level, so that any block in the list is
+    // large enough
+    if (size >= SMALL_BLOCK_SIZE) {
+        size_t const round =
+            (size_t{1}
+                << ((size_t) std::bit_width(size) - 1 - SL_INDEX_COUNT_LOG2)) -
+            1;
+        size += round;
+    }
+    return mapping_insert(size);
+}
+
+TLSFAllocator::BlockHeader* TLSFAllocator::search_suitable_block(
+    size_t fl, size_t sl) const noexcept {
+    if (fl >= FL_INDEX_COUNT)
+        return nullptr;
+    uint32_t sl_map = m_sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        uint32_t const fl_map = m_fl_bitmap & (~0u << (fl + 1));
+        if (!fl_map)
+            return nullptr;
+        fl = (size_t) std::countr_zero(fl_map);
+        sl_map = m_sl_bitmap[fl];
+    }
+    sl = (size_t) std::countr_zero(sl_map);
+    return m_free_blocks[fl][sl];
+}
+
+void TLSFAllocator::insert_free_block(BlockHeader* block) noexcept {
+    auto const [fl, sl] = mapping_insert(block_size(block));
+    BlockHeader*& head = m_free_blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if (head)
+        head->prev_free = block;
+    head = block;
+    m_fl_bitmap |= 1u << fl;
+    m_sl_bitmap[fl] |= 1u << sl;
+
+#if defined(COUST_TEST)
+    m_free_block_count++;
+    m_free_block_size += block_size(block);
+#endif
+}
+
+void TLSFAllocator::remove_free_block(BlockHeader* block) noexcept {
+    auto const [fl, sl] = mapping_insert(block_size(block));
+    if (block->next_free)
+        block->next_free->prev_free = block->prev_free;
+    if (block->prev_free)
+        block->prev_free->next_free = block->next_free;
+    BlockHeader*& head = m_free_blocks[fl][sl];
+    if (head == block) {
+        head = block->next_free;
+        if (!head) {
+            m_sl_bitmap[fl] &= ~(1u << sl);
+            if (!m_sl_bitmap[fl])
+                m_fl_bitmap &= ~(1u << fl);
+        }
+    }
+
+#if defined(COUST_TEST)
+    m_free_block_count--;
+    m_free_block_size -= block_size(block);
+#endif
+}
+
+void TLSFAllocator::split_block(BlockHeader* block, size_t size) noexcept {
+    size_t const residual_size = block_size(block) - size;
+    // no enough residual space left, give up trimming
+    if (residual_size < MIN_BLOCK_SIZE)
+        return;
+    BlockHeader* const RESTRICT residual =
+        (BlockHeader*) ptr_math::add(block, size);
+    residual->prev_phys = block;
+    residual->size = residual_size | FREE_BIT;
+    BlockHeader* const RESTRICT next = next_phys(residual);
+    next->prev_phys = residual;
+    next->size |= PREV_FREE_BIT;
+    block->size = size | (block->size & FLAG_BITS);
+    insert_free_block(residual);
+}
+
+#if defined(COUST_TEST)
+void TLSFAllocator::is_malfunctioning() const noexcept {
+    size_t free_block_count = 0;
+    size_t free_block_size = 0;
+    for (size_t fl = 0; fl < FL_INDEX_COUNT; ++fl) {
+        COUST_PANIC_IF_NOT(((m_fl_bitmap >> fl) & 1u) == (m_sl_bitmap[fl] != 0),
+            "");
+        for (size_t sl = 0; sl < SL_INDEX_COUNT; ++sl) {
+            BlockHeader const* block = m_free_blocks[fl][sl];
+            COUST_PANIC_IF_NOT(
+                ((m_sl_bitmap[fl] >> sl) & 1u) == (block != nullptr), "");
+            for (; block; block = block->next_free) {
+                COUST_PANIC_IF_NOT(is_free(block), "");
+                COUST_PANIC_IF_NOT(
+                    mapping_insert(block_size(block)) == std::make_pair(fl, sl),
+                    "");
+                // adjacent free blocks should have been merged
+                COUST_PANIC_IF_NOT(!is_prev_free(block), "");
+                COUST_PANIC_IF_NOT(!is_free(next_phys(block)), "");
+                COUST_PANIC_IF_NOT(is_prev_free(next_phys(block)), "");
+                COUST_PANIC_IF_NOT(next_phys(block)->prev_phys == block, "");
+                free_block_count++;
+                free_block_size += block_size(block);
+            }
+        }
+    }
+    COUST_PANIC_IF_NOT(free_block_count == m_free_block_count, "");
+    COUST_PANIC_IF_NOT(free_block_size == m_free_block_size, "");
+}
+#endif
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+#include "utils/allocators/Area.h"
+
+#include <array>
+
+namespace coust {
+namespace memory {
+
+// ref:
+// http://www.gii.upv.es/tlsf/files/papers/ecrts04_tlsf.pdf
+// https://github.com/mattconte/tlsf
+class TLSFAllocator {
+public:
+    TLSFAllocator(TLSFAllocator&&) = delete;
+    TLSFAllocator(TLSFAllocator const&) = delete;
+    TLSFAllocator& operator=(TLSFAllocator&&) = delete;
+    TLSFAllocator& operator=(TLSFAllocator const&) = delete;
+
+public:
+    using stateful = std::true_type;
+
+public:
+    TLSFAllocator() noexcept = default;
+
+    TLSFAllocator(void* begin, void* end) noexcept;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    void deallocate(void* p, size_t) noexcept;
+
+    // absorb the free block right after the block, or trim the block if it
+    // shrinks
+    bool try_expand(void* p, size_t, size_t new_size) noexcept;
+
+    void grow(void* p, size_t size) noexcept;
+
+    // stop using the memory of [begin, end) if none of its blocks is in use,
+    // and return whether it's given up. the range is made of whole areas
+    // passed to `grow()`, including every area merged with them
+    bool shrink(void* begin, void* end) noexcept;
+
+private:
+    // layout of memory block:
+    //                                    pointer allocated
+    //                                           |
+    //                                           v
+    // +------------------+----------------------+-------------------------+
+    // | BlockHeader* prev_phys | size_t size    | BlockHeader* next_free  |
+    // |                        |                | BlockHeader* prev_free  |
+    // +------------------------+----------------+-------------------------+
+    // |<--------- always in use ------------->|<- only used when free -->|
+    //
+    // `prev_phys` points to the block right before this one in the same area,
+    // which makes coalescing O(1). Since every block is aligned to
+    // `ALIGN_SIZE`, the lowest 2 bits of `size` are used as flags.
+    // Every area is terminated by a sentinel block of size 0 which is never
+    // free, so coalescing stops at the boundary of areas, unless the next area
+    // is right after the last one, in which case the two are merged.
+    struct BlockHeader {
+        BlockHeader* prev_phys = nullptr;
+        size_t size = 0;
+        BlockHeader* next_free = nullptr;
+        BlockHeader* prev_free = nullptr;
+    };
+
+    static size_t constexpr ALIGN_SIZE_LOG2 = 4u;
+    static size_t constexpr ALIGN_SIZE = size_t{1} << ALIGN_SIZE_LOG2;
+
+    // every first level (power of 2) is split into 16 second levels linearly
+    static size_t constexpr SL_INDEX_COUNT_LOG2 = 4u;
+    static size_t constexpr SL_INDEX_COUNT = size_t{1} << SL_INDEX_COUNT_LOG2;
+
+    // blocks smaller than `SMALL_BLOCK_SIZE` all live in the first level 0,
+    // and the largest block should be smaller than 4 GiB, which is consistent
+    // with `FreeListAllocator`
+    static size_t constexpr FL_INDEX_SHIFT =
+        SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2;
+    static size_t constexpr FL_INDEX_MAX = 32u;
+    static size_t constexpr FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+    static size_t constexpr SMALL_BLOCK_SIZE = size_t{1} << FL_INDEX_SHIFT;
+
+    static size_t constexpr BLOCK_HEADER_SIZE = 2 * sizeof(void*);
+    static size_t constexpr MIN_BLOCK_SIZE = sizeof(BlockHeader);
+
+    static size_t constexpr FREE_BIT = 0x1;
+    static size_t constexpr PREV_FREE_BIT = 0x2;
+    static size_t constexpr FLAG_BITS = FREE_BIT | PREV_FREE_BIT;
+
+    static_assert(BLOCK_HEADER_SIZE == ALIGN_SIZE);
+    static_assert(MIN_BLOCK_SIZE % ALIGN_SIZE == 0);
+
+public:
+    // the block header plus the sentinel at the end of an area, so an area of
+    // `n` bytes can serve one allocation of at most `n - BOOKKEEPING_SIZE`
+    // bytes
+    static size_t constexpr BOOKKEEPING_SIZE = 2 * BLOCK_HEADER_SIZE;
+
+    // the payload an area must have room for to serve the allocation, i.e.
+    // the size plus the gap split off in front of an over-aligned block
+    static constexpr size_t get_padded_size(
+        size_t size, size_t alignment) noexcept {
+        size = ptr_math::round_up_to_alinged(size, ALIGN_SIZE);
+        return alignment > ALIGN_SIZE ? size + alignment + MIN_BLOCK_SIZE :
+                                        size;
+    }
+
+private:
+    static size_t block_size(BlockHeader const* block) noexcept;
+
+    static bool is_free(BlockHeader const* block) noexcept;
+
+    static bool is_prev_free(BlockHeader const* block) noexcept;
+
+    static BlockHeader* next_phys(BlockHeader const* block) noexcept;
+
+    // first level & second level index of the list a block of `size` lives in
+    static std::pair<size_t, size_t> mapping_insert(size_t size) noexcept;
+
+    // first level & second level index of the list where every block is large
+    // enough for `size`
+    static std::pair<size_t, size_t> mapping_search(size_t size) noexcept;
+
+    BlockHeader* search_suitable_block(size_t fl, size_t sl) const noexcept;
+
+    void insert_free_block(BlockHeader* block) noexcept;
+
+    void remove_free_block(BlockHeader* block) noexcept;
+
+    // trim the trailing part of a (removed) free block and return it to the
+    // free lists if it is large enough
+    void split_block(BlockHeader* block, size_t size) noexcept;
+
+private:
+    uint32_t m_fl_bitmap = 0;
+    std::array<uint32_t, FL_INDEX_COUNT> m_sl_bitmap{};
+    std::array<std::array<BlockHeader*, SL_INDEX_COUNT>, FL_INDEX_COUNT>
+        m_free_blocks{};
+    // the sentinel of the latest area, so an area right after it can be
+    // merged into it
+    BlockHeader* m_last_sentinel = nullptr;
+
+#if defined(COUST_TEST)
+private:
+    size_t m_free_block_count = 0;
+    size_t m_free_block_size = 0;
+
+public:
+    void is_malfunctioning() const noexcept;
+#endif
+};
+
+static_assert(detail::GrowableAllocator<TLSFAllocator>, "");
+static_assert(detail::ShrinkableAllocator<TLSFAllocator>, "");
+static_assert(detail::ExpandableAllocator<TLSFAllocator>, "");
+
+}  // namespace memory
+}  // namespace coust
@@ -0,0 +1,230 @@
+#include "pch.h"
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/allocators/VirtualArea.h"
+
+#if defined(_WIN32)
+WARNING_PUSH
+DISABLE_ALL_WARNING
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+WARNING_POP
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace coust {
+namespace memory {
+namespace detail {
+
+size_t get_system_page_size() noexcept {
+#if defined(_WIN32)
+    static size_t const s_page_size = [] {
+        SYSTEM_INFO info{};
+        GetSystemInfo(&info);
+        return (size_t) info.dwPageSize;
+    }();
+#else
+    static size_t const s_page_size = (size_t) sysconf(_SC_PAGESIZE);
+#endif
+    return s_page_size;
+}
+
+void* reserve_pages(size_t size, PageType& page_type) noexcept {
+#if defined(_WIN32)
+    // large pages on windows need a privilege and must be committed at once,
+    // which defeats the purpose of reserving, so only regular pages are used
+    page_type = PageType::regular;
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    #if defined(MAP_HUGETLB)
+    if (page_type == PageType::explicit_huge) {
+        // no `MAP_NORESERVE` here, otherwise the mapping succeeds even if the
+        // pool is empty and the first touch of a page raises SIGBUS
+        void* const p = mmap(nullptr, size, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+            return p;
+    }
+    #endif
+    if (page_type == PageType::regular) {
+        void* const p = mmap(nullptr, size, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+    // huge pages can only back the ranges aligned to the huge page size, so
+    // reserve a bit more and unmap the unaligned head and tail
+    page_type = PageType::transparent_huge;
+    size_t const padded_size = size + HUGE_PAGE_SIZE;
+    void* const padded = mmap(nullptr, padded_size, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (padded == MAP_FAILED)
+        return nullptr;
+    void* const p = ptr_math::align(padded, HUGE_PAGE_SIZE);
+    size_t const head_size = ptr_math::sub(p, padded);
+    if (head_size > 0)
+        munmap(padded, head_size);
+    size_t const tail_size = HUGE_PAGE_SIZE - head_size;
+    if (tail_size > 0)
+        munmap(ptr_math::add(p, size), tail_size);
+    #if defined(MADV_HUGEPAGE)
+    madvise(p, size, MADV_HUGEPAGE);
+    #endif
+    return p;
+#endif
+}
+
+bool commit_pages(void* p, size_t size) noexcept {
+#if defined(_WIN32)
+    return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(p, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void decommit_pages(void* p, size_t size) noexcept {
+#if defined(_WIN32)
+    VirtualFree(p, size, MEM_DECOMMIT);
+#else
+    madvise(p, size, MADV_DONTNEED);
+    mprotect(p, size, PROT_NONE);
+#endif
+}
+
+void release_pages(void* p, size_t size) noexcept {
+#if defined(_WIN32)
+    (void) size;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, size);
+#endif
+}
+
+bool resize_pages(void* p, size_t size, size_t new_size) noexcept {
+#if defined(_WIN32)
+    // a reservation can only be released as a whole, so the tail is just
+    // decommitted. the range right after could be reserved as well, but the
+    // two reservations couldn't be released by a single `VirtualFree()` later
+    if (new_size > size)
+        return false;
+    decommit_pages(ptr_math::add(p, new_size), size - new_size);
+    return true;
+#elif defined(__linux__)
+    // without `MREMAP_MAYMOVE` the mapping either grows in place or fails,
+    // and the new pages inherit the protection of the committed ones
+    return mremap(p, size, new_size, 0) == p;
+#else
+    if (new_size > size)
+        return false;
+    munmap(ptr_math::add(p, new_size), size - new_size);
+    return true;
+#endif
+}
+
+}  // namespace detail
+
+VirtualArea::VirtualArea(size_t reserved_size, PageType page_type) noexcept
+    : m_page_type(page_type) {
+    m_page_size = page_type == PageType::regular ?
+                      detail::get_system_page_size() :
+                      detail::HUGE_PAGE_SIZE;
+    reserved_size = ptr_math::round_up_to_alinged(reserved_size, m_page_size);
+    m_begin = detail::reserve_pages(reserved_size, m_page_type);
+    COUST_PANIC_IF(m_begin == nullptr,
+        "Can't reserve {} bytes of virtual memory", reserved_size);
+    // transparent huge pages are formed by the kernel behind the scenes, so
+    // the memory can still be committed by regular pages
+    if (m_page_type != PageType::explicit_huge)
+        m_page_size = detail::get_system_page_size();
+    m_committed_end = m_begin;
+    m_reserved_end = ptr_math::add(m_begin, reserved_size);
+}
+
+VirtualArea::~VirtualArea() noexcept {
+    detail::release_pages(m_begin, get_reserved_size());
+}
+
+std::pair<void*, size_t> VirtualArea::commit(size_t size) noexcept {
+    size = ptr_math::round_up_to_alinged(size, m_page_size);
+    if (size > ptr_math::sub(m_reserved_end, m_committed_end))
+        return {nullptr, 0u};
+    void* const ret = m_committed_end;
+    COUST_PANIC_IF_NOT(detail::commit_pages(ret, size),
+        "Can't commit {} bytes of virtual memory at {}", size, ret);
+    m_committed_end = ptr_math::add(ret, size);
+    return {ret, size};
+}
+
+void VirtualArea::decommit(size_t size) noexcept {
+    size = ptr_math::round_up_to_alinged(size, m_page_size);
+    if (size >= get_committed_size())
+        return;
+    void* const new_end = ptr_math::add(m_begin, size);
+    detail::decommit_pages(new_end, ptr_math::sub(m_committed_end, new_end));
+    m_committed_end = new_end;
+}
+
+void* VirtualArea::begin() const noexcept {
+    return m_begin;
+}
+
+void* VirtualArea::end() const noexcept {
+    return m_committed_end;
+}
+
+bool VirtualArea::contained(void* p) const noexcept {
+    return (p >= m_begin) && (p < m_committed_end);
+}
+
+size_t VirtualArea::get_committed_size() const noexcept {
+    return ptr_math::sub(m_committed_end, m_begin);
+}
+
+size_t VirtualArea::get_reserved_size() const noexcept {
+    return ptr_math::sub(m_reserved_end, m_begin);
+}
+
+size_t VirtualArea::get_page_size() const noexcept {
+    return m_page_size;
+}
+
+PageType VirtualArea::get_page_type() const noexcept {
+    return m_page_type;
+}
+
+void* PageAllocator::allocate(size_t size, size_t alignment) noexcept {
+    size_t const page_size = detail::get_system_page_size();
+    COUST_ASSERT(alignment <= page_size,
+        "Page allocator can't provide alignment {} beyond the page size {}",
+        alignment, page_size);
+    PageType page_type = size >= detail::HUGE_PAGE_SIZE ?
+                             PageType::transparent_huge :
+                             PageType::regular;
+    size = ptr_math::round_up_to_alinged(size, page_size);
+    void* const p = detail::reserve_pages(size, page_type);
+    if (p && !detail::commit_pages(p, size)) {
+        detail::release_pages(p, size);
+        return nullptr;
+    }
+    return p;
+}
+
+void PageAllocator::deallocate(void* p, size_t size) noexcept {
+    detail::release_pages(
+        p, ptr_math::round_up_to_alinged(size, detail::get_system_page_size()));
+}
+
+bool PageAllocator::try_expand(
+    void* p, size_t old_size, size_t new_size) noexcept {
+    size_t const page_size = detail::get_system_page_size();
+    old_size = ptr_math::round_up_to_alinged(old_size, page_size);
+    new_size = ptr_math::round_up_to_alinged(new_size, page_size);
+    return new_size == old_size ||
+           detail::resize_pages(p, old_size, new_size);
+}
+
+}  // namespace memory
+}  // namespace coust
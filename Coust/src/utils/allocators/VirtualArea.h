@@ -0,0 +1,116 @@
+#pragma once
+
+#include "utils/allocators/Allocator.h"
+
+namespace coust {
+namespace memory {
+
+enum class PageType {
+    regular,
+    // ask the kernel to back the range with huge pages when it can
+    transparent_huge,
+    // map the range from the pre-allocated huge page pool of the system, fall
+    // back to transparent huge pages if the pool is empty or unsupported
+    explicit_huge,
+};
+
+namespace detail {
+
+size_t constexpr HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+size_t get_system_page_size() noexcept;
+
+// platform layer shared by `VirtualArea` and `PageAllocator`. `page_type` is
+// updated to the type actually used if the requested one isn't available
+void* reserve_pages(size_t size, PageType& page_type) noexcept;
+
+bool commit_pages(void* p, size_t size) noexcept;
+
+void decommit_pages(void* p, size_t size) noexcept;
+
+void release_pages(void* p, size_t size) noexcept;
+
+// resize the committed mapping `[p, p + size)` to `new_size` bytes without
+// moving it. growing fails if the address range after it is taken or the
+// platform can't extend a mapping, shrinking always succeeds
+bool resize_pages(void* p, size_t size, size_t new_size) noexcept;
+
+}  // namespace detail
+
+// A contiguous range of virtual address space reserved up front, which is
+// backed by physical memory page by page as it's committed. Since the
+// committed part always starts at `begin()`, whatever lives in the area grows
+// in place instead of jumping to a new block.
+class VirtualArea {
+public:
+    VirtualArea() = delete;
+    VirtualArea(VirtualArea&&) = delete;
+    VirtualArea(VirtualArea const&) = delete;
+    VirtualArea& operator=(VirtualArea&&) = delete;
+    VirtualArea& operator=(VirtualArea const&) = delete;
+
+public:
+    VirtualArea(size_t reserved_size, PageType page_type) noexcept;
+
+    ~VirtualArea() noexcept;
+
+    // commit at least `size` bytes right after the committed part, and return
+    // the newly committed range. returns nullptr if the reservation is used up
+    std::pair<void*, size_t> commit(size_t size) noexcept;
+
+    // return the physical memory beyond the first `size` bytes to the system,
+    // the address range stays reserved
+    void decommit(size_t size) noexcept;
+
+    void* begin() const noexcept;
+
+    // the end of the committed part
+    void* end() const noexcept;
+
+    // whether `p` is in the committed part
+    bool contained(void* p) const noexcept;
+
+    size_t get_committed_size() const noexcept;
+
+    size_t get_reserved_size() const noexcept;
+
+    // the granularity of commitment
+    size_t get_page_size() const noexcept;
+
+    PageType get_page_type() const noexcept;
+
+private:
+    void* m_begin = nullptr;
+    void* m_committed_end = nullptr;
+    void* m_reserved_end = nullptr;
+    size_t m_page_size = 0;
+    PageType m_page_type = PageType::regular;
+};
+
+// Every allocation maps its own pages from the system, so it's only meant for
+// allocations which are too large for any pool. Allocations larger than a
+// huge page ask for transparent huge pages.
+class PageAllocator {
+public:
+    using stateful = std::false_type;
+
+public:
+    PageAllocator() noexcept = default;
+    PageAllocator(PageAllocator&&) noexcept = default;
+    PageAllocator(PageAllocator const&) noexcept = default;
+    PageAllocator& operator=(PageAllocator&&) noexcept = default;
+    PageAllocator& operator=(PageAllocator const&) noexcept = default;
+
+    void* allocate(size_t size, size_t alignment) noexcept;
+
+    void deallocate(void* p, size_t size) noexcept;
+
+    // extend the mapping if the address range after it is free, shrinking
+    // always succeeds
+    bool try_expand(void* p, size_t old_size, size_t new_size) noexcept;
+};
+
+static_assert(detail::ExpandableAllocator<PageAllocator>, "");
+
+}  // namespace memory
+}  // namespace coust
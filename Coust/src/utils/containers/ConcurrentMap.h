@@ -0,0 +1,407 @@
+#pragma once
+
+#include "utils/containers/RobinMap.h"
+#include "utils/math/Hash.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+namespace coust {
+namespace container {
+
+namespace detail {
+
+// a shard owns a cache line of its own, so the lock word of one shard never
+// bounces along with the lock of its neighbour
+inline size_t constexpr SHARD_ALIGNMENT = 64;
+
+// the robin map indexes its buckets with the low bits of the hash, the shard
+// is picked with the higher bits of a mixed hash so the two stay independent
+template <size_t Shard_Count>
+size_t hash_to_shard(size_t hash) noexcept {
+    uint64_t const h = (uint64_t) hash * 0x9e3779b97f4a7c15ull;
+    return (size_t) (h >> 32) & (Shard_Count - 1);
+}
+
+}  // namespace detail
+
+// a hash map any number of threads can use at once. the keys are spread over
+// `Shard_Count` robin maps, each guarded by its own reader writer lock, so
+// threads only wait for each other when they touch the same shard.
+// a reference into a shard dies with the next rehash of another thread, so the
+// lookups hand out copies of the mapped values (the caches only keep handles)
+// or run a callback while the shard is locked
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+    typename Key_Equal = std::equal_to<Key>,
+    typename Alloc = std::allocator<std::pair<Key, T>>,
+    size_t Shard_Count = 16>
+    requires(std::has_single_bit(Shard_Count) && Shard_Count <= (1ull << 32))
+class concurrent_map {
+public:
+    using map_type = robin_map<Key, T, Hash, Key_Equal, Alloc>;
+
+    using key_type = typename map_type::key_type;
+    using mapped_type = typename map_type::mapped_type;
+    using value_type = typename map_type::value_type;
+    using size_type = typename map_type::size_type;
+    using hasher = typename map_type::hasher;
+    using key_equal = typename map_type::key_equal;
+    using allocator_type = typename map_type::allocator_type;
+
+    static size_t constexpr SHARD_COUNT = Shard_Count;
+
+private:
+    // the key types the underlying robin maps can look up with
+    template <typename K>
+    static bool constexpr accepts_key =
+        std::same_as<K, Key> || transparent_lookup<Hash, Key_Equal>;
+
+public:
+    concurrent_map(concurrent_map&&) = delete;
+    concurrent_map(concurrent_map const&) = delete;
+    concurrent_map& operator=(concurrent_map&&) = delete;
+    concurrent_map& operator=(concurrent_map const&) = delete;
+
+public:
+    concurrent_map() noexcept : concurrent_map(Hash{}, Key_Equal{}, Alloc{}) {}
+
+    explicit concurrent_map(Alloc const& alloc) noexcept
+        : concurrent_map(Hash{}, Key_Equal{}, alloc) {}
+
+    concurrent_map(Hash const& hash, Key_Equal const& equal,
+        Alloc const& alloc) noexcept
+        : m_shards(make_shards(
+              hash, equal, alloc, std::make_index_sequence<Shard_Count>{})),
+          m_hash(hash) {}
+
+public:
+    template <typename K>
+    std::optional<T> find(K const& key) const noexcept
+        requires(accepts_key<K>)
+    {
+        shard_type const& shard = get_shard(key);
+        std::shared_lock lock{shard.mutex};
+        auto const iter = shard.map.find(key);
+        if (iter == shard.map.end())
+            return std::nullopt;
+        return iter->second;
+    }
+
+    template <typename K>
+    bool contains(K const& key) const noexcept
+        requires(accepts_key<K>)
+    {
+        shard_type const& shard = get_shard(key);
+        std::shared_lock lock{shard.mutex};
+        return shard.map.contains(key);
+    }
+
+    // call `func` with the mapped value while its shard is locked for reading,
+    // return false if the key is absent
+    template <typename K, typename Func>
+    bool visit(K const& key, Func&& func) const noexcept
+        requires(accepts_key<K>)
+    {
+        shard_type const& shard = get_shard(key);
+        std::shared_lock lock{shard.mutex};
+        auto const iter = shard.map.find(key);
+        if (iter == shard.map.end())
+            return false;
+        std::forward<Func>(func)(iter->second);
+        return true;
+    }
+
+    // the mapped value of `key`, constructed from `args` if the key is absent.
+    // the second member is true if this call inserted it
+    template <typename K, typename... Args>
+    std::pair<T, bool> find_or_emplace(K&& key, Args&&... args) noexcept
+        requires(accepts_key<std::remove_cvref_t<K>>)
+    {
+        return find_or_emplace_with(std::forward<K>(key),
+            [&]() { return T(std::forward<Args>(args)...); });
+    }
+
+    // like `find_or_emplace`, but the value is only made by `make` when the key
+    // is absent. `make` runs with the shard locked for writing, so two threads
+    // missing the same key never make the value twice
+    template <typename K, typename Make>
+    std::pair<T, bool> find_or_emplace_with(K&& key, Make&& make) noexcept
+        requires(accepts_key<std::remove_cvref_t<K>>)
+    {
+        shard_type& shard = get_shard(key);
+        {
+            std::shared_lock lock{shard.mutex};
+            auto const iter = shard.map.find(key);
+            if (iter != shard.map.end())
+                return std::make_pair(iter->second, false);
+        }
+        std::unique_lock lock{shard.mutex};
+        // another thread may have inserted it between the two locks
+        if (auto const iter = shard.map.find(key); iter != shard.map.end())
+            return std::make_pair(iter->second, false);
+        T mapped = std::forward<Make>(make)();
+        shard.map.try_emplace(
+            make_key(shard.map.get_allocator(), std::forward<K>(key)), mapped);
+        return std::make_pair(std::move(mapped), true);
+    }
+
+    // return true if the key was inserted rather than assigned
+    template <typename M>
+    bool insert_or_assign(key_type const& key, M&& mapped) noexcept {
+        shard_type& shard = get_shard(key);
+        std::unique_lock lock{shard.mutex};
+        return shard.map.insert_or_assign(key, std::forward<M>(mapped)).second;
+    }
+
+    template <typename K>
+    size_type erase(K const& key) noexcept
+        requires(accepts_key<K>)
+    {
+        shard_type& shard = get_shard(key);
+        std::unique_lock lock{shard.mutex};
+        return shard.map.erase(key);
+    }
+
+    // erase every element `pred(key, mapped)` returns true for. return the
+    // count of the erased elements
+    template <typename Pred>
+    size_type erase_if(Pred&& pred) noexcept {
+        size_type erased_cnt = 0;
+        for (auto& shard : m_shards) {
+            std::unique_lock lock{shard.mutex};
+            for (auto iter = shard.map.begin(); iter != shard.map.end();) {
+                if (pred(iter->first, iter->second)) {
+                    iter = shard.map.erase(iter);
+                    ++erased_cnt;
+                } else {
+                    ++iter;
+                }
+            }
+        }
+        return erased_cnt;
+    }
+
+    // call `func(key, mapped)` for every element. the shards are locked one at
+    // a time, so it's not an atomic view of the whole map
+    template <typename Func>
+    void for_each(Func&& func) const noexcept {
+        for (auto const& shard : m_shards) {
+            std::shared_lock lock{shard.mutex};
+            for (auto const& [key, mapped] : shard.map) {
+                func(key, mapped);
+            }
+        }
+    }
+
+    void clear() noexcept {
+        for (auto& shard : m_shards) {
+            std::unique_lock lock{shard.mutex};
+            shard.map.clear();
+        }
+    }
+
+    // spread the reservation evenly over the shards
+    void reserve(size_type count) noexcept {
+        for (auto& shard : m_shards) {
+            std::unique_lock lock{shard.mutex};
+            shard.map.reserve((count + Shard_Count - 1) / Shard_Count);
+        }
+    }
+
+    // only exact when no other thread is modifying the map
+    size_type size() const noexcept {
+        size_type size = 0;
+        for (auto const& shard : m_shards) {
+            std::shared_lock lock{shard.mutex};
+            size += shard.map.size();
+        }
+        return size;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+private:
+    struct alignas(detail::SHARD_ALIGNMENT) shard_type {
+        shard_type(Hash const& hash, Key_Equal const& equal,
+            Alloc const& alloc) noexcept
+            : map(map_type::rh::INIT_BUCKET_COUNT_DEFAULT, hash, equal, alloc) {
+        }
+
+        mutable std::shared_mutex mutex{};
+        map_type map;
+    };
+
+    using shard_array = std::array<shard_type, Shard_Count>;
+
+    // the shards can't be moved, they are constructed in place
+    template <size_t... Indices>
+    static shard_array make_shards(Hash const& hash, Key_Equal const& equal,
+        Alloc const& alloc, std::index_sequence<Indices...>) noexcept {
+        return shard_array{
+            ((void) Indices, shard_type{hash, equal, alloc})...};
+    }
+
+    template <typename K>
+    shard_type& get_shard(K const& key) noexcept {
+        return m_shards[detail::hash_to_shard<Shard_Count>(m_hash(key))];
+    }
+
+    template <typename K>
+    shard_type const& get_shard(K const& key) const noexcept {
+        return m_shards[detail::hash_to_shard<Shard_Count>(m_hash(key))];
+    }
+
+    // a key looked up transparently is only turned into a real key on
+    // insertion, with the allocator of the map if the key takes one (e.g. a
+    // string with a custom allocator)
+    template <typename K>
+    static decltype(auto) make_key(
+        allocator_type const& alloc, K&& key) noexcept {
+        if constexpr (std::same_as<std::remove_cvref_t<K>, Key>)
+            return std::forward<K>(key);
+        else
+            return std::make_obj_using_allocator<Key>(
+                alloc, std::forward<K>(key));
+    }
+
+private:
+    shard_array m_shards;
+    Hash m_hash;
+};
+
+// the read-mostly counterpart of `concurrent_map` (read-copy-update). readers
+// look up an immutable snapshot of the map without taking any lock, a writer
+// copies the current snapshot, modifies the copy and publishes it in place of
+// the old one, which lives on until its last reader lets it go.
+// writing costs a copy of the whole map, it only pays off for the maps that
+// stop changing after the warm up
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+    typename Key_Equal = std::equal_to<Key>,
+    typename Alloc = std::allocator<std::pair<Key, T>>>
+class rcu_map {
+public:
+    using map_type = robin_map<Key, T, Hash, Key_Equal, Alloc>;
+
+    using key_type = typename map_type::key_type;
+    using mapped_type = typename map_type::mapped_type;
+    using value_type = typename map_type::value_type;
+    using size_type = typename map_type::size_type;
+    using hasher = typename map_type::hasher;
+    using key_equal = typename map_type::key_equal;
+    using allocator_type = typename map_type::allocator_type;
+
+    using snapshot_type = std::shared_ptr<map_type const>;
+
+public:
+    rcu_map(rcu_map&&) = delete;
+    rcu_map(rcu_map const&) = delete;
+    rcu_map& operator=(rcu_map&&) = delete;
+    rcu_map& operator=(rcu_map const&) = delete;
+
+public:
+    rcu_map() noexcept : rcu_map(Alloc{}) {}
+
+    explicit rcu_map(Alloc const& alloc) noexcept
+        : m_alloc(alloc),
+          m_snapshot(std::allocate_shared<map_type>(alloc, alloc)) {}
+
+public:
+    // every lookup on a snapshot sees the same map. loading a snapshot touches
+    // a reference count shared by all readers, a thread doing lots of lookups
+    // should take one snapshot & reuse it
+    snapshot_type snapshot() const noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return m_snapshot.load(std::memory_order_acquire);
+#else
+        std::lock_guard<std::mutex> lock{m_snapshot_mutex};
+        return m_snapshot;
+#endif
+    }
+
+    std::optional<T> find(key_type const& key) const noexcept {
+        snapshot_type const snapshot = this->snapshot();
+        auto const iter = snapshot->find(key);
+        if (iter == snapshot->end())
+            return std::nullopt;
+        return iter->second;
+    }
+
+    bool contains(key_type const& key) const noexcept {
+        return snapshot()->contains(key);
+    }
+
+    // see `concurrent_map::find_or_emplace_with`
+    template <typename Make>
+    std::pair<T, bool> find_or_emplace_with(
+        key_type const& key, Make&& make) noexcept {
+        if (auto found = find(key); found.has_value())
+            return std::make_pair(std::move(*found), false);
+        std::lock_guard<std::mutex> lock{m_writer_mutex};
+        // another writer may have published it before we got the lock
+        if (auto found = find(key); found.has_value())
+            return std::make_pair(std::move(*found), false);
+        T mapped = std::forward<Make>(make)();
+        update([&](map_type& map) { map.try_emplace(key, mapped); });
+        return std::make_pair(std::move(mapped), true);
+    }
+
+    template <typename... Args>
+    std::pair<T, bool> find_or_emplace(
+        key_type const& key, Args&&... args) noexcept {
+        return find_or_emplace_with(
+            key, [&]() { return T(std::forward<Args>(args)...); });
+    }
+
+    size_type erase(key_type const& key) noexcept {
+        std::lock_guard<std::mutex> lock{m_writer_mutex};
+        if (!snapshot()->contains(key))
+            return 0;
+        update([&](map_type& map) { map.erase(key); });
+        return 1;
+    }
+
+    void clear() noexcept {
+        std::lock_guard<std::mutex> lock{m_writer_mutex};
+        publish(std::allocate_shared<map_type>(m_alloc, m_alloc));
+    }
+
+    size_type size() const noexcept { return snapshot()->size(); }
+
+    bool empty() const noexcept { return snapshot()->empty(); }
+
+private:
+    // copy, modify & publish, the writer lock must be held
+    template <typename Func>
+    void update(Func&& func) noexcept {
+        auto copy = std::allocate_shared<map_type>(m_alloc, *snapshot());
+        std::forward<Func>(func)(*copy);
+        publish(std::move(copy));
+    }
+
+    void publish(snapshot_type snapshot) noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        m_snapshot.store(std::move(snapshot), std::memory_order_release);
+#else
+        std::lock_guard<std::mutex> lock{m_snapshot_mutex};
+        m_snapshot = std::move(snapshot);
+#endif
+    }
+
+private:
+    Alloc m_alloc;
+    // writers are serialized, readers never take it
+    std::mutex m_writer_mutex{};
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<snapshot_type> m_snapshot;
+#else
+    mutable std::mutex m_snapshot_mutex{};
+    snapshot_type m_snapshot;
+#endif
+};
+
+}  // namespace container
+}  // namespace coust
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+
+#include <memory>
+#include <algorithm>
+#include <initializer_list>
+
+namespace coust {
+namespace container {
+
+namespace detail {
+
+// the allocator can resize a block without moving it, see
+// `memory::StdAllocator::try_expand()`
+template <typename Alloc, typename T>
+concept expandable_allocator = requires(Alloc& a, T* p, std::size_t n) {
+    { a.try_expand(p, n, n) } noexcept -> std::same_as<bool>;
+};
+
+}  // namespace detail
+
+// A contiguous sequence like `std::vector`, except that it asks the allocator
+// to grow the current block in place before reallocating, so large buffers
+// (e.g. the ones grown over and over by serialization) aren't copied each time
+// they double. `std::vector` can't do this since `std::allocator_traits` has no
+// notion of resizing a block.
+template <typename T, typename Alloc = std::allocator<T>>
+class expandable_vector {
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+private:
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    static size_type constexpr MIN_CAPACITY = 4u;
+
+public:
+    expandable_vector() noexcept = default;
+
+    explicit expandable_vector(Alloc const& alloc) noexcept : m_alloc(alloc) {}
+
+    explicit expandable_vector(
+        size_type count, Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        resize(count);
+    }
+
+    expandable_vector(size_type count, T const& value,
+        Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        resize(count, value);
+    }
+
+    expandable_vector(
+        std::initializer_list<T> init, Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        reserve(init.size());
+        std::uninitialized_copy(init.begin(), init.end(), m_data);
+        m_size = init.size();
+    }
+
+    expandable_vector(expandable_vector const& other) noexcept
+        : m_alloc(alloc_traits::select_on_container_copy_construction(
+              other.m_alloc)) {
+        reserve(other.m_size);
+        std::uninitialized_copy(other.begin(), other.end(), m_data);
+        m_size = other.m_size;
+    }
+
+    expandable_vector(expandable_vector&& other) noexcept
+        : m_alloc(std::move(other.m_alloc)),
+          m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0u)),
+          m_capacity(std::exchange(other.m_capacity, 0u)) {}
+
+    expandable_vector& operator=(expandable_vector const& other) noexcept {
+        if (this == &other)
+            return *this;
+        clear();
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                          value) {
+            release();
+            m_alloc = other.m_alloc;
+        }
+        reserve(other.m_size);
+        std::uninitialized_copy(other.begin(), other.end(), m_data);
+        m_size = other.m_size;
+        return *this;
+    }
+
+    expandable_vector& operator=(expandable_vector&& other) noexcept {
+        std::swap(m_alloc, other.m_alloc);
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        return *this;
+    }
+
+    ~expandable_vector() noexcept {
+        clear();
+        release();
+    }
+
+public:
+    allocator_type get_allocator() const noexcept { return m_alloc; }
+
+    iterator begin() noexcept { return m_data; }
+
+    const_iterator begin() const noexcept { return m_data; }
+
+    iterator end() noexcept { return m_data + m_size; }
+
+    const_iterator end() const noexcept { return m_data + m_size; }
+
+    pointer data() noexcept { return m_data; }
+
+    const_pointer data() const noexcept { return m_data; }
+
+    bool empty() const noexcept { return m_size == 0; }
+
+    size_type size() const noexcept { return m_size; }
+
+    size_type capacity() const noexcept { return m_capacity; }
+
+    reference operator[](size_type idx) noexcept {
+        COUST_ASSERT(idx < m_size, "Index {} out of range {}", idx, m_size);
+        return m_data[idx];
+    }
+
+    const_reference operator[](size_type idx) const noexcept {
+        COUST_ASSERT(idx < m_size, "Index {} out of range {}", idx, m_size);
+        return m_data[idx];
+    }
+
+    reference front() noexcept { return operator[](0); }
+
+    const_reference front() const noexcept { return operator[](0); }
+
+    reference back() noexcept { return operator[](m_size - 1); }
+
+    const_reference back() const noexcept { return operator[](m_size - 1); }
+
+public:
+    void reserve(size_type new_capacity) noexcept {
+        if (new_capacity > m_capacity)
+            reallocate(new_capacity);
+    }
+
+    void resize(size_type count) noexcept {
+        reserve(count);
+        if (count > m_size)
+            std::uninitialized_value_construct(
+                m_data + m_size, m_data + count);
+        else
+            std::destroy(m_data + count, m_data + m_size);
+        m_size = count;
+    }
+
+    void resize(size_type count, T const& value) noexcept {
+        reserve(count);
+        if (count > m_size)
+            std::uninitialized_fill(m_data + m_size, m_data + count, value);
+        else
+            std::destroy(m_data + count, m_data + m_size);
+        m_size = count;
+    }
+
+    void push_back(T const& value) noexcept { emplace_back(value); }
+
+    void push_back(T&& value) noexcept { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) noexcept {
+        if (m_size == m_capacity) {
+            // the argument might live in the buffer, so it's constructed
+            // before the buffer is moved
+            T tmp{std::forward<Args>(args)...};
+            reallocate(get_grown_capacity(m_size + 1));
+            return *std::construct_at(m_data + m_size++, std::move(tmp));
+        }
+        return *std::construct_at(
+            m_data + m_size++, std::forward<Args>(args)...);
+    }
+
+    void pop_back() noexcept {
+        COUST_ASSERT(m_size > 0, "Pop from an empty expandable_vector");
+        std::destroy_at(m_data + --m_size);
+    }
+
+    void clear() noexcept {
+        std::destroy(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+private:
+    size_type get_grown_capacity(size_type required) const noexcept {
+        return std::max({required, m_capacity * 2, MIN_CAPACITY});
+    }
+
+    void reallocate(size_type new_capacity) noexcept {
+        if constexpr (detail::expandable_allocator<Alloc, T>) {
+            if (m_data &&
+                m_alloc.try_expand(m_data, m_capacity, new_capacity)) {
+                m_capacity = new_capacity;
+                return;
+            }
+        }
+        T* const new_data = alloc_traits::allocate(m_alloc, new_capacity);
+        std::uninitialized_move(m_data, m_data + m_size, new_data);
+        std::destroy(m_data, m_data + m_size);
+        release();
+        m_data = new_data;
+        m_capacity = new_capacity;
+    }
+
+    // the elements must have been destroyed
+    void release() noexcept {
+        if (m_data)
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+        m_data = nullptr;
+        m_capacity = 0;
+    }
+
+private:
+    Alloc m_alloc{};
+    T* m_data = nullptr;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+};
+
+}  // namespace container
+}  // namespace coust
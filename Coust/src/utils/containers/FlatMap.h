@@ -0,0 +1,300 @@
+#pragma once
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/math/Hash.h"
+#include "utils/containers/SmallVector.h"
+
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+
+namespace coust {
+namespace container {
+
+// A map kept as a sorted array, the first `N` elements live inside the map
+// itself & only a map growing past them touches the allocator.
+// It's meant for the maps of a handful of elements carried around by value
+// (e.g. the macros of a shader source): copying one is copying an array,
+// comparing two is comparing two arrays, and the sorted order makes both the
+// equality & the hash independent of the insertion order.
+// Like `std::flat_map`, inserting & erasing move the elements after the
+// position, and invalidate the iterators. The storage is a `small_vector`, the
+// map only keeps it sorted by the key.
+template <typename Key, typename T, size_t N, typename Compare = std::less<Key>,
+    typename Alloc = std::allocator<std::pair<Key, T>>>
+    requires(N > 0)
+class flat_map {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    // the key isn't const since the elements are moved around, don't modify it
+    // through an iterator
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+    using allocator_type = typename std::allocator_traits<
+        Alloc>::template rebind_alloc<value_type>;
+    using reference = value_type&;
+    using const_reference = value_type const&;
+    using pointer = value_type*;
+    using const_pointer = value_type const*;
+    using iterator = value_type*;
+    using const_iterator = value_type const*;
+
+    static size_type constexpr INLINE_CAPACITY = N;
+
+private:
+    using container_type = small_vector<value_type, N, allocator_type>;
+
+    // the lookups scan linearly up to this size, a few comparisons in order
+    // beat the unpredictable branches of a binary search
+    static size_type constexpr LINEAR_SEARCH_MAX = 8;
+
+    template <typename K>
+    static bool constexpr accepts_key =
+        std::same_as<K, Key> ||
+        requires { typename Compare::is_transparent; };
+
+public:
+    /* Constructors */
+    flat_map() noexcept = default;
+
+    explicit flat_map(Alloc const& alloc) noexcept : m_data(alloc) {}
+
+    flat_map(std::initializer_list<value_type> init,
+        Alloc const& alloc = Alloc{}) noexcept
+        : m_data(alloc) {
+        insert(init.begin(), init.end());
+    }
+
+    template <typename Iter>
+    flat_map(Iter first, Iter last, Alloc const& alloc = Alloc{}) noexcept
+        : m_data(alloc) {
+        insert(first, last);
+    }
+    /* Constructors */
+
+public:
+    /* operator = */
+    flat_map& operator=(std::initializer_list<value_type> list) noexcept {
+        clear();
+        insert(list.begin(), list.end());
+        return *this;
+    }
+    /* operator = */
+
+public:
+    allocator_type get_allocator() const noexcept {
+        return m_data.get_allocator();
+    }
+
+public:
+    /* iterators */
+    iterator begin() noexcept { return m_data.begin(); }
+
+    const_iterator begin() const noexcept { return m_data.begin(); }
+
+    const_iterator cbegin() const noexcept { return m_data.cbegin(); }
+
+    iterator end() noexcept { return m_data.end(); }
+
+    const_iterator end() const noexcept { return m_data.end(); }
+
+    const_iterator cend() const noexcept { return m_data.cend(); }
+    /* iterators */
+
+public:
+    /* capacity */
+    bool empty() const noexcept { return m_data.empty(); }
+
+    size_type size() const noexcept { return m_data.size(); }
+
+    size_type capacity() const noexcept { return m_data.capacity(); }
+
+    // whether the elements still live inside the map
+    bool is_inline() const noexcept { return m_data.is_inline(); }
+
+    void reserve(size_type new_capacity) noexcept {
+        m_data.reserve(new_capacity);
+    }
+    /* capacity */
+
+public:
+    /* modifier */
+    void clear() noexcept { m_data.clear(); }
+
+    std::pair<iterator, bool> insert(value_type const& value) noexcept {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) noexcept {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename Iter>
+    void insert(Iter first, Iter last) noexcept {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) noexcept
+        requires(accepts_key<std::remove_cvref_t<K>>)
+    {
+        size_type const idx = lower_bound_idx(key);
+        if (idx < size() && !less(key, m_data[idx].first))
+            return std::make_pair(begin() + idx, false);
+        iterator const iter = m_data.emplace(begin() + idx,
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(iter, true);
+    }
+
+    template <typename K, typename M>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& mapped) noexcept
+        requires(accepts_key<std::remove_cvref_t<K>>)
+    {
+        size_type const idx = lower_bound_idx(key);
+        if (idx < size() && !less(key, m_data[idx].first)) {
+            m_data[idx].second = std::forward<M>(mapped);
+            return std::make_pair(begin() + idx, false);
+        }
+        iterator const iter = m_data.emplace(begin() + idx,
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<M>(mapped)));
+        return std::make_pair(iter, true);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) noexcept {
+        // the key & the mapped value take the allocator if they use one, just
+        // as the elements are constructed
+        value_type value = std::make_obj_using_allocator<value_type>(
+            m_data.get_allocator(), std::forward<Args>(args)...);
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    iterator erase(const_iterator pos) noexcept { return m_data.erase(pos); }
+
+    template <typename K>
+    size_type erase(K const& key) noexcept
+        requires(accepts_key<K> && !std::convertible_to<K, const_iterator>)
+    {
+        const_iterator const iter = find(key);
+        if (iter == cend())
+            return 0;
+        erase(iter);
+        return 1;
+    }
+
+    void swap(flat_map& other) noexcept { m_data.swap(other.m_data); }
+    /* modifier */
+
+public:
+    /* lookup */
+    template <typename K>
+    T& at(K const& key) noexcept
+        requires(accepts_key<K>)
+    {
+        iterator const iter = find(key);
+        COUST_PANIC_IF(iter == end(), "Can't find key");
+        return iter->second;
+    }
+
+    template <typename K>
+    T const& at(K const& key) const noexcept
+        requires(accepts_key<K>)
+    {
+        const_iterator const iter = find(key);
+        COUST_PANIC_IF(iter == cend(), "Can't find key");
+        return iter->second;
+    }
+
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    template <typename K>
+    iterator find(K const& key) noexcept
+        requires(accepts_key<K>)
+    {
+        size_type const idx = lower_bound_idx(key);
+        if (idx < size() && !less(key, m_data[idx].first))
+            return begin() + idx;
+        return end();
+    }
+    WARNING_POP
+
+    template <typename K>
+    const_iterator find(K const& key) const noexcept
+        requires(accepts_key<K>)
+    {
+        return const_cast<flat_map*>(this)->find(key);
+    }
+
+    template <typename K>
+    bool contains(K const& key) const noexcept
+        requires(accepts_key<K>)
+    {
+        return find(key) != cend();
+    }
+    /* lookup */
+
+public:
+    // the elements are sorted, two maps holding the same elements compare
+    // equal whatever order they were inserted in
+    bool operator==(flat_map const& other) const noexcept {
+        return m_data == other.m_data;
+    }
+
+    bool operator!=(flat_map const& other) const noexcept {
+        return !operator==(other);
+    }
+
+private:
+    template <typename K1, typename K2>
+    bool less(K1 const& k1, K2 const& k2) const noexcept {
+        return m_compare(k1, k2);
+    }
+
+    template <typename K>
+    size_type lower_bound_idx(K const& key) const noexcept {
+        if (size() <= LINEAR_SEARCH_MAX) {
+            size_type idx = 0;
+            while (idx < size() && less(m_data[idx].first, key)) {
+                ++idx;
+            }
+            return idx;
+        }
+        auto const iter = std::lower_bound(begin(), end(), key,
+            [this](value_type const& value, K const& k) {
+                return less(value.first, k);
+            });
+        return size_type(iter - begin());
+    }
+
+private:
+    [[no_unique_address]] Compare m_compare{};
+    container_type m_data{};
+};
+
+}  // namespace container
+}  // namespace coust
+
+template <typename Key, typename T, size_t N, typename Compare, typename Alloc>
+struct std::hash<coust::container::flat_map<Key, T, N, Compare, Alloc>> {
+    // the elements are sorted, the hash doesn't depend on the insertion order
+    std::size_t operator()(coust::container::flat_map<Key, T, N, Compare,
+        Alloc> const& map) const noexcept {
+        std::size_t hash = map.size();
+        for (auto const& [key, mapped] : map) {
+            coust::hash_combine(hash, key);
+            coust::hash_combine(hash, mapped);
+        }
+        return hash;
+    }
+};
@@ -2,9 +2,12 @@
 
 #include "utils/Compiler.h"
 #include "utils/Assert.h"
+#include "utils/math/Hash.h"
 #include "utils/containers/GrowthPolicy.h"
 
+#include <array>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 // implementation reference: https://github.com/Tessil/robin-map
@@ -657,6 +660,22 @@ public:
         return find_impl(key, key_to_hash(key)) != cend();
     }
 
+    // look up every key of `keys`, the result of `keys[i]` goes to `iters[i]`.
+    // the keys are hashed & their home buckets prefetched a batch at a time
+    // before any of them is probed, so the cache misses of the lookups overlap
+    // instead of being paid one after another
+    template <typename K>
+    void find_batch(
+        std::span<K const> keys, std::span<iterator> iters) noexcept {
+        find_batch_impl(keys, iters);
+    }
+
+    template <typename K>
+    void find_batch(std::span<K const> keys,
+        std::span<const_iterator> iters) const noexcept {
+        find_batch_impl(keys, iters);
+    }
+
     /* Lookup*/
 public:
     /* Bucket Interface */
@@ -708,18 +727,19 @@ public:
     /* Observers */
 
 private:
-    size_t hash_to_index(hash_type hash) const noexcept {
-        size_t const bucket_idx =
-            Growth_Policy::hash_to_index((hash_type) hash);
+    size_t hash_to_index(size_t hash) const noexcept {
+        size_t const bucket_idx = Growth_Policy::hash_to_index(hash);
         return bucket_idx;
     }
 
-    size_t key_to_hash(key_type const& key) const noexcept {
+    template <typename K>
+    size_t key_to_hash(K const& key) const noexcept {
         size_t ret = Hash::operator()(key);
         return ret;
     }
 
-    bool compare_keys(key_type const& k1, key_type const& k2) const noexcept {
+    template <typename K>
+    bool compare_keys(key_type const& k1, K const& k2) const noexcept {
         return Key_Equal::operator()(k1, k2);
     }
 
@@ -771,7 +791,7 @@ private:
         robin_hash new_hash{new_bucket_count, (Hash&) (*this),
             (Key_Equal&) (*this), get_allocator(), m_min_load_factor,
             m_max_load_factor};
-        auto const move_value_to = [this](auto& rh, size_t home_idx,
+        auto const move_value_to = [](auto& rh, size_t home_idx,
                                        size_t bucket_idx,
                                        distance_type dist_from_home,
                                        hash_type hash, value_type&& value) {
@@ -786,15 +806,19 @@ private:
                         buckets_data[bucket_idx].swap(
                             dist_from_home, hash, value);
                 }
+                // probe with the growth policy of the new hash table
                 std::tie(bucket_idx, dist_from_home) =
-                    next(bucket_idx, dist_from_home, home_idx);
+                    rh.next(bucket_idx, dist_from_home, home_idx);
             }
         };
         for (auto& bucket : m_buckets_container) {
             if (bucket.empty())
                 continue;
             hash_type const hash = bucket.get_hash();
-            size_t const bucket_idx = new_hash.hash_to_index(hash);
+            // the truncated hash can't address more than 2^16 buckets, so the
+            // home bucket is always derived from the full hash
+            size_t const bucket_idx =
+                new_hash.hash_to_index(key_to_hash(bucket.get_key()));
             move_value_to(new_hash, bucket_idx, bucket_idx,
                 bucket_entry::IDEAL_DIST_FROM_HOME, hash,
                 std::move(bucket.get_value()));
@@ -861,7 +885,7 @@ private:
 
         size_t const origin_hash = key_to_hash(key);
         hash_type const truncated_hash = truncate(origin_hash);
-        size_t home_idx = hash_to_index(truncated_hash);
+        size_t home_idx = hash_to_index(origin_hash);
         size_t bucket_idx = home_idx;
         distance_type dist_from_home = bucket_entry::IDEAL_DIST_FROM_HOME;
         // find bucket who's richer than us and get ready to "rob" it
@@ -878,7 +902,7 @@ private:
         // keep growing / shrinking if needed
         while (grow_if_needed(dist_from_home) || shrink_if_needed()) {
             // if the container changed, find another bucket to rob
-            bucket_idx = home_idx = hash_to_index(truncated_hash);
+            bucket_idx = home_idx = hash_to_index(origin_hash);
             dist_from_home = bucket_entry::IDEAL_DIST_FROM_HOME;
             while (
                 m_buckets[bucket_idx].poorer_than_or_same_as(dist_from_home)) {
@@ -963,6 +987,30 @@ private:
         return iterator(m_buckets + return_bucket);
     }
 
+    template <typename K, typename Iter>
+    void find_batch_impl(
+        std::span<K const> keys, std::span<Iter> iters) const noexcept {
+        COUST_ASSERT(keys.size() <= iters.size(),
+            "Not enough room for the results of {} keys", keys.size());
+        std::array<size_t, FIND_BATCH_SIZE> hashes;
+        for (size_t begin = 0; begin < keys.size(); begin += FIND_BATCH_SIZE) {
+            size_t const count =
+                std::min(FIND_BATCH_SIZE, keys.size() - begin);
+            for (size_t i = 0; i < count; ++i) {
+                hashes[i] = key_to_hash(keys[begin + i]);
+                PREFETCH(m_buckets + hash_to_index(hashes[i]));
+            }
+            for (size_t i = 0; i < count; ++i) {
+                const_iterator const iter =
+                    find_impl(keys[begin + i], hashes[i]);
+                if constexpr (std::is_same_v<Iter, iterator>)
+                    iters[begin + i] = mutable_cast(iter);
+                else
+                    iters[begin + i] = iter;
+            }
+        }
+    }
+
     template <typename K>
     iterator find_impl(K const& key, size_t hash) noexcept {
         return mutable_cast(((const robin_hash*) (this))->find_impl(key, hash));
@@ -971,7 +1019,7 @@ private:
     template <typename K>
     const_iterator find_impl(K const& key, size_t hash) const noexcept {
         hash_type truncated_hash = truncate(hash);
-        size_t const home_idx = hash_to_index(truncated_hash);
+        size_t const home_idx = hash_to_index(hash);
         size_t bucket_idx = home_idx;
         distance_type dist_from_home = bucket_entry::IDEAL_DIST_FROM_HOME;
         while (m_buckets[bucket_idx].poorer_than_or_same_as(dist_from_home)) {
@@ -988,6 +1036,10 @@ private:
 public:
     static size_type constexpr INIT_BUCKET_COUNT_DEFAULT = 0;
 
+    // enough lookups in flight to cover the memory latency, while the hashes
+    // stay on the stack
+    static size_t constexpr FIND_BATCH_SIZE = 16;
+
     static float constexpr MIN_LOAD_FACTOR_DEFAULT = 0.0f;
     static float constexpr MIN_LOAD_FACTOR_MINIMUM = 0.0f;
     static float constexpr MIN_LOAD_FACTOR_MAXIMUM = 0.15f;
@@ -205,6 +205,14 @@ public:
 
     size_type erase(key_type const& key) noexcept { return m_rh.erase(key); }
 
+    template <typename K>
+    size_type erase(K const& key) noexcept
+        requires(transparent_lookup<Hash, Key_Equal> &&
+                 !std::convertible_to<K const&, const_iterator>)
+    {
+        return m_rh.erase(key);
+    }
+
     void swap(robin_set& other) { other.m_rh.swap(m_rh); }
     /* modifier */
 
@@ -217,6 +225,55 @@ public:
     }
 
     bool contains(Key const& key) const noexcept { return m_rh.contains(key); }
+
+    // see `robin_hash::find_batch`
+    void find_batch(std::span<key_type const> keys,
+        std::span<iterator> iters) noexcept {
+        m_rh.find_batch(keys, iters);
+    }
+
+    void find_batch(std::span<key_type const> keys,
+        std::span<const_iterator> iters) const noexcept {
+        m_rh.find_batch(keys, iters);
+    }
+
+    // the overloads below take any key type the transparent hasher & key
+    // equal accept, see `transparent_lookup`
+    template <typename K>
+    iterator find(K const& key) noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_rh.find(key);
+    }
+
+    template <typename K>
+    const_iterator find(K const& key) const noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_rh.find(key);
+    }
+
+    template <typename K>
+    bool contains(K const& key) const noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_rh.contains(key);
+    }
+
+    template <typename K>
+    void find_batch(std::span<K const> keys, std::span<iterator> iters) noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        m_rh.find_batch(keys, iters);
+    }
+
+    template <typename K>
+    void find_batch(std::span<K const> keys,
+        std::span<const_iterator> iters) const noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        m_rh.find_batch(keys, iters);
+    }
     /* lookup */
 
 public:
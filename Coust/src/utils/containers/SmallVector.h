@@ -0,0 +1,416 @@
+#pragma once
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+namespace coust {
+namespace container {
+
+// The type can be moved to another address with a `memcpy`, leaving nothing to
+// destroy behind. Trivially copyable types are, specialize it for the others
+// which hold no pointer into themselves (e.g. a handle with a destructor).
+template <typename T>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline bool constexpr is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+// A contiguous sequence like `std::vector`, except that the first `N` elements
+// live inside the vector itself & only a vector growing past them touches the
+// allocator.
+// It's meant for the short lists built & copied over and over (e.g. the bound
+// resources of a descriptor set): filling one up to `N` elements never
+// allocates. Moving an inline vector moves its elements one by one, so do keep
+// `N` small. Elements which are trivially relocatable are moved around with
+// `memcpy` when the vector grows, inserts or erases.
+template <typename T, size_t N, typename Alloc = std::allocator<T>>
+    requires(N > 0)
+class small_vector {
+public:
+    using value_type = T;
+    using allocator_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using iterator = T*;
+    using const_iterator = T const*;
+
+    static size_type constexpr INLINE_CAPACITY = N;
+
+private:
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    static bool constexpr RELOCATABLE = is_trivially_relocatable_v<T>;
+
+public:
+    /* Constructors */
+    small_vector() noexcept = default;
+
+    explicit small_vector(Alloc const& alloc) noexcept : m_alloc(alloc) {}
+
+    explicit small_vector(
+        size_type count, Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        resize(count);
+    }
+
+    small_vector(size_type count, T const& value,
+        Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        resize(count, value);
+    }
+
+    small_vector(
+        std::initializer_list<T> init, Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        append(init.begin(), init.end());
+    }
+
+    template <std::input_iterator Iter>
+    small_vector(Iter first, Iter last, Alloc const& alloc = Alloc{}) noexcept
+        : m_alloc(alloc) {
+        append(first, last);
+    }
+
+    small_vector(small_vector const& other) noexcept
+        : m_alloc(alloc_traits::select_on_container_copy_construction(
+              other.m_alloc)) {
+        append(other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept
+        : m_alloc(std::move(other.m_alloc)) {
+        steal_from(other);
+    }
+
+    ~small_vector() noexcept {
+        clear();
+        release();
+    }
+    /* Constructors */
+
+public:
+    /* operator = */
+    small_vector& operator=(small_vector const& other) noexcept {
+        if (this == &other)
+            return *this;
+        clear();
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+                          value) {
+            release();
+            m_alloc = other.m_alloc;
+        }
+        append(other.begin(), other.end());
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept {
+        if (this == &other)
+            return *this;
+        clear();
+        release();
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                          value)
+            m_alloc = std::move(other.m_alloc);
+        steal_from(other);
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> list) noexcept {
+        clear();
+        append(list.begin(), list.end());
+        return *this;
+    }
+    /* operator = */
+
+public:
+    allocator_type get_allocator() const noexcept { return m_alloc; }
+
+public:
+    /* iterators */
+    iterator begin() noexcept { return m_data; }
+
+    const_iterator begin() const noexcept { return m_data; }
+
+    const_iterator cbegin() const noexcept { return m_data; }
+
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    iterator end() noexcept { return m_data + m_size; }
+
+    const_iterator end() const noexcept { return m_data + m_size; }
+
+    const_iterator cend() const noexcept { return m_data + m_size; }
+    WARNING_POP
+
+    pointer data() noexcept { return m_data; }
+
+    const_pointer data() const noexcept { return m_data; }
+    /* iterators */
+
+public:
+    /* capacity */
+    bool empty() const noexcept { return m_size == 0; }
+
+    size_type size() const noexcept { return m_size; }
+
+    size_type capacity() const noexcept { return m_capacity; }
+
+    // whether the elements still live inside the vector
+    bool is_inline() const noexcept { return m_data == inline_data(); }
+
+    void reserve(size_type new_capacity) noexcept {
+        if (new_capacity <= m_capacity)
+            return;
+        pointer const new_data = alloc_traits::allocate(m_alloc, new_capacity);
+        relocate(m_data, m_size, new_data);
+        release();
+        m_data = new_data;
+        m_capacity = new_capacity;
+    }
+    /* capacity */
+
+public:
+    /* element access */
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    reference operator[](size_type idx) noexcept {
+        COUST_ASSERT(idx < m_size, "Index {} out of range {}", idx, m_size);
+        return m_data[idx];
+    }
+
+    const_reference operator[](size_type idx) const noexcept {
+        COUST_ASSERT(idx < m_size, "Index {} out of range {}", idx, m_size);
+        return m_data[idx];
+    }
+    WARNING_POP
+
+    reference front() noexcept { return operator[](0); }
+
+    const_reference front() const noexcept { return operator[](0); }
+
+    reference back() noexcept { return operator[](m_size - 1); }
+
+    const_reference back() const noexcept { return operator[](m_size - 1); }
+    /* element access */
+
+public:
+    /* modifier */
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    void clear() noexcept {
+        destroy(m_data, m_size);
+        m_size = 0;
+    }
+
+    void resize(size_type count) noexcept {
+        reserve(count);
+        for (; m_size < count; ++m_size) {
+            alloc_traits::construct(m_alloc, m_data + m_size);
+        }
+        truncate(count);
+    }
+
+    void resize(size_type count, T const& value) noexcept {
+        if (m_size < count) {
+            // the value might live in the buffer
+            T tmp = std::make_obj_using_allocator<T>(m_alloc, value);
+            reserve(count);
+            for (; m_size < count; ++m_size) {
+                alloc_traits::construct(m_alloc, m_data + m_size, tmp);
+            }
+        }
+        truncate(count);
+    }
+
+    void push_back(T const& value) noexcept { emplace_back(value); }
+
+    void push_back(T&& value) noexcept { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) noexcept {
+        if (m_size == m_capacity) {
+            // the arguments might refer to an element, so the new one is built
+            // before the buffer is moved
+            T tmp = std::make_obj_using_allocator<T>(
+                m_alloc, std::forward<Args>(args)...);
+            reserve(m_capacity * 2);
+            alloc_traits::construct(m_alloc, m_data + m_size, std::move(tmp));
+        } else {
+            alloc_traits::construct(
+                m_alloc, m_data + m_size, std::forward<Args>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
+    void pop_back() noexcept {
+        COUST_ASSERT(m_size > 0, "Pop from an empty small_vector");
+        alloc_traits::destroy(m_alloc, m_data + --m_size);
+    }
+
+    iterator insert(const_iterator pos, T const& value) noexcept {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value) noexcept {
+        return emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) noexcept {
+        size_type const idx = size_type(pos - cbegin());
+        COUST_ASSERT(idx <= m_size, "Inserting past the end of a small_vector");
+        T tmp = std::make_obj_using_allocator<T>(
+            m_alloc, std::forward<Args>(args)...);
+        if (m_size == m_capacity)
+            reserve(m_capacity * 2);
+        if constexpr (RELOCATABLE) {
+            // the slot at `idx` holds nothing alive after the shift
+            std::memmove(static_cast<void*>(m_data + idx + 1), m_data + idx,
+                (m_size - idx) * sizeof(T));
+            alloc_traits::construct(m_alloc, m_data + idx, std::move(tmp));
+        } else if (idx == m_size) {
+            alloc_traits::construct(m_alloc, m_data + idx, std::move(tmp));
+        } else {
+            alloc_traits::construct(
+                m_alloc, m_data + m_size, std::move(m_data[m_size - 1]));
+            std::move_backward(
+                m_data + idx, m_data + m_size - 1, m_data + m_size);
+            m_data[idx] = std::move(tmp);
+        }
+        ++m_size;
+        return m_data + idx;
+    }
+
+    iterator erase(const_iterator pos) noexcept {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        size_type const idx = size_type(first - cbegin());
+        size_type const count = size_type(last - first);
+        COUST_ASSERT(idx + count <= m_size,
+            "Erasing past the end of a small_vector");
+        if constexpr (RELOCATABLE) {
+            destroy(m_data + idx, count);
+            std::memmove(static_cast<void*>(m_data + idx),
+                m_data + idx + count, (m_size - idx - count) * sizeof(T));
+            m_size -= count;
+        } else {
+            std::move(m_data + idx + count, m_data + m_size, m_data + idx);
+            truncate(m_size - count);
+        }
+        return m_data + idx;
+    }
+
+    void swap(small_vector& other) noexcept {
+        small_vector tmp{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+    WARNING_POP
+    /* modifier */
+
+public:
+    bool operator==(small_vector const& other) const noexcept {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    bool operator!=(small_vector const& other) const noexcept {
+        return !operator==(other);
+    }
+
+private:
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    pointer inline_data() noexcept {
+        return std::launder(reinterpret_cast<pointer>(m_inline));
+    }
+
+    const_pointer inline_data() const noexcept {
+        return std::launder(reinterpret_cast<const_pointer>(m_inline));
+    }
+
+    template <typename Iter>
+    void append(Iter first, Iter last) noexcept {
+        if constexpr (std::forward_iterator<Iter>)
+            reserve(m_size + size_type(std::distance(first, last)));
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    void destroy(pointer first, size_type count) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type i = 0; i < count; ++i) {
+                alloc_traits::destroy(m_alloc, first + i);
+            }
+        }
+    }
+
+    // destroy the elements from `count` on
+    void truncate(size_type count) noexcept {
+        if (count < m_size) {
+            destroy(m_data + count, m_size - count);
+            m_size = count;
+        }
+    }
+
+    // move `count` elements from `src` to the uninitialized `dst` & destroy
+    // the sources
+    void relocate(pointer src, size_type count, pointer dst) noexcept {
+        if constexpr (RELOCATABLE) {
+            if (count > 0)
+                std::memcpy(static_cast<void*>(dst), src, count * sizeof(T));
+        } else {
+            for (size_type i = 0; i < count; ++i) {
+                alloc_traits::construct(m_alloc, dst + i, std::move(src[i]));
+                alloc_traits::destroy(m_alloc, src + i);
+            }
+        }
+    }
+    WARNING_POP
+
+    // give the heap block back, the elements must be destroyed already
+    void release() noexcept {
+        if (!is_inline())
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+        m_data = inline_data();
+        m_capacity = N;
+    }
+
+    // take the heap block of `other` or move its inline elements, `other` ends
+    // up empty & inline
+    void steal_from(small_vector& other) noexcept {
+        if (other.is_inline()) {
+            relocate(other.m_data, other.m_size, m_data);
+            m_size = std::exchange(other.m_size, 0u);
+        } else {
+            m_data = std::exchange(other.m_data, other.inline_data());
+            m_size = std::exchange(other.m_size, 0u);
+            m_capacity = std::exchange(other.m_capacity, N);
+        }
+    }
+
+private:
+    [[no_unique_address]] allocator_type m_alloc{};
+    pointer m_data = inline_data();
+    size_type m_size = 0;
+    size_type m_capacity = N;
+    alignas(T) std::byte m_inline[N * sizeof(T)];
+};
+
+}  // namespace container
+}  // namespace coust
@@ -0,0 +1,1007 @@
+#pragma once
+
+#include "utils/Compiler.h"
+#include "utils/Assert.h"
+#include "utils/math/Hash.h"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define COUST_SWISS_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    #define COUST_SWISS_NEON
+    #include <arm_neon.h>
+#endif
+
+// implementation reference: https://abseil.io/about/design/swisstables
+
+namespace coust {
+namespace container {
+namespace detail {
+
+// every slot has a control byte in a separate array:
+//   empty:    0b10000000
+//   deleted:  0b11111110
+//   sentinel: 0b11111111 (the end of the table, only read by iterators)
+//   full:     0b0hhhhhhh, the lowest 7 bits of the hash
+// so a whole group of slots is filtered with a few instructions before any
+// value is touched
+using ctrl_type = int8_t;
+
+ctrl_type constexpr CTRL_EMPTY = -128;
+ctrl_type constexpr CTRL_DELETED = -2;
+ctrl_type constexpr CTRL_SENTINEL = -1;
+
+inline bool is_full(ctrl_type ctrl) noexcept {
+    return ctrl >= 0;
+}
+
+size_t constexpr SWISS_GROUP_WIDTH = 16;
+
+// the matched control bytes of a group, one bit per byte
+class swiss_bitmask {
+public:
+    explicit swiss_bitmask(uint32_t mask) noexcept : m_mask(mask) {}
+
+    explicit operator bool() const noexcept { return m_mask != 0; }
+
+    size_t lowest() const noexcept { return (size_t) std::countr_zero(m_mask); }
+
+    void clear_lowest() noexcept { m_mask &= m_mask - 1; }
+
+    size_t trailing_zeros() const noexcept {
+        return (size_t) std::countr_zero(m_mask);
+    }
+
+    size_t leading_zeros() const noexcept {
+        return (size_t) std::countl_zero(m_mask) - (32 - SWISS_GROUP_WIDTH);
+    }
+
+private:
+    uint32_t m_mask;
+};
+
+class swiss_group {
+public:
+    explicit swiss_group(ctrl_type const* ctrl) noexcept {
+#if defined(COUST_SWISS_SSE2)
+        m_ctrl = _mm_loadu_si128((__m128i const*) ctrl);
+#elif defined(COUST_SWISS_NEON)
+        m_ctrl = vld1q_s8(ctrl);
+#else
+        std::memcpy(m_ctrl.data(), ctrl, SWISS_GROUP_WIDTH);
+#endif
+    }
+
+    swiss_bitmask match(ctrl_type h2) const noexcept {
+#if defined(COUST_SWISS_SSE2)
+        return swiss_bitmask{(uint32_t) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl))};
+#elif defined(COUST_SWISS_NEON)
+        return to_bitmask(vceqq_s8(vdupq_n_s8(h2), m_ctrl));
+#else
+        return to_bitmask([h2](ctrl_type c) { return c == h2; });
+#endif
+    }
+
+    swiss_bitmask match_empty() const noexcept { return match(CTRL_EMPTY); }
+
+    swiss_bitmask match_empty_or_deleted() const noexcept {
+#if defined(COUST_SWISS_SSE2)
+        return swiss_bitmask{(uint32_t) _mm_movemask_epi8(
+            _mm_cmpgt_epi8(_mm_set1_epi8(CTRL_SENTINEL), m_ctrl))};
+#elif defined(COUST_SWISS_NEON)
+        return to_bitmask(vcltq_s8(m_ctrl, vdupq_n_s8(CTRL_SENTINEL)));
+#else
+        return to_bitmask([](ctrl_type c) { return c < CTRL_SENTINEL; });
+#endif
+    }
+
+private:
+#if defined(COUST_SWISS_SSE2)
+    __m128i m_ctrl;
+#elif defined(COUST_SWISS_NEON)
+    int8x16_t m_ctrl;
+
+    // there's no movemask in neon, weight the lanes and sum each half instead
+    static swiss_bitmask to_bitmask(uint8x16_t cmp) noexcept {
+        std::array<uint8_t, SWISS_GROUP_WIDTH> constexpr weights{1, 2, 4, 8,
+            16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t const masked = vandq_u8(cmp, vld1q_u8(weights.data()));
+        return swiss_bitmask{(uint32_t) vaddv_u8(vget_low_u8(masked)) |
+                             ((uint32_t) vaddv_u8(vget_high_u8(masked)) << 8)};
+    }
+#else
+    std::array<ctrl_type, SWISS_GROUP_WIDTH> m_ctrl;
+
+    template <typename Pred>
+    swiss_bitmask to_bitmask(Pred pred) const noexcept {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < SWISS_GROUP_WIDTH; ++i) {
+            mask |= (uint32_t) pred(m_ctrl[i]) << i;
+        }
+        return swiss_bitmask{mask};
+    }
+#endif
+};
+
+// triangular probing over groups, which visits every group once when the
+// capacity is 2^n - 1
+class swiss_probe {
+public:
+    swiss_probe(size_t hash, size_t mask) noexcept
+        : m_mask(mask), m_offset(hash & mask) {}
+
+    size_t offset() const noexcept { return m_offset; }
+
+    size_t offset(size_t i) const noexcept { return (m_offset + i) & m_mask; }
+
+    size_t index() const noexcept { return m_index; }
+
+    void next() noexcept {
+        m_index += SWISS_GROUP_WIDTH;
+        m_offset = (m_offset + m_index) & m_mask;
+    }
+
+private:
+    size_t m_mask;
+    size_t m_offset;
+    size_t m_index = 0;
+};
+
+// `std::hash` of integers is the identity in most implementations, while the
+// control bytes take the lowest bits and the probing start takes the rest, so
+// the bits are mixed first
+inline size_t mix_hash(size_t hash) noexcept {
+    uint64_t const h = (uint64_t) hash * 0x9e3779b97f4a7c15ull;
+    return (size_t) (h ^ (h >> 32));
+}
+
+template <typename V>
+union swiss_slot {
+    swiss_slot() noexcept {}
+
+    ~swiss_slot() {}
+
+    V value;
+};
+
+template <typename Key, typename Mapped, typename Hash, typename Key_Equal,
+    typename Alloc>
+class swiss_hash : private Hash, private Key_Equal {
+public:
+    template <bool Constant>
+    class swiss_iterator;
+
+    static bool constexpr HAS_MAPPED = !std::is_same_v<Mapped, void>;
+
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::conditional_t<HAS_MAPPED,
+        std::pair<key_type, mapped_type>, key_type>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Key_Equal;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = value_type const&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = swiss_iterator<false>;
+    using const_iterator = swiss_iterator<true>;
+
+private:
+    using slot_type = swiss_slot<value_type>;
+    using ctrl_allocator = typename std::allocator_traits<
+        allocator_type>::template rebind_alloc<ctrl_type>;
+    using slot_allocator = typename std::allocator_traits<
+        allocator_type>::template rebind_alloc<slot_type>;
+    using ctrl_container_type = std::vector<ctrl_type, ctrl_allocator>;
+    using slot_container_type = std::vector<slot_type, slot_allocator>;
+
+public:
+    template <bool Constant>
+    class swiss_iterator {
+    private:
+        friend class swiss_hash;
+        using slot_ptr =
+            typename std::conditional_t<Constant, const slot_type*, slot_type*>;
+
+        swiss_iterator(ctrl_type const* ctrl, slot_ptr slot) noexcept
+            : m_ctrl(ctrl), m_slot(slot) {}
+
+    public:
+        // it's a one direction iterator
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename swiss_hash::value_type const;
+        using difference_type = ptrdiff_t;
+        using reference = value_type&;
+        using pointer = value_type*;
+
+    public:
+        swiss_iterator() noexcept {}
+
+        // construct from iterator (other) to const_iterator (this)
+        swiss_iterator(swiss_iterator<false> const& other) noexcept
+            requires(Constant)
+            : m_ctrl(other.m_ctrl), m_slot(other.m_slot) {}
+
+        swiss_iterator(swiss_iterator<false>&& other) noexcept
+            requires(Constant)
+            : m_ctrl(other.m_ctrl), m_slot(other.m_slot) {}
+
+        swiss_iterator(swiss_iterator&& other) noexcept = default;
+        swiss_iterator(swiss_iterator const& other) noexcept = default;
+        swiss_iterator& operator=(swiss_iterator&& other) noexcept = default;
+        swiss_iterator& operator=(
+            swiss_iterator const& other) noexcept = default;
+
+        // user isn't allowed to modify key
+        typename swiss_hash::key_type const& key() const noexcept {
+            return extract_key(m_slot->value);
+        }
+
+        auto const& mapped() const noexcept { return m_slot->value.second; }
+
+        auto& mapped() const noexcept
+            requires(!Constant)
+        {
+            return m_slot->value.second;
+        }
+
+        const_reference operator*() const noexcept { return m_slot->value; }
+
+        const_pointer operator->() const noexcept {
+            return std::addressof(m_slot->value);
+        }
+
+        reference operator*() noexcept { return m_slot->value; }
+
+        pointer operator->() noexcept { return std::addressof(m_slot->value); }
+
+        swiss_iterator& operator++() {
+            advance();
+            skip_empty_or_deleted();
+            return *this;
+        }
+
+        swiss_iterator operator++(int) {
+            swiss_iterator tmp{*this};
+            ++(*this);
+            return tmp;
+        }
+
+        friend bool operator==(
+            swiss_iterator const& lhs, swiss_iterator const& rhs) {
+            return lhs.m_ctrl == rhs.m_ctrl;
+        }
+
+        friend bool operator!=(
+            swiss_iterator const& lhs, swiss_iterator const& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        WARNING_PUSH
+        CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+        void advance() noexcept {
+            ++m_ctrl;
+            ++m_slot;
+        }
+
+        // proceed until reach the sentinel or a full slot
+        void skip_empty_or_deleted() noexcept {
+            while (*m_ctrl < CTRL_SENTINEL) {
+                advance();
+            }
+        }
+        WARNING_POP
+
+    private:
+        ctrl_type const* m_ctrl = nullptr;
+        slot_ptr m_slot = nullptr;
+    };
+
+    // API reference:
+    // https://en.cppreference.com/w/cpp/container/unordered_map
+public:
+    swiss_hash(size_type bucket_count, hasher const& hash,
+        key_equal const& equal, allocator_type const& allocator,
+        float min_load_factor = MIN_LOAD_FACTOR_DEFAULT,
+        float max_load_factor = MAX_LOAD_FACTOR_DEFAULT)
+        : Hash(hash),
+          Key_Equal(equal),
+          m_ctrl_container(allocator),
+          m_slots_container(allocator) {
+        COUST_ASSERT(bucket_count < max_bucket_count(),
+            "the size of this swiss map exceeds its limit");
+        this->min_load_factor(min_load_factor);
+        m_max_load_factor = std::clamp(
+            max_load_factor, MAX_LOAD_FACTOR_MINIMUM, MAX_LOAD_FACTOR_MAXIMUM);
+        initialize(normalize_capacity(bucket_count));
+    }
+
+    swiss_hash(swiss_hash const& other) noexcept
+        : Hash(other),
+          Key_Equal(other),
+          m_ctrl_container(other.m_ctrl_container),
+          m_slots_container(other.m_slots_container.size(),
+              other.m_slots_container.get_allocator()),
+          m_ctrl(m_ctrl_container.empty() ? empty_group() :
+                                            m_ctrl_container.data()),
+          m_slots(m_slots_container.data()),
+          m_capacity(other.m_capacity),
+          m_size(other.m_size),
+          m_growth_left(other.m_growth_left),
+          m_min_load_factor(other.m_min_load_factor),
+          m_max_load_factor(other.m_max_load_factor),
+          m_try_shrink_on_next_insert(other.m_try_shrink_on_next_insert) {
+        // same layout, so the control bytes are simply copied
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (is_full(ctrl_at(i)))
+                std::construct_at(std::addressof(slot_at(i).value),
+                    other.slot_at(i).value);
+        }
+    }
+
+    swiss_hash(swiss_hash&& other) noexcept
+        : Hash(std::forward<Hash>(other)),
+          Key_Equal(std::forward<Key_Equal>(other)),
+          m_ctrl_container(std::move(other.m_ctrl_container)),
+          m_slots_container(std::move(other.m_slots_container)),
+          m_ctrl(m_ctrl_container.empty() ? empty_group() :
+                                            m_ctrl_container.data()),
+          m_slots(m_slots_container.data()),
+          m_capacity(other.m_capacity),
+          m_size(other.m_size),
+          m_growth_left(other.m_growth_left),
+          m_min_load_factor(other.m_min_load_factor),
+          m_max_load_factor(other.m_max_load_factor),
+          m_try_shrink_on_next_insert(other.m_try_shrink_on_next_insert) {
+        // the values now belong to this table
+        other.reset_to_empty();
+        other.clear_and_shrink();
+    }
+
+    ~swiss_hash() { destroy_values(); }
+
+    swiss_hash& operator=(swiss_hash const& other) {
+        if (&other != this) {
+            swiss_hash copied{other};
+            copied.swap(*this);
+        }
+        return *this;
+    }
+
+    swiss_hash& operator=(swiss_hash&& other) {
+        other.swap(*this);
+        other.clear_and_shrink();
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return m_slots_container.get_allocator();
+    }
+
+public:
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    /* Iterators */
+    iterator begin() noexcept {
+        iterator ret{m_ctrl, m_slots};
+        ret.skip_empty_or_deleted();
+        return ret;
+    }
+
+    const_iterator begin() const noexcept { return cbegin(); }
+
+    const_iterator cbegin() const noexcept {
+        const_iterator ret{m_ctrl, m_slots};
+        ret.skip_empty_or_deleted();
+        return ret;
+    }
+
+    iterator end() noexcept {
+        return iterator{m_ctrl + m_capacity, m_slots + m_capacity};
+    }
+
+    const_iterator end() const noexcept { return cend(); }
+
+    const_iterator cend() const noexcept {
+        return const_iterator{m_ctrl + m_capacity, m_slots + m_capacity};
+    }
+    /* Iterators */
+    WARNING_POP
+
+public:
+    /* Capacity */
+    bool empty() const noexcept { return m_size == 0; }
+
+    size_type size() const noexcept { return m_size; }
+
+    size_type max_size() const noexcept {
+        return m_slots_container.max_size();
+    }
+    /* Capacity */
+public:
+    /* Modifiers*/
+    void clear() noexcept {
+        if (m_min_load_factor > 0.0f) {
+            clear_and_shrink();
+        } else {
+            destroy_values();
+            reset_ctrl();
+            m_size = 0;
+            m_growth_left = capacity_to_growth(m_capacity);
+        }
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> insert(V&& value) noexcept
+        // see `robin_hash::insert()`
+        requires(std::same_as<std::remove_cvref_t<V>, value_type>)
+    {
+        return insert_impl(extract_key(value), std::forward<V>(value));
+    }
+
+    template <typename V>
+    iterator insert(const_iterator hint, V&& value) noexcept
+        requires(std::same_as<std::remove_cvref_t<V>, value_type>)
+    {
+        if (hint != cend() &&
+            compare_keys(extract_key(value), extract_key(*hint)))
+            return mutable_cast(hint);
+        return insert(std::forward<V>(value)).first;
+    }
+
+    template <typename Iter>
+    void insert(Iter first, Iter last) noexcept
+        requires(requires(Iter l, Iter r) {
+            { std::distance(l, r) };
+            { ++l };
+            { l != r } -> std::same_as<bool>;
+            { *l };
+        })
+    {
+        auto const insertion_count = std::distance(first, last);
+        if (size_type(insertion_count) > m_growth_left)
+            reserve(m_size + size_type(insertion_count));
+        for (auto iter = first; iter != last; ++iter) {
+            insert(*iter);
+        }
+    }
+
+    template <typename K, typename M>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& mapped) noexcept
+        requires(std::same_as<key_type, std::remove_cvref_t<K>> &&
+                 std::is_assignable_v<mapped_type&, M &&>)
+    {
+        auto iter_success =
+            try_emplace(std::forward<K>(key), std::forward<M>(mapped));
+        if (!iter_success.second)
+            iter_success.first.mapped() = std::forward<M>(mapped);
+        return iter_success;
+    }
+
+    template <typename K, typename M>
+    iterator insert_or_assign(const_iterator hint, K&& key, M&& mapped) noexcept
+        requires(std::same_as<key_type, std::remove_cvref_t<K>> &&
+                 std::is_assignable_v<mapped_type&, M &&>)
+    {
+        if (hint != cend() && compare_keys(key, extract_key(*hint))) {
+            auto iter = mutable_cast(hint);
+            iter.mapped() = std::forward<M>(mapped);
+            return iter;
+        }
+        return insert_or_assign(std::forward<K>(key), std::forward<M>(mapped))
+            .first;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) noexcept
+        requires(std::constructible_from<value_type, Args...>)
+    {
+        return insert(value_type{std::forward<Args>(args)...});
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) noexcept
+        requires(std::constructible_from<value_type, Args...>)
+    {
+        return insert(hint, value_type{std::forward<Args>(args)...});
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(
+        K&& key, Args&&... mapped_args) noexcept
+        requires(std::same_as<key_type, std::remove_cvref_t<K>> &&
+                 std::constructible_from<mapped_type, Args...>)
+    {
+        return insert_impl(key, std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(mapped_args)...));
+    }
+
+    template <typename K, typename... Args>
+    iterator try_emplace(
+        const_iterator hint, K&& key, Args&&... mapped_args) noexcept
+        requires(std::same_as<key_type, std::remove_cvref_t<K>> &&
+                 std::constructible_from<mapped_type, Args...>)
+    {
+        if (hint != cend() && compare_keys(key, extract_key(*hint))) {
+            return mutable_cast(hint);
+        }
+        return try_emplace(
+            std::forward<K>(key), std::forward<Args>(mapped_args)...)
+            .first;
+    }
+
+    // unlike the robin hash, erasing never moves other values, so iterators
+    // other than `pos` stay valid
+    iterator erase(iterator pos) noexcept {
+        COUST_ASSERT(is_full(*pos.m_ctrl), "Can't erase an empty slot");
+        std::destroy_at(std::addressof(pos.m_slot->value));
+        erase_meta(index_of(pos));
+        m_try_shrink_on_next_insert = true;
+        pos.skip_empty_or_deleted();
+        return pos;
+    }
+
+    iterator erase(const_iterator pos) noexcept {
+        return erase(mutable_cast(pos));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        return erase(mutable_cast(first), mutable_cast(last));
+    }
+
+    iterator erase(iterator first, iterator last) noexcept {
+        while (first != last) {
+            first = erase(first);
+        }
+        return last;
+    }
+
+    template <typename K>
+    size_type erase(K const& key) noexcept {
+        auto iter = find_impl(key, key_to_hash(key));
+        if (iter != end()) {
+            erase(iter);
+            return 1u;
+        } else {
+            return 0u;
+        }
+    }
+
+    void swap(swiss_hash& other) noexcept {
+        std::swap((Hash&) (*this), (Hash&) (other));
+        std::swap((Key_Equal&) (*this), (Key_Equal&) (other));
+        std::swap(m_ctrl_container, other.m_ctrl_container);
+        std::swap(m_slots_container, other.m_slots_container);
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growth_left, other.m_growth_left);
+        std::swap(m_min_load_factor, other.m_min_load_factor);
+        std::swap(m_max_load_factor, other.m_max_load_factor);
+        std::swap(
+            m_try_shrink_on_next_insert, other.m_try_shrink_on_next_insert);
+    }
+    /* Modifiers*/
+
+public:
+    /* Lookup*/
+    template <typename K>
+    auto& at(K const& key) noexcept {
+        auto iter = find_impl(key, key_to_hash(key));
+        COUST_PANIC_IF(iter == end(), "Can't find key");
+        return iter.mapped();
+    }
+
+    template <typename K>
+    auto const& at(K const& key) const noexcept {
+        auto iter = find_impl(key, key_to_hash(key));
+        COUST_PANIC_IF(iter == cend(), "Can't find key");
+        return iter.mapped();
+    }
+
+    template <typename K>
+    iterator find(K const& key) noexcept {
+        return find_impl(key, key_to_hash(key));
+    }
+
+    template <typename K>
+    const_iterator find(K const& key) const noexcept {
+        return find_impl(key, key_to_hash(key));
+    }
+
+    template <typename K>
+    bool contains(K const& key) noexcept {
+        return find_impl(key, key_to_hash(key)) != end();
+    }
+
+    template <typename K>
+    bool contains(K const& key) const noexcept {
+        return find_impl(key, key_to_hash(key)) != cend();
+    }
+
+    /* Lookup*/
+public:
+    /* Bucket Interface */
+    size_type bucket_count() const noexcept { return m_capacity; }
+
+    size_type max_bucket_count() const noexcept {
+        return std::min(std::numeric_limits<size_t>::max() / 2,
+            m_slots_container.max_size());
+    }
+    /* Bucket Interface */
+public:
+    /* Hash Policy */
+    float load_factor() const noexcept {
+        return m_capacity == 0 ? 0.0f : float(m_size) / float(m_capacity);
+    }
+
+    float min_load_factor() const noexcept { return m_min_load_factor; }
+
+    float max_load_factor() const noexcept { return m_max_load_factor; }
+
+    void min_load_factor(float factor) noexcept {
+        m_min_load_factor = std::clamp(
+            factor, MIN_LOAD_FACTOR_MINIMUM, MIN_LOAD_FACTOR_MAXIMUM);
+    }
+
+    void max_load_factor(float factor) noexcept {
+        m_max_load_factor = std::clamp(
+            factor, MAX_LOAD_FACTOR_MINIMUM, MAX_LOAD_FACTOR_MAXIMUM);
+        size_t used_count = 0;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            used_count += ctrl_at(i) != CTRL_EMPTY;
+        }
+        size_t const growth = capacity_to_growth(m_capacity);
+        m_growth_left = growth > used_count ? growth - used_count : 0;
+    }
+
+    void rehash(size_type new_count) noexcept {
+        size_type const adjusted_count = std::max(new_count,
+            (size_type) std::ceil(float(size()) / float(m_max_load_factor)));
+        rehash_impl(adjusted_count);
+    }
+
+    void reserve(size_type new_capacity) noexcept {
+        rehash(size_type(std::ceil(float(new_capacity) / m_max_load_factor)));
+    }
+    /* Hash Policy */
+public:
+    /* Observers */
+    hasher hash_function() const noexcept { return (Hash const&) (*this); }
+
+    key_equal key_eq() const noexcept { return (Key_Equal const&) (*this); }
+
+    /* Observers */
+
+private:
+    static size_t h1(size_t hash) noexcept { return hash >> 7; }
+
+    static ctrl_type h2(size_t hash) noexcept {
+        return (ctrl_type) (hash & 0x7f);
+    }
+
+    template <typename K>
+    size_t key_to_hash(K const& key) const noexcept {
+        return mix_hash(Hash::operator()(key));
+    }
+
+    template <typename K>
+    bool compare_keys(key_type const& k1, K const& k2) const noexcept {
+        return Key_Equal::operator()(k1, k2);
+    }
+
+    static key_type& extract_key(value_type& value) noexcept {
+        if constexpr (HAS_MAPPED) {
+            return value.first;
+        } else {
+            return value;
+        }
+    }
+
+    static key_type const& extract_key(value_type const& value) noexcept {
+        if constexpr (HAS_MAPPED) {
+            return value.first;
+        } else {
+            return value;
+        }
+    }
+
+    static iterator mutable_cast(const_iterator iter) noexcept {
+        return iterator(iter.m_ctrl, const_cast<slot_type*>(iter.m_slot));
+    }
+
+    // capacity is either 0 or 2^n - 1 with at least a group of slots, so that
+    // the cloned control bytes always cover a whole group
+    static size_type normalize_capacity(size_type count) noexcept {
+        if (count == 0)
+            return 0;
+        count = std::max(count, SWISS_GROUP_WIDTH - 1);
+        return std::bit_ceil(count + 1) - 1;
+    }
+
+    size_type capacity_to_growth(size_type capacity) const noexcept {
+        // always keep an empty slot to stop the probing
+        size_type const growth =
+            (size_type) (float(capacity) * m_max_load_factor);
+        return std::min(growth, capacity == 0 ? 0 : capacity - 1);
+    }
+
+private:
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    ctrl_type ctrl_at(size_t idx) const noexcept { return m_ctrl[idx]; }
+
+    slot_type& slot_at(size_t idx) noexcept { return m_slots[idx]; }
+
+    slot_type const& slot_at(size_t idx) const noexcept { return m_slots[idx]; }
+
+    size_t index_of(const_iterator iter) const noexcept {
+        return (size_t) (iter.m_ctrl - m_ctrl);
+    }
+
+    iterator iterator_at(size_t idx) noexcept {
+        return iterator{m_ctrl + idx, m_slots + idx};
+    }
+
+    const_iterator iterator_at(size_t idx) const noexcept {
+        return const_iterator{m_ctrl + idx, m_slots + idx};
+    }
+
+    // also update the clone of the first `SWISS_GROUP_WIDTH - 1` bytes after
+    // the sentinel
+    void set_ctrl(size_t idx, ctrl_type ctrl) noexcept {
+        size_t constexpr cloned_count = SWISS_GROUP_WIDTH - 1;
+        m_ctrl[idx] = ctrl;
+        m_ctrl[((idx - cloned_count) & m_capacity) +
+               (cloned_count & m_capacity)] = ctrl;
+    }
+
+    void reset_ctrl() noexcept {
+        if (m_capacity == 0)
+            return;
+        std::ranges::fill(m_ctrl_container, CTRL_EMPTY);
+        m_ctrl[m_capacity] = CTRL_SENTINEL;
+    }
+    WARNING_POP
+
+    void initialize(size_type capacity) noexcept {
+        m_capacity = capacity;
+        if (m_capacity > 0) {
+            // the sentinel & the cloned bytes follow the control bytes
+            m_ctrl_container.resize(m_capacity + SWISS_GROUP_WIDTH);
+            slot_container_type{m_capacity, m_slots_container.get_allocator()}
+                .swap(m_slots_container);
+            m_ctrl = m_ctrl_container.data();
+            m_slots = m_slots_container.data();
+            reset_ctrl();
+        } else {
+            m_ctrl = empty_group();
+            m_slots = nullptr;
+        }
+        m_size = 0;
+        m_growth_left = capacity_to_growth(m_capacity);
+    }
+
+    void destroy_values() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < m_capacity && m_size > 0; ++i) {
+                if (is_full(ctrl_at(i)))
+                    std::destroy_at(std::addressof(slot_at(i).value));
+            }
+        }
+    }
+
+    // forget the values without destroying them
+    void reset_to_empty() noexcept {
+        m_ctrl = empty_group();
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+        m_try_shrink_on_next_insert = false;
+    }
+
+    void clear_and_shrink() noexcept {
+        destroy_values();
+        reset_to_empty();
+        ctrl_container_type{m_ctrl_container.get_allocator()}.swap(
+            m_ctrl_container);
+        slot_container_type{m_slots_container.get_allocator()}.swap(
+            m_slots_container);
+    }
+
+    // the first empty or deleted slot on the probing sequence of `hash`
+    size_t find_first_non_full(size_t hash) const noexcept {
+        swiss_probe probe{h1(hash), m_capacity};
+        while (true) {
+            swiss_group const group{std::addressof(m_ctrl[probe.offset()])};
+            auto const mask = group.match_empty_or_deleted();
+            if (mask)
+                return probe.offset(mask.lowest());
+            probe.next();
+            COUST_ASSERT(probe.index() <= m_capacity, "Swiss table is full");
+        }
+    }
+
+    void rehash_impl(size_type new_count) noexcept {
+        size_type new_capacity = normalize_capacity(new_count);
+        // the load factor is approximated with floats
+        while (new_capacity > 0 && capacity_to_growth(new_capacity) < m_size) {
+            new_capacity = new_capacity * 2 + 1;
+        }
+        swiss_hash new_hash{new_capacity, (Hash&) (*this), (Key_Equal&) (*this),
+            get_allocator(), m_min_load_factor, m_max_load_factor};
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (!is_full(ctrl_at(i)))
+                continue;
+            value_type& value = slot_at(i).value;
+            size_t const hash = key_to_hash(extract_key(value));
+            size_t const new_idx = new_hash.find_first_non_full(hash);
+            new_hash.set_ctrl(new_idx, h2(hash));
+            std::construct_at(std::addressof(new_hash.slot_at(new_idx).value),
+                std::move(value));
+            std::destroy_at(std::addressof(value));
+        }
+        new_hash.m_size = m_size;
+        new_hash.m_growth_left -= m_size;
+        // the values are moved out, don't destroy them again
+        m_size = 0;
+        reset_ctrl();
+        new_hash.swap(*this);
+    }
+
+    void rehash_and_grow_if_necessary() noexcept {
+        // mostly tombstones, clean them up in a table of the same size
+        if (m_capacity > 0 &&
+            m_size * 32 <= capacity_to_growth(m_capacity) * 25)
+            rehash_impl(m_capacity);
+        else
+            rehash_impl(m_capacity * 2 + 1);
+    }
+
+    void shrink_if_needed() noexcept {
+        bool const need_shrink = m_try_shrink_on_next_insert &&
+                                 m_min_load_factor != 0.0f &&
+                                 load_factor() < m_min_load_factor;
+        if (need_shrink)
+            reserve(m_size + 1);
+        m_try_shrink_on_next_insert = false;
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> insert_impl(
+        K const& key, Args&&... value_args) noexcept
+        requires(std::same_as<key_type, std::remove_cvref_t<K>>)
+    {
+        size_t const hash = key_to_hash(key);
+        if (auto const iter = find_impl(key, hash); iter != end())
+            return std::make_pair(iter, false);
+        shrink_if_needed();
+        size_t idx = find_first_non_full(hash);
+        // a tombstone can be reused without growing
+        if (m_growth_left == 0 && ctrl_at(idx) != CTRL_DELETED) {
+            rehash_and_grow_if_necessary();
+            idx = find_first_non_full(hash);
+        }
+        m_growth_left -= ctrl_at(idx) == CTRL_EMPTY;
+        set_ctrl(idx, h2(hash));
+        std::construct_at(std::addressof(slot_at(idx).value),
+            std::forward<Args>(value_args)...);
+        ++m_size;
+        return std::make_pair(iterator_at(idx), true);
+    }
+
+    void erase_meta(size_t idx) noexcept {
+        --m_size;
+        size_t const idx_before = (idx - SWISS_GROUP_WIDTH) & m_capacity;
+        auto const empty_after =
+            swiss_group{std::addressof(m_ctrl[idx])}.match_empty();
+        auto const empty_before =
+            swiss_group{std::addressof(m_ctrl[idx_before])}.match_empty();
+        // if every group covering the slot has always had an empty slot, no
+        // probing has ever passed it, so it can be empty instead of deleted
+        bool const was_never_full = empty_before && empty_after &&
+                                    empty_after.trailing_zeros() +
+                                            empty_before.leading_zeros() <
+                                        SWISS_GROUP_WIDTH;
+        set_ctrl(idx, was_never_full ? CTRL_EMPTY : CTRL_DELETED);
+        m_growth_left += was_never_full;
+    }
+
+    template <typename K>
+    iterator find_impl(K const& key, size_t hash) noexcept {
+        return mutable_cast(((const swiss_hash*) (this))->find_impl(key, hash));
+    }
+
+    template <typename K>
+    const_iterator find_impl(K const& key, size_t hash) const noexcept {
+        swiss_probe probe{h1(hash), m_capacity};
+        while (true) {
+            swiss_group const group{std::addressof(m_ctrl[probe.offset()])};
+            for (auto mask = group.match(h2(hash)); mask; mask.clear_lowest()) {
+                size_t const idx = probe.offset(mask.lowest());
+                if (compare_keys(extract_key(slot_at(idx).value), key))
+                    [[likely]]
+                    return iterator_at(idx);
+            }
+            if (group.match_empty()) [[likely]]
+                return cend();
+            probe.next();
+            COUST_ASSERT(probe.index() <= m_capacity, "Swiss table is full");
+        }
+    }
+
+public:
+    static size_type constexpr INIT_BUCKET_COUNT_DEFAULT = 0;
+
+    static float constexpr MIN_LOAD_FACTOR_DEFAULT = 0.0f;
+    static float constexpr MIN_LOAD_FACTOR_MINIMUM = 0.0f;
+    static float constexpr MIN_LOAD_FACTOR_MAXIMUM = 0.15f;
+
+    // the control bytes are probed a group at a time, so the table can be
+    // much fuller than the robin hash
+    static float constexpr MAX_LOAD_FACTOR_DEFAULT = 0.875f;
+    static float constexpr MAX_LOAD_FACTOR_MINIMUM = 0.2f;
+    static float constexpr MAX_LOAD_FACTOR_MAXIMUM = 0.875f;
+
+    static_assert(MIN_LOAD_FACTOR_DEFAULT < MAX_LOAD_FACTOR_DEFAULT, "");
+    static_assert(MIN_LOAD_FACTOR_MINIMUM < MAX_LOAD_FACTOR_MINIMUM, "");
+    static_assert(MIN_LOAD_FACTOR_MAXIMUM < MAX_LOAD_FACTOR_MAXIMUM, "");
+
+private:
+    // the control bytes of a table without any slot: a sentinel, so `begin()`
+    // is `end()`, followed by empty bytes, so lookups stop at the first group
+    static ctrl_type* empty_group() noexcept {
+        alignas(SWISS_GROUP_WIDTH) static std::array<ctrl_type,
+            SWISS_GROUP_WIDTH>
+            s_empty_group{CTRL_SENTINEL, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+                CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+                CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+                CTRL_EMPTY, CTRL_EMPTY};
+        return s_empty_group.data();
+    }
+
+private:
+    ctrl_container_type m_ctrl_container;
+
+    slot_container_type m_slots_container;
+
+    ctrl_type* RESTRICT m_ctrl = nullptr;
+
+    slot_type* RESTRICT m_slots = nullptr;
+
+    // 0 or 2^n - 1
+    size_type m_capacity = 0;
+
+    size_type m_size = 0;
+
+    // the number of empty slots which can be filled before growing, deleted
+    // slots don't count
+    size_type m_growth_left = 0;
+
+    // prevents container occupying too much memory
+    float m_min_load_factor = MIN_LOAD_FACTOR_DEFAULT;
+
+    float m_max_load_factor = MAX_LOAD_FACTOR_DEFAULT;
+
+    bool m_try_shrink_on_next_insert = false;
+};
+
+}  // namespace detail
+}  // namespace container
+}  // namespace coust
@@ -0,0 +1,365 @@
+#pragma once
+
+#include "utils/containers/SwissHash.h"
+
+// implementation reference: https://abseil.io/about/design/swisstables
+
+namespace coust {
+namespace container {
+
+// open addressing with the control bytes apart from the values, which are
+// probed a group at a time with SIMD. it's a drop-in replacement of
+// `robin_map`, except that erasing never moves the other values
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+    typename Key_Equal = std::equal_to<Key>,
+    typename Alloc = std::allocator<std::pair<Key, T>>>
+class swiss_map {
+public:
+    using sh = detail::swiss_hash<Key, T, Hash, Key_Equal, Alloc>;
+
+    using key_type = typename sh::key_type;
+    using mapped_type = typename sh::mapped_type;
+    using value_type = typename sh::value_type;
+    using size_type = typename sh::size_type;
+    using difference_type = typename sh::difference_type;
+    using hasher = typename sh::hasher;
+    using key_equal = typename sh::key_equal;
+    using allocator_type = typename sh::allocator_type;
+    using reference = typename sh::reference;
+    using const_reference = typename sh::const_reference;
+    using pointer = typename sh::pointer;
+    using const_pointer = typename sh::const_pointer;
+    using iterator = typename sh::iterator;
+    using const_iterator = typename sh::const_iterator;
+
+    // https://en.cppreference.com/w/cpp/container/unordered_map
+public:
+    /* Constructors */
+    swiss_map() noexcept : swiss_map(sh::INIT_BUCKET_COUNT_DEFAULT) {}
+
+    explicit swiss_map(size_type bucket_count, Hash const& hash = Hash{},
+        Key_Equal const& equal = Key_Equal{},
+        Alloc const& alloc = Alloc{}) noexcept
+        : m_sh(bucket_count, hash, equal, alloc) {}
+
+    swiss_map(size_type bucket_count, Alloc const& alloc) noexcept
+        : swiss_map(bucket_count, Hash{}, Key_Equal{}, alloc) {}
+
+    swiss_map(
+        size_type bucket_count, Hash const& hash, Alloc const& alloc) noexcept
+        : swiss_map(bucket_count, hash, Key_Equal{}, alloc) {}
+
+    explicit swiss_map(Alloc const& alloc) noexcept
+        : swiss_map(sh::INIT_BUCKET_COUNT_DEFAULT, Hash{}, Key_Equal{}, alloc) {
+    }
+
+    template <typename Iter>
+    swiss_map(Iter first, Iter last,
+        size_type bucket_count = sh::INIT_BUCKET_COUNT_DEFAULT,
+        Hash const& hash = Hash{}, Key_Equal const& equal = Key_Equal{},
+        Alloc const& alloc = Alloc{}) noexcept
+        : swiss_map(bucket_count, hash, equal, alloc) {
+        m_sh.insert(first, last);
+    }
+
+    template <typename Iter>
+    swiss_map(Iter first, Iter last, size_type bucket_count,
+        Alloc const& alloc) noexcept
+        : swiss_map(bucket_count, Hash{}, Key_Equal{}, alloc) {
+        m_sh.insert(first, last);
+    }
+
+    template <typename Iter>
+    swiss_map(Iter first, Iter last, size_type bucket_count, Hash const& hash,
+        Alloc const& alloc) noexcept
+        : swiss_map(bucket_count, hash, Key_Equal{}, alloc) {
+        m_sh.insert(first, last);
+    }
+
+    swiss_map(swiss_map const& other) noexcept : m_sh(other.m_sh) {}
+
+    swiss_map(swiss_map&& other) noexcept : m_sh(std::move(other.m_sh)) {}
+
+    swiss_map(std::initializer_list<value_type> init,
+        size_type bucket_count = sh::INIT_BUCKET_COUNT_DEFAULT,
+        Hash const& hash = Hash{}, Key_Equal const& equal = Key_Equal{},
+        Alloc const& alloc = Alloc{}) noexcept
+        : swiss_map(bucket_count, hash, equal, alloc) {
+        m_sh.insert(init.begin(), init.end());
+    }
+
+    swiss_map(std::initializer_list<value_type> init, size_type bucket_count,
+        Alloc const& alloc) noexcept
+        : swiss_map(bucket_count, Hash{}, Key_Equal{}, alloc) {
+        m_sh.insert(init.begin(), init.end());
+    }
+
+    swiss_map(std::initializer_list<value_type> init, size_type bucket_count,
+        Hash const& hash, Alloc const& alloc) noexcept
+        : swiss_map(bucket_count, hash, Key_Equal{}, alloc) {
+        m_sh.insert(init.begin(), init.end());
+    }
+    /* Constructors */
+public:
+    /* operator = */
+    swiss_map& operator=(swiss_map const& other) noexcept {
+        m_sh = other.m_sh;
+        return *this;
+    }
+
+    swiss_map& operator=(swiss_map&& other) noexcept {
+        m_sh = std::move(other.m_sh);
+        return *this;
+    }
+
+    swiss_map& operator=(std::initializer_list<value_type> list) noexcept {
+        m_sh.clear();
+        m_sh.reserve(list.size());
+        m_sh.insert(list.begin(), list.end());
+        return *this;
+    }
+    /* operator = */
+
+public:
+    allocator_type get_allocator() const noexcept {
+        return m_sh.get_allocator();
+    }
+
+public:
+    /* Iterators */
+    iterator begin() noexcept { return m_sh.begin(); }
+
+    const_iterator begin() const noexcept { return m_sh.begin(); }
+
+    const_iterator cbegin() const noexcept { return m_sh.cbegin(); }
+
+    iterator end() noexcept { return m_sh.end(); }
+
+    const_iterator end() const noexcept { return m_sh.end(); }
+
+    const_iterator cend() const noexcept { return m_sh.cend(); }
+    /* Iterators */
+
+public:
+    /* capacity */
+    bool empty() const noexcept { return m_sh.empty(); }
+
+    size_type size() const noexcept { return m_sh.size(); }
+
+    size_type max_size() const noexcept { return m_sh.max_size(); }
+    /* capacity */
+public:
+    /* modifier */
+    void clear() noexcept { m_sh.clear(); }
+
+    std::pair<iterator, bool> insert(value_type const& value) noexcept {
+        return m_sh.insert(value);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) noexcept {
+        return m_sh.insert(std::move(value));
+    }
+
+    template <typename P>
+    std::pair<iterator, bool> insert(P&& value) noexcept
+        requires(std::is_constructible_v<value_type, P &&>)
+    {
+        return m_sh.emplace(std::forward<P>(value));
+    }
+
+    iterator insert(const_iterator hint, value_type const& value) noexcept {
+        return m_sh.insert(hint, value);
+    }
+
+    iterator insert(const_iterator hint, value_type&& value) noexcept {
+        return m_sh.insert(hint, std::move(value));
+    }
+
+    template <typename P>
+    iterator insert(const_iterator hint, P&& value) noexcept
+        requires(std::is_constructible_v<value_type, P &&>)
+    {
+        return m_sh.emplace_hint(hint, std::forward<P>(value));
+    }
+
+    template <typename Iter>
+    void insert(Iter first, Iter last) noexcept {
+        m_sh.insert(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> list) noexcept {
+        m_sh.insert(list.begin(), list.end());
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(
+        key_type const& key, M&& obj) noexcept {
+        return m_sh.insert_or_assign(key, std::forward<M>(obj));
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(
+        key_type&& key, M&& obj) noexcept {
+        return m_sh.insert_or_assign(std::move(key), std::forward<M>(obj));
+    }
+
+    template <typename M>
+    iterator insert_or_assign(
+        const_iterator hint, key_type const& key, M&& obj) noexcept {
+        return m_sh.insert_or_assign(hint, key, std::forward<M>(obj));
+    }
+
+    template <typename M>
+    iterator insert_or_assign(
+        const_iterator hint, key_type&& key, M&& obj) noexcept {
+        return m_sh.insert_or_assign(
+            hint, std::move(key), std::forward<M>(obj));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) noexcept {
+        return m_sh.emplace(std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) noexcept {
+        return m_sh.emplace_hint(hint, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(
+        key_type const& key, Args&&... args) noexcept {
+        return m_sh.try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(
+        key_type&& key, Args&&... args) noexcept {
+        return m_sh.try_emplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator try_emplace(
+        const_iterator hint, key_type const& key, Args&&... args) noexcept {
+        return m_sh.try_emplace(hint, key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    iterator try_emplace(
+        const_iterator hint, key_type&& key, Args&&... args) noexcept {
+        return m_sh.try_emplace(
+            hint, std::move(key), std::forward<Args>(args)...);
+    }
+
+    iterator erase(iterator pos) noexcept { return m_sh.erase(pos); }
+
+    iterator erase(const_iterator pos) noexcept { return m_sh.erase(pos); }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        return m_sh.erase(first, last);
+    }
+
+    size_type erase(key_type const& key) noexcept { return m_sh.erase(key); }
+
+    template <typename K>
+    size_type erase(K const& key) noexcept
+        requires(transparent_lookup<Hash, Key_Equal> &&
+                 !std::convertible_to<K const&, const_iterator>)
+    {
+        return m_sh.erase(key);
+    }
+
+    void swap(swiss_map& other) noexcept { other.m_sh.swap(m_sh); }
+    /* modifier */
+
+public:
+    /* lookup */
+    T& at(key_type const& key) noexcept { return m_sh.at(key); }
+
+    T const& at(key_type const& key) const noexcept { return m_sh.at(key); }
+
+    iterator find(key_type const& key) noexcept { return m_sh.find(key); }
+
+    const_iterator find(key_type const& key) const noexcept {
+        return m_sh.find(key);
+    }
+
+    bool contains(key_type const& key) const noexcept {
+        return m_sh.contains(key);
+    }
+
+    // the overloads below take any key type the transparent hasher & key
+    // equal accept, see `transparent_lookup`
+    template <typename K>
+    T& at(K const& key) noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_sh.at(key);
+    }
+
+    template <typename K>
+    T const& at(K const& key) const noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_sh.at(key);
+    }
+
+    template <typename K>
+    iterator find(K const& key) noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_sh.find(key);
+    }
+
+    template <typename K>
+    const_iterator find(K const& key) const noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_sh.find(key);
+    }
+
+    template <typename K>
+    bool contains(K const& key) const noexcept
+        requires(transparent_lookup<Hash, Key_Equal>)
+    {
+        return m_sh.contains(key);
+    }
+    /* lookup */
+
+public:
+    /* bucket interface */
+    size_type bucket_count() const noexcept { return m_sh.bucket_count(); }
+
+    size_type max_bucket_count() const noexcept {
+        return m_sh.max_bucket_count();
+    }
+    /* bucket interface */
+
+public:
+    /* hash policy */
+    float load_factor() const noexcept { return m_sh.load_factor(); }
+
+    float min_load_factor() const noexcept { return m_sh.min_load_factor(); }
+    float max_load_factor() const noexcept { return m_sh.max_load_factor(); }
+
+    void min_load_factor(float ml) noexcept { m_sh.min_load_factor(ml); }
+    void max_load_factor(float ml) noexcept { m_sh.max_load_factor(ml); }
+
+    void rehash(size_type new_count) noexcept { m_sh.rehash(new_count); }
+
+    void reserve(size_type new_count) noexcept { m_sh.reserve(new_count); }
+    /* hash policy */
+
+public:
+    /* Observers */
+    Hash hash_function() const noexcept { return m_sh.hash_function(); }
+
+    Key_Equal key_eq() const noexcept { return m_sh.key_eq(); }
+    /* Observers */
+
+private:
+    sh m_sh;
+};
+
+}  // namespace container
+}  // namespace coust
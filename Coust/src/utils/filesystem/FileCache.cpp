@@ -82,7 +82,19 @@ Caches& Caches::get_instance() noexcept {
 WARNING_POP
 
 Caches::Caches(std::filesystem::path headers_path) noexcept
-    : m_headers_path(headers_path), m_cache_dir(m_headers_path.parent_path()) {
+    : m_bookkeeping_pool(
+          {memory::small_growth_factor, memory::medium_growth_factor},
+          memory::global_memory_pool_alignment),
+      m_bookkeeping_alloc(std::piecewise_construct,
+          std::forward_as_tuple(m_bookkeeping_pool),
+          std::forward_as_tuple(std::piecewise_construct,
+              std::forward_as_tuple(m_bookkeeping_pool), std::tuple<>{})),
+      m_headers_path(headers_path),
+      m_cache_dir(m_headers_path.parent_path()),
+      m_budget_handle(get_memory_budget().register_subsystem("File Cache",
+          [this](memory::MemoryPressure pressure, size_t size) {
+              return evict(pressure, size);
+          })) {
     if (std::filesystem::exists(headers_path)) {
         ByteArray header_bytes =
             read_file_whole(std::filesystem::path{headers_path});
@@ -96,9 +108,12 @@ Caches::Caches(std::filesystem::path headers_path) noexcept
 }
 
 Caches::~Caches() noexcept {
+    get_memory_budget().unregister_subsystem(m_budget_handle);
     for (auto const& [tag, data] : m_cache_data) {
+        if (!data.is_dirty)
+            continue;
         std::filesystem::path const path = m_cache_dir / std::to_string(tag);
-        write_cache_data(path, data);
+        write_cache_data(path, data.bytes);
     }
     std::erase_if(m_headers.m_headers, [this](Header const& h) {
         return check_cache_header(h) != Status::available;
@@ -131,7 +146,9 @@ std::pair<ByteArray, Caches::Status> Caches::get_cache_data(
     // immediately return it if we find one
     auto const cache_iter = m_cache_data.find(tag);
     if (cache_iter != m_cache_data.end()) {
-        return std::make_pair(cache_iter.mapped().copy(), Status::available);
+        CacheData& data = cache_iter.mapped();
+        data.last_accessed = ++m_access_count;
+        return std::make_pair(data.bytes.copy(), Status::available);
     }
 
     // read data from disk and check if it's valid
@@ -145,8 +162,9 @@ std::pair<ByteArray, Caches::Status> Caches::get_cache_data(
         return std::make_pair(ByteArray{}, data_status);
     }
 
-    auto [iter, success] = m_cache_data.emplace(tag, std::move(new_cache_data));
-    return std::make_pair(iter.mapped().copy(), Status::available);
+    auto [iter, success] = m_cache_data.emplace(tag,
+        CacheData{std::move(new_cache_data), ++m_access_count, false});
+    return std::make_pair(iter.mapped().bytes.copy(), Status::available);
 }
 
 void Caches::add_cache_data(std::string origin_name, size_t tag,
@@ -187,7 +205,8 @@ void Caches::add_cache_data(std::string origin_name, size_t tag,
         [tag](Header const& h) { return h.cache_tag == tag; });
 
     m_headers.m_headers.push_back(std::move(ret));
-    m_cache_data.emplace(tag, std::move(data));
+    m_cache_data.insert_or_assign(
+        tag, CacheData{std::move(data), ++m_access_count, true});
 }
 
 bool Caches::flush_cache_to_disk(std::string origin_name, size_t tag) noexcept {
@@ -203,12 +222,36 @@ bool Caches::flush_cache_to_disk(std::string origin_name, size_t tag) noexcept {
     if (data_iter != m_cache_data.end()) {
         std::filesystem::path const cache_path =
             m_cache_dir / std::to_string(tag);
-        write_cache_data(cache_path, data_iter.mapped());
+        write_cache_data(cache_path, data_iter.mapped().bytes);
+        data_iter.mapped().is_dirty = false;
         return true;
     }
     return false;
 }
 
+size_t Caches::evict(memory::MemoryPressure pressure, size_t size) noexcept {
+    memory::vector<std::pair<uint64_t, size_t>, BookkeepingAlloc> lru{
+        m_bookkeeping_alloc};
+    lru.reserve(m_cache_data.size());
+    for (auto const& [tag, data] : m_cache_data) {
+        lru.emplace_back(data.last_accessed, tag);
+    }
+    std::ranges::sort(lru);
+    size_t released = 0;
+    for (auto const& [last_accessed, tag] : lru) {
+        if (pressure != memory::MemoryPressure::hard && released >= size)
+            break;
+        auto const data_iter = m_cache_data.find(tag);
+        CacheData const& data = data_iter.mapped();
+        // it's read back from disk the next time
+        if (data.is_dirty)
+            write_cache_data(m_cache_dir / std::to_string(tag), data.bytes);
+        released += data.bytes.size();
+        m_cache_data.erase(data_iter);
+    }
+    return released;
+}
+
 Caches::Status Caches::check_cache_header(Header const& header) const noexcept {
     // we don't have to check cache that doesn't have corresponding file
     if (!header.created_from_file)
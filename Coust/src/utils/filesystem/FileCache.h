@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/Memory.h"
+#include "core/MemoryBudget.h"
+#include "utils/allocators/Composition.h"
 #include "utils/allocators/StlContainer.h"
 #include "utils/filesystem/FileIO.h"
 
@@ -50,6 +52,10 @@ public:
     // otherwise return false;
     bool flush_cache_to_disk(std::string origin_name, size_t tag) noexcept;
 
+    // drop the least recently used cache data from memory, the data not on
+    // disk yet is flushed first. return the bytes released
+    size_t evict(memory::MemoryPressure pressure, size_t size) noexcept;
+
 private:
     struct Header {
         // either full path of corresponding file or indicating its content if
@@ -72,6 +78,14 @@ private:
         bool created_from_file = false;
     };
 
+    struct CacheData {
+        ByteArray bytes;
+        // the value of `m_access_count` when the data was last used
+        uint64_t last_accessed;
+        // the data isn't written to disk yet
+        bool is_dirty;
+    };
+
     // the struct to be serialized to disk
     struct Headers {
         memory::string<DefaultAlloc> cache_folder_dir{get_default_alloc()};
@@ -79,6 +93,17 @@ private:
             get_default_alloc()};
     };
 
+    // the bookkeeping of the cache data (the map & the lru list) draws from a
+    // pool of its own instead of the default allocator: the small blocks go
+    // to pools of a few sizes, the medium ones to a tlsf allocator, and the
+    // buckets of a large map to the heap
+    using BookkeepingAlloc = memory::Segregator<memory::byte_128,
+        memory::Bucketizer<memory::HomoAlloc_S, 0, memory::byte_128,
+            memory::byte_32>,
+        memory::Segregator<memory::medium_growth_factor -
+                               memory::TLSFAllocator::BOOKKEEPING_SIZE,
+            memory::GeneralAlloc_M, memory::HeapAllocator>>;
+
 private:
     // we always put the magic number in the front of cache data file to
     // help quickly identify any possible corruption in the file
@@ -103,11 +128,15 @@ private:
 
 private:
     Headers m_headers;
+    memory::MemoryPool m_bookkeeping_pool;
+    BookkeepingAlloc m_bookkeeping_alloc;
     // cache tag -> cache data
-    memory::robin_map<size_t, ByteArray, DefaultAlloc> m_cache_data{
-        get_default_alloc()};
+    memory::robin_map<size_t, CacheData, BookkeepingAlloc> m_cache_data{
+        m_bookkeeping_alloc};
+    uint64_t m_access_count = 0;
     std::filesystem::path m_headers_path;
     std::filesystem::path m_cache_dir;
+    memory::MemoryBudget::Handle m_budget_handle;
 };
 
 }  // namespace file
@@ -44,6 +44,15 @@ ByteArray::~ByteArray() noexcept {
 void ByteArray::grow_to(size_t new_size) noexcept {
     COUST_ASSERT(new_size > m_size,
         "new_size {} is smaller than original size {}", new_size, m_size);
+    // the address (thus the alignment) doesn't change if it grows in place
+    size_t const aligned_new_size =
+        ptr_math::round_up_to_alinged(new_size, m_alignment);
+    if (m_bytes &&
+        get_default_alloc().try_expand(m_bytes, m_size, aligned_new_size)) {
+        memset(ptr_math::add(m_bytes, m_size), 0, aligned_new_size - m_size);
+        m_size = aligned_new_size;
+        return;
+    }
     ByteArray new_byte_array{new_size, m_alignment};
     memcpy(new_byte_array.data(), m_bytes, m_size);
     *this = std::move(new_byte_array);
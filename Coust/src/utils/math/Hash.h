@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <string_view>
+
 namespace coust {
 
 template <typename T>
@@ -24,4 +27,22 @@ constexpr std::size_t calc_std_hash(T const& key)
     return std::hash<type>{}(key);
 }
 
+// a hasher & a key equal both marked transparent (e.g. `std::equal_to<>`)
+// accept any key they can handle, so a map keyed by strings can be looked up
+// with a string view without constructing a temporary key
+template <typename Hash, typename Key_Equal>
+concept transparent_lookup = requires {
+    typename Hash::is_transparent;
+    typename Key_Equal::is_transparent;
+};
+
+// hash every kind of string through `std::string_view`
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const noexcept {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
 }  // namespace coust
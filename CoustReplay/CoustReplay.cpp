@@ -0,0 +1,77 @@
+#include "utils/Compiler.h"
+#include "core/Memory.h"
+#include "utils/allocators/AllocationTrace.h"
+#include "utils/allocators/HeapAllocator.h"
+
+// Replay an allocation trace recorded by `AggregateAllocator::start_trace()`
+// against the candidate allocators:
+//     CoustReplay <trace file> [candidate]
+// The resident memory of the process only counts the pages touched after the
+// replay starts, so a candidate may look better when it runs after another one
+// which leaves freed pages behind. Name a candidate to replay it alone.
+
+namespace {
+
+using namespace coust;
+using namespace coust::memory;
+
+// a single TLSF heap over one reserved range, which tells how much the pools
+// of size classes buy us
+using SingleTLSFAlloc = GrowableAllocator<GrowthType::virtual_memory,
+    large_growth_factor, TLSFAllocator>;
+
+size_t constexpr single_tlsf_reserved_size = size_t{1} << 32;
+
+void print_report(std::string_view name, ReplayReport const& report) {
+    std::cout << std::format(
+        "{:<16}{:>14.0f} ops/s{:>10.2f} ms{:>10} KiB live{:>10} KiB rss"
+        "{:>8.2f}% frag{:>6} failed\n",
+        name, report.get_operations_per_second(), report.seconds * 1000.0,
+        report.peak_live_size / 1024, report.peak_rss_size / 1024,
+        report.get_fragmentation_ratio() * 100.0, report.failed_count);
+}
+
+template <typename Alloc, typename... Args>
+void replay(std::string_view name, std::string_view selected,
+    std::span<AllocationEvent const> events, Args&&... args) {
+    if (!selected.empty() && selected != name)
+        return;
+    Alloc alloc{std::forward<Args>(args)...};
+    print_report(name, replay_allocation_trace(events, alloc));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "usage: CoustReplay <trace file> "
+                     "[heap | aggregate | thread_cached | single_tlsf]\n";
+        return 1;
+    }
+    WARNING_PUSH
+    CLANG_DISABLE_WARNING("-Wunsafe-buffer-usage")
+    std::string_view const trace_path = argv[1];
+    std::string_view const selected = argc > 2 ? argv[2] : "";
+    WARNING_POP
+    auto const events = read_allocation_trace(trace_path);
+    std::cout << std::format("{} events from {}\n", events.size(), trace_path);
+
+    replay<HeapAllocator>("heap", selected, events);
+    {
+        MemoryPool pool{
+            {small_growth_factor, medium_growth_factor},
+            global_memory_pool_alignment
+        };
+        replay<AggregateAllocator>("aggregate", selected, events, pool);
+    }
+    {
+        MemoryPool pool{
+            {small_growth_factor, medium_growth_factor},
+            global_memory_pool_alignment
+        };
+        replay<ThreadCachedAllocator>("thread_cached", selected, events, pool);
+    }
+    replay<SingleTLSFAlloc>("single_tlsf", selected, events,
+        single_tlsf_reserved_size, PageType::transparent_huge);
+    return 0;
+}